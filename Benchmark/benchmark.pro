@@ -0,0 +1,25 @@
+# 推理性能测试工具（无界面、无需摄像头），与 project3.pro 共用推理核心
+QT       += core
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+# 统计堆分配（CV_MEMSTATS）
+CONFIG += memstats
+
+TARGET = cultural-vision-bench
+
+SOURCES += \
+    main.cpp \
+    inferencebench.cpp \
+    syntheticcorpus.cpp
+
+HEADERS += \
+    inferencebench.h \
+    syntheticcorpus.h
+
+INCLUDEPATH += \
+    $$PWD \
+    $$PWD/..
+
+include($$PWD/../RecognizeImg/recognizeimg.pri)
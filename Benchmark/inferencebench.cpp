@@ -0,0 +1,449 @@
+#include "inferencebench.h"
+#include "inference.h"
+#include "threadtuning.h"
+#include <QDateTime>
+#include <QDir>
+#include <QSysInfo>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+namespace {
+
+// 最近秩法取分位数，samples 已升序
+double Percentile(const std::vector<double>& samples, double p)
+{
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+    return samples[std::min(samples.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+QString SizeText(const cv::Size& size)
+{
+    return QString("%1x%2").arg(size.width).arg(size.height);
+}
+
+} // namespace
+
+BenchStats BenchStats::From(std::vector<double> samples, int imagesPerSample)
+{
+    BenchStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double v : samples) {
+        total += v;
+    }
+    stats.count = static_cast<int>(samples.size());
+    stats.mean = total / samples.size();
+    stats.p50 = Percentile(samples, 50);
+    stats.p95 = Percentile(samples, 95);
+    stats.p99 = Percentile(samples, 99);
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.imagesPerSec = total > 0.0 ? samples.size() * imagesPerSample * 1000.0 / total : 0.0;
+    return stats;
+}
+
+InferenceBench::InferenceBench(const BenchOptions &options)
+    : _options(options), _corpus(options.sizes, std::max(1, options.imagesPerSize))
+{
+}
+
+QJsonObject InferenceBench::Run(QTextStream &log)
+{
+    _results = QJsonArray();
+    _errors = QJsonArray();
+    _memory = QJsonArray();
+    _profiles = QJsonArray();
+    _tuning = QJsonObject();
+
+    if (Enabled("decode")) {
+        log << "decode...\n";
+        log.flush();
+        BenchDecode();
+    }
+    if (Enabled("preprocess")) {
+        log << "preprocess...\n";
+        log.flush();
+        BenchPreProcess();
+    }
+    if (Enabled("blob")) {
+        log << "blob...\n";
+        log.flush();
+        BenchBlob();
+    }
+    if (Enabled("session")) {
+        if (_options.modelPath.isEmpty()) {
+            log << "session: skipped (no --model)\n";
+        } else {
+            for (int threads : _options.threads) {
+                log << "session, intra threads " << threads << "...\n";
+                log.flush();
+                BenchSession(threads, log);
+            }
+        }
+    }
+    if (Enabled("sessions")) {
+        if (_options.modelPath.isEmpty()) {
+            log << "sessions: skipped (no --model)\n";
+        } else {
+            log << "sessions, " << _options.sessionCount << " per share mode...\n";
+            log.flush();
+            BenchSessionMemory(log);
+        }
+    }
+    // 性能分析会拖慢推理并写文件，不随默认阶段运行
+    if (_options.stages.contains("profile")) {
+        if (_options.modelPath.isEmpty()) {
+            log << "profile: skipped (no --model)\n";
+        } else {
+            for (int threads : _options.threads) {
+                log << "profile, intra threads " << threads << "...\n";
+                log.flush();
+                BenchProfile(threads, log);
+            }
+        }
+    }
+
+    // 线程配置调优与 GUI 首次运行时相同，耗时较长，不随默认阶段运行
+    if (_options.stages.contains("tune")) {
+        if (_options.modelPath.isEmpty()) {
+            log << "tune: skipped (no --model)\n";
+        } else {
+            log << "tune, intra/inter threads x spinning...\n";
+            log.flush();
+            BenchTune(log);
+        }
+    }
+
+    QJsonObject meta;
+    meta["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    meta["os"] = QSysInfo::prettyProductName();
+    meta["cpu_arch"] = QSysInfo::currentCpuArchitecture();
+    meta["logical_cpus"] = QThread::idealThreadCount();
+    meta["opencv"] = CV_VERSION;
+    meta["onnxruntime"] = OrtGetApiBase()->GetVersionString();
+    meta["model"] = _options.modelPath;
+    meta["imgsz"] = _options.imgSize;
+    meta["warmup"] = _options.warmup;
+    meta["iterations"] = _options.iterations;
+    meta["images_per_size"] = _options.imagesPerSize;
+
+    QJsonObject report;
+    report["meta"] = meta;
+    report["results"] = _results;
+    if (!_memory.isEmpty()) {
+        report["session_memory"] = _memory;
+    }
+    if (!_profiles.isEmpty()) {
+        report["profiles"] = _profiles;
+    }
+    if (!_tuning.isEmpty()) {
+        report["tuning"] = _tuning;
+    }
+    if (!_errors.isEmpty()) {
+        report["errors"] = _errors;
+    }
+    return report;
+}
+
+bool InferenceBench::Enabled(const QString &stage) const
+{
+    return _options.stages.isEmpty() || _options.stages.contains(stage);
+}
+
+std::vector<double> InferenceBench::Measure(const std::function<void(int)> &fn) const
+{
+    for (int i = 0; i < _options.warmup; ++i) {
+        fn(-1 - i);
+    }
+    std::vector<double> samples;
+    samples.reserve(size_t(std::max(0, _options.iterations)));
+    for (int i = 0; i < _options.iterations; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        fn(i);
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return samples;
+}
+
+void InferenceBench::AddResult(const QString &stage, QJsonObject params, const std::vector<double> &samples,
+                               int imagesPerSample)
+{
+    const BenchStats stats = BenchStats::From(samples, imagesPerSample);
+    params["stage"] = stage;
+    params["count"] = stats.count;
+    params["mean_ms"] = stats.mean;
+    params["p50_ms"] = stats.p50;
+    params["p95_ms"] = stats.p95;
+    params["p99_ms"] = stats.p99;
+    params["min_ms"] = stats.min;
+    params["max_ms"] = stats.max;
+    params["images_per_sec"] = stats.imagesPerSec;
+    _results.append(params);
+}
+
+void InferenceBench::BenchDecode()
+{
+    for (size_t s = 0; s < _corpus.Sizes().size(); ++s) {
+        const std::vector<SyntheticCorpus::Image>& images = _corpus.Images(int(s));
+        for (const QString& format : {QString("jpeg"), QString("png")}) {
+            const std::vector<double> samples = Measure([&](int i) {
+                const SyntheticCorpus::Image& image = images[size_t(std::abs(i)) % images.size()];
+                const std::vector<uchar>& bytes = format == "jpeg" ? image.jpeg : image.png;
+                cv::Mat decoded = cv::imdecode(bytes, cv::IMREAD_COLOR);
+                Q_UNUSED(decoded);
+            });
+            QJsonObject params;
+            params["size"] = SizeText(_corpus.Sizes()[s]);
+            params["format"] = format;
+            AddResult("decode", params, samples);
+        }
+    }
+}
+
+void InferenceBench::BenchPreProcess()
+{
+    // PreProcess 不依赖推理会话
+    YOLO_V8 yolo;
+    const std::vector<int> imgsz = {_options.imgSize, _options.imgSize};
+    for (size_t s = 0; s < _corpus.Sizes().size(); ++s) {
+        const std::vector<SyntheticCorpus::Image>& images = _corpus.Images(int(s));
+        const std::vector<double> samples = Measure([&](int i) {
+            cv::Mat input = images[size_t(std::abs(i)) % images.size()].pixels;
+            cv::Mat output;
+            yolo.PreProcess(input, imgsz, output);
+        });
+        QJsonObject params;
+        params["size"] = SizeText(_corpus.Sizes()[s]);
+        AddResult("preprocess", params, samples);
+    }
+}
+
+void InferenceBench::BenchBlob()
+{
+    // 输入固定为模型尺寸，与原图尺寸无关
+    YOLO_V8 yolo;
+    cv::Mat input = _corpus.Images(0).front().pixels;
+    cv::Mat processed;
+    yolo.PreProcess(input, {_options.imgSize, _options.imgSize}, processed);
+
+    std::vector<float> buffer(processed.total() * 3);
+    float* blob = buffer.data();
+    const std::vector<double> samples = Measure([&](int) {
+        BlobFromImage(processed, blob);
+    });
+    QJsonObject params;
+    params["size"] = SizeText(cv::Size(_options.imgSize, _options.imgSize));
+    AddResult("blob", params, samples);
+}
+
+void InferenceBench::BenchSession(int threads, QTextStream &log)
+{
+    YOLO_V8 yolo;
+    DL_INIT_PARAM params;
+    params.modelPath = _options.modelPath.toStdString();
+    params.imgSize = {_options.imgSize, _options.imgSize};
+    params.modelType = YOLO_CLS;
+    params.cudaEnable = false;
+    params.intraOpNumThreads = threads;
+    params.logSeverityLevel = 3;
+    const char* ret = yolo.CreateSession(params);
+    if (ret != RET_OK) {
+        log << "  CreateSession failed: " << ret << "\n";
+        QJsonObject error;
+        error["threads"] = threads;
+        error["error"] = QString(ret);
+        _errors.append(error);
+        return;
+    }
+
+    for (size_t s = 0; s < _corpus.Sizes().size(); ++s) {
+        const std::vector<SyntheticCorpus::Image>& images = _corpus.Images(int(s));
+        QJsonObject base;
+        base["size"] = SizeText(_corpus.Sizes()[s]);
+        base["threads"] = threads;
+        base["batch"] = 1;
+
+        // 端到端 RunSession，同时记录内部的 session->Run 与后处理耗时
+        std::vector<double> run, post;
+        const std::vector<double> e2e = Measure([&](int i) {
+            cv::Mat input = images[size_t(std::abs(i)) % images.size()].pixels;
+            std::vector<DL_RESULT> results;
+            yolo.RunSession(input, results);
+            if (i >= 0) {
+                run.push_back(yolo.LastStageTime().run);
+                post.push_back(yolo.LastStageTime().postProcess);
+            }
+        });
+        AddResult("run", base, run);
+        AddResult("postprocess", base, post);
+        AddResult("end_to_end", base, e2e);
+
+        // 从 JPEG 字节开始的完整流程（解码 + RunSession）
+        const std::vector<double> pipeline = Measure([&](int i) {
+            const std::vector<uchar>& bytes = images[size_t(std::abs(i)) % images.size()].jpeg;
+            cv::Mat input = cv::imdecode(bytes, cv::IMREAD_COLOR);
+            std::vector<DL_RESULT> results;
+            yolo.RunSession(input, results);
+        });
+        AddResult("pipeline", base, pipeline);
+
+        // 批量推理：模型不支持动态 batch 时 RunSessionBatch 逐张推理，结果中标明
+        for (int batch : _options.batches) {
+            if (batch <= 1) {
+                continue;
+            }
+            std::vector<cv::Mat> inputs;
+            for (int k = 0; k < batch; ++k) {
+                inputs.push_back(images[size_t(k) % images.size()].pixels);
+            }
+            const std::vector<double> samples = Measure([&](int) {
+                std::vector<std::vector<DL_RESULT>> results;
+                yolo.RunSessionBatch(inputs, results);
+            });
+            QJsonObject batch_params = base;
+            batch_params["batch"] = batch;
+            batch_params["dynamic_batch"] = yolo.SupportsBatch();
+            AddResult("batch", batch_params, samples, batch);
+        }
+    }
+}
+
+void InferenceBench::BenchSessionMemory(QTextStream &log)
+{
+    const double mb = 1024.0 * 1024.0;
+    const struct { DL_SHARE_MODE mode; const char* name; } modes[] = {
+        {SHARE_NONE, "none"}, {SHARE_WEIGHTS, "weights"}, {SHARE_SESSION, "session"},
+    };
+    cv::Mat input = _corpus.Images(0).front().pixels;
+
+    for (const auto& mode : modes) {
+        // 每种方式之间全部释放，增量互不影响（SHARE_WEIGHTS 的重排权重在进程内保留，因此先测 none）
+        std::vector<std::unique_ptr<YOLO_V8>> sessions;
+        QJsonArray steps;
+        const qint64 baseline = MemoryStats::ResidentBytes();
+        qint64 previous = baseline;
+        for (int i = 0; i < _options.sessionCount; ++i) {
+            DL_INIT_PARAM params;
+            params.modelPath = _options.modelPath.toStdString();
+            params.imgSize = {_options.imgSize, _options.imgSize};
+            params.modelType = YOLO_CLS;
+            params.intraOpNumThreads = 1;
+            params.logSeverityLevel = 3;
+            params.shareMode = mode.mode;
+            std::unique_ptr<YOLO_V8> yolo(new YOLO_V8);
+            const char* ret = yolo->CreateSession(params);
+            if (ret != RET_OK) {
+                log << "  CreateSession failed: " << ret << "\n";
+                QJsonObject error;
+                error["share_mode"] = mode.name;
+                error["error"] = QString(ret);
+                _errors.append(error);
+                break;
+            }
+            // 运行一次，计入 arena 与中间结果的内存
+            std::vector<DL_RESULT> results;
+            yolo->RunSession(input, results);
+            sessions.push_back(std::move(yolo));
+
+            const qint64 resident = MemoryStats::ResidentBytes();
+            QJsonObject step;
+            step["sessions"] = i + 1;
+            step["resident_mb"] = resident / mb;
+            step["delta_mb"] = (resident - previous) / mb;
+            steps.append(step);
+            previous = resident;
+        }
+
+        QJsonObject entry;
+        entry["share_mode"] = mode.name;
+        entry["baseline_mb"] = baseline / mb;
+        entry["total_delta_mb"] = (previous - baseline) / mb;
+        entry["shared_sessions"] = YOLO_V8::SharedSessionCount();
+        entry["steps"] = steps;
+        _memory.append(entry);
+        log << "  " << mode.name << ": +" << QString::number((previous - baseline) / mb, 'f', 1)
+            << " MB for " << steps.size() << " sessions\n";
+        log.flush();
+    }
+}
+
+void InferenceBench::BenchProfile(int threads, QTextStream &log)
+{
+    QDir().mkpath(_options.profileDir);
+    YOLO_V8 yolo;
+    DL_INIT_PARAM params;
+    params.modelPath = _options.modelPath.toStdString();
+    params.imgSize = {_options.imgSize, _options.imgSize};
+    params.modelType = YOLO_CLS;
+    params.intraOpNumThreads = threads;
+    params.logSeverityLevel = 3;
+    params.profilePrefix = QDir(_options.profileDir).filePath(QString("ort-t%1").arg(threads)).toStdString();
+    params.profileRuns = _options.iterations;
+    const char* ret = yolo.CreateSession(params);
+    if (ret != RET_OK) {
+        log << "  CreateSession failed: " << ret << "\n";
+        QJsonObject error;
+        error["threads"] = threads;
+        error["stage"] = "profile";
+        error["error"] = QString(ret);
+        _errors.append(error);
+        return;
+    }
+
+    // 分析文件中的第一次 Run 是 CreateSession 内的预热
+    const std::vector<SyntheticCorpus::Image>& images = _corpus.Images(0);
+    for (int i = 0; i < _options.iterations; ++i) {
+        cv::Mat input = images[size_t(i) % images.size()].pixels;
+        std::vector<DL_RESULT> results;
+        yolo.RunSession(input, results);
+    }
+    const QString file = QString::fromStdString(yolo.EndProfiling());
+    log << "  " << file << "\n";
+
+    QJsonObject profile;
+    profile["threads"] = threads;
+    profile["runs"] = _options.iterations;
+    profile["file"] = file;
+    _profiles.append(profile);
+}
+
+void InferenceBench::BenchTune(QTextStream &log)
+{
+    ThreadTuning& tuning = ThreadTuning::Instance();
+    QString errorMsg;
+    if (!tuning.Tune(_options.modelPath.toStdString(), &errorMsg)) {
+        QJsonObject error;
+        error["stage"] = "tune";
+        error["message"] = errorMsg;
+        _errors.append(error);
+        log << "  " << errorMsg << "\n";
+        return;
+    }
+
+    auto toJson = [](const ThreadProfile& profile) {
+        QJsonObject object;
+        object["intra_threads"] = profile.intraOpNumThreads;
+        object["inter_threads"] = profile.interOpNumThreads;
+        object["spinning"] = profile.allowSpinning;
+        object["latency_ms"] = profile.latencyMs;
+        object["cpu_ms"] = profile.cpuMs;
+        return object;
+    };
+    QJsonArray results;
+    for (const ThreadProfile& profile : tuning.Results()) {
+        results.append(toJson(profile));
+    }
+    _tuning["results"] = results;
+    _tuning["latency"] = toJson(tuning.Profile(ThreadTuning::LowLatency));
+    _tuning["cpu"] = toJson(tuning.Profile(ThreadTuning::LowCpu));
+    _tuning["saved_to"] = ThreadTuning::DefaultPath();
+}
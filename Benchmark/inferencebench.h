@@ -0,0 +1,99 @@
+#ifndef INFERENCEBENCH_H
+#define INFERENCEBENCH_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QStringList>
+#include <QTextStream>
+#include <functional>
+#include <vector>
+#include "syntheticcorpus.h"
+
+// 性能测试参数
+struct BenchOptions
+{
+    QString modelPath;                  // 模型文件，为空时只测与模型无关的阶段
+    std::vector<cv::Size> sizes;        // 原图尺寸
+    int imagesPerSize = 4;              // 每个尺寸的合成图片数量
+    int imgSize = 640;                  // 模型输入边长
+    std::vector<int> threads{1, 2, 4};  // ORT intra-op 线程数
+    std::vector<int> batches{1, 4, 8};  // 每次 session->Run 的图片数
+    int warmup = 3;                     // 每个用例的预热次数（不计入统计）
+    int iterations = 30;                // 每个用例的计时次数
+    QStringList stages;                 // 只运行这些阶段，为空表示全部
+    int sessionCount = 4;               // sessions 阶段每种共享方式创建的会话数
+    QString profileDir = ".";           // profile 阶段 ORT 性能分析文件的目录
+};
+
+// 一个用例的延迟统计（毫秒）
+struct BenchStats
+{
+    int count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double imagesPerSec = 0.0;
+
+    /**
+     * @param samples 每次计时的耗时
+     * @param imagesPerSample 每次计时处理的图片数
+     */
+    static BenchStats From(std::vector<double> samples, int imagesPerSample);
+};
+
+/**
+ * @brief 推理性能测试
+ * 分别测量解码、PreProcess、BlobFromImage、session->Run、后处理与端到端 RunSession，
+ * 覆盖不同原图尺寸、线程数与 batch 大小，结果输出为 JSON。
+ * 阶段：decode、preprocess、blob 不需要模型；session（run / postprocess / end_to_end / pipeline / batch）需要模型；
+ * sessions 阶段按三种共享方式（DL_SHARE_MODE）依次创建 N 个会话，记录每个会话带来的常驻内存增量；
+ * profile 阶段只在 --stages 明确列出时运行，按每个线程数开启 ORT 性能分析推理 iterations 次，
+ * 分析文件用 tools/ort_profile_report.py 汇总；
+ * tune 阶段同样只在明确列出时运行，执行与 GUI 首次运行相同的线程配置调优（ThreadTuning），
+ * 输出全部组合的延迟与每帧 CPU 时间以及两个目标的最佳组合。
+ */
+class InferenceBench
+{
+public:
+    explicit InferenceBench(const BenchOptions& options);
+
+    /**
+     * @brief 运行全部用例
+     * @param log 进度输出
+     * @return 完整报告（meta + results）
+     */
+    QJsonObject Run(QTextStream& log);
+
+    const SyntheticCorpus& Corpus() const { return _corpus; }
+
+private:
+    bool Enabled(const QString& stage) const;
+
+    // 预热后计时 iterations 次，每次调用 fn(序号)，预热时序号为负
+    std::vector<double> Measure(const std::function<void(int)>& fn) const;
+
+    void AddResult(const QString& stage, QJsonObject params, const std::vector<double>& samples,
+                   int imagesPerSample = 1);
+
+    void BenchDecode();
+    void BenchPreProcess();
+    void BenchBlob();
+    void BenchSession(int threads, QTextStream& log);
+    void BenchSessionMemory(QTextStream& log);
+    void BenchProfile(int threads, QTextStream& log);
+    void BenchTune(QTextStream& log);
+
+private:
+    BenchOptions _options;
+    SyntheticCorpus _corpus;
+    QJsonArray _results;
+    QJsonArray _errors;
+    QJsonArray _memory;
+    QJsonArray _profiles;
+    QJsonObject _tuning;
+};
+
+#endif // INFERENCEBENCH_H
@@ -0,0 +1,127 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTextStream>
+#include "inferencebench.h"
+#include "tracer.h"
+
+namespace {
+
+// 解析 "1,2,4"
+std::vector<int> ParseInts(const QString& text)
+{
+    std::vector<int> values;
+    for (const QString& part : text.split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const int value = part.trimmed().toInt(&ok);
+        if (ok && value > 0) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+// 解析 "640x480,1920x1080"
+std::vector<cv::Size> ParseSizes(const QString& text)
+{
+    std::vector<cv::Size> sizes;
+    for (const QString& part : text.split(',', Qt::SkipEmptyParts)) {
+        const QStringList wh = part.trimmed().toLower().split('x');
+        if (wh.size() == 2 && wh[0].toInt() > 0 && wh[1].toInt() > 0) {
+            sizes.emplace_back(wh[0].toInt(), wh[1].toInt());
+        }
+    }
+    return sizes;
+}
+
+} // namespace
+
+// 推理性能测试
+// 用法：cultural-vision-bench [--model best.onnx] [--sizes 640x480,1920x1080] [--threads 1,2,4] [--batch 1,4,8]
+//       [--iterations 30] [--warmup 3] [--stages decode,preprocess,blob,session,sessions,profile,tune]
+//       [--session-count 4] [--profile-dir dir] [-o report.json] [--trace trace.json]
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cultural-vision-bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark decode, preprocessing and inference on a synthetic image corpus.");
+    parser.addHelpOption();
+
+    QCommandLineOption modelOption({"m", "model"}, "ONNX model file; without it only model-independent stages run.", "path");
+    QCommandLineOption sizesOption("sizes", "Source image sizes.", "WxH,...", "640x480,1280x720,1920x1080,4032x3024");
+    QCommandLineOption imagesOption("images", "Synthetic images per size.", "n", "4");
+    QCommandLineOption imgszOption("imgsz", "Model input size.", "n", "640");
+    QCommandLineOption threadsOption("threads", "ONNX Runtime intra-op thread counts.", "n,...", "1,2,4");
+    QCommandLineOption batchOption("batch", "Batch sizes.", "n,...", "1,4,8");
+    QCommandLineOption warmupOption("warmup", "Untimed runs per case.", "n", "3");
+    QCommandLineOption iterOption({"n", "iterations"}, "Timed runs per case.", "n", "30");
+    QCommandLineOption stagesOption("stages", "Stages to run: decode, preprocess, blob, session, sessions, profile, tune "
+                                    "(profile and tune only when listed).", "list");
+    QCommandLineOption profileDirOption("profile-dir", "Directory for ORT profile files of the profile stage.", "dir", ".");
+    QCommandLineOption sessionCountOption("session-count", "Sessions created per share mode in the sessions stage.", "n", "4");
+    QCommandLineOption outputOption({"o", "output"}, "Write the JSON report to file instead of stdout.", "path");
+    QCommandLineOption saveOption("save-corpus", "Also write the synthetic corpus to a directory.", "dir");
+    QCommandLineOption traceOption("trace", "Record per-stage spans and write a Chrome trace JSON file.", "path");
+
+    parser.addOptions({modelOption, sizesOption, imagesOption, imgszOption, threadsOption, batchOption,
+                       warmupOption, iterOption, stagesOption, sessionCountOption, profileDirOption, outputOption, saveOption, traceOption});
+    parser.process(app);
+
+    QTextStream err(stderr);
+
+    BenchOptions options;
+    options.modelPath = parser.value(modelOption);
+    options.sizes = ParseSizes(parser.value(sizesOption));
+    options.imagesPerSize = parser.value(imagesOption).toInt();
+    options.imgSize = parser.value(imgszOption).toInt();
+    options.threads = ParseInts(parser.value(threadsOption));
+    options.batches = ParseInts(parser.value(batchOption));
+    options.warmup = qMax(0, parser.value(warmupOption).toInt());
+    options.iterations = parser.value(iterOption).toInt();
+    options.sessionCount = qMax(1, parser.value(sessionCountOption).toInt());
+    options.profileDir = parser.value(profileDirOption);
+    if (parser.isSet(stagesOption)) {
+        options.stages = parser.value(stagesOption).split(',', Qt::SkipEmptyParts);
+    }
+
+    if (options.sizes.empty() || options.imgSize <= 0 || options.iterations <= 0) {
+        err << "Invalid --sizes, --imgsz or --iterations.\n";
+        return 2;
+    }
+
+    err << "generating synthetic corpus...\n";
+    err.flush();
+    InferenceBench bench(options);
+    if (parser.isSet(saveOption)) {
+        err << "saved " << bench.Corpus().Save(parser.value(saveOption)) << " files\n";
+    }
+
+    Tracer::SetEnabled(parser.isSet(traceOption));
+    const QJsonObject report = bench.Run(err);
+    if (parser.isSet(traceOption)) {
+        Tracer::SetEnabled(false);
+        if (!Tracer::WriteChromeJson(parser.value(traceOption))) {
+            err << "Cannot write file: " << parser.value(traceOption) << "\n";
+        }
+    }
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    // 报告写入文件或标准输出
+    QFile outFile;
+    if (parser.isSet(outputOption)) {
+        outFile.setFileName(parser.value(outputOption));
+        if (!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "Cannot write file: " << outFile.fileName() << "\n";
+            return 1;
+        }
+    } else {
+        outFile.open(stdout, QIODevice::WriteOnly);
+    }
+    outFile.write(json);
+    outFile.flush();
+
+    return report.contains("errors") ? 3 : 0;
+}
@@ -0,0 +1,89 @@
+#include "syntheticcorpus.h"
+#include <QDir>
+#include <QFile>
+
+SyntheticCorpus::SyntheticCorpus(const std::vector<cv::Size> &sizes, int imagesPerSize, quint64 seed)
+    : _sizes(sizes)
+{
+    cv::RNG rng(seed);
+    const std::vector<int> jpeg_params = {cv::IMWRITE_JPEG_QUALITY, 90};
+    _images.resize(_sizes.size());
+    for (size_t s = 0; s < _sizes.size(); ++s) {
+        for (int i = 0; i < imagesPerSize; ++i) {
+            Image image;
+            image.pixels = Generate(_sizes[s], rng);
+            cv::imencode(".jpg", image.pixels, image.jpeg, jpeg_params);
+            cv::imencode(".png", image.pixels, image.png);
+            _images[s].push_back(std::move(image));
+        }
+    }
+}
+
+int SyntheticCorpus::Save(const QString &dirPath) const
+{
+    QDir dir(dirPath);
+    if (!dir.mkpath(".")) {
+        return 0;
+    }
+    int written = 0;
+    auto write = [&dir, &written](const QString& name, const std::vector<uchar>& bytes) {
+        QFile file(dir.filePath(name));
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            && file.write(reinterpret_cast<const char*>(bytes.data()), qint64(bytes.size())) == qint64(bytes.size())) {
+            written++;
+        }
+    };
+    for (size_t s = 0; s < _sizes.size(); ++s) {
+        for (size_t i = 0; i < _images[s].size(); ++i) {
+            const QString base = QString("synthetic_%1x%2_%3").arg(_sizes[s].width).arg(_sizes[s].height).arg(i);
+            write(base + ".jpg", _images[s][i].jpeg);
+            write(base + ".png", _images[s][i].png);
+        }
+    }
+    return written;
+}
+
+cv::Mat SyntheticCorpus::Generate(const cv::Size &size, cv::RNG &rng)
+{
+    // 水平、垂直两个方向的颜色渐变作为底色
+    cv::Mat image(size, CV_8UC3);
+    const cv::Vec3b a(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+    const cv::Vec3b b(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+    for (int y = 0; y < size.height; ++y) {
+        cv::Vec3b* row = image.ptr<cv::Vec3b>(y);
+        const float fy = size.height > 1 ? float(y) / (size.height - 1) : 0.0f;
+        for (int x = 0; x < size.width; ++x) {
+            const float fx = size.width > 1 ? float(x) / (size.width - 1) : 0.0f;
+            const float t = 0.5f * (fx + fy);
+            for (int c = 0; c < 3; ++c) {
+                row[x][c] = cv::saturate_cast<uchar>(a[c] * (1.0f - t) + b[c] * t);
+            }
+        }
+    }
+
+    // 随机色块与线条，模拟纹样的高频细节，使编码大小接近真实照片
+    const int shapes = 20 + rng.uniform(0, 20);
+    const int scale = std::max(1, std::min(size.width, size.height) / 8);
+    for (int i = 0; i < shapes; ++i) {
+        const cv::Scalar color(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+        const cv::Point p1(rng.uniform(0, size.width), rng.uniform(0, size.height));
+        const cv::Point p2(rng.uniform(0, size.width), rng.uniform(0, size.height));
+        switch (i % 3) {
+        case 0:
+            cv::circle(image, p1, rng.uniform(1, scale + 1), color, cv::FILLED, cv::LINE_AA);
+            break;
+        case 1:
+            cv::rectangle(image, p1, p2, color, rng.uniform(1, 6));
+            break;
+        default:
+            cv::line(image, p1, p2, color, rng.uniform(1, 4), cv::LINE_AA);
+            break;
+        }
+    }
+
+    // 传感器噪声（有符号，叠加后饱和到 0~255）
+    cv::Mat noise(size, CV_16SC3);
+    rng.fill(noise, cv::RNG::NORMAL, cv::Scalar::all(0), cv::Scalar::all(8));
+    cv::add(image, noise, image, cv::noArray(), CV_8U);
+    return image;
+}
@@ -0,0 +1,48 @@
+#ifndef SYNTHETICCORPUS_H
+#define SYNTHETICCORPUS_H
+
+#include <QString>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 合成测试图片集
+ * 用固定随机种子生成带渐变、色块、线条和噪声的图片并编码为 JPEG / PNG，
+ * 每次运行内容完全相同，不依赖磁盘上的样本，结果可以跨机器比较。
+ */
+class SyntheticCorpus
+{
+public:
+    // 一张合成图片
+    struct Image
+    {
+        cv::Mat pixels;             // 解码后的 BGR 像素
+        std::vector<uchar> jpeg;    // JPEG 编码（质量 90）
+        std::vector<uchar> png;     // PNG 编码
+    };
+
+    /**
+     * @param sizes 图片尺寸列表（宽 x 高）
+     * @param imagesPerSize 每个尺寸生成的图片数量
+     * @param seed 随机种子
+     */
+    SyntheticCorpus(const std::vector<cv::Size>& sizes, int imagesPerSize, quint64 seed = 20240601);
+
+    const std::vector<cv::Size>& Sizes() const { return _sizes; }
+
+    // 某个尺寸的全部图片
+    const std::vector<Image>& Images(int sizeIndex) const { return _images[sizeIndex]; }
+
+    // 把图片集写入目录（便于用其他工具复现），返回写入的文件数
+    int Save(const QString& dirPath) const;
+
+private:
+    static cv::Mat Generate(const cv::Size& size, cv::RNG& rng);
+
+private:
+    std::vector<cv::Size> _sizes;
+    std::vector<std::vector<Image>> _images;
+};
+
+#endif // SYNTHETICCORPUS_H
@@ -0,0 +1,253 @@
+#include "batchclassifier.h"
+#include "recognizeimgthread.h"
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSet>
+#include <QThread>
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+// 支持的图片后缀
+const QSet<QString> IMAGE_SUFFIXES = {"jpg", "jpeg", "png", "bmp", "tif", "tiff", "webp"};
+
+bool IsImageFile(const QFileInfo& info)
+{
+    return info.isFile() && IMAGE_SUFFIXES.contains(info.suffix().toLower());
+}
+
+// CSV 字段转义：包含逗号、引号或换行时加引号
+QString CsvField(const QString& value)
+{
+    if (value.contains(',') || value.contains('"') || value.contains('\n')) {
+        QString escaped = value;
+        escaped.replace("\"", "\"\"");
+        return "\"" + escaped + "\"";
+    }
+    return value;
+}
+
+// 最近秩法计算分位数（输入已排序）
+double Percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.5);
+    rank = std::min(std::max<size_t>(rank, 1), sorted.size());
+    return sorted[rank - 1];
+}
+
+} // namespace
+
+BatchClassifier::BatchClassifier(const ClassifyOptions &options)
+    : _options(options)
+{
+}
+
+QString BatchClassifier::Init()
+{
+    _class_names = RecognizeImgThread::readLabels(_options.labelPath.toStdString());
+    if (_class_names.empty()) {
+        return QString("Cannot load labels: %1").arg(_options.labelPath);
+    }
+
+    DL_INIT_PARAM params;
+    params.modelPath = _options.modelPath.toStdString();
+    params.imgSize = {640, 640};
+    params.modelType = YOLO_CLS;
+    params.cudaEnable = false;
+    params.intraOpNumThreads = _options.intraOpNumThreads;
+    params.logSeverityLevel = 3;
+
+    const char* ret = _yolo.CreateSession(params);
+    if (ret != RET_OK) {
+        return QString("CreateSession failed: %1").arg(ret);
+    }
+    if (_options.batchSize > 1 && !_yolo.SupportsBatch()) {
+        qWarning("Model input has a fixed batch dimension, falling back to batch size 1.");
+    }
+    return QString();
+}
+
+QStringList BatchClassifier::CollectImages(const QStringList &inputs)
+{
+    QStringList files;
+    for (const QString& input : inputs) {
+        QFileInfo info(input);
+        if (info.isDir()) {
+            QStringList dir_files;
+            QDirIterator it(info.absoluteFilePath(), QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                it.next();
+                if (IsImageFile(it.fileInfo())) {
+                    dir_files << it.filePath();
+                }
+            }
+            dir_files.sort();
+            files << dir_files;
+        } else if (IsImageFile(info)) {
+            files << info.absoluteFilePath();
+        } else {
+            qWarning("Skipping non-image input: %s", qPrintable(input));
+        }
+    }
+    return files;
+}
+
+int BatchClassifier::Run(const QStringList &files, QTextStream &out)
+{
+    _next_index = 0;
+    _failed = 0;
+    _latencies.clear();
+    _latencies.reserve(files.size());
+
+    WriteHeader(out);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 启动工作线程，每个线程循环领取一个 batch 直到全部处理完
+    std::vector<std::unique_ptr<QThread>> workers;
+    const int worker_count = std::max(1, _options.workers);
+    for (int i = 0; i < worker_count; ++i) {
+        workers.emplace_back(QThread::create([this, &files, &out]() { WorkerLoop(files, out); }));
+        workers.back()->start();
+    }
+    for (auto& worker : workers) {
+        worker->wait();
+    }
+
+    _wall_ms = timer.nsecsElapsed() / 1e6;
+    out.flush();
+    return _failed;
+}
+
+void BatchClassifier::WorkerLoop(const QStringList &files, QTextStream &out)
+{
+    const int batch_size = _yolo.SupportsBatch() ? std::max(1, _options.batchSize) : 1;
+    const int total = files.size();
+
+    while (true) {
+        const int begin = _next_index.fetch_add(batch_size);
+        if (begin >= total) {
+            break;
+        }
+        const int end = std::min(begin + batch_size, total);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        // 解码本批次图片，无法解码的直接记为失败
+        std::vector<ClassifyRecord> records(end - begin);
+        std::vector<cv::Mat> images;
+        std::vector<int> image_slots;
+        for (int i = begin; i < end; ++i) {
+            ClassifyRecord& record = records[i - begin];
+            record.path = files.at(i);
+            cv::Mat image = cv::imread(record.path.toStdString());
+            if (image.empty()) {
+                record.error = "decode failed";
+                continue;
+            }
+            images.push_back(image);
+            image_slots.push_back(i - begin);
+        }
+
+        std::vector<std::vector<DL_RESULT>> results;
+        try {
+            _yolo.RunSessionBatch(images, results);
+        } catch (const std::exception& e) {
+            for (int slot : image_slots) {
+                records[slot].error = QString("inference failed: %1").arg(e.what());
+            }
+            results.clear();
+        }
+
+        const double latency = timer.nsecsElapsed() / 1e6;
+        for (size_t k = 0; k < results.size(); ++k) {
+            ClassifyRecord& record = records[image_slots[k]];
+            if (results[k].empty()) {
+                record.error = "no result";
+                continue;
+            }
+            const DL_RESULT& top = results[k].front();
+            record.classId = top.classId;
+            record.confidence = top.confidence;
+            record.className = (top.classId >= 0 && top.classId < (int)_class_names.size())
+                                   ? QString::fromStdString(_class_names[top.classId])
+                                   : QString("Invalid ID %1").arg(top.classId);
+        }
+
+        QMutexLocker locker(&_out_mutex);
+        for (ClassifyRecord& record : records) {
+            record.latencyMs = latency;
+            if (record.error.isEmpty()) {
+                _latencies.push_back(latency);
+            } else {
+                _failed++;
+            }
+            WriteRecord(out, record);
+        }
+    }
+}
+
+void BatchClassifier::WriteHeader(QTextStream &out)
+{
+    if (_options.format == "csv") {
+        out << "path,class_id,class_name,confidence,latency_ms,error\n";
+    }
+}
+
+void BatchClassifier::WriteRecord(QTextStream &out, const ClassifyRecord &record)
+{
+    if (_options.format == "jsonl") {
+        QJsonObject obj;
+        obj["path"] = record.path;
+        obj["class_id"] = record.classId;
+        obj["class_name"] = record.className;
+        obj["confidence"] = static_cast<double>(record.confidence);
+        obj["latency_ms"] = record.latencyMs;
+        if (!record.error.isEmpty()) {
+            obj["error"] = record.error;
+        }
+        out << QJsonDocument(obj).toJson(QJsonDocument::Compact) << "\n";
+    } else {
+        out << CsvField(record.path) << ','
+            << record.classId << ','
+            << CsvField(record.className) << ','
+            << QString::number(record.confidence, 'f', 6) << ','
+            << QString::number(record.latencyMs, 'f', 3) << ','
+            << CsvField(record.error) << "\n";
+    }
+}
+
+void BatchClassifier::PrintSummary(QTextStream &out) const
+{
+    std::vector<double> sorted = _latencies;
+    std::sort(sorted.begin(), sorted.end());
+
+    double mean = 0.0;
+    for (double v : sorted) {
+        mean += v;
+    }
+    mean = sorted.empty() ? 0.0 : mean / sorted.size();
+
+    const int processed = static_cast<int>(sorted.size()) + _failed;
+    const double throughput = _wall_ms > 0.0 ? processed * 1000.0 / _wall_ms : 0.0;
+
+    out << "images: " << processed << " (failed " << _failed << ")\n"
+        << "wall time: " << QString::number(_wall_ms / 1000.0, 'f', 3) << " s\n"
+        << "throughput: " << QString::number(throughput, 'f', 2) << " images/s\n"
+        << "latency ms: mean " << QString::number(mean, 'f', 2)
+        << "  p50 " << QString::number(Percentile(sorted, 50), 'f', 2)
+        << "  p90 " << QString::number(Percentile(sorted, 90), 'f', 2)
+        << "  p99 " << QString::number(Percentile(sorted, 99), 'f', 2)
+        << "  max " << QString::number(sorted.empty() ? 0.0 : sorted.back(), 'f', 2) << "\n";
+    out.flush();
+}
@@ -0,0 +1,79 @@
+#ifndef BATCHCLASSIFIER_H
+#define BATCHCLASSIFIER_H
+
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QMutex>
+#include <atomic>
+#include <vector>
+#include "inference.h"
+
+// 命令行分类参数
+struct ClassifyOptions
+{
+    QString modelPath;          // 模型文件路径
+    QString labelPath;          // 标签文件路径
+    int workers = 2;            // 并行工作线程数
+    int intraOpNumThreads = 1;  // 每次推理 ORT 使用的线程数
+    int batchSize = 8;          // 每次 session->Run 的图片数（模型支持动态 batch 时生效）
+    QString format = "csv";     // 输出格式：csv / jsonl
+};
+
+// 单张图片的分类结果
+struct ClassifyRecord
+{
+    QString path;               // 图片路径
+    int classId = -1;           // 类别 ID
+    QString className;          // 类别名
+    float confidence = 0.0f;    // 置信度
+    double latencyMs = 0.0;     // 从解码到得到结果的耗时
+    QString error;              // 失败原因，成功时为空
+};
+
+/**
+ * @brief 无界面批量分类器
+ * 复用 YOLO_V8 推理核心与 RecognizeImgThread 的标签加载，
+ * 多个工作线程共享同一个 Session，按 batch 取图片、解码、推理并输出 CSV / JSON Lines
+ */
+class BatchClassifier
+{
+public:
+    explicit BatchClassifier(const ClassifyOptions& options);
+
+    // 加载标签并创建推理会话，失败时返回错误信息
+    QString Init();
+
+    /**
+     * @brief 展开输入参数，目录按名称顺序递归收集其中的图片文件
+     * @param inputs 文件或目录列表
+     */
+    static QStringList CollectImages(const QStringList& inputs);
+
+    /**
+     * @brief 分类全部图片，结果逐行写入 out
+     * @return 失败的图片数量
+     */
+    int Run(const QStringList& files, QTextStream& out);
+
+    // 输出吞吐量与延迟分位数统计
+    void PrintSummary(QTextStream& out) const;
+
+private:
+    void WorkerLoop(const QStringList& files, QTextStream& out);
+    void WriteHeader(QTextStream& out);
+    void WriteRecord(QTextStream& out, const ClassifyRecord& record);
+
+private:
+    ClassifyOptions _options;
+    YOLO_V8 _yolo;                          // 所有工作线程共享的推理会话
+    std::vector<std::string> _class_names;  // 类别标签
+
+    std::atomic<int> _next_index{0};        // 下一个待处理图片的下标
+    QMutex _out_mutex;                      // 保护输出流与统计数据
+    std::vector<double> _latencies;         // 每张图片的延迟（毫秒）
+    int _failed = 0;                        // 失败数量
+    double _wall_ms = 0.0;                  // 总耗时
+};
+
+#endif // BATCHCLASSIFIER_H
@@ -0,0 +1,29 @@
+# 无界面命令行分类工具，与 project3.pro 共用推理核心
+QT       += core network
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = cultural-vision-cli
+
+SOURCES += \
+    main.cpp \
+    batchclassifier.cpp \
+    dynamicbatcher.cpp \
+    inferenceserver.cpp
+
+HEADERS += \
+    batchclassifier.h \
+    dynamicbatcher.h \
+    inferenceserver.h
+
+INCLUDEPATH += \
+    $$PWD \
+    $$PWD/..
+
+include($$PWD/../RecognizeImg/recognizeimg.pri)
+
+# Default rules for deployment.
+unix:!android: target.path = /opt/cultural-vision/bin
+!isEmpty(target.path): INSTALLS += target
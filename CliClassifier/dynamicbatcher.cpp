@@ -0,0 +1,139 @@
+#include "dynamicbatcher.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace {
+const size_t LATENCY_RING_SIZE = 4096;  // 统计分位数时保留的最近样本数
+}
+
+DynamicBatcher::DynamicBatcher(YOLO_V8 *yolo, int maxBatch, int maxDelayMs, QObject *parent)
+    : QThread(parent), _yolo(yolo),
+    _max_batch(std::max(1, maxBatch)), _max_delay_ms(std::max(0, maxDelayMs))
+{
+    _latency_ring.reserve(LATENCY_RING_SIZE);
+}
+
+void DynamicBatcher::Submit(BatchRequest request)
+{
+    request.enqueued.start();
+    QMutexLocker locker(&_mutex);
+    if (_stopping) {
+        locker.unlock();
+        request.done(DL_RESULT(), "server is shutting down");
+        return;
+    }
+    _queue.push_back(std::move(request));
+    _cond.wakeOne();
+}
+
+void DynamicBatcher::Stop()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _stopping = true;
+        _cond.wakeAll();
+    }
+    wait();
+}
+
+BatcherStats DynamicBatcher::Stats()
+{
+    QMutexLocker locker(&_mutex);
+    BatcherStats stats;
+    stats.requests = _requests;
+    stats.batches = _batches;
+    stats.queueDepth = static_cast<int>(_queue.size());
+    stats.meanBatch = _batches ? double(_requests) / _batches : 0.0;
+
+    std::vector<double> sorted = _latency_ring;
+    std::sort(sorted.begin(), sorted.end());
+    if (!sorted.empty()) {
+        stats.p50Ms = sorted[(sorted.size() - 1) * 50 / 100];
+        stats.p99Ms = sorted[(sorted.size() - 1) * 99 / 100];
+    }
+    return stats;
+}
+
+void DynamicBatcher::RecordLatency(double ms)
+{
+    if (_latency_ring.size() < LATENCY_RING_SIZE) {
+        _latency_ring.push_back(ms);
+    } else {
+        _latency_ring[_latency_pos] = ms;
+        _latency_pos = (_latency_pos + 1) % LATENCY_RING_SIZE;
+    }
+}
+
+void DynamicBatcher::run()
+{
+    // 模型不支持动态 batch 时每次只取一张
+    const int max_batch = _yolo->SupportsBatch() ? _max_batch : 1;
+
+    while (true) {
+        std::vector<BatchRequest> batch;
+        {
+            QMutexLocker locker(&_mutex);
+            while (_queue.empty() && !_stopping) {
+                _cond.wait(&_mutex);
+            }
+            if (_stopping) {
+                break;
+            }
+
+            // 等待凑满一个 batch，最多等到最早请求的截止时间
+            while (!_stopping && (int)_queue.size() < max_batch) {
+                const qint64 remaining = _max_delay_ms - _queue.front().enqueued.elapsed();
+                if (remaining <= 0) {
+                    break;
+                }
+                _cond.wait(&_mutex, static_cast<unsigned long>(remaining));
+            }
+
+            const int take = std::min<int>(max_batch, static_cast<int>(_queue.size()));
+            for (int i = 0; i < take; ++i) {
+                batch.push_back(std::move(_queue.front()));
+                _queue.pop_front();
+            }
+        }
+
+        // 在锁外执行推理，期间新的请求可以继续入队
+        std::vector<cv::Mat> images;
+        images.reserve(batch.size());
+        for (BatchRequest& request : batch) {
+            images.push_back(request.image);
+        }
+
+        std::vector<std::vector<DL_RESULT>> results;
+        QString error;
+        try {
+            _yolo->RunSessionBatch(images, results);
+        } catch (const std::exception& e) {
+            error = QString("inference failed: %1").arg(e.what());
+        }
+
+        std::vector<double> latencies;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (error.isEmpty() && i < results.size() && !results[i].empty()) {
+                batch[i].done(results[i].front(), QString());
+            } else {
+                batch[i].done(DL_RESULT(), error.isEmpty() ? QString("no result") : error);
+            }
+            latencies.push_back(batch[i].enqueued.nsecsElapsed() / 1e6);
+        }
+
+        QMutexLocker locker(&_mutex);
+        _batches++;
+        _requests += batch.size();
+        for (double ms : latencies) {
+            RecordLatency(ms);
+        }
+    }
+
+    // 退出前通知所有未处理的请求
+    QMutexLocker locker(&_mutex);
+    while (!_queue.empty()) {
+        BatchRequest request = std::move(_queue.front());
+        _queue.pop_front();
+        request.done(DL_RESULT(), "server is shutting down");
+    }
+}
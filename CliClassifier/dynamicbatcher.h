@@ -0,0 +1,73 @@
+#ifndef DYNAMICBATCHER_H
+#define DYNAMICBATCHER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "inference.h"
+
+// 待推理请求：解码后的图片 + 完成回调（在批处理线程中调用）
+struct BatchRequest
+{
+    cv::Mat image;
+    std::function<void(const DL_RESULT& result, const QString& error)> done;
+    QElapsedTimer enqueued;   // 入队时刻，用于计算排队延迟
+};
+
+// 批处理统计
+struct BatcherStats
+{
+    quint64 requests = 0;     // 已完成请求数
+    quint64 batches = 0;      // 已执行的 session->Run 次数
+    int queueDepth = 0;       // 当前排队请求数
+    double meanBatch = 0.0;   // 平均 batch 大小
+    double p50Ms = 0.0;       // 请求延迟（入队到完成）分位数
+    double p99Ms = 0.0;
+};
+
+/**
+ * @brief 动态批处理线程
+ * 将并发到达的请求合并为一次批量推理：
+ * 队列达到 maxBatch，或最早的请求已等待 maxDelayMs 时立即执行
+ */
+class DynamicBatcher : public QThread
+{
+    Q_OBJECT
+public:
+    DynamicBatcher(YOLO_V8* yolo, int maxBatch, int maxDelayMs, QObject *parent = nullptr);
+
+    // 提交请求（线程安全）
+    void Submit(BatchRequest request);
+
+    // 停止线程，未处理的请求以错误结束
+    void Stop();
+
+    BatcherStats Stats();
+
+protected:
+    void run() override;
+
+private:
+    void RecordLatency(double ms);
+
+private:
+    YOLO_V8* _yolo;                     // 共享推理会话
+    const int _max_batch;               // 最大 batch
+    const int _max_delay_ms;            // 最长排队等待时间
+
+    QMutex _mutex;                      // 保护以下成员
+    QWaitCondition _cond;
+    std::deque<BatchRequest> _queue;
+    bool _stopping = false;
+
+    quint64 _requests = 0;
+    quint64 _batches = 0;
+    std::vector<double> _latency_ring;  // 最近请求延迟（环形缓冲）
+    size_t _latency_pos = 0;
+};
+
+#endif // DYNAMICBATCHER_H
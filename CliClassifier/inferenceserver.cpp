@@ -0,0 +1,282 @@
+#include "inferenceserver.h"
+#include "recognizeimgthread.h"
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QThreadPool>
+
+namespace {
+
+const int MAX_HEADER_BYTES = 16 * 1024;          // 请求头上限
+const qint64 MAX_BODY_BYTES = 64 * 1024 * 1024;  // 请求体（图片）上限
+
+QByteArray StatusText(int status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 413: return "Payload Too Large";
+    case 500: return "Internal Server Error";
+    default:  return "Error";
+    }
+}
+
+QByteArray ErrorJson(const QString& message)
+{
+    QJsonObject obj;
+    obj["error"] = message;
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+} // namespace
+
+InferenceServer::InferenceServer(const ServerOptions &options, QObject *parent)
+    : QObject(parent), _options(options)
+{
+    connect(&_server, &QTcpServer::newConnection, this, &InferenceServer::SlotNewConnection);
+}
+
+InferenceServer::~InferenceServer()
+{
+    _server.close();
+    QThreadPool::globalInstance()->waitForDone();
+    if (_batcher) {
+        _batcher->Stop();
+    }
+}
+
+QString InferenceServer::Start()
+{
+    _class_names = RecognizeImgThread::readLabels(_options.labelPath.toStdString());
+    if (_class_names.empty()) {
+        return QString("Cannot load labels: %1").arg(_options.labelPath);
+    }
+
+    DL_INIT_PARAM params;
+    params.modelPath = _options.modelPath.toStdString();
+    params.imgSize = {640, 640};
+    params.modelType = YOLO_CLS;
+    params.cudaEnable = false;
+    params.intraOpNumThreads = _options.intraOpNumThreads;
+    params.logSeverityLevel = 3;
+
+    const char* ret = _yolo.CreateSession(params);
+    if (ret != RET_OK) {
+        return QString("CreateSession failed: %1").arg(ret);
+    }
+
+    _batcher.reset(new DynamicBatcher(&_yolo, _options.maxBatch, _options.maxDelayMs));
+    _batcher->start();
+
+    // 只监听本机回环地址
+    if (!_server.listen(QHostAddress::LocalHost, _options.port)) {
+        return QString("Cannot listen on 127.0.0.1:%1: %2").arg(_options.port).arg(_server.errorString());
+    }
+    _uptime.start();
+    return QString();
+}
+
+void InferenceServer::SlotNewConnection()
+{
+    while (QTcpSocket* socket = _server.nextPendingConnection()) {
+        _connections.insert(socket, Connection());
+        connect(socket, &QTcpSocket::readyRead, this, &InferenceServer::SlotReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &InferenceServer::SlotDisconnected);
+    }
+}
+
+void InferenceServer::SlotReadyRead()
+{
+    auto* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket || !_connections.contains(socket)) {
+        return;
+    }
+    _connections[socket].buffer.append(socket->readAll());
+    ProcessBuffer(socket);
+}
+
+void InferenceServer::SlotDisconnected()
+{
+    auto* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+    _connections.remove(socket);
+    socket->deleteLater();
+}
+
+void InferenceServer::ProcessBuffer(QTcpSocket *socket)
+{
+    // 同一连接上的请求按顺序处理，上一个请求完成前不解析下一个；
+    // 在这里循环处理，流水线发送的大量请求不会加深调用栈
+    while (_connections.contains(socket) && !_connections[socket].busy && ProcessRequest(socket)) {
+    }
+}
+
+bool InferenceServer::ProcessRequest(QTcpSocket *socket)
+{
+    Connection& conn = _connections[socket];
+    const int header_end = conn.buffer.indexOf("\r\n\r\n");
+    if (header_end < 0) {
+        if (conn.buffer.size() > MAX_HEADER_BYTES) {
+            SendResponse(socket, 400, ErrorJson("header too large"), false);
+        }
+        return false;
+    }
+
+    // 解析请求行与请求头
+    const QList<QByteArray> lines = conn.buffer.left(header_end).split('\n');
+    const QList<QByteArray> request_line = lines.first().trimmed().split(' ');
+    if (request_line.size() < 3) {
+        SendResponse(socket, 400, ErrorJson("malformed request line"), false);
+        return false;
+    }
+    const QByteArray method = request_line.at(0);
+    const QByteArray target = request_line.at(1);
+    const bool http10 = request_line.at(2).trimmed() == "HTTP/1.0";
+
+    qint64 content_length = 0;
+    bool keep_alive = !http10;
+    for (int i = 1; i < lines.size(); ++i) {
+        const QByteArray line = lines.at(i).trimmed();
+        const int colon = line.indexOf(':');
+        if (colon <= 0) {
+            continue;
+        }
+        const QByteArray name = line.left(colon).trimmed().toLower();
+        const QByteArray value = line.mid(colon + 1).trimmed();
+        if (name == "content-length") {
+            content_length = value.toLongLong();
+        } else if (name == "connection") {
+            keep_alive = value.toLower() == "keep-alive" || (!http10 && value.toLower() != "close");
+        }
+    }
+
+    if (content_length < 0 || content_length > MAX_BODY_BYTES) {
+        SendResponse(socket, 413, ErrorJson("body too large"), false);
+        return false;
+    }
+
+    const qint64 total = header_end + 4 + content_length;
+    if (conn.buffer.size() < total) {
+        return false; // 请求体尚未接收完整
+    }
+    const QByteArray body = conn.buffer.mid(header_end + 4, content_length);
+    conn.buffer.remove(0, static_cast<int>(total));
+    _http_requests.fetch_add(1, std::memory_order_relaxed);
+
+    // 路由
+    const QByteArray path = target.split('?').first();
+    if (path == "/health") {
+        SendResponse(socket, 200, "{\"status\":\"ok\"}", keep_alive);
+    } else if (path == "/stats") {
+        SendResponse(socket, 200, StatsJson(), keep_alive);
+    } else if (path == "/classify") {
+        if (method != "POST") {
+            SendResponse(socket, 405, ErrorJson("use POST with image bytes"), keep_alive);
+        } else if (body.isEmpty()) {
+            SendResponse(socket, 400, ErrorJson("empty body"), keep_alive);
+        } else {
+            HandleClassify(socket, body, keep_alive);
+        }
+    } else {
+        SendResponse(socket, 404, ErrorJson("not found"), keep_alive);
+    }
+    return true;
+}
+
+void InferenceServer::HandleClassify(QTcpSocket *socket, const QByteArray &body, bool keepAlive)
+{
+    _connections[socket].busy = true;
+    QPointer<QTcpSocket> guard(socket);
+
+    // 回到服务线程发送响应（连接可能已断开）
+    auto reply = [this, guard, keepAlive](int status, const QByteArray& json) {
+        QMetaObject::invokeMethod(this, [this, guard, keepAlive, status, json]() {
+            if (guard) {
+                SendResponse(guard, status, json, keepAlive);
+                // 推理期间同一连接上可能已经到达下一个请求
+                ProcessBuffer(guard);
+            }
+        }, Qt::QueuedConnection);
+    };
+
+    // 解码放到线程池中进行，避免阻塞事件循环
+    QThreadPool::globalInstance()->start([this, body, reply]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        cv::Mat image = cv::imdecode(cv::Mat(1, body.size(), CV_8UC1, const_cast<char*>(body.constData())),
+                                     cv::IMREAD_COLOR);
+        if (image.empty()) {
+            reply(400, ErrorJson("cannot decode image"));
+            return;
+        }
+
+        BatchRequest request;
+        request.image = image;
+        request.done = [this, reply, timer](const DL_RESULT& result, const QString& error) {
+            if (!error.isEmpty()) {
+                reply(500, ErrorJson(error));
+                return;
+            }
+            QJsonObject obj;
+            obj["class_id"] = result.classId;
+            obj["class_name"] = (result.classId >= 0 && result.classId < (int)_class_names.size())
+                                    ? QString::fromStdString(_class_names[result.classId])
+                                    : QString("Invalid ID %1").arg(result.classId);
+            obj["confidence"] = static_cast<double>(result.confidence);
+            obj["latency_ms"] = timer.nsecsElapsed() / 1e6;
+            reply(200, QJsonDocument(obj).toJson(QJsonDocument::Compact));
+        };
+        _batcher->Submit(std::move(request));
+    });
+}
+
+void InferenceServer::SendResponse(QTcpSocket *socket, int status, const QByteArray &body, bool keepAlive)
+{
+    if (status >= 400) {
+        _errors.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    QByteArray response;
+    response += "HTTP/1.1 " + QByteArray::number(status) + " " + StatusText(status) + "\r\n";
+    response += "Content-Type: application/json\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    response += "\r\n";
+    response += body;
+    socket->write(response);
+
+    if (!keepAlive) {
+        _connections.remove(socket);
+        socket->disconnectFromHost();
+        return;
+    }
+
+    // 同一连接上的下一个请求由 ProcessBuffer 的循环处理
+    if (_connections.contains(socket)) {
+        _connections[socket].busy = false;
+    }
+}
+
+QByteArray InferenceServer::StatsJson()
+{
+    const BatcherStats stats = _batcher->Stats();
+    QJsonObject obj;
+    obj["uptime_s"] = _uptime.elapsed() / 1000.0;
+    obj["http_requests"] = static_cast<double>(_http_requests.load());
+    obj["errors"] = static_cast<double>(_errors.load());
+    obj["inferences"] = static_cast<double>(stats.requests);
+    obj["batches"] = static_cast<double>(stats.batches);
+    obj["mean_batch_size"] = stats.meanBatch;
+    obj["queue_depth"] = stats.queueDepth;
+    obj["latency_p50_ms"] = stats.p50Ms;
+    obj["latency_p99_ms"] = stats.p99Ms;
+    obj["max_batch"] = _options.maxBatch;
+    obj["max_delay_ms"] = _options.maxDelayMs;
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,75 @@
+#ifndef INFERENCESERVER_H
+#define INFERENCESERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
+#include "dynamicbatcher.h"
+
+// 服务端参数
+struct ServerOptions
+{
+    QString modelPath;          // 模型文件路径
+    QString labelPath;          // 标签文件路径
+    quint16 port = 8765;        // 监听端口（仅 127.0.0.1）
+    int intraOpNumThreads = 2;  // ORT 线程数
+    int maxBatch = 8;           // 动态批处理最大 batch
+    int maxDelayMs = 5;         // 动态批处理最长排队时间
+};
+
+/**
+ * @brief 本地 HTTP 推理服务
+ * 进程内只加载一份模型，供同一台机器上的其他工具通过 HTTP 调用：
+ *   POST /classify  请求体为图片字节，返回 JSON 分类结果
+ *   GET  /health    存活检查
+ *   GET  /stats     请求数、batch 统计、排队深度与延迟分位数
+ */
+class InferenceServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit InferenceServer(const ServerOptions& options, QObject *parent = nullptr);
+    ~InferenceServer();
+
+    // 加载模型并开始监听，失败时返回错误信息
+    QString Start();
+
+private slots:
+    void SlotNewConnection();
+    void SlotReadyRead();
+    void SlotDisconnected();
+
+private:
+    // 每个连接上尚未处理完的请求数据
+    struct Connection
+    {
+        QByteArray buffer;      // 已接收的原始数据
+        bool busy = false;      // 是否有请求正在推理
+    };
+
+    // 依次处理缓冲区中已完整到达的请求，直到数据不完整、连接关闭或有请求在推理
+    void ProcessBuffer(QTcpSocket* socket);
+    // 解析并处理一个请求，没有完整请求或出错关闭连接时返回 false
+    bool ProcessRequest(QTcpSocket* socket);
+    void HandleClassify(QTcpSocket* socket, const QByteArray& body, bool keepAlive);
+    void SendResponse(QTcpSocket* socket, int status, const QByteArray& body, bool keepAlive);
+    QByteArray StatsJson();
+
+private:
+    ServerOptions _options;
+    QTcpServer _server;
+    YOLO_V8 _yolo;                                  // 唯一的推理会话
+    std::vector<std::string> _class_names;          // 类别标签
+    std::unique_ptr<DynamicBatcher> _batcher;       // 动态批处理线程
+    QHash<QTcpSocket*, Connection> _connections;    // 活动连接
+
+    QElapsedTimer _uptime;
+    std::atomic<quint64> _http_requests{0};         // HTTP 请求总数
+    std::atomic<quint64> _errors{0};                // 失败请求数
+};
+
+#endif // INFERENCESERVER_H
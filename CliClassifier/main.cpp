@@ -0,0 +1,106 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+#include "batchclassifier.h"
+#include "inferenceserver.h"
+
+// 无界面命令行分类工具
+// 用法：cultural-vision-cli --model best.onnx --labels class_names.txt [--format jsonl] <文件或目录>...
+// 服务模式：cultural-vision-cli --serve [--port 8765] [--max-batch 8] [--max-delay-ms 5]
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cultural-vision-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Classify embroidery images without a display.");
+    parser.addHelpOption();
+
+    QCommandLineOption modelOption({"m", "model"}, "ONNX model file.", "path", "best.onnx");
+    QCommandLineOption labelOption({"l", "labels"}, "Class name file, one label per line.", "path", "class_names.txt");
+    QCommandLineOption workerOption({"j", "workers"}, "Number of worker threads.", "n",
+                                    QString::number(qMax(1, QThread::idealThreadCount() / 2)));
+    QCommandLineOption intraOption("intra-threads", "ONNX Runtime intra-op threads per run.", "n", "2");
+    QCommandLineOption batchOption({"b", "batch"}, "Images per session run (needs a dynamic-batch model).", "n", "8");
+    QCommandLineOption formatOption({"f", "format"}, "Output format: csv or jsonl.", "format", "csv");
+    QCommandLineOption outputOption({"o", "output"}, "Write results to file instead of stdout.", "path");
+    QCommandLineOption serveOption("serve", "Run a local HTTP inference server instead of classifying files.");
+    QCommandLineOption portOption({"p", "port"}, "Server port on 127.0.0.1.", "port", "8765");
+    QCommandLineOption maxBatchOption("max-batch", "Server: maximum requests merged into one run.", "n", "8");
+    QCommandLineOption maxDelayOption("max-delay-ms", "Server: maximum queueing delay before a run.", "ms", "5");
+
+    parser.addOptions({modelOption, labelOption, workerOption, intraOption, batchOption, formatOption, outputOption,
+                       serveOption, portOption, maxBatchOption, maxDelayOption});
+    parser.addPositionalArgument("inputs", "Image files or directories.", "<path>...");
+    parser.process(app);
+
+    QTextStream err(stderr);
+
+    // ---- 服务模式 ----
+    if (parser.isSet(serveOption)) {
+        ServerOptions serverOptions;
+        serverOptions.modelPath = parser.value(modelOption);
+        serverOptions.labelPath = parser.value(labelOption);
+        serverOptions.port = static_cast<quint16>(parser.value(portOption).toUInt());
+        serverOptions.intraOpNumThreads = parser.value(intraOption).toInt();
+        serverOptions.maxBatch = parser.value(maxBatchOption).toInt();
+        serverOptions.maxDelayMs = parser.value(maxDelayOption).toInt();
+
+        InferenceServer server(serverOptions);
+        const QString error = server.Start();
+        if (!error.isEmpty()) {
+            err << error << "\n";
+            return 1;
+        }
+        err << "Listening on http://127.0.0.1:" << serverOptions.port
+            << " (POST /classify, GET /health, GET /stats)\n";
+        err.flush();
+        return app.exec();
+    }
+
+    ClassifyOptions options;
+    options.modelPath = parser.value(modelOption);
+    options.labelPath = parser.value(labelOption);
+    options.workers = parser.value(workerOption).toInt();
+    options.intraOpNumThreads = parser.value(intraOption).toInt();
+    options.batchSize = parser.value(batchOption).toInt();
+    options.format = parser.value(formatOption).toLower();
+
+    if (options.format != "csv" && options.format != "jsonl") {
+        err << "Unknown format: " << options.format << "\n";
+        return 2;
+    }
+
+    const QStringList files = BatchClassifier::CollectImages(parser.positionalArguments());
+    if (files.isEmpty()) {
+        err << "No images found.\n";
+        parser.showHelp(2);
+    }
+
+    BatchClassifier classifier(options);
+    const QString error = classifier.Init();
+    if (!error.isEmpty()) {
+        err << error << "\n";
+        return 1;
+    }
+
+    // 结果写入文件或标准输出
+    QFile outFile;
+    if (parser.isSet(outputOption)) {
+        outFile.setFileName(parser.value(outputOption));
+        if (!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            err << "Cannot write file: " << outFile.fileName() << "\n";
+            return 1;
+        }
+    } else {
+        outFile.open(stdout, QIODevice::WriteOnly);
+    }
+    QTextStream out(&outFile);
+
+    const int failed = classifier.Run(files, out);
+    classifier.PrintSummary(err);
+
+    return failed == 0 ? 0 : 3;
+}
@@ -0,0 +1,25 @@
+# 推理子进程：由界面进程（InferenceClient）启动，持有推理会话，帧经共享内存传入
+QT       += core network
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = cultural-vision-worker
+
+SOURCES += \
+    main.cpp \
+    workerservice.cpp
+
+HEADERS += \
+    workerservice.h
+
+INCLUDEPATH += \
+    $$PWD \
+    $$PWD/..
+
+include($$PWD/../RecognizeImg/recognizeimg.pri)
+
+# 与界面程序放在同一目录，InferenceClient 按 applicationDirPath 查找
+unix:!android: target.path = /opt/cultural-vision/bin
+!isEmpty(target.path): INSTALLS += target
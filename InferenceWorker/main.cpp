@@ -0,0 +1,48 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include "workerservice.h"
+
+// 推理子进程，由界面进程启动（CV_INFERENCE_WORKER=1），一般不手动运行
+// 用法：cultural-vision-worker --server <name> --shm <key> --model best.onnx [--threads 4] [--inter-threads 1] [--spin on|off]
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cultural-vision-worker");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Inference worker process for the Cultural-Vision GUI.");
+    parser.addHelpOption();
+
+    QCommandLineOption serverOption("server", "Local socket name of the GUI process.", "name");
+    QCommandLineOption shmOption("shm", "Shared memory key of the frame ring.", "key");
+    QCommandLineOption modelOption({"m", "model"}, "ONNX model file.", "path", "best.onnx");
+    QCommandLineOption threadsOption("threads", "ONNX Runtime intra-op threads.", "n", "4");
+    QCommandLineOption interThreadsOption("inter-threads", "ONNX Runtime inter-op threads (>1 runs the graph in parallel mode).", "n", "1");
+    QCommandLineOption spinOption("spin", "Let ONNX Runtime thread pools spin between tasks.", "on|off", "on");
+
+    parser.addOptions({serverOption, shmOption, modelOption, threadsOption, interThreadsOption, spinOption});
+    parser.process(app);
+
+    QTextStream err(stderr);
+    if (!parser.isSet(serverOption) || !parser.isSet(shmOption)) {
+        err << "--server and --shm are required.\n";
+        return 2;
+    }
+
+    WorkerOptions options;
+    options.serverName = parser.value(serverOption);
+    options.memoryKey = parser.value(shmOption);
+    options.modelPath = parser.value(modelOption);
+    options.intraOpNumThreads = qMax(1, parser.value(threadsOption).toInt());
+    options.interOpNumThreads = qMax(1, parser.value(interThreadsOption).toInt());
+    options.allowSpinning = parser.value(spinOption) != "off";
+
+    WorkerService service(options);
+    const QString error = service.Start();
+    if (!error.isEmpty()) {
+        err << error << "\n";
+        return 1;
+    }
+    return app.exec();
+}
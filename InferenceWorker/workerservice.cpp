@@ -0,0 +1,118 @@
+#include "workerservice.h"
+#include <QCoreApplication>
+#include <algorithm>
+#include <cstring>
+
+using namespace WorkerProtocol;
+
+WorkerService::WorkerService(const WorkerOptions &options, QObject *parent)
+    : QObject(parent), _options(options)
+{
+    connect(&_socket, &QLocalSocket::readyRead, this, &WorkerService::SlotReadyRead);
+    connect(&_socket, &QLocalSocket::disconnected, qApp, &QCoreApplication::quit);
+}
+
+QString WorkerService::Start()
+{
+    // 只读挂载：推理前的预处理会先拷贝出裁剪后的图像，不写共享内存
+    _memory.setKey(_options.memoryKey);
+    if (!_memory.attach(QSharedMemory::ReadOnly)) {
+        return QString("Cannot attach shared memory %1: %2").arg(_options.memoryKey, _memory.errorString());
+    }
+    RingHeader header;
+    if (size_t(_memory.size()) < sizeof(header)) {
+        return "Shared memory too small.";
+    }
+    std::memcpy(&header, _memory.constData(), sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION
+        || size_t(_memory.size()) < RingBytes(header.slotCount, header.slotBytes)) {
+        return "Shared memory layout mismatch.";
+    }
+    _slotCount = header.slotCount;
+    _slotBytes = header.slotBytes;
+
+    DL_INIT_PARAM params;
+    params.modelPath = _options.modelPath.toStdString();
+    params.imgSize = {640, 640};
+    params.modelType = YOLO_CLS;
+    params.cudaEnable = false;
+    params.intraOpNumThreads = _options.intraOpNumThreads;
+    params.interOpNumThreads = _options.interOpNumThreads;
+    params.allowSpinning = _options.allowSpinning;
+    params.logSeverityLevel = 3;
+    const char* ret = _yolo.CreateSession(params);
+    if (ret != RET_OK) {
+        return QString("CreateSession failed: %1").arg(ret);
+    }
+
+    _socket.connectToServer(_options.serverName);
+    if (!_socket.waitForConnected(5000)) {
+        return QString("Cannot connect to %1: %2").arg(_options.serverName, _socket.errorString());
+    }
+    Message hello{};
+    hello.type = Hello;
+    Send(hello);
+    return QString();
+}
+
+void WorkerService::SlotReadyRead()
+{
+    _readBuffer.append(_socket.readAll());
+    int offset = 0;
+    while (_readBuffer.size() - offset >= int(sizeof(Message))) {
+        Message message;
+        std::memcpy(&message, _readBuffer.constData() + offset, sizeof(message));
+        offset += int(sizeof(Message));
+        if (message.type == Frame) {
+            Process(message);
+        }
+    }
+    _readBuffer.remove(0, offset);
+}
+
+void WorkerService::Process(const Message &frame)
+{
+    Message result{};
+    result.type = Result;
+    result.slot = frame.slot;
+    result.seq = frame.seq;
+    result.classId = -1;
+
+    const quint64 bytes = quint64(frame.step) * frame.height;
+    if (frame.slot >= _slotCount || frame.width == 0 || frame.height == 0
+        || frame.step < frame.width * 3 || bytes > _slotBytes) {
+        result.status = BadFrame;
+        Send(result);
+        return;
+    }
+
+    // 直接包装共享内存中的像素
+    uchar* data = const_cast<uchar*>(static_cast<const uchar*>(_memory.constData()))
+                  + SlotOffset(frame.slot, _slotBytes);
+    cv::Mat image(int(frame.height), int(frame.width), CV_8UC3, data, frame.step);
+
+    std::vector<DL_RESULT> results;
+    try {
+        _yolo.RunSession(image, results);
+    } catch (const std::exception&) {
+        results.clear();
+    }
+    if (results.empty()) {
+        result.status = InferenceFailed;
+    } else {
+        const auto top = std::max_element(results.begin(), results.end(),
+                                          [](const DL_RESULT& a, const DL_RESULT& b) {
+                                              return a.confidence < b.confidence;
+                                          });
+        result.status = Ok;
+        result.classId = top->classId;
+        result.confidence = top->confidence;
+    }
+    Send(result);
+}
+
+void WorkerService::Send(const Message &message)
+{
+    _socket.write(reinterpret_cast<const char*>(&message), sizeof(message));
+    _socket.flush();
+}
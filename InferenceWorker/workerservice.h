@@ -0,0 +1,52 @@
+#ifndef WORKERSERVICE_H
+#define WORKERSERVICE_H
+
+#include <QLocalSocket>
+#include <QObject>
+#include <QSharedMemory>
+#include "inference.h"
+#include "workerprotocol.h"
+
+// 子进程启动参数
+struct WorkerOptions
+{
+    QString serverName;         // 界面进程的本地套接字名
+    QString memoryKey;          // 共享内存键
+    QString modelPath;          // 模型文件
+    int intraOpNumThreads = 4;  // ORT intra-op 线程数
+    int interOpNumThreads = 1;  // ORT inter-op 线程数
+    bool allowSpinning = true;  // ORT 线程池自旋
+};
+
+/**
+ * @brief 推理子进程的服务端
+ * 只读挂载界面进程创建的共享内存，创建推理会话后连接本地套接字并发送 Hello；
+ * 每收到一条 Frame 消息，直接在共享内存中的像素上推理（不拷贝），回复 Result。
+ * 与界面进程断开即退出（界面进程负责重启）。
+ */
+class WorkerService : public QObject
+{
+    Q_OBJECT
+public:
+    explicit WorkerService(const WorkerOptions& options, QObject* parent = nullptr);
+
+    // 挂载共享内存、创建会话、连接界面进程；失败返回错误信息
+    QString Start();
+
+private slots:
+    void SlotReadyRead();
+
+private:
+    void Process(const WorkerProtocol::Message& frame);
+    void Send(const WorkerProtocol::Message& message);
+
+    WorkerOptions _options;
+    QSharedMemory _memory;
+    QLocalSocket _socket;
+    YOLO_V8 _yolo;
+    quint32 _slotCount = 0;
+    quint64 _slotBytes = 0;
+    QByteArray _readBuffer;
+};
+
+#endif // WORKERSERVICE_H
@@ -0,0 +1,141 @@
+#include "batchrecognizethread.h"
+#include "recognizeimgthread.h"
+#include "resultcache.h"
+#include "embeddingindex.h"
+#include "const.h"
+#include "inferencescheduler.h"
+#include "threadtuning.h"
+#include <QFile>
+
+BatchRecognizeThread::BatchRecognizeThread(const QStringList &img_paths, const QString &label_path,
+                                           const QString &model_path, QObject *parent)
+    : QThread(parent), _img_paths(img_paths), _label_path(label_path), _model_path(model_path)
+{
+}
+
+void BatchRecognizeThread::SetModelBundle(std::shared_ptr<const ModelBundle> bundle)
+{
+    if (!bundle) {
+        return;
+    }
+    _bundle = std::move(bundle);
+    _label_path = _bundle->labelPath;
+    _model_path = _bundle->modelPath;
+}
+
+void BatchRecognizeThread::Stop()
+{
+    _stop = true;
+}
+
+void BatchRecognizeThread::run()
+{
+    std::vector<std::string> classNames = _bundle ? _bundle->classNames
+                                                  : RecognizeImgThread::readLabels(_label_path.toStdString());
+    if (classNames.empty()) {
+        emit SigBatchFail(QString("Cannot load labels: %1").arg(_label_path));
+        return;
+    }
+
+    ResultCache& cache = ResultCache::Instance();
+    const quint64 modelId = cache.ModelId(_model_path);
+    EmbeddingIndex& index = EmbeddingIndex::ForModel(modelId);
+    // 模型没有特征向量输出时只看结果缓存
+    const bool indexEmbedding = RecognizeImgThread::ModelHasEmbedding(_model_path, modelId);
+
+    // 推理会话在第一次真正需要推理时才创建，全部命中缓存时不必加载模型
+    std::unique_ptr<YOLO_V8> yolo;
+
+    // 以低优先级按小块申请推理槽，单张检测与实时识别可以插队
+    InferenceScheduler& scheduler = InferenceScheduler::Instance();
+    std::unique_ptr<InferenceScheduler::Ticket> ticket;
+    int chunkUsed = 0;
+
+    const int total = _img_paths.size();
+    int succeeded = 0;
+    int failed = 0;
+
+    for (int i = 0; i < total && !_stop; ++i) {
+        const QString& path = _img_paths.at(i);
+
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            failed++;
+            emit SigProgress(i + 1, total);
+            continue;
+        }
+        QByteArray content = file.readAll();
+        file.close();
+
+        const quint64 key = ResultCache::MakeKey(content, modelId);
+        ResultCache::Entry entry;
+
+        // 结果已缓存（且需要特征向量时已在索引中），直接跳过
+        if ((!indexEmbedding || index.Contains(path)) && cache.Lookup(modelId, key, entry)) {
+            succeeded++;
+            emit SigItemFinish(path, RecognizeImgThread::ClassName(classNames, entry.classId), entry.confidence);
+            emit SigProgress(i + 1, total);
+            continue;
+        }
+
+        cv::Mat image = cv::imdecode(cv::Mat(1, content.size(), CV_8UC1, content.data()), cv::IMREAD_COLOR);
+        if (image.empty()) {
+            failed++;
+            emit SigProgress(i + 1, total);
+            continue;
+        }
+
+        // 块用完或有更高优先级请求等待时归还槽，重新排队
+        if (ticket && (chunkUsed >= BATCH_CHUNK_SIZE || scheduler.HasWaitersAbove(InferenceScheduler::Batch))) {
+            ticket.reset();
+        }
+        if (!ticket) {
+            ticket.reset(new InferenceScheduler::Ticket(InferenceScheduler::Batch));
+            chunkUsed = 0;
+        }
+        chunkUsed++;
+
+        if (!yolo) {
+            yolo.reset(new YOLO_V8());
+            DL_INIT_PARAM params;
+            params.modelPath = _model_path.toStdString();
+            params.imgSize = {640, 640};
+            params.modelType = YOLO_CLS;
+            params.cudaEnable = false;
+            ThreadTuning::Instance().Apply(params);   // 本机调优的线程配置
+            params.logSeverityLevel = 3;
+            params.embeddingOutputName = EMBEDDING_OUTPUT_NAME;
+            const char* ret = yolo->CreateSession(params);
+            if (ret != RET_OK) {
+                emit SigBatchFail(QString("CreateSession failed: %1").arg(ret));
+                return;
+            }
+        }
+
+        std::vector<DL_RESULT> results;
+        try {
+            yolo->RunSession(image, results);
+        } catch (const std::exception&) {
+            results.clear();
+        }
+        if (results.empty()) {
+            failed++;
+            emit SigProgress(i + 1, total);
+            continue;
+        }
+
+        const DL_RESULT& top = results.front();
+        cache.Insert(modelId, key, ResultCache::Entry{top.classId, top.confidence});
+        if (!top.embedding.empty()) {
+            index.Add(path, top.embedding);
+        }
+
+        succeeded++;
+        emit SigItemFinish(path, RecognizeImgThread::ClassName(classNames, top.classId), top.confidence);
+        emit SigProgress(i + 1, total);
+    }
+
+    ticket.reset();
+    index.Save();
+    emit SigBatchFinish(succeeded, failed);
+}
@@ -0,0 +1,46 @@
+#ifndef BATCHRECOGNIZETHREAD_H
+#define BATCHRECOGNIZETHREAD_H
+
+#include <QThread>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include "inference.h"
+#include "modelregistry.h"
+
+/**
+ * @brief 批量识别线程
+ * 对一个项目中的全部图片依次分类：只创建一次推理会话，
+ * 结果写入结果缓存，特征向量增量加入相似检索索引，结束时保存索引
+ */
+class BatchRecognizeThread : public QThread
+{
+    Q_OBJECT
+public:
+    explicit BatchRecognizeThread(const QStringList& img_paths, const QString& label_path,
+                                  const QString& model_path, QObject *parent = nullptr);
+
+    // 整批使用同一版本的模型与标签，期间发生热替换不影响本批结果；为空时沿用构造时的路径
+    void SetModelBundle(std::shared_ptr<const ModelBundle> bundle);
+
+    // 请求停止（当前图片处理完后退出）
+    void Stop();
+
+protected:
+    virtual void run();
+
+private:
+    QStringList _img_paths;      // 待识别图片路径
+    QString _label_path;         // 标签文件路径
+    QString _model_path;         // 模型文件路径
+    std::atomic<bool> _stop{false};
+    std::shared_ptr<const ModelBundle> _bundle; // 本批使用的模型版本
+
+signals:
+    void SigItemFinish(const QString& path, const QString& className, float confidence); // 单张识别完成
+    void SigProgress(int done, int total);                   // 进度更新
+    void SigBatchFinish(int succeeded, int failed);          // 全部完成
+    void SigBatchFail(const QString& errorMsg);              // 无法开始（模型/标签加载失败）
+};
+
+#endif // BATCHRECOGNIZETHREAD_H
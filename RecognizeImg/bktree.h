@@ -0,0 +1,73 @@
+#ifndef BKTREE_H
+#define BKTREE_H
+
+#include <QtGlobal>
+#include <algorithm>
+#include <vector>
+#include "simdutil.h"
+
+/**
+ * @brief 以汉明距离为度量的 BK 树
+ * 用于在大量 64 位感知哈希中查找距离不超过阈值的近似重复项，
+ * 查询时利用三角不等式只访问 [d - r, d + r] 范围内的子树
+ */
+class BKTree
+{
+public:
+    // 插入一个哈希及其编号
+    void Insert(quint64 hash, int id)
+    {
+        if (_nodes.empty()) {
+            _nodes.push_back(Node{hash, id, {}});
+            return;
+        }
+        int cur = 0;
+        while (true) {
+            const int d = SimdUtil::HammingDistance(hash, _nodes[cur].hash);
+            int& child = _nodes[cur].children[d];
+            if (child == 0) {
+                child = static_cast<int>(_nodes.size());
+                _nodes.push_back(Node{hash, id, {}});
+                return;
+            }
+            cur = child;
+        }
+    }
+
+    // 查找与 hash 的汉明距离 <= radius 的全部编号
+    void Query(quint64 hash, int radius, std::vector<int>& out) const
+    {
+        if (_nodes.empty()) {
+            return;
+        }
+        std::vector<int> stack{0};
+        while (!stack.empty()) {
+            const Node& node = _nodes[stack.back()];
+            stack.pop_back();
+            const int d = SimdUtil::HammingDistance(hash, node.hash);
+            if (d <= radius) {
+                out.push_back(node.id);
+            }
+            const int lo = std::max(0, d - radius);
+            const int hi = std::min(64, d + radius);
+            for (int k = lo; k <= hi; ++k) {
+                if (node.children[k] != 0) {
+                    stack.push_back(node.children[k]);
+                }
+            }
+        }
+    }
+
+    int Size() const { return static_cast<int>(_nodes.size()); }
+
+private:
+    struct Node
+    {
+        quint64 hash;
+        int id;
+        int children[65];   // 按距离 0..64 索引的子节点（0 表示无，根节点不会成为子节点）
+    };
+    std::vector<Node> _nodes;
+};
+
+#endif // BKTREE_H
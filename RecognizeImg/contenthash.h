@@ -0,0 +1,123 @@
+#ifndef CONTENTHASH_H
+#define CONTENTHASH_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <cstring>
+
+/**
+ * @brief 快速内容哈希（XXH64 算法）
+ * 用于结果缓存等场景，根据文件内容生成稳定的 64 位键值，跨进程、跨版本保持一致
+ */
+namespace ContentHash {
+
+namespace detail {
+constexpr quint64 P1 = 0x9E3779B185EBCA87ULL;
+constexpr quint64 P2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr quint64 P3 = 0x165667B19E3779F9ULL;
+constexpr quint64 P4 = 0x85EBCA77C2B2AE63ULL;
+constexpr quint64 P5 = 0x27D4EB2F165667C5ULL;
+
+inline quint64 Rotl(quint64 x, int r) { return (x << r) | (x >> (64 - r)); }
+inline quint64 Read64(const uchar* p) { quint64 v; std::memcpy(&v, p, 8); return v; }
+inline quint32 Read32(const uchar* p) { quint32 v; std::memcpy(&v, p, 4); return v; }
+inline quint64 Round(quint64 acc, quint64 input)
+{
+    acc += input * P2;
+    acc = Rotl(acc, 31);
+    return acc * P1;
+}
+inline quint64 MergeRound(quint64 acc, quint64 val)
+{
+    acc ^= Round(0, val);
+    return acc * P1 + P4;
+}
+} // namespace detail
+
+// 计算一段内存的 64 位哈希
+inline quint64 Hash64(const void* data, qint64 len, quint64 seed = 0)
+{
+    using namespace detail;
+    const uchar* p = static_cast<const uchar*>(data);
+    const uchar* end = p + len;
+    quint64 h;
+
+    if (len >= 32) {
+        const uchar* limit = end - 32;
+        quint64 v1 = seed + P1 + P2;
+        quint64 v2 = seed + P2;
+        quint64 v3 = seed;
+        quint64 v4 = seed - P1;
+        do {
+            v1 = Round(v1, Read64(p));      p += 8;
+            v2 = Round(v2, Read64(p));      p += 8;
+            v3 = Round(v3, Read64(p));      p += 8;
+            v4 = Round(v4, Read64(p));      p += 8;
+        } while (p <= limit);
+        h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+        h = MergeRound(h, v1);
+        h = MergeRound(h, v2);
+        h = MergeRound(h, v3);
+        h = MergeRound(h, v4);
+    } else {
+        h = seed + P5;
+    }
+
+    h += static_cast<quint64>(len);
+
+    while (p + 8 <= end) {
+        h ^= Round(0, Read64(p));
+        h = Rotl(h, 27) * P1 + P4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<quint64>(Read32(p)) * P1;
+        h = Rotl(h, 23) * P2 + P3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * P5;
+        h = Rotl(h, 11) * P1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+inline quint64 Hash64(const QByteArray& bytes, quint64 seed = 0)
+{
+    return Hash64(bytes.constData(), bytes.size(), seed);
+}
+
+// 合并两个哈希值（用于 内容哈希 + 模型标识 组合键）
+inline quint64 Combine(quint64 a, quint64 b)
+{
+    return a ^ (b + 0x9E3779B97F4A7C15ULL + (a << 6) + (a >> 2));
+}
+
+// 读取整个文件并计算哈希；content 不为空时顺便返回文件内容，避免二次读盘
+inline bool HashFile(const QString& path, quint64& outHash, QByteArray* content = nullptr)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray bytes = file.readAll();
+    file.close();
+    outHash = Hash64(bytes);
+    if (content) {
+        *content = std::move(bytes);
+    }
+    return true;
+}
+
+} // namespace ContentHash
+
+#endif // CONTENTHASH_H
@@ -0,0 +1,519 @@
+#include "embeddingindex.h"
+#include "simdutil.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QWriteLocker>
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace {
+
+const quint32 INDEX_MAGIC = 0x43564549; // "CVEI"
+const quint32 INDEX_VERSION = 1;
+const int INDEX_MAX_MODELS = 4;         // 最多保留几个模型的索引文件（按最近修改时间）
+
+// 每个线程一份的访问标记，避免并行查询之间相互干扰
+struct VisitedList
+{
+    std::vector<quint32> tags;
+    quint32 epoch = 0;
+
+    void Reset(size_t n)
+    {
+        if (tags.size() < n) {
+            tags.resize(n, 0);
+        }
+        if (++epoch == 0) {
+            std::fill(tags.begin(), tags.end(), 0);
+            epoch = 1;
+        }
+    }
+    bool Visit(quint32 id)
+    {
+        if (tags[id] == epoch) {
+            return false;
+        }
+        tags[id] = epoch;
+        return true;
+    }
+};
+
+thread_local VisitedList t_visited;
+
+// 已打开的索引（模型标识 -> 实例），实例不释放，调用方持有的引用一直有效
+QMutex g_indexes_mutex;
+QHash<quint64, EmbeddingIndex*> g_indexes;
+
+QString IndexDir()
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (dir.isEmpty()) {
+        dir = QDir::tempPath();
+    }
+    QDir().mkpath(dir);
+    return dir;
+}
+
+} // namespace
+
+EmbeddingIndex& EmbeddingIndex::ForModel(quint64 modelId)
+{
+    QMutexLocker locker(&g_indexes_mutex);
+    EmbeddingIndex*& index = g_indexes[modelId];
+    if (!index) {
+        index = new EmbeddingIndex(PathFor(modelId), modelId);
+        PruneFiles();
+    }
+    return *index;
+}
+
+void EmbeddingIndex::SaveAll()
+{
+    QMutexLocker locker(&g_indexes_mutex);
+    for (EmbeddingIndex* index : qAsConst(g_indexes)) {
+        index->Save();
+    }
+}
+
+QString EmbeddingIndex::PathFor(quint64 modelId)
+{
+    return QString("%1/embeddings_%2.hnsw").arg(IndexDir()).arg(modelId, 16, 16, QChar('0'));
+}
+
+void EmbeddingIndex::PruneFiles()
+{
+    // 调用方持有 g_indexes_mutex；已打开的索引总是保留
+    const QFileInfoList files = QDir(IndexDir()).entryInfoList({"embeddings_*.hnsw"}, QDir::Files, QDir::Time);
+    int kept = 0;
+    for (const QFileInfo& info : files) {
+        bool open = false;
+        for (const EmbeddingIndex* index : qAsConst(g_indexes)) {
+            open = open || index->_file_path == info.filePath();
+        }
+        if (open || kept < INDEX_MAX_MODELS) {
+            kept++;
+            continue;
+        }
+        QFile::remove(info.filePath());
+    }
+}
+
+EmbeddingIndex::EmbeddingIndex(const QString &filePath, quint64 modelId)
+    : _file_path(filePath), _model_id(modelId)
+{
+    _level_mult = 1.0 / std::log(double(_m));
+    if (!Load()) {
+        // 文件不存在或已损坏：从空索引开始
+        Reset(0);
+    }
+}
+
+EmbeddingIndex::~EmbeddingIndex()
+{
+}
+
+void EmbeddingIndex::Reset(int dim)
+{
+    _dim = dim;
+    _vectors.clear();
+    _links.clear();
+    _paths.clear();
+    _ids.clear();
+    _entry = -1;
+    _max_level = -1;
+    _dirty = false;
+}
+
+bool EmbeddingIndex::Load()
+{
+    QFile file(_file_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic, version, count;
+    quint64 model_id;
+    qint32 dim, m, max_level;
+    qint64 entry;
+    in >> magic >> version >> model_id >> dim >> m >> count >> entry >> max_level;
+    if (in.status() != QDataStream::Ok || magic != INDEX_MAGIC || version != INDEX_VERSION
+        || model_id != _model_id || dim <= 0 || m != _m) {
+        return false;
+    }
+
+    // 文件被截断或损坏时，先按文件大小检查向量总量，避免按错误的数量分配内存
+    const quint64 file_size = quint64(file.size());
+    if (quint64(dim) > file_size / sizeof(float) || quint64(count) > file_size / (quint64(dim) * sizeof(float))) {
+        return false;
+    }
+    const bool entry_valid = count == 0 ? (entry == -1 && max_level == -1) : (entry >= 0 && entry < qint64(count));
+    if (!entry_valid) {
+        return false;
+    }
+
+    _dim = dim;
+    _vectors.resize(size_t(count) * dim);
+    _links.resize(count);
+    _paths.resize(count);
+    for (quint32 id = 0; id < count; ++id) {
+        qint32 levels;
+        in >> _paths[id] >> levels;
+        if (in.status() != QDataStream::Ok || levels <= 0 || levels > 64) {
+            return false;
+        }
+        _links[id].resize(levels);
+        for (int level = 0; level < levels; ++level) {
+            quint32 n;
+            in >> n;
+            if (in.status() != QDataStream::Ok || n > quint32(level == 0 ? _m0 : _m)) {
+                return false;
+            }
+            std::vector<quint32>& neighbors = _links[id][level];
+            neighbors.resize(n);
+            for (quint32& nb : neighbors) {
+                in >> nb;
+                if (nb >= count) {
+                    return false;
+                }
+            }
+        }
+        in.readRawData(reinterpret_cast<char*>(_vectors.data() + size_t(id) * dim), dim * sizeof(float));
+        _ids.insert(_paths[id], id);
+    }
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+    // 最高层必须是入口节点所在的层，第 l 层的邻居自身也必须有第 l 层，否则搜索会访问不存在的层
+    if (count > 0 && max_level != qint32(_links[entry].size()) - 1) {
+        return false;
+    }
+    for (const auto& node_links : _links) {
+        for (size_t level = 0; level < node_links.size(); ++level) {
+            for (quint32 nb : node_links[level]) {
+                if (_links[nb].size() <= level) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    _entry = entry;
+    _max_level = max_level;
+    _dirty = false;
+    return true;
+}
+
+bool EmbeddingIndex::Save()
+{
+    QWriteLocker locker(&_lock);
+    if (!_dirty || _file_path.isEmpty()) {
+        return true;
+    }
+
+    QSaveFile file(_file_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "[EmbeddingIndex] Cannot write:" << _file_path;
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+
+    out << INDEX_MAGIC << INDEX_VERSION << _model_id << qint32(_dim) << qint32(_m)
+        << quint32(_paths.size()) << qint64(_entry) << qint32(_max_level);
+    for (size_t id = 0; id < _paths.size(); ++id) {
+        out << _paths[id] << qint32(_links[id].size());
+        for (const auto& neighbors : _links[id]) {
+            out << quint32(neighbors.size());
+            for (quint32 nb : neighbors) {
+                out << nb;
+            }
+        }
+        out.writeRawData(reinterpret_cast<const char*>(Vector(quint32(id))), _dim * sizeof(float));
+    }
+
+    if (!file.commit()) {
+        return false;
+    }
+    _dirty = false;
+    return true;
+}
+
+float EmbeddingIndex::Distance(const float *a, const float *b) const
+{
+    // 向量已归一化：距离 = 1 - 余弦相似度
+    return 1.0f - SimdUtil::DotProduct(a, b, size_t(_dim));
+}
+
+int EmbeddingIndex::RandomLevel()
+{
+    std::uniform_real_distribution<double> dist(std::nextafter(0.0, 1.0), 1.0);
+    return static_cast<int>(-std::log(dist(_rng)) * _level_mult);
+}
+
+void EmbeddingIndex::Add(const QString &path, const std::vector<float> &embedding)
+{
+    if (embedding.empty()) {
+        return;
+    }
+
+    // L2 归一化，使内积等于余弦相似度
+    std::vector<float> normalized = embedding;
+    const float norm = std::sqrt(SimdUtil::DotProduct(normalized.data(), normalized.data(), normalized.size()));
+    if (norm > 0.0f) {
+        for (float& v : normalized) {
+            v /= norm;
+        }
+    }
+
+    QWriteLocker locker(&_lock);
+    if (_dim == 0) {
+        _dim = static_cast<int>(normalized.size());
+    }
+    if (static_cast<int>(normalized.size()) != _dim) {
+        qWarning() << "[EmbeddingIndex] Dimension mismatch:" << normalized.size() << "vs" << _dim;
+        return;
+    }
+
+    auto it = _ids.find(path);
+    if (it != _ids.end()) {
+        // 同一路径再次识别：只更新向量，保留已有连接
+        std::copy(normalized.begin(), normalized.end(), _vectors.begin() + size_t(it.value()) * _dim);
+        _dirty = true;
+        return;
+    }
+
+    const quint32 id = static_cast<quint32>(_paths.size());
+    _paths.push_back(path);
+    _ids.insert(path, id);
+    _vectors.insert(_vectors.end(), normalized.begin(), normalized.end());
+    _links.emplace_back(RandomLevel() + 1);
+    Insert(id);
+    _dirty = true;
+}
+
+void EmbeddingIndex::Insert(quint32 id)
+{
+    const int level = static_cast<int>(_links[id].size()) - 1;
+    const float* query = Vector(id);
+
+    if (_entry < 0) {
+        _entry = id;
+        _max_level = level;
+        return;
+    }
+
+    // 高层贪心下降到新节点所在层
+    quint32 cur = static_cast<quint32>(_entry);
+    float cur_dist = Distance(query, Vector(cur));
+    for (int lc = _max_level; lc > level; --lc) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (quint32 nb : _links[cur][lc]) {
+                const float d = Distance(query, Vector(nb));
+                if (d < cur_dist) {
+                    cur_dist = d;
+                    cur = nb;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // 逐层建立双向连接
+    for (int lc = std::min(level, _max_level); lc >= 0; --lc) {
+        std::vector<DistId> candidates = SearchLayer(query, cur, _ef_construction, lc);
+        const int max_links = lc == 0 ? _m0 : _m;
+        std::vector<quint32> neighbors = SelectNeighbors(candidates, _m);
+        _links[id][lc] = neighbors;
+
+        for (quint32 nb : neighbors) {
+            std::vector<quint32>& nb_links = _links[nb][lc];
+            nb_links.push_back(id);
+            if (static_cast<int>(nb_links.size()) > max_links) {
+                // 邻居连接数超限时重新挑选
+                std::vector<DistId> nb_candidates;
+                nb_candidates.reserve(nb_links.size());
+                for (quint32 x : nb_links) {
+                    nb_candidates.emplace_back(Distance(Vector(nb), Vector(x)), x);
+                }
+                std::sort(nb_candidates.begin(), nb_candidates.end());
+                nb_links = SelectNeighbors(nb_candidates, max_links);
+            }
+        }
+        cur = candidates.front().second;
+    }
+
+    if (level > _max_level) {
+        _max_level = level;
+        _entry = id;
+    }
+}
+
+std::vector<EmbeddingIndex::DistId> EmbeddingIndex::SearchLayer(const float *query, quint32 entry,
+                                                                int ef, int level) const
+{
+    VisitedList& visited = t_visited;
+    visited.Reset(_paths.size());
+
+    // candidates：待扩展的小顶堆；results：当前最优的大顶堆
+    std::priority_queue<DistId, std::vector<DistId>, std::greater<DistId>> candidates;
+    std::priority_queue<DistId> results;
+
+    const float d0 = Distance(query, Vector(entry));
+    candidates.emplace(d0, entry);
+    results.emplace(d0, entry);
+    visited.Visit(entry);
+
+    while (!candidates.empty()) {
+        const DistId current = candidates.top();
+        if (current.first > results.top().first && static_cast<int>(results.size()) >= ef) {
+            break;
+        }
+        candidates.pop();
+
+        for (quint32 nb : _links[current.second][level]) {
+            if (!visited.Visit(nb)) {
+                continue;
+            }
+            const float d = Distance(query, Vector(nb));
+            if (static_cast<int>(results.size()) < ef || d < results.top().first) {
+                candidates.emplace(d, nb);
+                results.emplace(d, nb);
+                if (static_cast<int>(results.size()) > ef) {
+                    results.pop();
+                }
+            }
+        }
+    }
+
+    std::vector<DistId> sorted;
+    sorted.reserve(results.size());
+    while (!results.empty()) {
+        sorted.push_back(results.top());
+        results.pop();
+    }
+    std::reverse(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+std::vector<quint32> EmbeddingIndex::SelectNeighbors(const std::vector<DistId> &candidates, int m) const
+{
+    std::vector<quint32> selected;
+    selected.reserve(m);
+
+    // 候选按距离升序：若某候选离已选邻居比离基准节点更近，则跳过，保证连接覆盖不同方向
+    for (const DistId& candidate : candidates) {
+        if (static_cast<int>(selected.size()) >= m) {
+            break;
+        }
+        bool good = true;
+        for (quint32 s : selected) {
+            if (Distance(Vector(candidate.second), Vector(s)) < candidate.first) {
+                good = false;
+                break;
+            }
+        }
+        if (good) {
+            selected.push_back(candidate.second);
+        }
+    }
+
+    // 启发式过滤后不足 m 个时，用最近的候选补齐
+    for (const DistId& candidate : candidates) {
+        if (static_cast<int>(selected.size()) >= m) {
+            break;
+        }
+        if (std::find(selected.begin(), selected.end(), candidate.second) == selected.end()) {
+            selected.push_back(candidate.second);
+        }
+    }
+    return selected;
+}
+
+QVector<EmbeddingIndex::Hit> EmbeddingIndex::SearchLocked(const float *query, int k, int ef, qint64 exclude) const
+{
+    QVector<Hit> hits;
+    if (_entry < 0 || k <= 0) {
+        return hits;
+    }
+
+    quint32 cur = static_cast<quint32>(_entry);
+    float cur_dist = Distance(query, Vector(cur));
+    for (int lc = _max_level; lc > 0; --lc) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (quint32 nb : _links[cur][lc]) {
+                const float d = Distance(query, Vector(nb));
+                if (d < cur_dist) {
+                    cur_dist = d;
+                    cur = nb;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    const std::vector<DistId> found = SearchLayer(query, cur, std::max(ef, k + 1), 0);
+    for (const DistId& item : found) {
+        if (static_cast<qint64>(item.second) == exclude) {
+            continue;
+        }
+        hits.push_back(Hit{_paths[item.second], 1.0f - item.first});
+        if (hits.size() >= k) {
+            break;
+        }
+    }
+    return hits;
+}
+
+QVector<EmbeddingIndex::Hit> EmbeddingIndex::Search(const std::vector<float> &query, int k, int ef) const
+{
+    std::vector<float> normalized = query;
+    const float norm = std::sqrt(SimdUtil::DotProduct(normalized.data(), normalized.data(), normalized.size()));
+    if (norm > 0.0f) {
+        for (float& v : normalized) {
+            v /= norm;
+        }
+    }
+
+    QReadLocker locker(&_lock);
+    if (static_cast<int>(normalized.size()) != _dim) {
+        return QVector<Hit>();
+    }
+    return SearchLocked(normalized.data(), k, ef, -1);
+}
+
+QVector<EmbeddingIndex::Hit> EmbeddingIndex::SearchByPath(const QString &path, int k, int ef) const
+{
+    QReadLocker locker(&_lock);
+    auto it = _ids.find(path);
+    if (it == _ids.end()) {
+        return QVector<Hit>();
+    }
+    return SearchLocked(Vector(it.value()), k, ef, it.value());
+}
+
+bool EmbeddingIndex::Contains(const QString &path) const
+{
+    QReadLocker locker(&_lock);
+    return _ids.contains(path);
+}
+
+int EmbeddingIndex::Size() const
+{
+    QReadLocker locker(&_lock);
+    return static_cast<int>(_paths.size());
+}
@@ -0,0 +1,106 @@
+#ifndef EMBEDDINGINDEX_H
+#define EMBEDDINGINDEX_H
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+#include <random>
+#include <vector>
+
+/**
+ * @brief 图片特征向量的近似最近邻索引（HNSW）
+ * 保存模型倒数第二层输出的特征向量（已 L2 归一化），用内积衡量相似度，
+ * 支持增量插入、按路径或向量查询 Top-K 相似图片，并持久化到磁盘。
+ * 特征向量只在同一模型下可比：每个模型标识一个实例、一个文件，
+ * 模型热替换期间新旧模型同时使用时互不影响；只保留最近使用的若干个模型的文件。
+ * 查询之间可以并行，插入时独占。
+ */
+class EmbeddingIndex
+{
+public:
+    // 查询结果
+    struct Hit
+    {
+        QString path;        // 图片路径
+        float similarity;    // 余弦相似度 [-1, 1]
+    };
+
+    /**
+     * @brief 取得某个模型的索引（线程安全），第一次访问时读取该模型的索引文件
+     * 实例一直保留到进程结束，返回的引用可以长期持有
+     * @param modelId 模型内容哈希（ResultCache::ModelId）
+     */
+    static EmbeddingIndex& ForModel(quint64 modelId);
+
+    // 保存全部已打开索引的修改（退出前调用）
+    static void SaveAll();
+
+    // 模型的索引文件位置（应用数据目录下）
+    static QString PathFor(quint64 modelId);
+
+    // 有未保存的修改时写回磁盘
+    bool Save();
+
+    /**
+     * @brief 插入一张图片的特征向量，已存在的路径直接覆盖向量
+     * @param path 图片路径
+     * @param embedding 特征向量（内部会做 L2 归一化）
+     */
+    void Add(const QString& path, const std::vector<float>& embedding);
+
+    bool Contains(const QString& path) const;
+    int Size() const;
+
+    // 按向量查询最相似的 k 张图片
+    QVector<Hit> Search(const std::vector<float>& query, int k, int ef = 64) const;
+
+    // 按已索引图片查询相似图片（结果中不包含自身）
+    QVector<Hit> SearchByPath(const QString& path, int k, int ef = 64) const;
+
+private:
+    EmbeddingIndex(const QString& filePath, quint64 modelId);
+    ~EmbeddingIndex();
+    EmbeddingIndex(const EmbeddingIndex&) = delete;
+    EmbeddingIndex& operator=(const EmbeddingIndex&) = delete;
+
+    typedef std::pair<float, quint32> DistId;  // (距离, 节点编号)
+
+    void Reset(int dim);
+    bool Load();
+    static void PruneFiles();   // 删除较久未用的其他模型的索引文件
+    const float* Vector(quint32 id) const { return _vectors.data() + size_t(id) * _dim; }
+    float Distance(const float* a, const float* b) const;
+    int RandomLevel();
+
+    // 在第 level 层从 entry 出发做 ef 宽度的最佳优先搜索，返回按距离升序的候选
+    std::vector<DistId> SearchLayer(const float* query, quint32 entry, int ef, int level) const;
+    // 启发式选择邻居，保持连接的多样性
+    std::vector<quint32> SelectNeighbors(const std::vector<DistId>& candidates, int m) const;
+    void Insert(quint32 id);
+    QVector<Hit> SearchLocked(const float* query, int k, int ef, qint64 exclude) const;
+
+private:
+    mutable QReadWriteLock _lock;
+
+    QString _file_path;                 // 索引文件路径
+    quint64 _model_id = 0;              // 模型标识
+    bool _dirty = false;                // 是否有未保存的修改
+
+    int _dim = 0;                       // 向量维度（第一次插入时确定）
+    int _m = 16;                        // 上层每个节点的最大连接数
+    int _m0 = 32;                       // 第 0 层的最大连接数
+    int _ef_construction = 200;         // 构建时的搜索宽度
+    double _level_mult = 0.0;           // 层数分布参数 1/ln(M)
+
+    std::vector<float> _vectors;                        // 所有向量连续存放
+    std::vector<std::vector<std::vector<quint32>>> _links; // [节点][层] -> 邻居
+    std::vector<QString> _paths;                        // 节点对应的图片路径
+    QHash<QString, quint32> _ids;                       // 路径 -> 节点编号
+    qint64 _entry = -1;                                 // 入口节点
+    int _max_level = -1;                                // 当前最高层
+
+    std::mt19937 _rng{20240501u};
+};
+
+#endif // EMBEDDINGINDEX_H
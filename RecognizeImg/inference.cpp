@@ -1,16 +1,166 @@
 #include "inference.h"
+#include "tracer.h"
+#include "metrics.h"
+#include "memorystats.h"
 #include <regex>
+#include <cstring>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
 
 // 定义通用最小值宏
 #define min(a,b) (((a) < (b)) ? (a) : (b))
 
+// 自 start 起经过的毫秒数（分阶段计时）
+static double ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 累计单次推理在调用线程上的堆分配
+static void RecordAllocations(const MemoryStats::Counts& counts)
+{
+    static Metrics& metrics = Metrics::Instance();
+    static Counter& allocations = metrics.GetCounter("cv_inference_allocations_total", "Heap allocations made by RunSession on the calling thread.");
+    static Counter& bytes = metrics.GetCounter("cv_inference_allocated_bytes_total", "Heap bytes allocated by RunSession on the calling thread.");
+    allocations.Inc(counts.allocations);
+    bytes.Inc(counts.bytes);
+}
+
+namespace {
+
+// 调用线程上最近一次推理的统计：同一个 YOLO_V8 可能被多个线程同时使用，不能保存在实例上
+thread_local DL_STAGE_TIME t_stageTime;
+thread_local MemoryStats::Counts t_allocations;
+
+/**
+ * 进程内共享的 ONNX Runtime 资源
+ * prepacked：GEMM/Conv 重排后的权重，按模型路径每个模型一份，同一模型的所有共享会话（含不同线程配置）共用；
+ *            由使用它的会话持有，该模型最后一个会话关闭时释放（热替换退役的模型不再常驻）；
+ * sessions：配置完全相同的会话直接复用同一个 Ort::Session（Run 线程安全），初始化器只有一份；
+ * 另外在 env 上注册一个共享的 CPU arena，共享会话不再各自持有 arena。
+ */
+struct SharedOrt
+{
+    Ort::Env env{ORT_LOGGING_LEVEL_WARNING, "Yolo"};
+    bool envAllocator = false;
+    std::mutex mutex;
+    std::map<std::string, std::weak_ptr<Ort::PrepackedWeightsContainer>> prepacked;
+    std::map<std::string, std::weak_ptr<Ort::Session>> sessions;
+
+    SharedOrt()
+    {
+        try {
+            Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            Ort::ArenaCfg arenaCfg(0, -1, -1, -1);
+            env.CreateAndRegisterAllocator(memoryInfo, arenaCfg);
+            envAllocator = true;
+        } catch (const std::exception& e) {
+            std::cout << "[YOLO_V8]: shared arena unavailable: " << e.what() << std::endl;
+        }
+    }
+};
+
+SharedOrt& Shared()
+{
+    static SharedOrt shared;
+    return shared;
+}
+
+// 取得模型的重排权重容器，没有会话在用时新建
+std::shared_ptr<Ort::PrepackedWeightsContainer> Prepacked(const std::string& modelPath)
+{
+    SharedOrt& shared = Shared();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    for (auto it = shared.prepacked.begin(); it != shared.prepacked.end();) {
+        if (it->second.expired()) {
+            it = shared.prepacked.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    std::shared_ptr<Ort::PrepackedWeightsContainer> container = shared.prepacked[modelPath].lock();
+    if (!container) {
+        container = std::make_shared<Ort::PrepackedWeightsContainer>();
+        shared.prepacked[modelPath] = container;
+    }
+    return container;
+}
+
+// 会话连同它使用的重排权重：成员按声明逆序析构，会话先于权重释放
+struct PrepackedSession
+{
+    std::shared_ptr<Ort::PrepackedWeightsContainer> prepacked;
+    Ort::Session session;
+
+    PrepackedSession(std::shared_ptr<Ort::PrepackedWeightsContainer> weights, Ort::Env& env,
+                     const ORTCHAR_T* modelPath, const Ort::SessionOptions& options)
+        : prepacked(std::move(weights)), session(env, modelPath, options, *prepacked)
+    {
+    }
+};
+
+// 决定会话内容的参数
+std::string SessionKey(const DL_INIT_PARAM& params)
+{
+    return params.modelPath + "|intra=" + std::to_string(params.intraOpNumThreads)
+           + "|inter=" + std::to_string(params.interOpNumThreads) + "|spin=" + std::to_string(params.allowSpinning)
+           + "|cuda=" + std::to_string(params.cudaEnable) + "|log=" + std::to_string(params.logSeverityLevel);
+}
+
+} // namespace
+
+const DL_STAGE_TIME& YOLO_V8::LastStageTime() const
+{
+    return t_stageTime;
+}
+
+const MemoryStats::Counts& YOLO_V8::LastAllocations() const
+{
+    return t_allocations;
+}
+
+int YOLO_V8::SharedSessionCount()
+{
+    SharedOrt& shared = Shared();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    int count = 0;
+    for (auto it = shared.sessions.begin(); it != shared.sessions.end();) {
+        if (it->second.expired()) {
+            it = shared.sessions.erase(it);
+        } else {
+            ++count;
+            ++it;
+        }
+    }
+    return count;
+}
+
 YOLO_V8::YOLO_V8() {
     // 空实现，可在此添加默认成员初始化
     cudaEnable = false;
 }
 
 YOLO_V8::~YOLO_V8() {
-    delete session; // 手动释放 ONNX Runtime Session 对象
+    // session 为共享指针，最后一个使用者释放时销毁 Ort::Session
+    EndProfiling();
+}
+
+std::string YOLO_V8::EndProfiling()
+{
+    // 只有一个线程能把 profiling 从 true 改为 false
+    if (session && profiling.exchange(false))
+    {
+        try {
+            Ort::AllocatorWithDefaultOptions allocator;
+            profileFile = session->EndProfilingAllocated(allocator).get();
+            std::cout << "[YOLO_V8]: profile written to " << profileFile << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << "[YOLO_V8]: EndProfiling failed: " << e.what() << std::endl;
+        }
+    }
+    return profileFile;
 }
 
 // -------------------- 图像转Tensor（模板函数） --------------------
@@ -38,6 +188,9 @@ char* BlobFromImage(cv::Mat& iImg, T& iBlob) {
     return RET_OK; // 返回成功状态（nullptr）
 }
 
+// 显式实例化，性能测试等模块可以单独调用
+template char* BlobFromImage<float*>(cv::Mat& iImg, float*& iBlob);
+
 char* YOLO_V8::PreProcess(cv::Mat& iImg, std::vector<int> iImgSize, cv::Mat& oImg)
 {
     if (iImg.channels() == 3)
@@ -53,6 +206,7 @@ char* YOLO_V8::PreProcess(cv::Mat& iImg, std::vector<int> iImgSize, cv::Mat& oIm
     switch (modelType)
     {
         case YOLO_CLS:
+        case YOLO_CLS_U8:
         {
             // 使用 CenterCrop 策略（居中裁剪）
             // 在分类模型中，输入尺寸通常固定为方形，因此直接裁剪中心区域即可
@@ -92,7 +246,37 @@ const char* YOLO_V8::CreateSession(DL_INIT_PARAM& iParams) {
         imgSize = iParams.imgSize;
         modelType = iParams.modelType;
 
-        env = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "Yolo");
+        // 重复调用时先释放旧会话（须在替换 env 之前）
+        EndProfiling();
+        session.reset();
+        profileFile.clear();
+
+        // 性能分析绑定在会话上，分析用的会话不与其他实例共享
+        const bool profile = !iParams.profilePrefix.empty();
+        if (profile && iParams.shareMode == SHARE_SESSION)
+        {
+            iParams.shareMode = SHARE_WEIGHTS;
+        }
+
+        // 配置相同的共享会话已存在时直接复用
+        const std::string sessionKey = SessionKey(iParams);
+        bool reused = false;
+        if (iParams.shareMode == SHARE_SESSION)
+        {
+            SharedOrt& shared = Shared();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            auto it = shared.sessions.find(sessionKey);
+            if (it != shared.sessions.end())
+            {
+                session = it->second.lock();
+                reused = session != nullptr;
+            }
+        }
+
+        if (iParams.shareMode == SHARE_NONE)
+        {
+            env = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "Yolo");
+        }
 
         Ort::SessionOptions sessionOption;
 
@@ -112,9 +296,37 @@ const char* YOLO_V8::CreateSession(DL_INIT_PARAM& iParams) {
         // 设置并行线程数（CPU模式下生效）
         sessionOption.SetIntraOpNumThreads(iParams.intraOpNumThreads);
 
+        // 算子间并行：只有并行执行模式下 inter-op 线程池才会被使用
+        if (iParams.interOpNumThreads > 1)
+        {
+            sessionOption.SetExecutionMode(ExecutionMode::ORT_PARALLEL);
+            sessionOption.SetInterOpNumThreads(iParams.interOpNumThreads);
+        }
+
+        // 线程池自旋：关闭后空闲线程立即休眠，稀疏的实时帧之间不再空转
+        const char* spinning = iParams.allowSpinning ? "1" : "0";
+        sessionOption.AddConfigEntry("session.intra_op.allow_spinning", spinning);
+        sessionOption.AddConfigEntry("session.inter_op.allow_spinning", spinning);
+
         // 设置日志严重级别（0=verbose, 1=info, 2=warning, 3=error, 4=fatal）
         sessionOption.SetLogSeverityLevel(iParams.logSeverityLevel);
 
+        // 性能分析：记录每个节点的耗时（含预热的一次 Run）
+        if (profile)
+        {
+#ifdef _WIN32
+            // 与模型路径相同，UTF-8 转为 UTF-16
+            const int prefixSize = MultiByteToWideChar(CP_UTF8, 0, iParams.profilePrefix.c_str(),
+                                                       static_cast<int>(iParams.profilePrefix.length()), nullptr, 0);
+            std::wstring profilePrefix(prefixSize, L'\0');
+            MultiByteToWideChar(CP_UTF8, 0, iParams.profilePrefix.c_str(),
+                                static_cast<int>(iParams.profilePrefix.length()), &profilePrefix[0], prefixSize);
+            sessionOption.EnableProfiling(profilePrefix.c_str());
+#else
+            sessionOption.EnableProfiling(iParams.profilePrefix.c_str());
+#endif // _WIN32
+        }
+
 #ifdef _WIN32
         // Windows下ONNX要求使用宽字符路径，因此进行UTF-8 → UTF-16转换
         int ModelPathSize = MultiByteToWideChar(
@@ -133,45 +345,135 @@ const char* YOLO_V8::CreateSession(DL_INIT_PARAM& iParams) {
             );
         wide_cstr[ModelPathSize] = L'\0';
         const wchar_t* modelPath = wide_cstr;
-
+#else
+        const char* modelPath = iParams.modelPath.c_str();
 #endif // _WIN32
 
         // 实际加载ONNX模型，若路径或依赖错误将抛出异常
-        session = new Ort::Session(env, modelPath, sessionOption);
+        if (reused)
+        {
+            // 复用已有会话，无需加载
+        }
+        else if (iParams.shareMode == SHARE_NONE)
+        {
+            session = std::make_shared<Ort::Session>(env, modelPath, sessionOption);
+        }
+        else
+        {
+            SharedOrt& shared = Shared();
+            if (shared.envAllocator)
+            {
+                sessionOption.AddConfigEntry("session.use_env_allocators", "1");
+            }
+            // 别名构造：对外只暴露 Ort::Session，引用计数归整个 PrepackedSession
+            auto holder = std::make_shared<PrepackedSession>(Prepacked(iParams.modelPath), shared.env, modelPath, sessionOption);
+            session = std::shared_ptr<Ort::Session>(holder, &holder->session);
+            if (iParams.shareMode == SHARE_SESSION)
+            {
+                // 两个线程同时创建时以先登记的为准，后创建的会话随本对象释放
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                std::shared_ptr<Ort::Session> existing = shared.sessions[sessionKey].lock();
+                if (existing)
+                {
+                    session = existing;
+                    reused = true;
+                }
+                else
+                {
+                    shared.sessions[sessionKey] = session;
+                }
+            }
+        }
+#ifdef _WIN32
+        delete[] wide_cstr;
+#endif // _WIN32
+
+        // 输入第 0 维为 -1 时表示模型支持动态 batch，可一次推理多张图片
+        auto inputInfo = session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo();
+        std::vector<int64_t> inputShape = inputInfo.GetShape();
+        dynamicBatch = !inputShape.empty() && inputShape[0] < 0;
+
+        // 输入类型决定喂给模型的格式：uint8 输入直接使用预处理后的 RGB 图像
+        const bool uint8Input = inputInfo.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+        if (modelType == YOLO_CLS_U8 && !uint8Input)
+        {
+            session.reset();
+            return "[YOLO_V8]:Model input is not uint8. Prepare it with tools/fuse_uint8_input.py.";
+        }
+        if (modelType == YOLO_CLS && uint8Input)
+        {
+            modelType = YOLO_CLS_U8;
+        }
 
         Ort::AllocatorWithDefaultOptions allocator; // 创建分配器
 
-        // 获取输入节点数量
+        // 节点名称复制到 std::string 中保存，随对象释放；指针数组在名称全部读取后再生成
+        inputNodeNameStore.clear();
+        outputNodeNameStore.clear();
         size_t inputNodesNum = session->GetInputCount();
-        // 遍历输入节点
         for (size_t i = 0; i < inputNodesNum; i++)
         {
-            // 获取输入节点名称
-            Ort::AllocatedStringPtr input_node_name = session->GetInputNameAllocated(i, allocator);
-
-            // 分配内存并复制名称
-            char* temp_buf = new char[50];
-            strcpy_s(temp_buf, sizeof(temp_buf), input_node_name.get());
-            inputNodeNames.push_back(temp_buf);
+            inputNodeNameStore.emplace_back(session->GetInputNameAllocated(i, allocator).get());
         }
-
-        // 获取输出节点数量
         size_t OutputNodesNum = session->GetOutputCount();
         for (size_t i = 0; i < OutputNodesNum; i++)
         {
-            // 获取输出节点名称
-            Ort::AllocatedStringPtr output_node_name = session->GetOutputNameAllocated(i, allocator);
+            outputNodeNameStore.emplace_back(session->GetOutputNameAllocated(i, allocator).get());
+        }
+        inputNodeNames.clear();
+        for (const std::string& name : inputNodeNameStore)
+        {
+            inputNodeNames.push_back(name.c_str());
+        }
+        outputNodeNames.clear();
+        for (const std::string& name : outputNodeNameStore)
+        {
+            outputNodeNames.push_back(name.c_str());
+        }
 
-            // 分配内存并复制名称
-            char* temp_buf = new char[10];
-            strcpy_s(temp_buf, sizeof(temp_buf), output_node_name.get());
-            outputNodeNames.push_back(temp_buf);
+        // 确定实际取回的输出：分类输出在前，可选的特征向量输出在后
+        int embeddingIndex = -1;
+        if (!iParams.embeddingOutputName.empty())
+        {
+            for (size_t i = 0; i < outputNodeNames.size(); i++)
+            {
+                if (iParams.embeddingOutputName == outputNodeNames[i])
+                {
+                    embeddingIndex = static_cast<int>(i);
+                }
+            }
+            if (embeddingIndex < 0)
+            {
+                std::cout << "[YOLO_V8]: Model has no output named " << iParams.embeddingOutputName
+                          << ", embedding extraction disabled." << std::endl;
+            }
+        }
+        runOutputNames.clear();
+        for (size_t i = 0; i < outputNodeNames.size(); i++)
+        {
+            if (static_cast<int>(i) != embeddingIndex)
+            {
+                runOutputNames.push_back(outputNodeNames[i]);
+                std::vector<int64_t> outputShape = session->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape();
+                classCount = outputShape.empty() ? -1 : static_cast<int>(outputShape.back());
+                break;
+            }
+        }
+        embeddingEnable = embeddingIndex >= 0;
+        if (embeddingEnable)
+        {
+            runOutputNames.push_back(outputNodeNames[embeddingIndex]);
         }
 
         options = Ort::RunOptions{ nullptr };
 
-        // 用于初始化显存、kernel、权重，减少第一次推理的延迟
-        WarmUpSession();
+        // 用于初始化显存、kernel、权重，减少第一次推理的延迟（复用的会话已经预热过）
+        if (!reused)
+        {
+            WarmUpSession();
+        }
+        profiling = profile;
+        profileRunsLeft = profile ? iParams.profileRuns : 0;
 
         return RET_OK; // 成功
     }
@@ -182,22 +484,64 @@ const char* YOLO_V8::CreateSession(DL_INIT_PARAM& iParams) {
         std::string result = std::string(str1) + std::string(str2);
 
         // 输出详细错误信息到控制台
-        char* merged = new char[result.length() + 1];
-        strcpy_s(merged, sizeof(merged), result.c_str());
-        std::cout << merged << std::endl;
-        delete[] merged;
+        std::cout << result << std::endl;
 
         // 返回简短错误提示
         return "[YOLO_V8]:Create session failed.";
     }
 }
 
+bool YOLO_V8::ArenaStats(std::vector<std::pair<std::string, std::string>>& oStats) const
+{
+    oStats.clear();
+    if (!session) {
+        return false;
+    }
+#if ORT_API_VERSION >= 23
+    // 会话 CPU 分配器（默认启用 arena）的统计：InUse、MaxInUse、TotalAllocated、NumAllocs、NumArenaExtensions 等
+    const OrtApi& api = Ort::GetApi();
+    Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    OrtAllocator* allocator = nullptr;
+    if (OrtStatus* status = api.CreateAllocator(*session, memoryInfo, &allocator)) {
+        api.ReleaseStatus(status);
+        return false;
+    }
+    OrtKeyValuePairs* pairs = nullptr;
+    OrtStatus* status = api.AllocatorGetStats(allocator, &pairs);
+    if (status) {
+        api.ReleaseStatus(status);
+        api.ReleaseAllocator(allocator);
+        return false;
+    }
+    const char* const* keys = nullptr;
+    const char* const* values = nullptr;
+    size_t count = 0;
+    api.GetKeyValuePairs(pairs, &keys, &values, &count);
+    for (size_t i = 0; i < count; ++i) {
+        oStats.emplace_back(keys[i], values[i]);
+    }
+    api.ReleaseKeyValuePairs(pairs);
+    api.ReleaseAllocator(allocator);
+    return true;
+#else
+    // 旧版本 ONNX Runtime 没有分配器统计接口
+    return false;
+#endif
+}
+
 char* YOLO_V8::RunSession(cv::Mat& iImg, std::vector<DL_RESULT>& oResult) {
     char* Ret = RET_OK;  // 定义返回值，默认返回 nullptr（表示成功）
 
+    t_stageTime = DL_STAGE_TIME();
+    MemoryStats::Scope memScope;
+    auto start = std::chrono::steady_clock::now();
+
     cv::Mat processedImg; // 定义图像处理后的容器
     // 对输入图像进行预处理（调整大小、颜色格式、填充等）
+    TRACE_BEGIN(preprocess, "yolo.preprocess");
     PreProcess(iImg, imgSize, processedImg);
+    TRACE_END(preprocess);
+    t_stageTime.preProcess = ElapsedMs(start);
 
     // 判断模型类型（根据是否是 FLOAT32 / FLOAT16）
     if (modelType < 4)
@@ -206,7 +550,11 @@ char* YOLO_V8::RunSession(cv::Mat& iImg, std::vector<DL_RESULT>& oResult) {
         float* blob = new float[processedImg.total() * 3];
 
         // 将 OpenCV 图像转换为神经网络输入格式（归一化到 [0,1]）
+        start = std::chrono::steady_clock::now();
+        TRACE_BEGIN(to_blob, "yolo.blob");
         BlobFromImage(processedImg, blob);
+        TRACE_END(to_blob);
+        t_stageTime.blob = ElapsedMs(start);
 
         // 设置 ONNX 模型输入张量维度：NCHW = [1, 3, height, width]
         std::vector<int64_t> inputNodeDims = { 1, 3, imgSize.at(0), imgSize.at(1) };
@@ -214,76 +562,228 @@ char* YOLO_V8::RunSession(cv::Mat& iImg, std::vector<DL_RESULT>& oResult) {
         // 调用模板函数 TensorProcess 进行模型推理和结果解析
         TensorProcess(iImg, blob, inputNodeDims, oResult);
     }
+    else if (modelType == YOLO_CLS_U8)
+    {
+        // 归一化与 HWC->CHW 在模型内完成，预处理结果直接作为输入张量，不再拷贝
+        if (!processedImg.isContinuous())
+        {
+            processedImg = processedImg.clone();
+        }
+        std::vector<int64_t> inputNodeDims = { 1, imgSize.at(1), imgSize.at(0), 3 };
+        Ort::Value inputTensor = Ort::Value::CreateTensor<uint8_t>(
+            Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU),
+            processedImg.data, processedImg.total() * 3,
+            inputNodeDims.data(), inputNodeDims.size());
+        RunTensor(inputTensor, oResult);
+    }
+
+    t_allocations = memScope.Delta();
+    RecordAllocations(t_allocations);
+
+    // 达到分析次数后写出性能分析结果
+    if (profiling && profileRunsLeft.load() > 0 && profileRunsLeft.fetch_sub(1) == 1)
+    {
+        EndProfiling();
+    }
 
     // 返回结果指针（RET_OK = nullptr 表示成功）
     return Ret;
 }
 
+char* YOLO_V8::RunSessionBatch(std::vector<cv::Mat>& iImgs, std::vector<std::vector<DL_RESULT>>& oResults)
+{
+    oResults.assign(iImgs.size(), std::vector<DL_RESULT>());
+    if (iImgs.empty()) {
+        return RET_OK;
+    }
+
+    // 模型输入 batch 固定为 1 时，逐张推理
+    if (!dynamicBatch || iImgs.size() == 1)
+    {
+        for (size_t i = 0; i < iImgs.size(); ++i)
+        {
+            RunSession(iImgs[i], oResults[i]);
+        }
+        return RET_OK;
+    }
+
+    if (modelType < 4)
+    {
+        const size_t batch = iImgs.size();
+        const size_t stride = 3 * static_cast<size_t>(imgSize.at(0)) * imgSize.at(1);
+
+        // 所有图片连续存放在同一块输入缓冲区中：NCHW = [N, 3, H, W]
+        t_stageTime = DL_STAGE_TIME();
+        MemoryStats::Scope memScope;
+        float* blob = new float[batch * stride];
+        for (size_t i = 0; i < batch; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            cv::Mat processedImg;
+            TRACE_BEGIN(preprocess, "yolo.preprocess");
+            PreProcess(iImgs[i], imgSize, processedImg);
+            TRACE_END(preprocess);
+            t_stageTime.preProcess += ElapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            float* dst = blob + i * stride;
+            TRACE_BEGIN(to_blob, "yolo.blob");
+            BlobFromImage(processedImg, dst);
+            TRACE_END(to_blob);
+            t_stageTime.blob += ElapsedMs(start);
+        }
+
+        std::vector<int64_t> inputNodeDims = { static_cast<int64_t>(batch), 3, imgSize.at(0), imgSize.at(1) };
+
+        // TensorProcess 按 batch 行依次输出结果，每张图片一条
+        std::vector<DL_RESULT> flat;
+        TensorProcess(iImgs.front(), blob, inputNodeDims, flat);
+        for (size_t i = 0; i < batch && i < flat.size(); ++i)
+        {
+            oResults[i].push_back(flat[i]);
+        }
+        t_allocations = memScope.Delta();
+        RecordAllocations(t_allocations);
+    }
+    else if (modelType == YOLO_CLS_U8)
+    {
+        const size_t batch = iImgs.size();
+        const size_t stride = 3 * static_cast<size_t>(imgSize.at(0)) * imgSize.at(1);
+
+        // NHWC = [N, H, W, 3]，每张图片直接缩放到输入缓冲区中对应的位置
+        t_stageTime = DL_STAGE_TIME();
+        MemoryStats::Scope memScope;
+        std::vector<uint8_t> input(batch * stride);
+        for (size_t i = 0; i < batch; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            cv::Mat processedImg;
+            TRACE_BEGIN(preprocess, "yolo.preprocess");
+            PreProcess(iImgs[i], imgSize, processedImg);
+            cv::Mat slot(imgSize.at(1), imgSize.at(0), CV_8UC3, input.data() + i * stride);
+            processedImg.copyTo(slot);
+            TRACE_END(preprocess);
+            t_stageTime.preProcess += ElapsedMs(start);
+        }
+
+        std::vector<int64_t> inputNodeDims = { static_cast<int64_t>(batch), imgSize.at(1), imgSize.at(0), 3 };
+        Ort::Value inputTensor = Ort::Value::CreateTensor<uint8_t>(
+            Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU),
+            input.data(), input.size(), inputNodeDims.data(), inputNodeDims.size());
+
+        std::vector<DL_RESULT> flat;
+        RunTensor(inputTensor, flat);
+        for (size_t i = 0; i < batch && i < flat.size(); ++i)
+        {
+            oResults[i].push_back(flat[i]);
+        }
+        t_allocations = memScope.Delta();
+        RecordAllocations(t_allocations);
+    }
+    return RET_OK;
+}
+
 
 template<typename N>
 char* YOLO_V8::TensorProcess(cv::Mat& iImg, N& blob,
                              std::vector<int64_t>& inputNodeDims, std::vector<DL_RESULT>& oResult)
 {
     Q_UNUSED(iImg);
+    // 输入张量元素数量 = N × 3 × H × W
+    size_t inputTensorLength = 1;
+    for (int64_t d : inputNodeDims) inputTensorLength *= static_cast<size_t>(d);
+
     // === 1️ 创建 ONNX Runtime 输入张量 ===
     Ort::Value inputTensor = Ort::Value::CreateTensor<typename std::remove_pointer<N>::type>(
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU),  // 在 CPU 上创建内存
         blob,                                                           // 输入数据指针
-        3 * imgSize.at(0) * imgSize.at(1),                              // 输入张量元素数量
+        inputTensorLength,                                              // 输入张量元素数量
         inputNodeDims.data(),                                           // 输入维度数组
         inputNodeDims.size());                                          // 维度数量
 
+    char* Ret = RunTensor(inputTensor, oResult);
+
+    // 释放输入内存（blob 在推理后已不再使用）
+    delete[] blob;
+    return Ret;
+}
+
+char* YOLO_V8::RunTensor(Ort::Value& inputTensor, std::vector<DL_RESULT>& oResult)
+{
     // === 2 模型推理（执行前向计算） ===
+    auto start = std::chrono::steady_clock::now();
+    TRACE_BEGIN(run, "yolo.run");
     auto outputTensor = session->Run(
         options,                   // 运行选项
         inputNodeNames.data(),     // 输入节点名称数组
         &inputTensor,              // 输入张量
         1,                         // 输入数量
-        outputNodeNames.data(),    // 输出节点名称数组
-        outputNodeNames.size());   // 输出数量
+        runOutputNames.data(),     // 输出节点名称数组
+        runOutputNames.size());    // 输出数量
+    TRACE_END(run);
+    t_stageTime.run = ElapsedMs(start);
+    static Histogram& runTime = Metrics::Instance().GetHistogram("cv_session_run_seconds", "ONNX Runtime session Run() time.");
+    runTime.RecordMs(t_stageTime.run);
+    start = std::chrono::steady_clock::now();
+    TRACE_SCOPE("yolo.postprocess");
 
     // === 3️ 获取输出张量信息 ===
     Ort::TypeInfo typeInfo = outputTensor.front().GetTypeInfo();           // 获取输出类型信息
     auto tensor_info = typeInfo.GetTensorTypeAndShapeInfo();               // 获取形状信息
     std::vector<int64_t> outputNodeDims = tensor_info.GetShape();          // 输出张量维度
-    auto output = outputTensor.front().GetTensorMutableData<typename std::remove_pointer<N>::type>(); // 输出数据指针
-
-    // 释放输入内存（blob 在推理后已不再使用）
-    delete[] blob;
+    auto output = outputTensor.front().GetTensorMutableData<float>(); // 输出数据指针（分类输出始终为 float）
 
     // === 4️ 根据模型类型解析输出 ===
     switch (modelType)
     {
     case YOLO_CLS:
+    case YOLO_CLS_U8:
     {
-        cv::Mat rawData;
-        rawData = cv::Mat(1, static_cast<int>(outputNodeDims.back()), CV_32F, output);
-
-        float* data = (float*)rawData.data;
+        float* data = output;
         int num_classes = static_cast<int>(outputNodeDims.back());
+        // 输出形状为 [N, num_classes]，逐行取最大值
+        int64_t batch = outputNodeDims.size() > 1 ? outputNodeDims.front() : 1;
 
-        // === 找出最大置信度类别 ===
-        int max_index = 0;
-        float max_value = data[0];
-        for (int i = 1; i < num_classes; ++i)
+        for (int64_t b = 0; b < batch; ++b, data += num_classes)
         {
-            if (data[i] > max_value)
+            // === 找出最大置信度类别 ===
+            int max_index = 0;
+            float max_value = data[0];
+            for (int i = 1; i < num_classes; ++i)
             {
-                max_value = data[i];
-                max_index = i;
+                if (data[i] > max_value)
+                {
+                    max_value = data[i];
+                    max_index = i;
+                }
             }
+
+            // 保存结果
+            DL_RESULT result;
+            result.classId = max_index;
+            result.confidence = max_value;
+            oResult.push_back(result);
         }
 
-        // 保存结果
-        DL_RESULT result;
-        result.classId = max_index;
-        result.confidence = max_value;
-        oResult.push_back(result);
+        // 可选：取出倒数第二层的特征向量，形状为 [N, D]
+        if (embeddingEnable && outputTensor.size() > 1)
+        {
+            auto embeddingInfo = outputTensor[1].GetTensorTypeAndShapeInfo();
+            const size_t total = embeddingInfo.GetElementCount();
+            const size_t dim = batch > 0 ? total / static_cast<size_t>(batch) : 0;
+            const float* embedding = outputTensor[1].GetTensorData<float>();
+            const size_t first = oResult.size() - static_cast<size_t>(batch);
+            for (int64_t b = 0; b < batch; ++b)
+            {
+                oResult[first + b].embedding.assign(embedding + b * dim, embedding + (b + 1) * dim);
+            }
+        }
         break;
     }
     default:
         std::cout << "[YOLO_V8]: Not support model type." << std::endl;
     }
+    t_stageTime.postProcess = ElapsedMs(start);
     // 返回执行成功标志
     return RET_OK;
 }
@@ -329,7 +829,7 @@ char* YOLO_V8::WarmUpSession() {
         auto output_tensors = session->Run(
             options,
             inputNodeNames.data(), &input_tensor, 1,
-            outputNodeNames.data(), outputNodeNames.size()
+            runOutputNames.data(), runOutputNames.size()
             );
 
         // 释放内存
@@ -347,6 +847,19 @@ char* YOLO_V8::WarmUpSession() {
                       << post_process_time << " ms. " << std::endl;
         }
     }
+    else if (modelType == YOLO_CLS_U8)
+    {
+        // uint8 输入：预处理结果直接作为输入张量
+        std::vector<int64_t> YOLO_input_node_dims = { 1, imgSize.at(1), imgSize.at(0), 3 };
+        Ort::Value input_tensor = Ort::Value::CreateTensor<uint8_t>(
+            Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU),
+            processedImg.data, processedImg.total() * 3,
+            YOLO_input_node_dims.data(), YOLO_input_node_dims.size());
+        auto output_tensors = session->Run(
+            options,
+            inputNodeNames.data(), &input_tensor, 1,
+            runOutputNames.data(), runOutputNames.size());
+    }
     // 返回成功标志
     return RET_OK;
 }
@@ -10,11 +10,15 @@
 #endif
 
 #include <QtGlobal>
+#include <atomic>
 #include <string>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <cstdio>
 #include <opencv2/opencv.hpp>
 #include "onnxruntime_cxx_api.h"
+#include "memorystats.h"
 
 #ifdef USE_CUDA
 #include <cuda_fp16.h>
@@ -23,6 +27,15 @@
 enum MODEL_TYPE
 {
     YOLO_CLS = 3,           // YOLOv8 分类模型（FP32）
+    YOLO_CLS_U8 = 7,        // YOLOv8 分类模型，输入为 uint8 NHWC RGB（归一化在图内，见 tools/fuse_uint8_input.py）
+};
+
+// 同一进程内会话之间的共享方式
+enum DL_SHARE_MODE
+{
+    SHARE_NONE = 0,     // 独立会话：各自的 env、arena 与重排权重
+    SHARE_WEIGHTS = 1,  // 独立会话，共享重排权重（PrepackedWeightsContainer）与 env 上的 CPU arena
+    SHARE_SESSION = 2,  // 模型与会话参数相同时复用同一个 Ort::Session，否则同 SHARE_WEIGHTS
 };
 
 // 模型初始化参数结构体
@@ -38,6 +51,12 @@ typedef struct _DL_INIT_PARAM
     bool cudaEnable = false;                // 是否启用GPU(CUDA)
     int logSeverityLevel = 3;               // ONNX Runtime日志级别
     int intraOpNumThreads = 1;              // CPU线程数
+    int interOpNumThreads = 1;              // 算子间并行线程数（大于 1 时以并行模式执行图）
+    bool allowSpinning = true;              // ORT 线程池在任务间自旋等待（降低延迟，空闲时仍占 CPU）
+    std::string embeddingOutputName;        // 特征向量输出名（为空表示不提取，模型需先用 tools/expose_embedding.py 导出）
+    DL_SHARE_MODE shareMode = SHARE_SESSION; // 与进程内其他会话的共享方式
+    std::string profilePrefix;              // 非空时开启 ORT 性能分析，结果写入 <prefix>_<时间>.json（会话不共享）
+    int profileRuns = 0;                    // 分析的 RunSession 次数，达到后自动写出结果（0 表示直到 EndProfiling）
 } DL_INIT_PARAM;
 
 
@@ -49,9 +68,25 @@ typedef struct _DL_RESULT
     float confidence;                 // 置信度
     cv::Rect box;                     // 检测框坐标 (x, y, w, h)
     std::vector<cv::Point2f> keyPoints; // 姿态关键点坐标（仅在pose模型中使用）
+    std::vector<float> embedding;     // 倒数第二层特征向量（开启提取时有效）
 } DL_RESULT;
 
 
+// 最近一次推理各阶段耗时（毫秒），用于性能测试与诊断
+typedef struct _DL_STAGE_TIME
+{
+    double preProcess = 0.0;   // 颜色转换、裁剪、缩放（批量推理时为全部图片之和，下同）
+    double blob = 0.0;         // HWC uint8 -> CHW float 归一化
+    double run = 0.0;          // session->Run
+    double postProcess = 0.0;  // 输出解析（取最大类别、拷贝特征向量）
+} DL_STAGE_TIME;
+
+
+// 图像转 Tensor：BGR/RGB uint8 HWC -> CHW 归一化到 [0,1]（已显式实例化 float*）
+template<typename T>
+char* BlobFromImage(cv::Mat& iImg, T& iBlob);
+
+
 // YOLOv8 模型类封装
 // 封装ONNX Runtime推理接口、预处理、后处理、CUDA初始化等
 class YOLO_V8
@@ -64,13 +99,43 @@ public:
 
     const char* CreateSession(DL_INIT_PARAM& iParams);
     char* RunSession(cv::Mat& iImg, std::vector<DL_RESULT>& oResult);
+    // 批量推理：模型支持动态 batch 时合并为一次 session->Run，否则逐张推理
+    char* RunSessionBatch(std::vector<cv::Mat>& iImgs, std::vector<std::vector<DL_RESULT>>& oResults);
+    bool SupportsBatch() const { return dynamicBatch; }
+    bool SupportsEmbedding() const { return embeddingEnable; }
+    int ClassCount() const { return classCount; }  // 分类输出的类别数（动态维度时为 -1）
     char* WarmUpSession();
 
+    // 当前存活的共享会话（SHARE_SESSION）数量
+    static int SharedSessionCount();
+
+    /**
+     * @brief 结束 ORT 性能分析并写出 JSON（开启 profilePrefix 时有效，重复调用无副作用）
+     * 汇总与对比见 tools/ort_profile_report.py
+     * @return 写出的文件路径，未开启或已结束时返回已有结果（可能为空）
+     */
+    std::string EndProfiling();
+    bool Profiling() const { return profiling.load(); }
+    const std::string& ProfileFile() const { return profileFile; }
+
+    // 调用线程上最近一次 RunSession / RunSessionBatch 的分阶段耗时
+    // （按线程保存：同一实例被多个线程同时使用时互不覆盖，须在推理的线程上读取）
+    const DL_STAGE_TIME& LastStageTime() const;
+
+    // 调用线程上最近一次 RunSession / RunSessionBatch 的堆分配（需 CV_MEMSTATS）
+    const MemoryStats::Counts& LastAllocations() const;
+
+    // 会话 CPU arena 的统计（键值均为文本），ONNX Runtime 不支持时返回 false
+    bool ArenaStats(std::vector<std::pair<std::string, std::string>>& oStats) const;
+
     template<typename N>
     char* TensorProcess(cv::Mat& iImg, N& blob,
                         std::vector<int64_t>& inputNodeDims,
                         std::vector<DL_RESULT>& oResult);
 
+    // 运行已创建好的输入张量并解析输出（TensorProcess 与 uint8 输入共用）
+    char* RunTensor(Ort::Value& inputTensor, std::vector<DL_RESULT>& oResult);
+
     char* PreProcess(cv::Mat& iImg, std::vector<int> iImgSize, cv::Mat& oImg);
 
 public:
@@ -79,15 +144,24 @@ public:
 
 private:
     Ort::Env env;                     // ONNX Runtime环境对象
-    Ort::Session* session;            // 推理Session对象
+    std::shared_ptr<Ort::Session> session;  // 推理Session对象（SHARE_SESSION 时可能与其他实例共用）
     bool cudaEnable;                  // 是否启用CUDA
+    bool dynamicBatch = false;        // 模型输入是否支持动态 batch
     Ort::RunOptions options;          // 运行选项
-    std::vector<const char*> inputNodeNames;  // 输入节点名称
-    std::vector<const char*> outputNodeNames; // 输出节点名称
-
-    MODEL_TYPE modelType;             // 当前模型类型
+    std::vector<std::string> inputNodeNameStore;  // 输入节点名称
+    std::vector<std::string> outputNodeNameStore; // 输出节点名称
+    std::vector<const char*> inputNodeNames;  // 输入节点名称（指向 inputNodeNameStore）
+    std::vector<const char*> outputNodeNames; // 输出节点名称（指向 outputNodeNameStore）
+    std::vector<const char*> runOutputNames;  // 推理时实际取回的输出（分类 + 可选特征向量）
+    bool embeddingEnable = false;             // 是否输出特征向量
+    int classCount = -1;                      // 分类输出的类别数
+
+    MODEL_TYPE modelType = YOLO_CLS;  // 当前模型类型
     std::vector<int> imgSize;         // 模型输入尺寸
     float rectConfidenceThreshold;    // 置信度阈值
     float iouThreshold;               // IoU阈值
     float resizeScales;               // 图像缩放比例（用于恢复原图检测框）
+    std::atomic<bool> profiling{false};   // ORT 性能分析进行中
+    std::atomic<int> profileRunsLeft{0};  // 剩余需要分析的 RunSession 次数（0 表示不限，多个线程同时推理时原子递减）
+    std::string profileFile;          // 性能分析结果文件
 };
@@ -0,0 +1,201 @@
+#include "inferencescheduler.h"
+#include "metrics.h"
+#include "tracer.h"
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+
+InferenceScheduler::Ticket::Ticket(Priority priority, qint64 deadlineNs)
+    : _priority(priority), _deadlineNs(deadlineNs)
+{
+    _granted = InferenceScheduler::Instance().Acquire(priority, deadlineNs, _grantedNs);
+}
+
+InferenceScheduler::Ticket::~Ticket()
+{
+    Release();
+}
+
+void InferenceScheduler::Ticket::Release()
+{
+    if (_granted) {
+        _granted = false;
+        InferenceScheduler::Instance().Release(_priority, _grantedNs, _deadlineNs);
+    }
+}
+
+InferenceScheduler &InferenceScheduler::Instance()
+{
+    static InferenceScheduler instance;
+    return instance;
+}
+
+InferenceScheduler::InferenceScheduler()
+{
+    // 单次推理使用 4 个 intra-op 线程；ThreadTuning 载入或选定线程配置后按其线程数重新设置
+    _slots = std::max(1, QThread::idealThreadCount() / 4);
+
+    Metrics& metrics = Metrics::Instance();
+    for (int p = 0; p < PriorityCount; ++p) {
+        const QString labels = QString("class=\"%1\"").arg(QLatin1String(PriorityName(Priority(p))));
+        ClassMetrics& m = _metrics[p];
+        m.wait = &metrics.GetHistogram("cv_scheduler_wait_seconds", "Time inference requests waited for a slot, by priority class.", labels);
+        m.service = &metrics.GetHistogram("cv_scheduler_service_seconds", "Time inference requests held a slot, by priority class.", labels);
+        m.queued = &metrics.GetGauge("cv_scheduler_queued", "Inference requests waiting for a slot, by priority class.", labels);
+        m.expired = &metrics.GetCounter("cv_scheduler_expired_total", "Requests abandoned because their deadline passed while queued.", labels);
+        m.missed = &metrics.GetCounter("cv_scheduler_deadline_missed_total", "Requests that finished after their deadline.", labels);
+    }
+    metrics.RegisterCallback("cv_scheduler_slots", "Concurrent inference slots.", Metrics::TypeGauge,
+                             [this]() { return double(_slots); });
+}
+
+void InferenceScheduler::SetSlots(int slots)
+{
+    QMutexLocker locker(&_mutex);
+    _slots = std::max(1, slots);
+    _changed.wakeAll();
+}
+
+int InferenceScheduler::Slots() const
+{
+    return _slots;
+}
+
+bool InferenceScheduler::HasWaitersAbove(Priority priority) const
+{
+    QMutexLocker locker(&_mutex);
+    for (const Waiter& waiter : _waiters) {
+        if (waiter.priority < priority) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int InferenceScheduler::Active() const
+{
+    QMutexLocker locker(&_mutex);
+    return _busy + _external;
+}
+
+quint64 InferenceScheduler::Started() const
+{
+    return _started.load(std::memory_order_relaxed);
+}
+
+void InferenceScheduler::AddExternal(int delta)
+{
+    if (delta > 0) {
+        _started.fetch_add(quint64(delta), std::memory_order_relaxed);
+    }
+    QMutexLocker locker(&_mutex);
+    _external = std::max(0, _external + delta);
+}
+
+const char *InferenceScheduler::PriorityName(Priority priority)
+{
+    switch (priority) {
+    case Interactive: return "interactive";
+    case Live: return "live";
+    case Batch: return "batch";
+    default: return "unknown";
+    }
+}
+
+bool InferenceScheduler::IsNext(const Waiter &waiter) const
+{
+    // 优先级高者优先；同优先级有截止时间者优先、截止早者优先；最后按申请顺序
+    auto before = [](const Waiter& a, const Waiter& b) {
+        if (a.priority != b.priority) {
+            return a.priority < b.priority;
+        }
+        if (a.deadlineNs != b.deadlineNs) {
+            if (a.deadlineNs == 0 || b.deadlineNs == 0) {
+                return b.deadlineNs == 0;
+            }
+            return a.deadlineNs < b.deadlineNs;
+        }
+        return a.seq < b.seq;
+    };
+    for (const Waiter& other : _waiters) {
+        if (other.seq != waiter.seq && before(other, waiter) && HasFreeSlot(other.priority)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool InferenceScheduler::HasFreeSlot(Priority priority) const
+{
+    if (_busy >= _slots) {
+        return false;
+    }
+    // 批量任务至少留出一个槽给高优先级请求
+    return priority != Batch || _slots == 1 || _busyBatch < _slots - 1;
+}
+
+bool InferenceScheduler::Acquire(Priority priority, qint64 deadlineNs, qint64 &grantedNs)
+{
+    ClassMetrics& m = _metrics[priority];
+    const qint64 startNs = Tracer::NowNs();
+
+    QMutexLocker locker(&_mutex);
+    const auto self = _waiters.insert(_waiters.end(), Waiter{priority, deadlineNs, _nextSeq++});
+    m.queued->Add(1);
+
+    bool granted = false;
+    while (true) {
+        if (HasFreeSlot(priority) && IsNext(*self)) {
+            granted = true;
+            break;
+        }
+        if (deadlineNs <= 0) {
+            _changed.wait(&_mutex);
+            continue;
+        }
+        const qint64 remainingNs = deadlineNs - Tracer::NowNs();
+        if (remainingNs <= 0) {
+            break;
+        }
+        _changed.wait(&_mutex, QDeadlineTimer(remainingNs / 1000000 + 1));
+    }
+
+    _waiters.erase(self);
+    m.queued->Add(-1);
+    if (!granted) {
+        m.expired->Inc();
+        // 本请求可能挡住了其他等待者
+        _changed.wakeAll();
+        return false;
+    }
+    _busy++;
+    if (priority == Batch) {
+        _busyBatch++;
+    }
+    _started.fetch_add(1, std::memory_order_relaxed);
+    // 本请求排在前面时，排在后面的等待者看到过空槽却仍在等待；还有空槽就叫醒它们
+    if (_busy < _slots && !_waiters.empty()) {
+        _changed.wakeAll();
+    }
+    grantedNs = Tracer::NowNs();
+    m.wait->Record((grantedNs - startNs) / 1000);
+    return true;
+}
+
+void InferenceScheduler::Release(Priority priority, qint64 grantedNs, qint64 deadlineNs)
+{
+    ClassMetrics& m = _metrics[priority];
+    const qint64 nowNs = Tracer::NowNs();
+    m.service->Record((nowNs - grantedNs) / 1000);
+    if (deadlineNs > 0 && nowNs > deadlineNs) {
+        m.missed->Inc();
+    }
+
+    QMutexLocker locker(&_mutex);
+    _busy--;
+    if (priority == Batch) {
+        _busyBatch--;
+    }
+    _changed.wakeAll();
+}
@@ -0,0 +1,128 @@
+#ifndef INFERENCESCHEDULER_H
+#define INFERENCESCHEDULER_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QtGlobal>
+#include <atomic>
+#include <list>
+
+class Gauge;
+class Counter;
+class Histogram;
+
+/**
+ * @brief 推理调度器：按优先级分配推理执行槽
+ * 推理前申请一个槽（Ticket），推理后归还；槽空出时优先分给高优先级的等待者，
+ * 同一优先级内按截止时间（最早优先）再按申请顺序。
+ * 批量识别按小块（BATCH_CHUNK_SIZE 张）申请，有更高优先级的请求等待时提前归还，
+ * 因此单张检测与实时识别最多等待一张批量图片的推理时间。
+ * 截止时间已过仍未拿到槽的请求直接放弃（实时帧过期后没有意义）。
+ *
+ * 每个优先级导出：等待时间、占用时间（直方图），排队数，过期与超时完成次数。
+ */
+class InferenceScheduler
+{
+public:
+    enum Priority
+    {
+        Interactive = 0,    // 用户主动触发（单张检测）
+        Live = 1,           // 实时画面
+        Batch = 2,          // 后台批量识别
+        PriorityCount = 3,
+    };
+
+    /**
+     * @brief 一次推理占用的槽（RAII），析构时归还
+     * 构造时阻塞到拿到槽或截止时间已过
+     */
+    class Ticket
+    {
+    public:
+        /**
+         * @param priority 优先级
+         * @param deadlineNs 截止时刻（Tracer::NowNs），0 表示不限
+         */
+        explicit Ticket(Priority priority, qint64 deadlineNs = 0);
+        ~Ticket();
+
+        // 是否拿到了槽（false 表示截止时间已过）
+        bool Granted() const { return _granted; }
+
+        // 提前归还（之后 Granted() 为 false）
+        void Release();
+
+    private:
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+
+        Priority _priority;
+        qint64 _deadlineNs;
+        qint64 _grantedNs = 0;
+        bool _granted = false;
+    };
+
+    // 获取全局唯一实例（线程安全）
+    static InferenceScheduler& Instance();
+
+    /**
+     * @brief 设置并发推理槽数量（默认按 CPU 核数，每槽 4 个推理线程）
+     * 批量任务最多占用 slots - 1 个槽（只有一个槽时占用全部），保证高优先级请求总有槽可等
+     */
+    void SetSlots(int slots);
+    int Slots() const;
+
+    // 是否有比 priority 更高优先级的请求在等待（批量任务据此提前归还槽）
+    bool HasWaitersAbove(Priority priority) const;
+
+    // 正在进行的推理数（已发出的槽加上进程外登记的推理）
+    int Active() const;
+    // 累计开始的推理数；前后两次相同且期间 Active() 为 0，说明这段时间没有其他推理（调优测量据此取舍）
+    quint64 Started() const;
+    // 推理子进程中的推理开始（+1）或结束（-1），不占用槽，只计入 Active() / Started()
+    void AddExternal(int delta);
+
+    static const char* PriorityName(Priority priority);
+
+private:
+    InferenceScheduler();
+    InferenceScheduler(const InferenceScheduler&) = delete;
+    InferenceScheduler& operator=(const InferenceScheduler&) = delete;
+
+    struct Waiter
+    {
+        Priority priority;
+        qint64 deadlineNs;
+        quint64 seq;
+    };
+
+    // 成功时返回 true 并写入拿到槽的时刻
+    bool Acquire(Priority priority, qint64 deadlineNs, qint64& grantedNs);
+    void Release(Priority priority, qint64 grantedNs, qint64 deadlineNs);
+
+    // 调用时已加锁
+    bool IsNext(const Waiter& waiter) const;
+    bool HasFreeSlot(Priority priority) const;
+
+    struct ClassMetrics
+    {
+        Histogram* wait = nullptr;
+        Histogram* service = nullptr;
+        Gauge* queued = nullptr;
+        Counter* expired = nullptr;
+        Counter* missed = nullptr;
+    };
+
+    mutable QMutex _mutex;
+    QWaitCondition _changed;
+    std::list<Waiter> _waiters;
+    quint64 _nextSeq = 0;
+    std::atomic<int> _slots{1};
+    int _busy = 0;
+    int _busyBatch = 0;
+    int _external = 0;
+    std::atomic<quint64> _started{0};
+    ClassMetrics _metrics[PriorityCount];
+};
+
+#endif // INFERENCESCHEDULER_H
@@ -0,0 +1,254 @@
+#include "memorystats.h"
+#include "metrics.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <malloc.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <malloc/malloc.h>
+#include <sys/resource.h>
+#else
+#include <malloc.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+
+namespace {
+
+// 平凡类型的 thread_local 不需要构造与析构，线程退出阶段的分配也能安全计数
+thread_local quint64 t_allocations = 0;
+thread_local quint64 t_bytes = 0;
+
+std::atomic<quint64> g_allocations{0};
+std::atomic<quint64> g_bytes{0};
+std::atomic<qint64> g_live{0};
+
+#ifdef CV_MEMSTATS
+// 分配器给出的实际块大小
+inline size_t BlockSize(void* p)
+{
+#ifdef _WIN32
+    return _msize(p);
+#elif defined(__APPLE__)
+    return malloc_size(p);
+#else
+    return malloc_usable_size(p);
+#endif
+}
+
+inline void* CountedAlloc(size_t size)
+{
+    void* p = std::malloc(size ? size : 1);
+    if (p) {
+        const size_t block = BlockSize(p);
+        ++t_allocations;
+        t_bytes += block;
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(block, std::memory_order_relaxed);
+        g_live.fetch_add(qint64(block), std::memory_order_relaxed);
+    }
+    return p;
+}
+
+inline void CountedFree(void* p)
+{
+    if (p) {
+        g_live.fetch_sub(qint64(BlockSize(p)), std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+// 对齐分配（alignas 超过默认对齐的类型）；Windows 上须与 _aligned_free 配对
+inline void* CountedAlignedAlloc(size_t size, std::align_val_t alignment)
+{
+    const size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    void* p = _aligned_malloc(size ? size : 1, align);
+    const size_t block = p ? _aligned_msize(p, align, 0) : 0;
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, align < sizeof(void*) ? sizeof(void*) : align, size ? size : 1) != 0) {
+        p = nullptr;
+    }
+    const size_t block = p ? BlockSize(p) : 0;
+#endif
+    if (p) {
+        ++t_allocations;
+        t_bytes += block;
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(block, std::memory_order_relaxed);
+        g_live.fetch_add(qint64(block), std::memory_order_relaxed);
+    }
+    return p;
+}
+
+inline void CountedAlignedFree(void* p, std::align_val_t alignment)
+{
+    if (p) {
+#ifdef _WIN32
+        g_live.fetch_sub(qint64(_aligned_msize(p, static_cast<size_t>(alignment), 0)), std::memory_order_relaxed);
+        _aligned_free(p);
+#else
+        Q_UNUSED(alignment);
+        g_live.fetch_sub(qint64(BlockSize(p)), std::memory_order_relaxed);
+        std::free(p);
+#endif
+    }
+}
+#endif
+
+} // namespace
+
+#ifdef CV_MEMSTATS
+// -------------------- 全局 operator new / delete --------------------
+
+void* operator new(size_t size)
+{
+    void* p = CountedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    void* p = CountedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { CountedFree(p); }
+void operator delete[](void* p) noexcept { CountedFree(p); }
+void operator delete(void* p, size_t) noexcept { CountedFree(p); }
+void operator delete[](void* p, size_t) noexcept { CountedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { CountedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { CountedFree(p); }
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    void* p = CountedAlignedAlloc(size, alignment);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    void* p = CountedAlignedAlloc(size, alignment);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, alignment); }
+void operator delete(void* p, std::align_val_t alignment) noexcept { CountedAlignedFree(p, alignment); }
+void operator delete[](void* p, std::align_val_t alignment) noexcept { CountedAlignedFree(p, alignment); }
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept { CountedAlignedFree(p, alignment); }
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept { CountedAlignedFree(p, alignment); }
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedAlignedFree(p, alignment); }
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedAlignedFree(p, alignment); }
+#endif
+
+bool MemoryStats::Enabled()
+{
+#ifdef CV_MEMSTATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+MemoryStats::Counts MemoryStats::ThreadCounts()
+{
+    return Counts{t_allocations, t_bytes};
+}
+
+MemoryStats::Counts MemoryStats::TotalCounts()
+{
+    return Counts{g_allocations.load(std::memory_order_relaxed), g_bytes.load(std::memory_order_relaxed)};
+}
+
+qint64 MemoryStats::LiveHeapBytes()
+{
+    return g_live.load(std::memory_order_relaxed);
+}
+
+qint64 MemoryStats::ResidentBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.WorkingSetSize);
+    }
+    return -1;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        return qint64(info.resident_size);
+    }
+    return -1;
+#else
+    // /proc/self/statm 第二列为常驻页数
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) {
+        return -1;
+    }
+    long pages = 0, resident = 0;
+    const int read = std::fscanf(file, "%ld %ld", &pages, &resident);
+    std::fclose(file);
+    return read == 2 ? qint64(resident) * sysconf(_SC_PAGESIZE) : -1;
+#endif
+}
+
+qint64 MemoryStats::PeakResidentBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.PeakWorkingSetSize);
+    }
+    return -1;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#ifdef __APPLE__
+    return qint64(usage.ru_maxrss);          // 字节
+#else
+    return qint64(usage.ru_maxrss) * 1024;   // KB
+#endif
+#endif
+}
+
+void MemoryStats::RegisterMetrics()
+{
+    Metrics& metrics = Metrics::Instance();
+    metrics.RegisterCallback("cv_process_resident_bytes", "Current resident set size.", Metrics::TypeGauge,
+                             []() { return double(ResidentBytes()); });
+    metrics.RegisterCallback("cv_process_peak_resident_bytes", "Peak resident set size since start.", Metrics::TypeGauge,
+                             []() { return double(PeakResidentBytes()); });
+    if (Enabled()) {
+        metrics.RegisterCallback("cv_heap_allocations_total", "operator new calls.", Metrics::TypeCounter,
+                                 []() { return double(TotalCounts().allocations); });
+        metrics.RegisterCallback("cv_heap_allocated_bytes_total", "Bytes returned by operator new.", Metrics::TypeCounter,
+                                 []() { return double(TotalCounts().bytes); });
+        metrics.RegisterCallback("cv_heap_live_bytes", "Bytes allocated with operator new and not yet freed.", Metrics::TypeGauge,
+                                 []() { return double(LiveHeapBytes()); });
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <QtGlobal>
+
+/**
+ * @brief 内存统计
+ * 定义 CV_MEMSTATS 时（qmake CONFIG += memstats，Regression 与 Benchmark 默认开启）替换全局 operator new/delete（含对齐版本），
+ * 按线程累计分配次数与字节数（thread_local，无锁），并维护全局的分配总数与堆上存活字节数（relaxed 原子）。
+ * Scope 取当前线程的差值，用于统计单次推理的分配；ORT 内部线程池中的分配不计入调用线程，
+ * 这部分由 YOLO_V8::ArenaStats 的 arena 统计反映。
+ * 常驻内存与峰值常驻内存读取自操作系统，与是否定义 CV_MEMSTATS 无关。
+ */
+class MemoryStats
+{
+public:
+    // 分配次数与字节数
+    struct Counts
+    {
+        quint64 allocations = 0;
+        quint64 bytes = 0;
+    };
+
+    // 是否编译了分配统计
+    static bool Enabled();
+
+    // 当前线程累计的分配
+    static Counts ThreadCounts();
+
+    // 全部线程累计的分配
+    static Counts TotalCounts();
+
+    // 堆上存活字节数（按分配器实际给出的块大小）
+    static qint64 LiveHeapBytes();
+
+    // 当前常驻内存、进程启动以来的峰值常驻内存（字节），取不到时为 -1
+    static qint64 ResidentBytes();
+    static qint64 PeakResidentBytes();
+
+    // 把以上数值注册为 Metrics 读取回调（cv_process_*、cv_heap_*），重复调用无副作用
+    static void RegisterMetrics();
+
+    // 统计一段代码在当前线程上的分配
+    class Scope
+    {
+    public:
+        Scope() : _start(ThreadCounts()) {}
+        Counts Delta() const
+        {
+            const Counts now = ThreadCounts();
+            return Counts{now.allocations - _start.allocations, now.bytes - _start.bytes};
+        }
+
+    private:
+        Counts _start;
+    };
+};
+
+#endif // MEMORYSTATS_H
@@ -0,0 +1,292 @@
+#include "metrics.h"
+#include <QMutexLocker>
+#include <QSet>
+#include <QtAlgorithms>
+#include <cmath>
+
+namespace {
+
+// 最大可记录值（微秒）
+const quint64 MAX_MICROS = (quint64(1) << 37) - 1;
+
+// Prometheus 直方图的上界（秒）
+const double EXPORT_BOUNDS[] = {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+                                0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+
+QByteArray Number(double value)
+{
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    return QByteArray::number(value, 'g', 10);
+}
+
+// 拼接标签：{a="1",le="0.5"}
+QByteArray Labels(const QString& labels, const QByteArray& extra = QByteArray())
+{
+    QByteArray text = labels.toUtf8();
+    if (!extra.isEmpty()) {
+        if (!text.isEmpty()) {
+            text += ',';
+        }
+        text += extra;
+    }
+    return text.isEmpty() ? QByteArray() : '{' + text + '}';
+}
+
+} // namespace
+
+// -------------------- Histogram --------------------
+
+Histogram::Histogram()
+    : _buckets(new std::atomic<quint64>[BUCKET_COUNT])
+{
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+int Histogram::BucketOf(quint64 micros)
+{
+    const quint64 half = quint64(1) << (SUB_BUCKET_BITS - 1);
+    if (micros < (half << 1)) {
+        return int(micros);
+    }
+    micros = qMin(micros, MAX_MICROS);
+    const int msb = 63 - qCountLeadingZeroBits(micros);
+    const int shift = msb - (SUB_BUCKET_BITS - 1);              // >= 1
+    const int sub = int(micros >> shift);                       // [64, 128)
+    return int(half << 1) + (shift - 1) * int(half) + (sub - int(half));
+}
+
+quint64 Histogram::LowerBound(int bucket)
+{
+    const int half = 1 << (SUB_BUCKET_BITS - 1);
+    if (bucket < (half << 1)) {
+        return quint64(bucket);
+    }
+    const int k = bucket - (half << 1);
+    const int shift = k / half + 1;
+    const quint64 sub = quint64(k % half + half);
+    return sub << shift;
+}
+
+quint64 Histogram::UpperBound(int bucket)
+{
+    const int half = 1 << (SUB_BUCKET_BITS - 1);
+    if (bucket < (half << 1)) {
+        return quint64(bucket);
+    }
+    const int shift = (bucket - (half << 1)) / half + 1;
+    return LowerBound(bucket) + (quint64(1) << shift) - 1;
+}
+
+void Histogram::Record(qint64 micros)
+{
+    const quint64 value = micros > 0 ? quint64(micros) : 0;
+    _buckets[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+
+    quint64 max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Snapshot Histogram::Take() const
+{
+    // 先读出全部桶，分位数与计数来自同一份数据
+    std::vector<quint64> counts(BUCKET_COUNT);
+    Snapshot snapshot;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = _buckets[i].load(std::memory_order_relaxed);
+        snapshot.count += counts[i];
+    }
+    snapshot.sum = double(_sum.load(std::memory_order_relaxed));
+    snapshot.max = double(_max.load(std::memory_order_relaxed));
+    if (snapshot.count == 0) {
+        return snapshot;
+    }
+
+    // 分位数取桶上界（不超过最大值）
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    double* outputs[] = {&snapshot.p50, &snapshot.p90, &snapshot.p99, &snapshot.p999};
+    int q = 0;
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT && q < 4; ++i) {
+        seen += counts[i];
+        while (q < 4 && seen >= quint64(std::ceil(quantiles[q] * snapshot.count))) {
+            *outputs[q] = qMin(double(UpperBound(i)), snapshot.max);
+            ++q;
+        }
+    }
+    return snapshot;
+}
+
+QVector<quint64> Histogram::Cumulative(const QVector<qint64> &bounds, quint64 &total) const
+{
+    QVector<quint64> result(bounds.size(), 0);
+    total = 0;
+    int b = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        const quint64 count = _buckets[i].load(std::memory_order_relaxed);
+        while (b < bounds.size() && UpperBound(i) > quint64(qMax<qint64>(bounds[b], 0))) {
+            result[b++] = total;
+        }
+        total += count;
+    }
+    while (b < bounds.size()) {
+        result[b++] = total;
+    }
+    return result;
+}
+
+// -------------------- Metrics --------------------
+
+Metrics::Metrics()
+{
+}
+
+Metrics &Metrics::Instance()
+{
+    static Metrics instance;
+    return instance;
+}
+
+Metrics::Entry &Metrics::Find(const QString &name, const QString &help, const QString &labels, Type type)
+{
+    QMutexLocker locker(&_mutex);
+    for (auto& entry : _entries) {
+        if (entry->name == name && entry->labels == labels && entry->type == type) {
+            return *entry;
+        }
+    }
+    std::unique_ptr<Entry> entry(new Entry);
+    entry->name = name;
+    entry->help = help;
+    entry->labels = labels;
+    entry->type = type;
+    _entries.push_back(std::move(entry));
+    return *_entries.back();
+}
+
+Counter &Metrics::GetCounter(const QString &name, const QString &help, const QString &labels)
+{
+    Entry& entry = Find(name, help, labels, TypeCounter);
+    QMutexLocker locker(&_mutex);
+    if (!entry.counter) {
+        entry.counter.reset(new Counter);
+    }
+    return *entry.counter;
+}
+
+Gauge &Metrics::GetGauge(const QString &name, const QString &help, const QString &labels)
+{
+    Entry& entry = Find(name, help, labels, TypeGauge);
+    QMutexLocker locker(&_mutex);
+    if (!entry.gauge) {
+        entry.gauge.reset(new Gauge);
+    }
+    return *entry.gauge;
+}
+
+Histogram &Metrics::GetHistogram(const QString &name, const QString &help, const QString &labels)
+{
+    Entry& entry = Find(name, help, labels, TypeHistogram);
+    QMutexLocker locker(&_mutex);
+    if (!entry.histogram) {
+        entry.histogram.reset(new Histogram);
+    }
+    return *entry.histogram;
+}
+
+void Metrics::RegisterCallback(const QString &name, const QString &help, Type type,
+                               std::function<double ()> read, const QString &labels)
+{
+    Entry& entry = Find(name, help, labels, type);
+    QMutexLocker locker(&_mutex);
+    entry.read = std::move(read);
+}
+
+QVector<Metrics::Sample> Metrics::Collect() const
+{
+    QMutexLocker locker(&_mutex);
+    QVector<Sample> samples;
+    samples.reserve(int(_entries.size()));
+    for (const auto& entry : _entries) {
+        Sample sample;
+        sample.name = entry->name;
+        sample.labels = entry->labels;
+        sample.type = entry->type;
+        if (entry->read) {
+            sample.value = entry->read();
+        } else if (entry->counter) {
+            sample.value = double(entry->counter->Value());
+        } else if (entry->gauge) {
+            sample.value = double(entry->gauge->Value());
+        } else if (entry->histogram) {
+            sample.hist = entry->histogram->Take();
+        }
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+QByteArray Metrics::PrometheusText() const
+{
+    QMutexLocker locker(&_mutex);
+
+    QVector<qint64> bounds;
+    for (double bound : EXPORT_BOUNDS) {
+        bounds.push_back(qint64(bound * 1e6));
+    }
+
+    QByteArray text;
+    QSet<QString> written;
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        const QString& name = _entries[i]->name;
+        if (written.contains(name)) {
+            continue;
+        }
+        written.insert(name);
+
+        const Type type = _entries[i]->type;
+        QString help = _entries[i]->help;
+        help.replace('\\', "\\\\").replace('\n', "\\n");
+        const char* typeName = type == TypeCounter ? "counter" : type == TypeGauge ? "gauge" : "histogram";
+        text += "# HELP " + name.toUtf8() + ' ' + help.toUtf8() + '\n';
+        text += "# TYPE " + name.toUtf8() + ' ' + typeName + '\n';
+
+        // 同名不同标签的指标写在同一组
+        for (size_t j = i; j < _entries.size(); ++j) {
+            const Entry& entry = *_entries[j];
+            if (entry.name != name) {
+                continue;
+            }
+            const QByteArray metric = name.toUtf8();
+            if (entry.histogram) {
+                quint64 total = 0;
+                const QVector<quint64> cumulative = entry.histogram->Cumulative(bounds, total);
+                for (int b = 0; b < bounds.size(); ++b) {
+                    text += metric + "_bucket" + Labels(entry.labels, "le=\"" + Number(EXPORT_BOUNDS[b]) + '"')
+                            + ' ' + QByteArray::number(cumulative[b]) + '\n';
+                }
+                text += metric + "_bucket" + Labels(entry.labels, "le=\"+Inf\"") + ' ' + QByteArray::number(total) + '\n';
+                text += metric + "_sum" + Labels(entry.labels) + ' '
+                        + Number(double(entry.histogram->SumMicros()) / 1e6) + '\n';
+                text += metric + "_count" + Labels(entry.labels) + ' ' + QByteArray::number(total) + '\n';
+            } else {
+                double value = 0;
+                if (entry.read) {
+                    value = entry.read();
+                } else if (entry.counter) {
+                    value = double(entry.counter->Value());
+                } else if (entry.gauge) {
+                    value = double(entry.gauge->Value());
+                }
+                text += metric + Labels(entry.labels) + ' ' + Number(value) + '\n';
+            }
+        }
+    }
+    return text;
+}
@@ -0,0 +1,167 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 进程内指标（计数器、瞬时值、延迟直方图）
+ * 指标在第一次使用时注册（加锁），注册后对象地址不变，调用方保存引用；
+ * 之后的更新只有 relaxed 原子操作，不加锁。
+ * 导出为 Prometheus 文本格式（见 MetricsServer），诊断面板直接读取快照。
+ *
+ * 常见用法：
+ *     static Counter& frames = Metrics::Instance().GetCounter("cv_frames_captured_total", "...");
+ *     frames.Inc();
+ */
+
+// 单调递增计数器
+class Counter
+{
+public:
+    void Inc(quint64 n = 1) { _value.fetch_add(n, std::memory_order_relaxed); }
+    quint64 Value() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> _value{0};
+};
+
+// 瞬时值（队列长度等）
+class Gauge
+{
+public:
+    void Set(qint64 value) { _value.store(value, std::memory_order_relaxed); }
+    void Add(qint64 delta) { _value.fetch_add(delta, std::memory_order_relaxed); }
+    qint64 Value() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> _value{0};
+};
+
+/**
+ * @brief HDR 风格的延迟直方图（单位微秒）
+ * 小于 128 µs 的值精确计数；更大的值按 2 的幂分段，每段再等分 64 个桶，
+ * 相对误差不超过 1/64（约 1.6%），最大可记录约 38 小时（更大的值计入最后一个桶）。
+ * 每个桶一个原子计数器，记录只需一次桶下标计算和三次 fetch_add。
+ */
+class Histogram
+{
+public:
+    // 分位数等统计（单位微秒）
+    struct Snapshot
+    {
+        quint64 count = 0;
+        double sum = 0;
+        double max = 0;
+        double p50 = 0;
+        double p90 = 0;
+        double p99 = 0;
+        double p999 = 0;
+    };
+
+    Histogram();
+
+    // 记录一个值（微秒），负值按 0 记录
+    void Record(qint64 micros);
+    void RecordMs(double ms) { Record(qint64(ms * 1000.0 + 0.5)); }
+
+    quint64 Count() const { return _count.load(std::memory_order_relaxed); }
+    quint64 SumMicros() const { return _sum.load(std::memory_order_relaxed); }
+    Snapshot Take() const;
+
+    /**
+     * @brief 各上界（微秒，升序）以下的累计记录数，用于 Prometheus 的 le 桶
+     * 以 HDR 桶的上界判断，边界附近的误差与桶宽一致
+     * @param total 输出全部桶的记录数（与累计值来自同一次读取）
+     */
+    QVector<quint64> Cumulative(const QVector<qint64>& bounds, quint64& total) const;
+
+    // 下标与桶值互转
+    static int BucketOf(quint64 micros);
+    static quint64 LowerBound(int bucket);
+    static quint64 UpperBound(int bucket);
+
+    static const int SUB_BUCKET_BITS = 7;   // 每段 128 个值
+    static const int BUCKET_COUNT = 128 + 30 * 64;
+
+private:
+    std::unique_ptr<std::atomic<quint64>[]> _buckets;
+    std::atomic<quint64> _count{0};
+    std::atomic<quint64> _sum{0};
+    std::atomic<quint64> _max{0};
+};
+
+class Metrics
+{
+public:
+    enum Type { TypeCounter, TypeGauge, TypeHistogram };
+
+    // 快照中的一项，诊断面板使用
+    struct Sample
+    {
+        QString name;
+        QString labels;             // 形如 reason="busy"，没有时为空
+        Type type;
+        double value = 0;           // 计数器与瞬时值
+        Histogram::Snapshot hist;   // 直方图
+    };
+
+    // 获取全局唯一实例（线程安全）
+    static Metrics& Instance();
+
+    /**
+     * @brief 取得（必要时注册）指标，相同名称与标签返回同一对象
+     * @param name 指标名称，遵循 Prometheus 命名（小写、下划线、计数器以 _total 结尾）
+     * @param help 说明
+     * @param labels 标签，形如 reason="busy"，可为空
+     */
+    Counter& GetCounter(const QString& name, const QString& help, const QString& labels = QString());
+    Gauge& GetGauge(const QString& name, const QString& help, const QString& labels = QString());
+
+    // 直方图以微秒记录，导出时换算为秒（名称应以 _seconds 结尾）
+    Histogram& GetHistogram(const QString& name, const QString& help, const QString& labels = QString());
+
+    /**
+     * @brief 注册一个导出时才读取的值（例如结果缓存的命中数）
+     * 回调在注册表的锁内调用，不能再注册指标
+     * @param type TypeCounter 或 TypeGauge
+     */
+    void RegisterCallback(const QString& name, const QString& help, Type type,
+                          std::function<double()> read, const QString& labels = QString());
+
+    // 全部指标的当前值
+    QVector<Sample> Collect() const;
+
+    // Prometheus 文本格式（version 0.0.4）
+    QByteArray PrometheusText() const;
+
+private:
+    Metrics();
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    struct Entry
+    {
+        QString name;
+        QString help;
+        QString labels;
+        Type type;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+        std::function<double()> read;
+    };
+
+    Entry& Find(const QString& name, const QString& help, const QString& labels, Type type);
+
+    mutable QMutex _mutex;
+    std::vector<std::unique_ptr<Entry>> _entries;   // 注册顺序，同名指标相邻导出
+};
+
+#endif // METRICS_H
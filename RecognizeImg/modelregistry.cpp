@@ -0,0 +1,335 @@
+#include "modelregistry.h"
+#include "inference.h"
+#include "recognizeimgthread.h"
+#include "metrics.h"
+#include "tracer.h"
+#include "threadtuning.h"
+#include <QCollator>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QtDebug>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+const char* const MODEL_FILE = "best.onnx";
+const char* const LABEL_FILE = "class_names.txt";
+const char* const CURRENT_FILE = "current";
+const int RETRY_INITIAL_MS = 1000;   // 加载失败后第一次重试的间隔，之后逐次加倍
+const int RETRY_MAX_MS = 60000;      // 超过后不再定时重试，等待目录变化
+
+std::atomic<int> g_aliveBundles{0};
+
+} // namespace
+
+ModelBundle::ModelBundle()
+{
+    g_aliveBundles.fetch_add(1, std::memory_order_relaxed);
+}
+
+ModelBundle::~ModelBundle()
+{
+    g_aliveBundles.fetch_sub(1, std::memory_order_relaxed);
+}
+
+int ModelBundle::Alive()
+{
+    return g_aliveBundles.load(std::memory_order_relaxed);
+}
+
+ModelRegistry &ModelRegistry::Instance()
+{
+    static ModelRegistry instance;
+    return instance;
+}
+
+ModelRegistry::ModelRegistry()
+    : _watcher(this), _reloadTimer(this), _retryTimer(this)
+{
+    // 第一次访问可能来自线程池（SetFallback），定时器与目录监视须在界面线程
+    if (QCoreApplication::instance()) {
+        moveToThread(QCoreApplication::instance()->thread());
+    }
+
+    _reloadTimer.setSingleShot(true);
+    _reloadTimer.setInterval(500);
+    connect(&_reloadTimer, &QTimer::timeout, this, &ModelRegistry::Reload);
+    _retryTimer.setSingleShot(true);
+    connect(&_retryTimer, &QTimer::timeout, this, &ModelRegistry::Reload);
+    connect(&_watcher, &QFileSystemWatcher::directoryChanged, &_reloadTimer, QOverload<>::of(&QTimer::start));
+    connect(&_watcher, &QFileSystemWatcher::fileChanged, &_reloadTimer, QOverload<>::of(&QTimer::start));
+
+    Metrics::Instance().RegisterCallback("cv_model_bundles_alive", "Model versions still referenced (current plus ones draining).",
+                                         Metrics::TypeGauge, []() { return double(ModelBundle::Alive()); });
+}
+
+QString ModelRegistry::DefaultRoot()
+{
+    const QString fromEnv = qEnvironmentVariable("CV_MODEL_DIR");
+    if (!fromEnv.isEmpty()) {
+        return fromEnv;
+    }
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/models";
+}
+
+void ModelRegistry::SetFallback(const QString &modelPath, const QString &labelPath)
+{
+    auto bundle = std::make_shared<ModelBundle>();
+    bundle->version = "builtin";
+    bundle->modelPath = modelPath;
+    bundle->labelPath = labelPath;
+    bundle->classNames = RecognizeImgThread::readLabels(labelPath.toStdString());
+
+    QMutexLocker locker(&_mutex);
+    // 外部版本已经生效时不再回退
+    if (!_current || _current->version == "builtin") {
+        _current = bundle;
+    }
+}
+
+std::shared_ptr<const ModelBundle> ModelRegistry::Current() const
+{
+    QMutexLocker locker(&_mutex);
+    return _current;
+}
+
+void ModelRegistry::Shutdown()
+{
+    std::shared_ptr<const ModelBundle> previous;
+    {
+        QMutexLocker locker(&_mutex);
+        _shutdown = true;
+        while (_loadRunning) {
+            _loadFinished.wait(&_mutex);
+        }
+        previous = std::move(_current);
+        _current.reset();
+    }
+    _reloadTimer.stop();
+    _retryTimer.stop();
+}
+
+void ModelRegistry::Start(const QString &root)
+{
+    _root = root;
+    QDir().mkpath(_root);
+    WatchPaths();
+    Reload();
+}
+
+void ModelRegistry::WatchPaths()
+{
+    if (!_watcher.directories().isEmpty()) {
+        _watcher.removePaths(_watcher.directories());
+    }
+    if (!_watcher.files().isEmpty()) {
+        _watcher.removePaths(_watcher.files());
+    }
+    // 根目录（新增版本、current 被替换）、current 文件本身（原地改写）
+    // 以及各版本目录（复制过程中文件陆续出现）
+    QDir root(_root);
+    _watcher.addPath(_root);
+    const QString currentFile = root.filePath(CURRENT_FILE);
+    if (QFile::exists(currentFile)) {
+        _watcher.addPath(currentFile);
+    }
+    for (const QString& version : root.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        _watcher.addPath(root.filePath(version));
+    }
+}
+
+QString ModelRegistry::Signature(const QString &version) const
+{
+    QDir dir(QDir(_root).filePath(version));
+    QString signature;
+    for (const char* name : {MODEL_FILE, LABEL_FILE}) {
+        const QFileInfo info(dir.filePath(name));
+        signature += QString("%1:%2;").arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch());
+    }
+    return signature;
+}
+
+void ModelRegistry::ScheduleRetry()
+{
+    if (_retryDelayMs >= RETRY_MAX_MS) {
+        return;
+    }
+    _retryDelayMs = _retryDelayMs ? qMin(_retryDelayMs * 2, RETRY_MAX_MS) : RETRY_INITIAL_MS;
+    _retryTimer.start(_retryDelayMs);
+}
+
+QString ModelRegistry::SelectVersion() const
+{
+    QDir root(_root);
+    auto complete = [&root](const QString& version) {
+        return !version.isEmpty() && QFile::exists(root.filePath(version + "/" + MODEL_FILE))
+               && QFile::exists(root.filePath(version + "/" + LABEL_FILE));
+    };
+
+    QFile currentFile(root.filePath(CURRENT_FILE));
+    if (currentFile.open(QIODevice::ReadOnly)) {
+        const QString pinned = QString::fromUtf8(currentFile.readAll()).trimmed();
+        if (complete(pinned)) {
+            return pinned;
+        }
+        if (!pinned.isEmpty()) {
+            qWarning() << "[ModelRegistry] pinned version is incomplete:" << pinned;
+        }
+    }
+
+    // 按自然顺序取最大的完整版本（v10 排在 v9 之后）
+    QStringList versions = root.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    QCollator collator;
+    collator.setNumericMode(true);
+    std::sort(versions.begin(), versions.end(), collator);
+    for (int i = versions.size() - 1; i >= 0; --i) {
+        if (complete(versions[i])) {
+            return versions[i];
+        }
+    }
+    return QString();
+}
+
+void ModelRegistry::Reload()
+{
+    WatchPaths();
+    if (_loading) {
+        _reloadPending = true;
+        return;
+    }
+    const QString version = SelectVersion();
+    const std::shared_ptr<const ModelBundle> current = Current();
+    if (version.isEmpty() || (current && current->version == version)) {
+        _retryTimer.stop();
+        _retryDelayMs = 0;
+        return;
+    }
+    if (version == _failedVersion) {
+        if (Signature(version) == _failedSignature) {
+            // 失败后文件没有变化，暂不重新加载；间隔逐次加倍，到上限后只等目录变化
+            ScheduleRetry();
+            return;
+        }
+        // 文件仍在变化（多半还在复制），从最短间隔重新开始
+        _retryDelayMs = 0;
+    }
+    LoadAsync(version);
+}
+
+void ModelRegistry::LoadAsync(const QString &version)
+{
+    {
+        QMutexLocker locker(&_mutex);
+        if (_shutdown) {
+            return;
+        }
+        _loadRunning = true;
+    }
+    _loading = true;
+    _retryTimer.stop();
+    const QString dirPath = QDir(_root).filePath(version);
+    // 加载前记录签名：加载期间文件若又变化，下次重试会重新加载
+    const QString signature = Signature(version);
+    QThreadPool::globalInstance()->start([this, version, dirPath, signature]() {
+        static Metrics& metrics = Metrics::Instance();
+        static Counter& swapped = metrics.GetCounter("cv_model_swaps_total", "Model hot-swap attempts, by outcome.", "outcome=\"swapped\"");
+        static Counter& failed = metrics.GetCounter("cv_model_swaps_total", "Model hot-swap attempts, by outcome.", "outcome=\"failed\"");
+
+        QString error;
+        std::shared_ptr<const ModelBundle> bundle = Load(version, dirPath, error);
+        if (bundle) {
+            swapped.Inc();
+        } else {
+            failed.Inc();
+        }
+        {
+            QMutexLocker locker(&_mutex);
+            _loadRunning = false;
+            _loadFinished.wakeAll();
+            if (_shutdown) {
+                return;   // 正在退出，新版本随 bundle 在此释放
+            }
+        }
+        // 替换与后续扫描回到界面线程进行
+        QMetaObject::invokeMethod(this, [this, version, signature, bundle, error]() {
+            _loading = false;
+            if (bundle) {
+                _failedVersion.clear();
+                _retryDelayMs = 0;
+                Swap(bundle);
+            } else {
+                qWarning() << "[ModelRegistry] cannot load version" << version << ":" << error;
+                _failedVersion = version;
+                _failedSignature = signature;
+                ScheduleRetry();
+                emit modelLoadFailed(version, error);
+            }
+            if (_reloadPending) {
+                _reloadPending = false;
+                Reload();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ModelRegistry::Swap(std::shared_ptr<const ModelBundle> bundle)
+{
+    std::shared_ptr<const ModelBundle> previous;
+    {
+        QMutexLocker locker(&_mutex);
+        if (_shutdown) {
+            return;
+        }
+        previous = _current;
+        _current = bundle;
+    }
+    qInfo() << "[ModelRegistry] switched to version" << bundle->version
+            << (previous ? QString("(was %1)").arg(previous->version) : QString());
+    emit modelChanged(bundle->version);
+    // previous 在此释放本处的引用；仍在进行的请求持有它直到结束
+}
+
+std::shared_ptr<const ModelBundle> ModelRegistry::Load(const QString &version, const QString &dirPath, QString &error)
+{
+    TRACE_SCOPE("model.load");
+    QDir dir(dirPath);
+    auto bundle = std::make_shared<ModelBundle>();
+    bundle->version = version;
+    bundle->modelPath = QFileInfo(dir.filePath(MODEL_FILE)).absoluteFilePath();
+    bundle->labelPath = QFileInfo(dir.filePath(LABEL_FILE)).absoluteFilePath();
+    bundle->classNames = RecognizeImgThread::readLabels(bundle->labelPath.toStdString());
+    if (bundle->classNames.empty()) {
+        error = "empty label file";
+        return nullptr;
+    }
+
+    // 参数与 RecognizeImgThread 一致，替换后的识别直接复用这个已预热的会话
+    std::shared_ptr<YOLO_V8> yolo = std::make_shared<YOLO_V8>();
+    DL_INIT_PARAM params;
+    params.modelPath = bundle->modelPath.toStdString();
+    params.imgSize = {640, 640};
+    params.modelType = YOLO_CLS;
+    params.cudaEnable = false;
+    ThreadTuning::Instance().Apply(params);
+    params.logSeverityLevel = 3;
+    const char* ret = yolo->CreateSession(params);
+    if (ret != RET_OK) {
+        error = QString(ret);
+        return nullptr;
+    }
+    // 标签表必须与模型匹配，否则宁可继续使用旧版本
+    if (yolo->ClassCount() > 0 && yolo->ClassCount() != int(bundle->classNames.size())) {
+        error = QString("model has %1 classes but label file has %2")
+                    .arg(yolo->ClassCount()).arg(bundle->classNames.size());
+        return nullptr;
+    }
+    bundle->session = yolo;
+    return bundle;
+}
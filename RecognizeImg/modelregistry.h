@@ -0,0 +1,120 @@
+#ifndef MODELREGISTRY_H
+#define MODELREGISTRY_H
+
+#include <QFileSystemWatcher>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QWaitCondition>
+#include <memory>
+#include <string>
+#include <vector>
+
+class YOLO_V8;
+
+/**
+ * @brief 一个版本的模型：模型文件与标签表总是一起发布、一起替换
+ * 创建后不再修改，可以在多个线程间共享。
+ */
+struct ModelBundle
+{
+    QString version;                        // 版本目录名，内置模型为 "builtin"
+    QString modelPath;                      // best.onnx
+    QString labelPath;                      // class_names.txt
+    std::vector<std::string> classNames;    // 与模型同时读取的标签表
+    std::shared_ptr<YOLO_V8> session;       // 预热好的共享会话（SHARE_SESSION），可能为空
+
+    ModelBundle();
+    ~ModelBundle();
+
+    // 存活的 ModelBundle 数量（替换后旧版本在所有请求结束时释放）
+    static int Alive();
+};
+
+/**
+ * @brief 可热替换的分类模型（RCU 方式）
+ * 外部模型目录按版本存放：
+ *     <root>/<version>/best.onnx
+ *     <root>/<version>/class_names.txt
+ *     <root>/current            （可选）文本文件，内容为要使用的版本名；没有时取名称最大的完整版本
+ * 目录变化后在后台加载新版本：读取标签、创建并预热会话、检查类别数与标签数一致，
+ * 全部通过后一次性替换 Current()。请求开始时取得 Current() 并持有到结束，
+ * 替换不影响进行中的请求；旧版本在最后一个持有者释放时销毁（会话随之释放）。
+ * 加载失败时保留当前版本，并按指数退避重试（版本目录可能还在复制中）；
+ * 失败后文件一直没有变化时停止重试，直到目录再次变化。没有外部模型时使用内置模型（SetFallback）。
+ * 实例归属界面线程，可在任意线程调用 Current() / SetFallback()。
+ */
+class ModelRegistry : public QObject
+{
+    Q_OBJECT
+public:
+    // 获取全局唯一实例（线程安全）
+    static ModelRegistry& Instance();
+
+    // 外部模型目录：环境变量 CV_MODEL_DIR，默认 <AppDataLocation>/models
+    static QString DefaultRoot();
+
+    /**
+     * @brief 设置内置模型（已解压到磁盘），在外部模型可用前作为当前版本
+     * 只读取标签，不创建会话
+     */
+    void SetFallback(const QString& modelPath, const QString& labelPath);
+
+    /**
+     * @brief 开始监视外部模型目录并加载其中的当前版本（后台进行）
+     * 须在界面线程（或有事件循环的线程）调用
+     */
+    void Start(const QString& root = DefaultRoot());
+
+    // 重新扫描外部模型目录（有新版本时后台加载并替换）
+    void Reload();
+
+    // 退出前调用：等待进行中的加载结束并释放全部版本（须早于 ONNX Runtime 的静态对象析构）
+    void Shutdown();
+
+    // 当前版本，可能为空（内置模型尚未就绪）；调用方持有期间不会被释放
+    std::shared_ptr<const ModelBundle> Current() const;
+
+    QString Root() const { return _root; }
+
+signals:
+    // 已切换到新版本（在 ModelRegistry 所在线程发出）
+    void modelChanged(const QString& version);
+    // 新版本加载失败，仍使用原版本
+    void modelLoadFailed(const QString& version, const QString& errorMsg);
+
+private:
+    ModelRegistry();
+    ModelRegistry(const ModelRegistry&) = delete;
+    ModelRegistry& operator=(const ModelRegistry&) = delete;
+
+    // 选出应使用的版本目录名，没有可用版本时返回空
+    QString SelectVersion() const;
+    void LoadAsync(const QString& version);
+    void Swap(std::shared_ptr<const ModelBundle> bundle);
+    void WatchPaths();
+    void ScheduleRetry();
+    // 版本目录中模型与标签文件的大小和修改时间，用于判断失败后文件是否变化
+    QString Signature(const QString& version) const;
+
+    // 读取并检查一个版本，失败时返回空并写入 error（在线程池中调用）
+    static std::shared_ptr<const ModelBundle> Load(const QString& version, const QString& dirPath, QString& error);
+
+    mutable QMutex _mutex;
+    QWaitCondition _loadFinished;
+    std::shared_ptr<const ModelBundle> _current;
+    bool _loadRunning = false;  // 线程池中的加载尚未结束（受 _mutex 保护）
+    bool _shutdown = false;
+    QString _root;
+    QFileSystemWatcher _watcher;
+    QTimer _reloadTimer;        // 合并短时间内的多次目录变化
+    QTimer _retryTimer;         // 加载失败后的重试
+    bool _loading = false;      // 后台加载进行中（只在界面线程读写）
+    bool _reloadPending = false;
+    int _retryDelayMs = 0;      // 当前重试间隔，0 表示未在重试
+    QString _failedVersion;     // 最近一次加载失败的版本及其当时的文件签名
+    QString _failedSignature;
+};
+
+#endif // MODELREGISTRY_H
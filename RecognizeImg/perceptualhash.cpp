@@ -0,0 +1,80 @@
+#include "perceptualhash.h"
+#include <QFile>
+#include <algorithm>
+
+namespace PerceptualHash {
+
+namespace {
+
+quint64 ComputeDHash(const cv::Mat& gray)
+{
+    cv::Mat small;
+    cv::resize(gray, small, cv::Size(9, 8), 0, 0, cv::INTER_AREA);
+
+    // 每行 8 次比较：左侧像素比右侧亮则置 1
+    quint64 hash = 0;
+    for (int y = 0; y < 8; ++y) {
+        const uchar* row = small.ptr<uchar>(y);
+        for (int x = 0; x < 8; ++x) {
+            hash = (hash << 1) | (row[x] > row[x + 1] ? 1u : 0u);
+        }
+    }
+    return hash;
+}
+
+quint64 ComputePHash(const cv::Mat& gray)
+{
+    cv::Mat small, small_f, freq;
+    cv::resize(gray, small, cv::Size(32, 32), 0, 0, cv::INTER_AREA);
+    small.convertTo(small_f, CV_32F);
+    cv::dct(small_f, freq);
+
+    // 取左上角 8x8 低频系数（跳过直流分量参与中值计算）
+    float coeffs[64];
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            coeffs[y * 8 + x] = freq.at<float>(y, x);
+        }
+    }
+    float sorted[63];
+    std::copy(coeffs + 1, coeffs + 64, sorted);
+    std::nth_element(sorted, sorted + 31, sorted + 63);
+    const float median = sorted[31];
+
+    quint64 hash = 0;
+    for (int i = 0; i < 64; ++i) {
+        hash = (hash << 1) | (coeffs[i] > median ? 1u : 0u);
+    }
+    return hash;
+}
+
+} // namespace
+
+quint64 Compute(const cv::Mat &gray, HashType type)
+{
+    return type == DHash ? ComputeDHash(gray) : ComputePHash(gray);
+}
+
+bool HashFile(const QString &path, HashType type, quint64 &hash)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray content = file.readAll();
+    file.close();
+
+    // 哈希只需要极小的灰度图：按 1/8 分辨率解码，JPEG 可直接在 DCT 域缩小
+    cv::Mat raw(1, content.size(), CV_8UC1, content.data());
+    cv::Mat gray = cv::imdecode(raw, cv::IMREAD_REDUCED_GRAYSCALE_8);
+    if (gray.empty() || gray.cols < 9 || gray.rows < 8) {
+        gray = cv::imdecode(raw, cv::IMREAD_GRAYSCALE);
+    }
+    if (gray.empty()) {
+        return false;
+    }
+    hash = Compute(gray, type);
+    return true;
+}
+
+} // namespace PerceptualHash
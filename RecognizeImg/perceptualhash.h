@@ -0,0 +1,31 @@
+#ifndef PERCEPTUALHASH_H
+#define PERCEPTUALHASH_H
+
+#include <QString>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief 感知哈希
+ * 同一作品的连拍、重新导出、轻微缩放或压缩后得到的哈希只相差少数几位，
+ * 可用汉明距离判断近似重复
+ */
+namespace PerceptualHash {
+
+enum HashType
+{
+    DHash = 1,  // 差异哈希：9x8 灰度图相邻像素比较，速度最快
+    PHash = 2,  // 感知哈希：32x32 DCT 低频 8x8 与中值比较，对亮度/压缩更稳健
+};
+
+// 由灰度图计算 64 位哈希
+quint64 Compute(const cv::Mat& gray, HashType type);
+
+/**
+ * @brief 读取图片并计算哈希，JPEG 以 1/8 分辨率解码以减少开销
+ * @return 无法解码时返回 false
+ */
+bool HashFile(const QString& path, HashType type, quint64& hash);
+
+} // namespace PerceptualHash
+
+#endif // PERCEPTUALHASH_H
@@ -0,0 +1,81 @@
+# ---------------- 推理核心（GUI 与命令行工具共用） ----------------
+# 使用方式：include($$PWD/../RecognizeImg/recognizeimg.pri)
+
+SOURCES += \
+    $$PWD/inference.cpp \
+    $$PWD/recognizeimgthread.cpp \
+    $$PWD/resultcache.cpp \
+    $$PWD/embeddingindex.cpp \
+    $$PWD/batchrecognizethread.cpp \
+    $$PWD/perceptualhash.cpp \
+    $$PWD/tracer.cpp \
+    $$PWD/metrics.cpp \
+    $$PWD/memorystats.cpp \
+    $$PWD/inferencescheduler.cpp \
+    $$PWD/modelregistry.cpp \
+    $$PWD/threadtuning.cpp
+
+HEADERS += \
+    $$PWD/inference.h \
+    $$PWD/recognizeimgthread.h \
+    $$PWD/resultcache.h \
+    $$PWD/contenthash.h \
+    $$PWD/simdutil.h \
+    $$PWD/embeddingindex.h \
+    $$PWD/batchrecognizethread.h \
+    $$PWD/perceptualhash.h \
+    $$PWD/bktree.h \
+    $$PWD/tracer.h \
+    $$PWD/metrics.h \
+    $$PWD/memorystats.h \
+    $$PWD/inferencescheduler.h \
+    $$PWD/workerprotocol.h \
+    $$PWD/modelregistry.h \
+    $$PWD/threadtuning.h
+
+INCLUDEPATH += $$PWD
+
+# 分阶段计时（Tracer），默认编译进来、运行时关闭；qmake CONFIG+=no_trace 完全去掉
+!contains(CONFIG, no_trace): DEFINES += CV_TRACE
+# 堆分配计数（替换全局 operator new/delete），只在 CONFIG += memstats 的目标（Regression、Benchmark）中开启
+contains(CONFIG, memstats): DEFINES += CV_MEMSTATS
+
+win32 {
+    # ---------------- OpenCV 配置 ----------------
+    # Windows Release 版本
+    CONFIG(release, debug|release): LIBS += -LE:/opencv/build/x64/vc16/lib/ -lopencv_world490
+    # Windows Debug 版本
+    else:CONFIG(debug, debug|release): LIBS += -LE:/opencv/build/x64/vc16/lib/ -lopencv_world490d
+
+    # OpenCV 包含路径和依赖路径
+    INCLUDEPATH += E:/opencv/build/include \
+                   E:/opencv/build/include/opencv2
+
+    DEPENDPATH += E:/opencv/build/include \
+                  E:/opencv/build/include/opencv2
+
+    # ---------------- ONNX Runtime 配置 ----------------
+    LIBS += -LE:/onnxruntime/onnxruntime-win-x64-1.16.0/lib/ -lonnxruntime
+
+    # 进程内存信息（GetProcessMemoryInfo）
+    LIBS += -lpsapi
+
+    # ONNX Runtime 包含路径和依赖路径
+    INCLUDEPATH += E:/onnxruntime/onnxruntime-win-x64-1.16.0/include
+    DEPENDPATH += E:/onnxruntime/onnxruntime-win-x64-1.16.0/include
+}
+
+unix {
+    # ---------------- OpenCV 配置 ----------------
+    # 通过 pkg-config 查找系统安装的 OpenCV 4
+    CONFIG += link_pkgconfig
+    PKGCONFIG += opencv4
+
+    # ---------------- ONNX Runtime 配置 ----------------
+    # 默认使用 /opt/onnxruntime，可通过 qmake ONNXRUNTIME_DIR=/path 覆盖
+    isEmpty(ONNXRUNTIME_DIR): ONNXRUNTIME_DIR = /opt/onnxruntime
+    INCLUDEPATH += $$ONNXRUNTIME_DIR/include
+    DEPENDPATH += $$ONNXRUNTIME_DIR/include
+    LIBS += -L$$ONNXRUNTIME_DIR/lib -lonnxruntime
+    QMAKE_RPATHDIR += $$ONNXRUNTIME_DIR/lib
+}
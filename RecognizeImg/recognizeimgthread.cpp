@@ -1,4 +1,13 @@
 #include "recognizeimgthread.h"
+#include "resultcache.h"
+#include "embeddingindex.h"
+#include "const.h"
+#include "tracer.h"
+#include "threadtuning.h"
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 
 RecognizeImgThread::RecognizeImgThread(QString _img_path, QString _label_path, QString _model_path, QObject *parent) :
     _img_path(_img_path), _label_path(_label_path), _model_path(_model_path), QThread(parent)
@@ -6,13 +15,122 @@ RecognizeImgThread::RecognizeImgThread(QString _img_path, QString _label_path, Q
 
 }
 
+void RecognizeImgThread::SetIndexEmbedding(bool enable)
+{
+    _index_embedding = enable;
+}
+
+void RecognizeImgThread::SetPriority(InferenceScheduler::Priority priority, qint64 deadlineNs)
+{
+    _priority = priority;
+    _deadline_ns = deadlineNs;
+}
+
+void RecognizeImgThread::SetModelBundle(std::shared_ptr<const ModelBundle> bundle)
+{
+    if (!bundle) {
+        return;
+    }
+    _bundle = std::move(bundle);
+    _label_path = _bundle->labelPath;
+    _model_path = _bundle->modelPath;
+}
+
 void RecognizeImgThread::run()
 {
-    std::vector<std::string> classNames = readLabels(_label_path.toStdString()); // 加载类别标签
-    cv::Mat image = cv::imread(_img_path.toStdString()); // 加载待识别图片
+    // 标签与模型来自同一版本；版本已带标签时不再读盘
+    std::vector<std::string> classNames = _bundle ? _bundle->classNames
+                                                  : readLabels(_label_path.toStdString()); // 加载类别标签
+
+    // 读取图片原始字节，用于计算缓存键（解码前即可判断是否命中）
+    TRACE_BEGIN(read_file, "recognize.read_file");
+    QFile file(_img_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        emit SigRecognizeFail(QString("Cannot open image: %1").arg(_img_path));
+        return;
+    }
+    QByteArray content = file.readAll();
+    file.close();
+    TRACE_END(read_file);
+
+    ResultCache& cache = ResultCache::Instance();
+    _model_id = cache.ModelId(_model_path);
+    _cache_key = ResultCache::MakeKey(content, _model_id);
+
+    // 特征索引按模型分开，新旧模型同时识别时各自写入自己的索引
+    bool need_embedding = false;
+    if (_index_embedding) {
+        const EmbeddingIndex& index = EmbeddingIndex::ForModel(_model_id);
+        // 模型没有特征向量输出时索引永远不会有这张图，不能因此放弃缓存结果
+        need_embedding = ModelHasEmbedding(_model_path, _model_id) && !index.Contains(_img_path);
+    }
+
+    ResultCache::Entry entry;
+    TRACE_BEGIN(lookup, "recognize.cache_lookup");
+    const bool hit = !need_embedding && _priority != InferenceScheduler::Live
+                     && cache.Lookup(_model_id, _cache_key, entry);
+    TRACE_END(lookup);
+    if (hit) {
+        // 命中缓存，跳过解码与推理
+        emit SigRecognizeFinish(ClassName(classNames, entry.classId), entry.confidence, _model_id);
+        return;
+    }
+
+    // 直接从内存解码，避免再次读盘
+    TRACE_BEGIN(decode, "recognize.decode");
+    cv::Mat image = cv::imdecode(cv::Mat(1, content.size(), CV_8UC1, content.data()), cv::IMREAD_COLOR);
+    if (image.empty()) {
+        emit SigRecognizeFail(QString("Cannot decode image: %1").arg(_img_path));
+        return;
+    }
+    TRACE_END(decode);
     RecognizeImg(classNames, image, _model_path); // 识别
 }
 
+bool RecognizeImgThread::ModelHasEmbedding(const QString &modelPath, quint64 modelId)
+{
+    static QMutex mutex;
+    static QHash<quint64, bool> known;
+    {
+        QMutexLocker locker(&mutex);
+        auto it = known.constFind(modelId);
+        if (it != known.constEnd()) {
+            return it.value();
+        }
+    }
+
+    // 参数与识别时一致，共享会话已存在时直接复用，不会再次加载模型
+    TRACE_SCOPE("recognize.probe_embedding");
+    try {
+        YOLO_V8 yolo;
+        DL_INIT_PARAM params;
+        params.modelPath = modelPath.toStdString();
+        params.imgSize = {640, 640};
+        params.modelType = YOLO_CLS;
+        params.cudaEnable = false;
+        ThreadTuning::Instance().Apply(params);
+        params.logSeverityLevel = 3;
+        params.embeddingOutputName = EMBEDDING_OUTPUT_NAME;
+        if (yolo.CreateSession(params) != RET_OK) {
+            return false;   // 加载失败不记录，之后的识别同样会报错
+        }
+        const bool has = yolo.SupportsEmbedding();
+        QMutexLocker locker(&mutex);
+        known.insert(modelId, has);
+        return has;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+QString RecognizeImgThread::ClassName(const std::vector<std::string> &classNames, int classId)
+{
+    // 根据 ID 获取标签名，如果越界则提示无效
+    return (classId >= 0 && classId < (int)classNames.size())
+               ? QString::fromStdString(classNames[classId])
+               : QString("Invalid ID %1").arg(classId);
+}
+
 
 
 std::vector<std::string> RecognizeImgThread::readLabels(const std::string &labelFile)
@@ -45,11 +163,25 @@ void RecognizeImgThread::RecognizeImg(std::vector<std::string> classNames, cv::M
         params.rectConfidenceThreshold = 0.01f;        // 置信度阈值（一般对分类影响不大）
         params.iouThreshold = 0.5f;                    // IoU 阈值（主要用于检测任务，这里保留默认值）
         params.cudaEnable = false;                     // 是否启用 GPU 加速（false 表示仅使用 CPU）
-        params.intraOpNumThreads = 4;                  // 推理使用的线程数
+        ThreadTuning::Instance().Apply(params);        // 推理线程数与自旋（本机调优结果，按所选目标）
         params.logSeverityLevel = 3;                   // 日志等级（3 表示仅输出错误和警告）
+        if (_index_embedding) {
+            params.embeddingOutputName = EMBEDDING_OUTPUT_NAME; // 同时取出特征向量用于相似检索
+        }
+
+        // 等待推理槽：高优先级请求先执行，实时帧过期则放弃
+        TRACE_BEGIN(schedule, "recognize.schedule");
+        InferenceScheduler::Ticket ticket(_priority, _deadline_ns);
+        TRACE_END(schedule);
+        if (!ticket.Granted()) {
+            emit SigRecognizeFail("Deadline expired before inference started.");
+            return;
+        }
 
         // 创建模型推理会话
+        TRACE_BEGIN(create_session, "recognize.create_session");
         const char* ret = yolo.CreateSession(params);
+        TRACE_END(create_session);
         if (ret != RET_OK) {
             // 如果模型创建失败，发送信号并退出线程
             emit SigRecognizeFail(QString("CreateSession failed: %1").arg(ret));
@@ -57,7 +189,9 @@ void RecognizeImgThread::RecognizeImg(std::vector<std::string> classNames, cv::M
         }
 
         std::vector<DL_RESULT> results;
+        TRACE_BEGIN(run, "recognize.run");
         ret = yolo.RunSession(image, results);
+        TRACE_END(run);
         if (ret != RET_OK) {
             // 如果推理失败，发送失败信号
             emit SigRecognizeFail(QString("RunSession failed: %1").arg(ret));
@@ -79,12 +213,18 @@ void RecognizeImgThread::RecognizeImg(std::vector<std::string> classNames, cv::M
         int topId = results[0].classId;        // 类别 ID
         float topConf = results[0].confidence; // 置信度
 
-        // 根据 ID 获取标签名，如果越界则提示无效
-        QString className = (topId >= 0 && topId < (int)classNames.size())
-                                ? QString::fromStdString(classNames[topId])
-                                : QString("Invalid ID %1").arg(topId);
+        // 写入结果缓存，下次同一张图片直接命中；实时画面每帧都不同，写入只会挤掉有用的结果
+        if (_priority != InferenceScheduler::Live) {
+            ResultCache::Instance().Insert(_model_id, _cache_key, ResultCache::Entry{topId, topConf});
+        }
+
+        // 加入相似检索索引
+        if (_index_embedding && !results[0].embedding.empty()) {
+            EmbeddingIndex::ForModel(_model_id).Add(_img_path, results[0].embedding);
+        }
+
         // 发出结果信号
-        emit SigRecognizeFinish(className, topConf);
+        emit SigRecognizeFinish(ClassName(classNames, topId), topConf, _model_id);
     }
     catch (const std::exception &e) {
         emit SigRecognizeFail(QString("Exception: %1").arg(e.what()));
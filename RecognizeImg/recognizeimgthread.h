@@ -9,12 +9,24 @@
 #include <algorithm>  // 添加algorithm头文件
 #include <opencv2/opencv.hpp>
 #include "inference.h"
+#include "inferencescheduler.h"
+#include "modelregistry.h"
+#include <memory>
 
 class RecognizeImgThread : public QThread
 {
     Q_OBJECT
 public:
     explicit RecognizeImgThread(QString _img_path, QString _label_path, QString _model_path, QObject *parent = nullptr);
+    static std::vector<std::string> readLabels(const std::string& labelFile); // 读取标签文件（命令行工具共用）
+    void SetIndexEmbedding(bool enable); // 是否提取特征向量并加入相似检索索引（默认关闭）
+    // 推理优先级与截止时刻（Tracer::NowNs，0 表示不限），默认为用户主动触发的单张检测
+    void SetPriority(InferenceScheduler::Priority priority, qint64 deadlineNs = 0);
+    // 使用指定版本的模型与标签（ModelRegistry::Current()），识别期间持有该版本；为空时沿用构造时的路径
+    void SetModelBundle(std::shared_ptr<const ModelBundle> bundle);
+    static QString ClassName(const std::vector<std::string>& classNames, int classId); // 类别 ID 转标签名
+    // 模型是否带特征向量输出（按模型标识记录，每个模型只探测一次）；没有时不必为相似检索索引放弃缓存结果
+    static bool ModelHasEmbedding(const QString& modelPath, quint64 modelId);
 protected:
     // 线程执行函数
     virtual void run();
@@ -22,10 +34,15 @@ private:
     QString _img_path; // 待识别图片路径
     QString _label_path; // 标签文件路径
     QString _model_path; // 模型文件路径
-    std::vector<std::string> readLabels(const std::string& labelFile); // 读取标签文件
+    quint64 _model_id = 0; // 模型标识（结果缓存与特征索引按它区分模型）
+    quint64 _cache_key = 0; // 结果缓存键（图片内容哈希 + 模型标识）
+    bool _index_embedding = false; // 是否写入相似检索索引
+    InferenceScheduler::Priority _priority = InferenceScheduler::Interactive; // 推理优先级
+    qint64 _deadline_ns = 0; // 截止时刻，过期仍未开始推理则放弃
+    std::shared_ptr<const ModelBundle> _bundle; // 本次识别使用的模型版本（热替换时旧版本在此释放后销毁）
     void RecognizeImg(std::vector<std::string> classNames, cv::Mat image, QString modelPath);
 signals:
-    void SigRecognizeFinish(QString className, float confidence); // 推理完成信号
+    void SigRecognizeFinish(QString className, float confidence, quint64 modelId); // 推理完成信号（附带模型标识，用于查询该模型的相似检索索引）
     void SigRecognizeFail(QString errorMsg);                      // 出错信号
 };
 
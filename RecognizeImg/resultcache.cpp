@@ -0,0 +1,416 @@
+#include "resultcache.h"
+#include "contenthash.h"
+#include "metrics.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char DISK_MAGIC[4] = {'C', 'V', 'R', 'C'};
+const quint32 DISK_VERSION = 2;
+const quint64 DISK_INIT_CAPACITY = 4096;  // 初始槽位数（必须是 2 的幂）
+const quint64 DISK_MAX_CAPACITY = 1 << 20; // 每个模型的最大槽位数（约 24 MB），满后淘汰较久未用的一半
+const int MEMORY_CAPACITY = 2048;         // 内存 LRU 最多保存的条目数
+const int DISK_MAX_MODELS = 4;            // 最多保留几个模型的磁盘存储文件（按最近修改时间）
+
+// 磁盘文件头（64 字节）
+struct DiskHeader
+{
+    char magic[4];
+    quint32 version;
+    quint64 modelId;   // 模型内容哈希，与文件名不一致时视为损坏并重建
+    quint64 capacity;  // 槽位数
+    quint64 count;     // 已使用槽位数
+    quint64 clock;     // 访问计数，每次写入或命中加一
+    quint8 reserved[24];
+};
+
+// 磁盘记录（24 字节），key 为 0 表示空槽
+struct DiskRecord
+{
+    quint64 key;
+    qint32 classId;
+    float confidence;
+    quint64 lastUse;   // 最近一次写入或命中时的 clock，淘汰时保留较大的一半
+};
+
+static_assert(sizeof(DiskHeader) == 64, "DiskHeader must be 64 bytes");
+static_assert(sizeof(DiskRecord) == 24, "DiskRecord must be 24 bytes");
+
+inline DiskHeader* Header(uchar* map) { return reinterpret_cast<DiskHeader*>(map); }
+inline DiskRecord* Records(uchar* map) { return reinterpret_cast<DiskRecord*>(map + sizeof(DiskHeader)); }
+
+} // namespace
+
+ResultCache& ResultCache::Instance()
+{
+    static ResultCache instance;
+    return instance;
+}
+
+ResultCache::ResultCache()
+{
+    _memory.setMaxCost(MEMORY_CAPACITY);
+
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (dir.isEmpty()) {
+        dir = QDir::tempPath();
+    }
+    QDir().mkpath(dir);
+    _disk_dir = dir;
+
+    Metrics& metrics = Metrics::Instance();
+    metrics.RegisterCallback("cv_result_cache_lookups_total", "Result cache lookups by outcome.", Metrics::TypeCounter,
+                             [this]() { return double(MemoryHits()); }, "outcome=\"memory_hit\"");
+    metrics.RegisterCallback("cv_result_cache_lookups_total", "Result cache lookups by outcome.", Metrics::TypeCounter,
+                             [this]() { return double(DiskHits()); }, "outcome=\"disk_hit\"");
+    metrics.RegisterCallback("cv_result_cache_lookups_total", "Result cache lookups by outcome.", Metrics::TypeCounter,
+                             [this]() { return double(Misses()); }, "outcome=\"miss\"");
+    // 内存层：每条约为 Entry 加 QCache 节点开销；磁盘层为映射文件大小之和
+    metrics.RegisterCallback("cv_pool_bytes", "Approximate bytes held by image pools and caches.", Metrics::TypeGauge,
+                             [this]() {
+                                 QMutexLocker locker(&_mutex);
+                                 return double(_memory.size()) * (sizeof(Entry) + 64);
+                             }, "pool=\"result_cache\"");
+    metrics.RegisterCallback("cv_pool_bytes", "Approximate bytes held by image pools and caches.", Metrics::TypeGauge,
+                             [this]() {
+                                 QMutexLocker locker(&_mutex);
+                                 double bytes = 0.0;
+                                 for (DiskStore* store : qAsConst(_stores)) {
+                                     bytes += store->map ? double(store->file.size()) : 0.0;
+                                 }
+                                 return bytes;
+                             }, "pool=\"result_cache_mapped\"");
+}
+
+ResultCache::~ResultCache()
+{
+    CloseAllDiskStores();
+}
+
+quint64 ResultCache::ModelId(const QString &modelPath)
+{
+    QFileInfo info(modelPath);
+    QMutexLocker locker(&_model_mutex);
+
+    // 大小、修改时间都未变化时，沿用上次计算的模型标识
+    auto it = _models.constFind(modelPath);
+    if (it != _models.constEnd() && it->size == info.size() && it->mtime == info.lastModified()) {
+        return it->id;
+    }
+
+    quint64 model_id = 0;
+    if (!ContentHash::HashFile(modelPath, model_id)) {
+        qWarning() << "[ResultCache] Cannot read model:" << modelPath;
+        return 0;
+    }
+    _models.insert(modelPath, ModelFile{info.size(), info.lastModified(), model_id});
+    return model_id;
+}
+
+quint64 ResultCache::MakeKey(const QByteArray &content, quint64 modelId)
+{
+    quint64 key = ContentHash::Combine(ContentHash::Hash64(content), modelId);
+    return key ? key : 1; // 0 保留为空槽标记
+}
+
+bool ResultCache::Lookup(quint64 modelId, quint64 key, Entry &out)
+{
+    QMutexLocker locker(&_mutex);
+
+    if (Entry* entry = _memory.object(key)) {
+        out = *entry;
+        _mem_hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    DiskStore* store = Store(modelId);
+    if (store && DiskLookup(*store, key, out)) {
+        _memory.insert(key, new Entry(out));
+        _disk_hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    _misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void ResultCache::Insert(quint64 modelId, quint64 key, const Entry &entry)
+{
+    QMutexLocker locker(&_mutex);
+    _memory.insert(key, new Entry(entry));
+    if (DiskStore* store = Store(modelId)) {
+        DiskInsert(*store, modelId, key, entry);
+    }
+}
+
+void ResultCache::Clear()
+{
+    QMutexLocker locker(&_mutex);
+    _memory.clear();
+    CloseAllDiskStores();
+    QDir dir(_disk_dir);
+    for (const QString& name : dir.entryList({"result_cache_*.bin"}, QDir::Files)) {
+        QFile::remove(dir.filePath(name));
+    }
+}
+
+void ResultCache::ResetCounters()
+{
+    _mem_hits.store(0, std::memory_order_relaxed);
+    _disk_hits.store(0, std::memory_order_relaxed);
+    _misses.store(0, std::memory_order_relaxed);
+}
+
+QString ResultCache::DiskPath(quint64 modelId) const
+{
+    return QString("%1/result_cache_%2.bin").arg(_disk_dir).arg(modelId, 16, 16, QChar('0'));
+}
+
+ResultCache::DiskStore *ResultCache::Store(quint64 modelId)
+{
+    if (modelId == 0) {
+        return nullptr;
+    }
+    auto it = _stores.constFind(modelId);
+    if (it != _stores.constEnd()) {
+        return it.value()->map ? it.value() : nullptr;
+    }
+
+    DiskStore* store = new DiskStore;
+    if (!OpenDiskStore(*store, modelId)) {
+        qWarning() << "[ResultCache] Cannot open disk store:" << DiskPath(modelId);
+    }
+    // 打开失败也记下，不再每次重试
+    _stores.insert(modelId, store);
+    PruneDiskStores();
+    return store->map ? store : nullptr;
+}
+
+void ResultCache::PruneDiskStores()
+{
+    QDir dir(_disk_dir);
+    const QFileInfoList files = dir.entryInfoList({"result_cache_*.bin"}, QDir::Files, QDir::Time);
+    int kept = 0;
+    for (const QFileInfo& info : files) {
+        bool open = false;
+        for (DiskStore* store : qAsConst(_stores)) {
+            open = open || store->file.fileName() == info.filePath();
+        }
+        if (open || kept < DISK_MAX_MODELS) {
+            kept++;
+            continue;
+        }
+        QFile::remove(info.filePath());
+    }
+}
+
+bool ResultCache::OpenDiskStore(DiskStore &store, quint64 modelId)
+{
+    const QString path = DiskPath(modelId);
+    store.file.setFileName(path);
+    bool valid = false;
+
+    if (store.file.exists() && store.file.open(QIODevice::ReadWrite)) {
+        DiskHeader header;
+        if (store.file.read(reinterpret_cast<char*>(&header), sizeof(header)) == sizeof(header)
+            && std::memcmp(header.magic, DISK_MAGIC, 4) == 0
+            && header.version == DISK_VERSION
+            && header.modelId == modelId
+            && header.capacity > 0 && (header.capacity & (header.capacity - 1)) == 0
+            && header.count < header.capacity
+            && store.file.size() == qint64(sizeof(DiskHeader) + header.capacity * sizeof(DiskRecord))) {
+            valid = true;
+        }
+        if (!valid) {
+            store.file.close();
+        }
+    }
+
+    if (!valid) {
+        // 文件不存在或损坏：重建
+        if (!CreateDiskStore(path, modelId, DISK_INIT_CAPACITY)) {
+            return false;
+        }
+        if (!store.file.open(QIODevice::ReadWrite)) {
+            return false;
+        }
+    }
+
+    store.map = store.file.map(0, store.file.size());
+    if (!store.map) {
+        store.file.close();
+        return false;
+    }
+    return true;
+}
+
+bool ResultCache::CreateDiskStore(const QString &path, quint64 modelId, quint64 capacity)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    DiskHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, DISK_MAGIC, 4);
+    header.version = DISK_VERSION;
+    header.modelId = modelId;
+    header.capacity = capacity;
+    header.count = 0;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // 记录区全部置零（key = 0 即空槽）
+    return file.resize(sizeof(DiskHeader) + capacity * sizeof(DiskRecord));
+}
+
+void ResultCache::CloseDiskStore(DiskStore &store)
+{
+    if (store.map) {
+        store.file.unmap(store.map);
+        store.map = nullptr;
+    }
+    if (store.file.isOpen()) {
+        store.file.close();
+    }
+}
+
+void ResultCache::CloseAllDiskStores()
+{
+    for (DiskStore* store : qAsConst(_stores)) {
+        CloseDiskStore(*store);
+        delete store;
+    }
+    _stores.clear();
+}
+
+bool ResultCache::DiskLookup(DiskStore &store, quint64 key, Entry &out)
+{
+    DiskHeader* header = Header(store.map);
+    const quint64 mask = header->capacity - 1;
+    DiskRecord* records = Records(store.map);
+
+    // 线性探测；文件损坏时表可能没有空槽，最多探测 capacity 次
+    for (quint64 n = 0, i = key & mask; n < header->capacity; ++n, i = (i + 1) & mask) {
+        DiskRecord& rec = records[i];
+        if (rec.key == 0) {
+            return false;
+        }
+        if (rec.key == key) {
+            out.classId = rec.classId;
+            out.confidence = rec.confidence;
+            rec.lastUse = ++header->clock;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResultCache::DiskInsert(DiskStore &store, quint64 modelId, quint64 key, const Entry &entry)
+{
+    // 装载因子超过 0.7 时扩容，保证探测链较短；已到上限时改为淘汰较久未用的一半
+    DiskHeader* header = Header(store.map);
+    if ((header->count + 1) * 10 > header->capacity * 7) {
+        if (header->capacity < DISK_MAX_CAPACITY) {
+            RebuildDiskStore(store, modelId, header->capacity * 2, false);
+        } else {
+            RebuildDiskStore(store, modelId, header->capacity, true);
+        }
+        if (!store.map) {
+            return;
+        }
+        header = Header(store.map);
+    }
+
+    const quint64 mask = header->capacity - 1;
+    DiskRecord* records = Records(store.map);
+    for (quint64 n = 0, i = key & mask; n < header->capacity; ++n, i = (i + 1) & mask) {
+        DiskRecord& rec = records[i];
+        if (rec.key == 0 || rec.key == key) {
+            if (rec.key == 0) {
+                header->count++;
+            }
+            rec.key = key;
+            rec.classId = entry.classId;
+            rec.confidence = entry.confidence;
+            rec.lastUse = ++header->clock;
+            return;
+        }
+    }
+}
+
+void ResultCache::RebuildDiskStore(DiskStore &store, quint64 modelId, quint64 capacity, bool evict)
+{
+    const quint64 old_capacity = Header(store.map)->capacity;
+    const quint64 clock = Header(store.map)->clock;
+    const QString path = DiskPath(modelId);
+    const QString tmp_path = path + ".tmp";
+    DiskRecord* old_records = Records(store.map);
+
+    // 淘汰时以 lastUse 的中位数为界，只保留较新的一半
+    quint64 min_use = 0;
+    if (evict) {
+        std::vector<quint64> uses;
+        uses.reserve(Header(store.map)->count);
+        for (quint64 i = 0; i < old_capacity; ++i) {
+            if (old_records[i].key != 0) {
+                uses.push_back(old_records[i].lastUse);
+            }
+        }
+        if (!uses.empty()) {
+            auto middle = uses.begin() + uses.size() / 2;
+            std::nth_element(uses.begin(), middle, uses.end());
+            min_use = *middle;
+        }
+    }
+
+    if (!CreateDiskStore(tmp_path, modelId, capacity)) {
+        return;
+    }
+
+    QFile tmp_file(tmp_path);
+    if (!tmp_file.open(QIODevice::ReadWrite)) {
+        return;
+    }
+    uchar* tmp_map = tmp_file.map(0, tmp_file.size());
+    if (!tmp_map) {
+        return;
+    }
+
+    // 将旧表中（保留的）记录重新散列到新表
+    const quint64 new_mask = capacity - 1;
+    DiskRecord* new_records = Records(tmp_map);
+    quint64 count = 0;
+    for (quint64 i = 0; i < old_capacity; ++i) {
+        const DiskRecord& rec = old_records[i];
+        if (rec.key == 0 || rec.lastUse < min_use) {
+            continue;
+        }
+        quint64 j = rec.key & new_mask;
+        for (quint64 n = 1; new_records[j].key != 0 && n < capacity; ++n) {
+            j = (j + 1) & new_mask;
+        }
+        if (new_records[j].key != 0) {
+            break; // 新表已满（旧表的 count 与实际不符）
+        }
+        new_records[j] = rec;
+        count++;
+    }
+    Header(tmp_map)->count = count;
+    Header(tmp_map)->clock = clock;
+
+    tmp_file.unmap(tmp_map);
+    tmp_file.close();
+
+    CloseDiskStore(store);
+    QFile::remove(path);
+    QFile::rename(tmp_path, path);
+    OpenDiskStore(store, modelId);
+}
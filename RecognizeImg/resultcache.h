@@ -0,0 +1,108 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <QCache>
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+
+/**
+ * @brief 识别结果缓存（内存 LRU + 磁盘存储 两级）
+ * 以 “图片内容哈希 + 模型标识” 作为键，命中时直接返回类别与置信度，无需解码和推理。
+ * 磁盘层按模型标识每个模型一个文件（内存映射的开放寻址哈希表，文件头记录模型标识），
+ * 模型热替换期间新旧模型同时使用时互不影响；只保留最近使用的若干个模型的文件。
+ * 每个文件的槽位数有上限，写满后按最近使用时间淘汰较旧的一半。
+ * 模型标识由调用方随每次 Lookup / Insert 传入，缓存本身没有“当前模型”。
+ */
+class ResultCache
+{
+public:
+    // 缓存的识别结果
+    struct Entry
+    {
+        qint32 classId = -1;      // 类别 ID
+        float confidence = 0.0f;  // 置信度
+    };
+
+    // 获取全局唯一实例（线程安全）
+    static ResultCache& Instance();
+
+    /**
+     * @brief 模型标识（模型内容哈希），特征索引等同样依赖模型的数据用它做失效判断
+     * 按路径记住结果，文件大小或修改时间变化时重新计算；读取失败返回 0
+     */
+    quint64 ModelId(const QString& modelPath);
+
+    /**
+     * @brief 根据图片内容生成缓存键（已混入模型标识）
+     * @param content 图片文件的原始字节
+     */
+    static quint64 MakeKey(const QByteArray& content, quint64 modelId);
+
+    // 查找缓存，先查内存 LRU，再查该模型的磁盘存储；磁盘命中时提升到内存
+    bool Lookup(quint64 modelId, quint64 key, Entry& out);
+
+    // 写入缓存（内存 LRU 与该模型的磁盘存储）
+    void Insert(quint64 modelId, quint64 key, const Entry& entry);
+
+    // 清空两级缓存
+    void Clear();
+
+    // 统计信息
+    quint64 MemoryHits() const { return _mem_hits.load(std::memory_order_relaxed); }
+    quint64 DiskHits() const { return _disk_hits.load(std::memory_order_relaxed); }
+    quint64 Misses() const { return _misses.load(std::memory_order_relaxed); }
+    void ResetCounters();
+
+private:
+    ResultCache();
+    ~ResultCache();
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // 一个模型的磁盘存储
+    struct DiskStore
+    {
+        QFile file;
+        uchar* map = nullptr;           // 文件映射地址
+    };
+
+    // 已算出的模型标识
+    struct ModelFile
+    {
+        qint64 size = -1;
+        QDateTime mtime;
+        quint64 id = 0;
+    };
+
+    QString DiskPath(quint64 modelId) const;
+    DiskStore* Store(quint64 modelId);                      // 取得（必要时打开）模型的磁盘存储
+    bool OpenDiskStore(DiskStore& store, quint64 modelId);  // 打开（必要时重建）磁盘存储
+    bool CreateDiskStore(const QString& path, quint64 modelId, quint64 capacity); // 新建空的磁盘哈希表
+    void CloseDiskStore(DiskStore& store);
+    void CloseAllDiskStores();
+    void PruneDiskStores();                                 // 删除较久未用的其他模型的文件
+    bool DiskLookup(DiskStore& store, quint64 key, Entry& out);
+    void DiskInsert(DiskStore& store, quint64 modelId, quint64 key, const Entry& entry);
+    // 装载因子过高时重建：未到上限时扩容，否则按最近使用淘汰一半
+    void RebuildDiskStore(DiskStore& store, quint64 modelId, quint64 capacity, bool evict);
+
+private:
+    QMutex _mutex;                       // 保护以下所有成员（模型标识除外）
+    QCache<quint64, Entry> _memory;      // 内存 LRU 层（键已混入模型标识，各模型共用）
+
+    QString _disk_dir;                   // 磁盘存储目录
+    QHash<quint64, DiskStore*> _stores;  // 模型标识 -> 已打开的磁盘存储
+
+    QMutex _model_mutex;                 // 保护 _models，计算哈希时不阻塞查找
+    QHash<QString, ModelFile> _models;   // 模型路径 -> 模型标识
+
+    std::atomic<quint64> _mem_hits{0};   // 内存层命中次数
+    std::atomic<quint64> _disk_hits{0};  // 磁盘层命中次数
+    std::atomic<quint64> _misses{0};     // 未命中次数
+};
+
+#endif // RESULTCACHE_H
@@ -0,0 +1,417 @@
+#include "threadtuning.h"
+#include "const.h"
+#include "inferencescheduler.h"
+#include "tracer.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <QThread>
+#include <QtDebug>
+#include <algorithm>
+#include <chrono>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <ctime>
+#endif
+
+namespace {
+
+// 进程累计 CPU 时间（用户态 + 内核态，毫秒），包括 ORT 线程池中的全部线程
+double ProcessCpuMs()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) / 1e4;   // 100ns -> ms
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) {
+        return 0.0;
+    }
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+#endif
+}
+
+double Median(std::vector<double> values)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+QJsonObject ToJson(const ThreadProfile& profile)
+{
+    QJsonObject object;
+    object["intra_threads"] = profile.intraOpNumThreads;
+    object["inter_threads"] = profile.interOpNumThreads;
+    object["spinning"] = profile.allowSpinning;
+    object["latency_ms"] = profile.latencyMs;
+    object["cpu_ms"] = profile.cpuMs;
+    return object;
+}
+
+ThreadProfile FromJson(const QJsonObject& object)
+{
+    ThreadProfile profile;
+    profile.intraOpNumThreads = qMax(1, object["intra_threads"].toInt(profile.intraOpNumThreads));
+    profile.interOpNumThreads = qMax(1, object["inter_threads"].toInt(profile.interOpNumThreads));
+    profile.allowSpinning = object["spinning"].toBool(profile.allowSpinning);
+    profile.latencyMs = object["latency_ms"].toDouble();
+    profile.cpuMs = object["cpu_ms"].toDouble();
+    return profile;
+}
+
+} // namespace
+
+ThreadTuning &ThreadTuning::Instance()
+{
+    static ThreadTuning instance;
+    return instance;
+}
+
+QString ThreadTuning::DefaultPath()
+{
+    // 按机器保存，不随漫游配置同步到其他机器
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (dir.isEmpty()) {
+        dir = QDir::tempPath();
+    }
+    QDir().mkpath(dir);
+    return dir + "/thread_profile.json";
+}
+
+QString ThreadTuning::MachineId()
+{
+    return QString("%1|%2|%3").arg(QSysInfo::machineHostName(), QSysInfo::currentCpuArchitecture())
+        .arg(QThread::idealThreadCount());
+}
+
+const char *ThreadTuning::ObjectiveName(Objective objective)
+{
+    return objective == LowCpu ? "cpu" : "latency";
+}
+
+bool ThreadTuning::Load(const QString &path)
+{
+    QMutexLocker locker(&_mutex);
+    const bool tuned = LoadLocked(path);
+    UpdateSlotsLocked();
+    return tuned;
+}
+
+bool ThreadTuning::LoadLocked(const QString &path)
+{
+    _path = path;
+    _tuned = false;
+    _results.clear();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    // 用户选择的目标与调优结果无关，换机器后仍然保留
+    _objective = root["objective"].toString() == ObjectiveName(LowCpu) ? LowCpu : LowLatency;
+
+    if (root["machine"].toString() != MachineId() || qEnvironmentVariableIntValue("CV_THREAD_RETUNE") == 1) {
+        return false;
+    }
+    const QJsonObject best = root["best"].toObject();
+    _best[LowLatency] = FromJson(best[ObjectiveName(LowLatency)].toObject());
+    _best[LowCpu] = FromJson(best[ObjectiveName(LowCpu)].toObject());
+    if (!_best[LowLatency].Measured() || !_best[LowCpu].Measured()) {
+        return false;
+    }
+    for (const QJsonValue& value : root["results"].toArray()) {
+        _results.append(FromJson(value.toObject()));
+    }
+    _tuned = true;
+    return true;
+}
+
+bool ThreadTuning::SaveLocked() const
+{
+    QJsonObject root;
+    root["machine"] = MachineId();
+    root["objective"] = ObjectiveName(_objective);
+    if (_tuned) {
+        QJsonObject best;
+        best[ObjectiveName(LowLatency)] = ToJson(_best[LowLatency]);
+        best[ObjectiveName(LowCpu)] = ToJson(_best[LowCpu]);
+        root["best"] = best;
+        QJsonArray results;
+        for (const ThreadProfile& profile : _results) {
+            results.append(ToJson(profile));
+        }
+        root["results"] = results;
+    }
+
+    QFile file(_path.isEmpty() ? DefaultPath() : _path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[ThreadTuning] cannot write" << file.fileName();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    return true;
+}
+
+bool ThreadTuning::IsTuned() const
+{
+    QMutexLocker locker(&_mutex);
+    return _tuned;
+}
+
+void ThreadTuning::Cancel()
+{
+    _cancel = true;
+}
+
+void ThreadTuning::SetObjective(Objective objective)
+{
+    QMutexLocker locker(&_mutex);
+    if (_objective == objective) {
+        return;
+    }
+    _objective = objective;
+    UpdateSlotsLocked();
+    SaveLocked();
+}
+
+ThreadTuning::Objective ThreadTuning::CurrentObjective() const
+{
+    QMutexLocker locker(&_mutex);
+    return _objective;
+}
+
+ThreadProfile ThreadTuning::Profile() const
+{
+    return Profile(CurrentObjective());
+}
+
+ThreadProfile ThreadTuning::Profile(Objective objective) const
+{
+    QMutexLocker locker(&_mutex);
+    return _tuned ? _best[objective] : DefaultProfile(objective);
+}
+
+QVector<ThreadProfile> ThreadTuning::Results() const
+{
+    QMutexLocker locker(&_mutex);
+    return _results;
+}
+
+ThreadProfile ThreadTuning::DefaultProfile(Objective objective) const
+{
+    ThreadProfile profile;
+    profile.intraOpNumThreads = qBound(1, QThread::idealThreadCount(), 4);
+    profile.allowSpinning = objective == LowLatency;
+    return profile;
+}
+
+void ThreadTuning::UpdateSlotsLocked() const
+{
+    // 并发推理数 × 每个会话的 intra-op 线程数不超过核数，多个会话同时推理时不超额占用 CPU
+    const ThreadProfile profile = _tuned ? _best[_objective] : DefaultProfile(_objective);
+    const int cores = qMax(1, QThread::idealThreadCount());
+    InferenceScheduler::Instance().SetSlots(qMax(1, cores / qMax(1, profile.intraOpNumThreads)));
+}
+
+void ThreadTuning::Apply(DL_INIT_PARAM &params) const
+{
+    const ThreadProfile profile = Profile();
+    params.intraOpNumThreads = profile.intraOpNumThreads;
+    params.interOpNumThreads = profile.interOpNumThreads;
+    params.allowSpinning = profile.allowSpinning;
+}
+
+bool ThreadTuning::Tune(const std::string &modelPath, QString *errorMsg)
+{
+    TRACE_SCOPE("tuning.run");
+    const int cores = qMax(1, QThread::idealThreadCount());
+
+    // intra-op：1、2、4 ... 直到逻辑核数，另加核数的一半（常为物理核数）与核数本身
+    std::vector<int> intraCandidates;
+    for (int n = 1; n <= cores; n *= 2) {
+        intraCandidates.push_back(n);
+    }
+    intraCandidates.push_back(qMax(1, cores / 2));
+    intraCandidates.push_back(cores);
+    std::sort(intraCandidates.begin(), intraCandidates.end());
+    intraCandidates.erase(std::unique(intraCandidates.begin(), intraCandidates.end()), intraCandidates.end());
+
+    // inter-op：分类网络基本是一条链，并行执行模式只在核数较多时值得一试
+    std::vector<int> interCandidates = {1};
+    if (cores >= 4) {
+        interCandidates.push_back(2);
+    }
+
+    // 分类耗时与图像内容无关，用随机图像测量
+    cv::Mat image(640, 640, CV_8UC3);
+    cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+
+    QVector<ThreadProfile> results;
+    QString error;
+    int discards = 0;
+    for (int intra : intraCandidates) {
+        for (int inter : interCandidates) {
+            // 并行模式的 inter-op 线程与 intra-op 线程池同时运行，合计不超过核数
+            if (inter > 1 && intra + inter > cores) {
+                continue;
+            }
+            for (bool spinning : {true, false}) {
+                if (_cancel) {
+                    if (errorMsg) {
+                        *errorMsg = "Tuning cancelled.";
+                    }
+                    return false;
+                }
+                ThreadProfile candidate;
+                candidate.intraOpNumThreads = intra;
+                candidate.interOpNumThreads = inter;
+                candidate.allowSpinning = spinning;
+                const ThreadProfile measured = Measure(modelPath, candidate, image, discards, error);
+                if (discards > TUNE_MAX_DISCARDS) {
+                    // 其他推理一直在进行，测量结果不可信，下次启动再调优
+                    if (errorMsg) {
+                        *errorMsg = "Other inference kept running during tuning.";
+                    }
+                    return false;
+                }
+                if (!measured.Measured()) {
+                    continue;
+                }
+                qInfo().noquote() << QString("[ThreadTuning] intra=%1 inter=%2 spin=%3: %4 ms, %5 ms CPU/frame")
+                                         .arg(intra).arg(inter).arg(spinning ? "on" : "off")
+                                         .arg(measured.latencyMs, 0, 'f', 2).arg(measured.cpuMs, 0, 'f', 2);
+                results.append(measured);
+            }
+        }
+    }
+    if (results.isEmpty()) {
+        if (errorMsg) {
+            *errorMsg = error.isEmpty() ? QString("No configuration could be measured.") : error;
+        }
+        return false;
+    }
+
+    QMutexLocker locker(&_mutex);
+    _results = results;
+    _best[LowLatency] = Select(results, LowLatency);
+    _best[LowCpu] = Select(results, LowCpu);
+    _tuned = true;
+    for (Objective objective : {LowLatency, LowCpu}) {
+        const ThreadProfile& best = _best[objective];
+        qInfo().noquote() << QString("[ThreadTuning] best for %1: intra=%2 inter=%3 spin=%4 (%5 ms, %6 ms CPU/frame)")
+                                 .arg(ObjectiveName(objective)).arg(best.intraOpNumThreads).arg(best.interOpNumThreads)
+                                 .arg(best.allowSpinning ? "on" : "off").arg(best.latencyMs, 0, 'f', 2)
+                                 .arg(best.cpuMs, 0, 'f', 2);
+    }
+    UpdateSlotsLocked();
+    SaveLocked();
+    return true;
+}
+
+ThreadProfile ThreadTuning::Measure(const std::string &modelPath, ThreadProfile profile, const cv::Mat &image,
+                                   int &discards, QString &error) const
+{
+    const InferenceScheduler& scheduler = InferenceScheduler::Instance();
+    try {
+        // 独立会话，不与进程内其他会话共享线程池与 arena
+        YOLO_V8 yolo;
+        DL_INIT_PARAM params;
+        params.modelPath = modelPath;
+        params.imgSize = {640, 640};
+        params.modelType = YOLO_CLS;
+        params.cudaEnable = false;
+        params.logSeverityLevel = 3;
+        params.shareMode = SHARE_NONE;
+        params.intraOpNumThreads = profile.intraOpNumThreads;
+        params.interOpNumThreads = profile.interOpNumThreads;
+        params.allowSpinning = profile.allowSpinning;
+        const char* ret = yolo.CreateSession(params);   // 含一次预热
+        if (ret != RET_OK) {
+            error = QString("CreateSession failed: %1").arg(ret);
+            return ThreadProfile();
+        }
+
+        std::vector<double> latency;
+        std::vector<double> cpu;
+        std::vector<DL_RESULT> results;
+        while (int(latency.size()) < TUNE_RUNS) {
+            if (_cancel || discards > TUNE_MAX_DISCARDS) {
+                return ThreadProfile();
+            }
+            // 有其他推理在进行时等它结束
+            if (scheduler.Active() > 0) {
+                discards++;
+                QThread::msleep(TUNE_IDLE_MS);
+                continue;
+            }
+            const quint64 started = scheduler.Started();
+            cv::Mat input = image.clone();
+            results.clear();
+            const double cpuStart = ProcessCpuMs();
+            const auto start = std::chrono::steady_clock::now();
+            ret = yolo.RunSession(input, results);
+            const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (ret != RET_OK) {
+                error = QString("RunSession failed: %1").arg(ret);
+                return ThreadProfile();
+            }
+            // 空闲间隔内自旋线程消耗的 CPU 也算在这一帧上
+            QThread::msleep(TUNE_IDLE_MS);
+            const double cpuMs = ProcessCpuMs() - cpuStart;
+            // 期间有其他推理开始或仍在进行：延迟与 CPU 都被干扰，丢弃重测
+            if (scheduler.Active() > 0 || scheduler.Started() != started) {
+                discards++;
+                continue;
+            }
+            latency.push_back(elapsed);
+            cpu.push_back(cpuMs);
+        }
+        profile.latencyMs = Median(latency);
+        profile.cpuMs = Median(cpu);
+        return profile;
+    } catch (const std::exception& e) {
+        error = QString("Exception: %1").arg(e.what());
+        return ThreadProfile();
+    }
+}
+
+ThreadProfile ThreadTuning::Select(const QVector<ThreadProfile> &results, Objective objective)
+{
+    // 主目标最优值 TUNE_TOLERANCE 以内的组合中，按另一目标择优
+    auto primary = [objective](const ThreadProfile& p) { return objective == LowLatency ? p.latencyMs : p.cpuMs; };
+    auto secondary = [objective](const ThreadProfile& p) { return objective == LowLatency ? p.cpuMs : p.latencyMs; };
+
+    double bestPrimary = primary(results.front());
+    for (const ThreadProfile& profile : results) {
+        bestPrimary = std::min(bestPrimary, primary(profile));
+    }
+    const ThreadProfile* best = nullptr;
+    for (const ThreadProfile& profile : results) {
+        if (primary(profile) > bestPrimary * (1.0 + TUNE_TOLERANCE)) {
+            continue;
+        }
+        if (!best || secondary(profile) < secondary(*best)) {
+            best = &profile;
+        }
+    }
+    return *best;
+}
@@ -0,0 +1,114 @@
+#ifndef THREADTUNING_H
+#define THREADTUNING_H
+
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <string>
+#include "inference.h"
+
+// 一组 ORT 线程配置及其测量结果
+struct ThreadProfile
+{
+    int intraOpNumThreads = 4;
+    int interOpNumThreads = 1;
+    bool allowSpinning = true;
+    double latencyMs = 0.0;    // 单次推理延迟（中位数）
+    double cpuMs = 0.0;        // 每帧消耗的进程 CPU 时间（推理 + 随后的空闲间隔，含自旋）
+
+    bool Measured() const { return latencyMs > 0.0; }
+};
+
+/**
+ * @brief 推理线程配置的自动调优
+ * 首次运行时用当前模型测量 intra-op / inter-op 线程数与线程池自旋的各种组合，
+ * 分别按延迟与 CPU 时间选出最佳组合，连同全部测量结果按机器保存（AppLocalDataLocation）。
+ * 之后创建会话时用 Apply 填入所选目标对应的组合；硬件或机器变化后重新调优。
+ * 未调优时使用 min(4, 核数) 个线程，自旋与否取决于所选目标。
+ */
+class ThreadTuning
+{
+public:
+    // 调优目标
+    enum Objective
+    {
+        LowLatency = 0,   // 单帧延迟最低
+        LowCpu = 1,       // 每帧 CPU 时间最少（适合长时间运行的实时识别）
+    };
+
+    // 获取全局唯一实例（线程安全）
+    static ThreadTuning& Instance();
+
+    // 保存位置：<AppLocalDataLocation>/thread_profile.json
+    static QString DefaultPath();
+
+    // 本机标识（主机名、CPU 架构、逻辑核数），不一致时视为未调优
+    static QString MachineId();
+
+    static const char* ObjectiveName(Objective objective);
+
+    /**
+     * @brief 读取已保存的调优结果
+     * @return 本机已调优（环境变量 CV_THREAD_RETUNE=1 时总是返回 false）
+     */
+    bool Load(const QString& path = DefaultPath());
+
+    /**
+     * @brief 测量全部组合并选出两个目标的最佳组合，成功后保存
+     * 耗时数秒到数十秒（与核数有关），在后台线程调用；可与界面的推理同时进行，
+     * 期间有其他推理的测量会被丢弃，其他推理一直不停时放弃调优（返回 false）
+     * @param modelPath 用于测量的模型
+     * @param errorMsg 失败时的错误信息，可为空
+     */
+    bool Tune(const std::string& modelPath, QString* errorMsg = nullptr);
+
+    bool IsTuned() const;
+
+    // 中止进行中的 Tune（当前组合测完后返回 false，不保存），退出前调用
+    void Cancel();
+
+    // 选择目标（立即保存），之后新建的会话使用对应组合
+    // Load、Tune、SetObjective 之后按所选组合调整 InferenceScheduler 的并发槽数
+    void SetObjective(Objective objective);
+    Objective CurrentObjective() const;
+
+    // 所选目标（或指定目标）的线程配置
+    ThreadProfile Profile() const;
+    ThreadProfile Profile(Objective objective) const;
+
+    // 全部测量结果（未调优时为空）
+    QVector<ThreadProfile> Results() const;
+
+    // 把所选目标的线程配置写入会话参数
+    void Apply(DL_INIT_PARAM& params) const;
+
+private:
+    ThreadTuning() = default;
+    ThreadTuning(const ThreadTuning&) = delete;
+    ThreadTuning& operator=(const ThreadTuning&) = delete;
+
+    /**
+     * @brief 测量一种组合，失败时返回未测量的结果
+     * 期间有其他推理（InferenceScheduler::Active / Started）的那次测量丢弃重测，
+     * 丢弃次数累计到 discards，超过 TUNE_MAX_DISCARDS 时返回未测量的结果
+     */
+    ThreadProfile Measure(const std::string& modelPath, ThreadProfile profile, const cv::Mat& image,
+                          int& discards, QString& error) const;
+    static ThreadProfile Select(const QVector<ThreadProfile>& results, Objective objective);
+    ThreadProfile DefaultProfile(Objective objective) const;
+    bool LoadLocked(const QString& path);
+    bool SaveLocked() const;
+    // 按所选目标的 intra-op 线程数设置推理调度器的并发槽数（核数 / 线程数）
+    void UpdateSlotsLocked() const;
+
+    mutable QMutex _mutex;
+    QString _path;
+    bool _tuned = false;
+    Objective _objective = LowLatency;
+    ThreadProfile _best[2];
+    QVector<ThreadProfile> _results;
+    std::atomic<bool> _cancel{false};
+};
+
+#endif // THREADTUNING_H
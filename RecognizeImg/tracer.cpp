@@ -0,0 +1,220 @@
+#include "tracer.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+std::atomic<bool> Tracer::_enabled{false};
+
+namespace {
+
+// 每个线程缓冲区的记录数（约 2.5 MB）
+const size_t BUFFER_EVENTS = 1 << 16;
+
+// 一条记录。字段用 relaxed 原子变量，导出线程读取时不构成数据竞争
+struct TraceEvent
+{
+    std::atomic<const char*> name{nullptr};
+    std::atomic<qint64> start{0};
+    std::atomic<qint64> dur{0};
+    std::atomic<quint32> tid{0};
+};
+
+// 导出时复制出的一条记录
+struct Snapshot
+{
+    const char* name;
+    qint64 start;
+    qint64 dur;
+    quint32 tid;
+};
+
+// 线程缓冲区：只由持有它的线程写入
+// 线程退出后缓冲区连同 tid 交给下一个线程，导出时同一 tid 下依次是先后持有它的线程的记录，
+// 线程名称取最近的持有者；短命线程再多，名称表也只与同时存在的线程数有关
+struct ThreadBuffer
+{
+    std::unique_ptr<TraceEvent[]> events{new TraceEvent[BUFFER_EVENTS]};
+    std::atomic<quint64> head{0};   // 已写入的记录总数
+    std::atomic<quint64> tail{0};   // Clear 之后的起点
+    quint32 tid = 0;                // 导出时的线程编号
+    QString name;                   // 最近持有线程的名称
+    bool inUse = false;
+};
+
+// 全部缓冲区，只在线程领取、归还缓冲区和导出时加锁
+struct Registry
+{
+    QMutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    quint32 nextTid = 1;
+};
+
+Registry& GetRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+// 线程退出时归还缓冲区
+struct ThreadSlot
+{
+    ThreadBuffer* buffer = nullptr;
+    ~ThreadSlot()
+    {
+        if (buffer) {
+            Registry& registry = GetRegistry();
+            QMutexLocker locker(&registry.mutex);
+            buffer->inUse = false;
+        }
+    }
+};
+
+thread_local ThreadSlot t_slot;
+
+ThreadBuffer* AcquireBuffer()
+{
+    Registry& registry = GetRegistry();
+    QMutexLocker locker(&registry.mutex);
+
+    // 线程名称：主线程记为 main，其余取线程对象名或类名（如 CameraThread）
+    QString name;
+    QThread* thread = QThread::currentThread();
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+        name = "main";
+    } else if (thread) {
+        name = thread->objectName().isEmpty() ? QString(thread->metaObject()->className()) : thread->objectName();
+    }
+
+    ThreadBuffer* buffer = nullptr;
+    for (auto& candidate : registry.buffers) {
+        if (!candidate->inUse) {
+            buffer = candidate.get();
+            break;
+        }
+    }
+    if (!buffer) {
+        registry.buffers.emplace_back(new ThreadBuffer);
+        buffer = registry.buffers.back().get();
+        buffer->tid = registry.nextTid++;
+    }
+    buffer->inUse = true;
+    buffer->name = name;
+    return buffer;
+}
+
+// 导出的时间原点：程序加载时（静态初始化）取得，早于任何一条记录
+const qint64 g_processStartNs = Tracer::NowNs();
+
+} // namespace
+
+qint64 Tracer::NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::Record(const char *name, qint64 startNs, qint64 durNs)
+{
+    ThreadBuffer* buffer = t_slot.buffer;
+    if (!buffer) {
+        buffer = t_slot.buffer = AcquireBuffer();
+    }
+
+    const quint64 index = buffer->head.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer->events[index % BUFFER_EVENTS];
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(startNs, std::memory_order_relaxed);
+    event.dur.store(durNs, std::memory_order_relaxed);
+    event.tid.store(buffer->tid, std::memory_order_relaxed);
+    buffer->head.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::Clear()
+{
+    Registry& registry = GetRegistry();
+    QMutexLocker locker(&registry.mutex);
+    for (auto& buffer : registry.buffers) {
+        buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+QByteArray Tracer::ChromeJson()
+{
+    Registry& registry = GetRegistry();
+    QMutexLocker locker(&registry.mutex);
+    const qint64 origin = g_processStartNs;
+
+    QByteArray json;
+    json.reserve(1 << 20);
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&json, &first]() {
+        if (!first) {
+            json += ",\n";
+        }
+        first = false;
+    };
+
+    // 线程名称元数据
+    for (const auto& buffer : registry.buffers) {
+        separator();
+        QString name = buffer->name;
+        name.replace('\\', "\\\\").replace('"', "\\\"");
+        json += QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%1,\"args\":{\"name\":\"%2\"}}")
+                    .arg(buffer->tid).arg(name).toUtf8();
+    }
+
+    for (auto& buffer : registry.buffers) {
+        // 先复制记录，再按复制后的 head 丢弃期间可能被覆盖的部分
+        const quint64 head = buffer->head.load(std::memory_order_acquire);
+        const quint64 begin = std::max(buffer->tail.load(std::memory_order_relaxed),
+                                       head > BUFFER_EVENTS ? head - BUFFER_EVENTS : quint64(0));
+        std::vector<Snapshot> events;
+        events.reserve(head - begin);
+        for (quint64 i = begin; i < head; ++i) {
+            const TraceEvent& event = buffer->events[i % BUFFER_EVENTS];
+            events.push_back({event.name.load(std::memory_order_relaxed),
+                              event.start.load(std::memory_order_relaxed),
+                              event.dur.load(std::memory_order_relaxed),
+                              event.tid.load(std::memory_order_relaxed)});
+        }
+        const quint64 head_after = buffer->head.load(std::memory_order_acquire);
+        const quint64 valid_from = head_after > BUFFER_EVENTS ? head_after - BUFFER_EVENTS : 0;
+
+        for (size_t i = 0; i < events.size(); ++i) {
+            const Snapshot& event = events[i];
+            if (begin + i < valid_from || !event.name) {
+                continue;
+            }
+            // Trace Event Format 的时间单位为微秒
+            separator();
+            json += "{\"name\":\"";
+            json += event.name;
+            json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+            json += QByteArray::number(event.tid);
+            json += ",\"ts\":";
+            json += QByteArray::number((event.start - origin) / 1000.0, 'f', 3);
+            json += ",\"dur\":";
+            json += QByteArray::number(event.dur / 1000.0, 'f', 3);
+            json += "}";
+        }
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+bool Tracer::WriteChromeJson(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    const QByteArray json = ChromeJson();
+    return file.write(json) == json.size();
+}
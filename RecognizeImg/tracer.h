@@ -0,0 +1,88 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @brief 轻量级分阶段计时（导出为 Chrome / Perfetto trace JSON）
+ * 每个线程第一次记录时领取一块固定大小的环形缓冲区，之后只由该线程写入，无锁；
+ * 缓冲区写满后覆盖最早的记录。线程退出时缓冲区归还（记录保留），供新线程复用，
+ * 因此每帧新建线程也不会无限占用内存。
+ * 运行时默认关闭，关闭时每个计时点只有一次原子读；
+ * 编译时未定义 CV_TRACE（qmake CONFIG += no_trace）则所有 TRACE_ 宏展开为空。
+ * 导出的文件可在 chrome://tracing 或 ui.perfetto.dev 中打开。
+ */
+class Tracer
+{
+public:
+    // 开启 / 关闭记录
+    static void SetEnabled(bool enabled) { _enabled.store(enabled, std::memory_order_relaxed); }
+    static bool IsEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+    // 单调时钟（纳秒）
+    static qint64 NowNs();
+
+    /**
+     * @brief 记录一段已结束的计时
+     * @param name 阶段名称，必须是静态字符串（只保存指针）
+     * @param startNs 开始时间（NowNs）
+     * @param durNs 持续时间
+     */
+    static void Record(const char* name, qint64 startNs, qint64 durNs);
+
+    // 清空全部记录
+    static void Clear();
+
+    // 当前全部记录导出为 Chrome trace JSON（Trace Event Format）
+    static QByteArray ChromeJson();
+
+    // 导出到文件
+    static bool WriteChromeJson(const QString& path);
+
+    // RAII 计时：构造时开始，析构或 End() 时结束
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name)
+            : _name(name), _start(IsEnabled() ? NowNs() : -1) {}
+        ~Scope() { End(); }
+
+        void End()
+        {
+            if (_start >= 0) {
+                Record(_name, _start, NowNs() - _start);
+                _start = -1;
+            }
+        }
+
+    private:
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        const char* _name;
+        qint64 _start;
+    };
+
+private:
+    static std::atomic<bool> _enabled;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef CV_TRACE
+// 计时到当前作用域结束
+#define TRACE_SCOPE(name) Tracer::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+// 具名计时，用 TRACE_END 提前结束
+#define TRACE_BEGIN(var, name) Tracer::Scope var(name)
+#define TRACE_END(var) var.End()
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_BEGIN(var, name) ((void)0)
+#define TRACE_END(var) ((void)0)
+#endif
+
+#endif // TRACER_H
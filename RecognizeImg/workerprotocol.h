@@ -0,0 +1,72 @@
+#ifndef WORKERPROTOCOL_H
+#define WORKERPROTOCOL_H
+
+#include <QtGlobal>
+#include <cstddef>
+
+/**
+ * @brief 界面进程与推理子进程（cultural-vision-worker）之间的协议
+ * 帧像素放在共享内存环形缓冲区里，本地套接字上只传固定长度的控制消息（Message）。
+ *
+ * 共享内存布局（由界面进程创建，子进程只读挂载）：
+ *     RingHeader | 对齐到 64 字节 | slot 0 | slot 1 | ... （每个 slot 为 slotBytes 字节）
+ * slot 的占用由界面进程管理：写入像素后发送 Frame，收到同一 slot 的 Result 后才重新使用。
+ * 两端运行在同一台机器上，消息按本机字节序直接读写。
+ */
+namespace WorkerProtocol {
+
+const quint32 MAGIC = 0x52575643;   // "CVWR"
+const quint32 VERSION = 1;
+
+struct RingHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 slotCount;
+    quint32 reserved;
+    quint64 slotBytes;
+};
+
+// 第一个 slot 相对共享内存起始的偏移
+const size_t SLOTS_OFFSET = (sizeof(RingHeader) + 63) / 64 * 64;
+
+inline size_t RingBytes(quint32 slotCount, quint64 slotBytes)
+{
+    return SLOTS_OFFSET + size_t(slotCount) * size_t(slotBytes);
+}
+
+inline size_t SlotOffset(quint32 slot, quint64 slotBytes)
+{
+    return SLOTS_OFFSET + size_t(slot) * size_t(slotBytes);
+}
+
+enum MessageType : quint32
+{
+    Hello = 1,      // 子进程 -> 界面：会话已创建，可以接收帧
+    Frame = 2,      // 界面 -> 子进程：slot 中的帧已写好（BGR，CV_8UC3）
+    Result = 3,     // 子进程 -> 界面：该 slot 的识别结果，slot 可重新使用
+};
+
+enum Status : quint32
+{
+    Ok = 0,
+    BadFrame = 1,           // slot 编号或尺寸不合法
+    InferenceFailed = 2,    // RunSession 失败或没有结果
+};
+
+struct Message
+{
+    quint32 type;
+    quint32 slot;
+    quint64 seq;            // 界面分配的帧序号，结果原样带回
+    quint32 width;
+    quint32 height;
+    quint32 step;           // 每行字节数
+    quint32 status;
+    qint32 classId;
+    float confidence;
+};
+
+} // namespace WorkerProtocol
+
+#endif // WORKERPROTOCOL_H
@@ -0,0 +1,141 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTextStream>
+#include "regressionsuite.h"
+
+namespace {
+
+bool WriteJson(const QString& path, const QJsonObject& object, QTextStream& err)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err << "Cannot write file: " << path << "\n";
+        return false;
+    }
+    file.write(QJsonDocument(object).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+} // namespace
+
+// 部署前的精度与性能回归检查
+// 记录黄金文件：cultural-vision-regress --model best.onnx --labels class_names.txt --dataset dir --golden golden.json --record
+// 检查：        cultural-vision-regress --model best.onnx --labels class_names.txt --dataset dir --golden golden.json
+//               [--budget budgets.json] [--report diff.json]
+// 长稳测试：    cultural-vision-regress --model best.onnx --labels class_names.txt --dataset dir --soak 60 [--session-per-image]
+// 退出码：0 通过，1 未通过，2 参数或环境错误
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cultural-vision-regress");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Check top-1 agreement with golden outputs and latency budgets on a fixed image set.");
+    parser.addHelpOption();
+
+    QCommandLineOption modelOption({"m", "model"}, "ONNX model file.", "path", "best.onnx");
+    QCommandLineOption labelOption({"l", "labels"}, "Class name file, one label per line.", "path", "class_names.txt");
+    QCommandLineOption datasetOption({"d", "dataset"}, "Labelled image set; first-level folder names are class names.", "dir");
+    QCommandLineOption goldenOption({"g", "golden"}, "Golden output file.", "path", "golden.json");
+    QCommandLineOption budgetOption({"b", "budget"}, "Budget file (see budgets.json).", "path");
+    QCommandLineOption recordOption("record", "Write the golden file from this build instead of checking.");
+    QCommandLineOption reportOption({"r", "report"}, "Also write the diff report as JSON.", "path");
+    QCommandLineOption imgszOption("imgsz", "Model input size.", "n", "640");
+    QCommandLineOption threadsOption("threads", "ONNX Runtime intra-op threads.", "n", "1");
+    QCommandLineOption warmupOption("warmup", "Override warm-up rounds from the budget file.", "n");
+    QCommandLineOption repeatOption("repeat", "Override timed rounds from the budget file.", "n");
+    QCommandLineOption soakOption("soak", "Soak test: run for this many minutes and fail if steady-state memory grows.", "minutes");
+    QCommandLineOption perImageOption("session-per-image", "Soak: create a new session for every image, like the live view.");
+
+    parser.addOptions({modelOption, labelOption, datasetOption, goldenOption, budgetOption, recordOption,
+                       reportOption, imgszOption, threadsOption, warmupOption, repeatOption,
+                       soakOption, perImageOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (!parser.isSet(datasetOption)) {
+        err << "--dataset is required.\n";
+        parser.showHelp(2);
+    }
+
+    RegressionBudget budget;
+    if (parser.isSet(budgetOption)) {
+        QString error;
+        if (!RegressionBudget::Load(parser.value(budgetOption), budget, error)) {
+            err << error << "\n";
+            return 2;
+        }
+    }
+    if (parser.isSet(warmupOption)) {
+        budget.warmup = qMax(0, parser.value(warmupOption).toInt());
+    }
+    if (parser.isSet(repeatOption)) {
+        budget.repeat = qMax(1, parser.value(repeatOption).toInt());
+    }
+
+    RegressionOptions options;
+    options.modelPath = parser.value(modelOption);
+    options.labelPath = parser.value(labelOption);
+    options.datasetDir = parser.value(datasetOption);
+    options.imgSize = parser.value(imgszOption).toInt();
+    options.intraOpNumThreads = qMax(1, parser.value(threadsOption).toInt());
+
+    // 比对模式先读黄金文件，避免跑完才发现缺失
+    const bool soak = parser.isSet(soakOption);
+    QJsonObject golden;
+    if (!parser.isSet(recordOption) && !soak) {
+        QFile file(parser.value(goldenOption));
+        if (!file.open(QIODevice::ReadOnly)) {
+            err << "Cannot open golden file: " << file.fileName() << " (run with --record first)\n";
+            return 2;
+        }
+        golden = QJsonDocument::fromJson(file.readAll()).object();
+        if (golden.isEmpty()) {
+            err << "Invalid golden file: " << file.fileName() << "\n";
+            return 2;
+        }
+    }
+
+    RegressionSuite suite(options, budget);
+    const QString error = suite.Init();
+    if (!error.isEmpty()) {
+        err << error << "\n";
+        return 2;
+    }
+    if (soak) {
+        const double minutes = parser.value(soakOption).toDouble();
+        if (minutes <= 0) {
+            err << "Invalid --soak duration.\n";
+            return 2;
+        }
+        err << suite.ImageCount() << " images, soak for " << minutes << " min\n";
+        const bool pass = suite.Soak(minutes, parser.isSet(perImageOption), err, out);
+        out.flush();
+        if (parser.isSet(reportOption) && !WriteJson(parser.value(reportOption), suite.Report(), err)) {
+            return 2;
+        }
+        return pass ? 0 : 1;
+    }
+
+    err << suite.ImageCount() << " images, " << budget.warmup << " warm-up + " << budget.repeat << " timed rounds\n";
+    suite.Run(err);
+
+    if (parser.isSet(recordOption)) {
+        if (!WriteJson(parser.value(goldenOption), suite.Golden(), err)) {
+            return 2;
+        }
+        err << "golden written to " << parser.value(goldenOption) << "\n";
+        return 0;
+    }
+
+    const bool pass = suite.Compare(golden, out);
+    out.flush();
+    if (parser.isSet(reportOption) && !WriteJson(parser.value(reportOption), suite.Report(), err)) {
+        return 2;
+    }
+    return pass ? 0 : 1;
+}
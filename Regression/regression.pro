@@ -0,0 +1,26 @@
+# 性能与精度回归检查（无界面），与 project3.pro 共用推理核心
+QT       += core
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+# 统计堆分配（CV_MEMSTATS）
+CONFIG += memstats
+
+TARGET = cultural-vision-regress
+
+SOURCES += \
+    main.cpp \
+    regressionsuite.cpp
+
+HEADERS += \
+    regressionsuite.h
+
+DISTFILES += \
+    budgets.json
+
+INCLUDEPATH += \
+    $$PWD \
+    $$PWD/..
+
+include($$PWD/../RecognizeImg/recognizeimg.pri)
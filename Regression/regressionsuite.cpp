@@ -0,0 +1,601 @@
+#include "regressionsuite.h"
+#include "recognizeimgthread.h"
+#include "const.h"
+#include "memorystats.h"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+const char* const REGRESSION_STAGES[6] = {"decode", "preprocess", "blob", "run", "postprocess", "end_to_end"};
+
+namespace {
+
+// 最近秩法取分位数
+double Percentile(std::vector<double> samples, double p)
+{
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+    return samples[std::min(samples.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+double Median(const std::vector<double>& values)
+{
+    return Percentile(values, 50.0);
+}
+
+// 最小二乘斜率（y 对 x）
+double Slope(const std::vector<double>& x, const std::vector<double>& y)
+{
+    const size_t n = x.size();
+    if (n < 2) {
+        return 0.0;
+    }
+    double mx = 0.0, my = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        mx += x[i];
+        my += y[i];
+    }
+    mx /= n;
+    my /= n;
+    double sxy = 0.0, sxx = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sxy += (x[i] - mx) * (y[i] - my);
+        sxx += (x[i] - mx) * (x[i] - mx);
+    }
+    return sxx > 0 ? sxy / sxx : 0.0;
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool IsImageFile(const QFileInfo& info)
+{
+    if (!info.isFile()) {
+        return false;
+    }
+    const QString suffix = info.suffix().toLower();
+    for (const char* image_suffix : IMAGE_SUFFIXES) {
+        if (suffix == QLatin1String(image_suffix)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString Ms(double value)
+{
+    return QString::number(value, 'f', 2);
+}
+
+} // namespace
+
+// -------------------- RegressionBudget --------------------
+
+bool RegressionBudget::Load(const QString &path, RegressionBudget &out, QString &error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Cannot open budget file: %1").arg(path);
+        return false;
+    }
+    QJsonParseError parse_error;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parse_error);
+    if (!doc.isObject()) {
+        error = QString("Invalid budget file %1: %2").arg(path, parse_error.errorString());
+        return false;
+    }
+
+    const QJsonObject root = doc.object();
+    RegressionBudget budget;
+    budget.warmup = qMax(0, root.value("warmup").toInt(budget.warmup));
+    budget.repeat = qMax(1, root.value("repeat").toInt(budget.repeat));
+    budget.minTop1Agreement = root.value("min_top1_agreement").toDouble(budget.minTop1Agreement);
+    budget.maxConfidenceDelta = root.value("max_confidence_delta").toDouble(budget.maxConfidenceDelta);
+    budget.minAccuracy = root.value("min_accuracy").toDouble(budget.minAccuracy);
+    budget.minThroughput = root.value("min_throughput_ips").toDouble(budget.minThroughput);
+    budget.maxSlowdown = root.value("max_slowdown").toDouble(budget.maxSlowdown);
+
+    const QJsonObject soak = root.value("soak").toObject();
+    budget.soakWarmupFraction = qBound(0.0, soak.value("warmup_fraction").toDouble(budget.soakWarmupFraction), 0.9);
+    budget.maxRssGrowthMbPerHour = soak.value("max_rss_growth_mb_per_hour").toDouble(budget.maxRssGrowthMbPerHour);
+    budget.maxHeapGrowthMbPerHour = soak.value("max_heap_growth_mb_per_hour").toDouble(budget.maxHeapGrowthMbPerHour);
+
+    const QJsonObject stages = root.value("stages").toObject();
+    for (auto it = stages.begin(); it != stages.end(); ++it) {
+        const QJsonObject stage = it.value().toObject();
+        StageBudget stage_budget;
+        stage_budget.p50Ms = stage.value("p50_ms").toDouble();
+        stage_budget.p95Ms = stage.value("p95_ms").toDouble();
+        budget.stages.insert(it.key(), stage_budget);
+    }
+    out = budget;
+    return true;
+}
+
+// -------------------- RegressionSuite --------------------
+
+RegressionSuite::RegressionSuite(const RegressionOptions &options, const RegressionBudget &budget)
+    : _options(options), _budget(budget)
+{
+}
+
+QString RegressionSuite::Init()
+{
+    _classNames = RecognizeImgThread::readLabels(_options.labelPath.toStdString());
+    if (_classNames.empty()) {
+        return QString("Cannot load labels: %1").arg(_options.labelPath);
+    }
+
+    // 图片集：按相对路径排序，第一级子目录名作为标注
+    const QDir root(_options.datasetDir);
+    if (!root.exists()) {
+        return QString("Dataset not found: %1").arg(_options.datasetDir);
+    }
+    QStringList files;
+    QDirIterator it(root.absolutePath(), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        if (IsImageFile(it.fileInfo())) {
+            files << root.relativeFilePath(it.filePath());
+        }
+    }
+    files.sort();
+    if (files.isEmpty()) {
+        return QString("No images in dataset: %1").arg(_options.datasetDir);
+    }
+
+    for (const QString& rel : files) {
+        QFile file(root.filePath(rel));
+        if (!file.open(QIODevice::ReadOnly)) {
+            return QString("Cannot open image: %1").arg(file.fileName());
+        }
+        Sample sample;
+        sample.path = rel;
+        const int slash = rel.indexOf('/');
+        sample.label = slash > 0 ? rel.left(slash) : QString();
+        sample.bytes = file.readAll();
+        _images.push_back(sample);
+    }
+
+    QString error;
+    _yolo = NewSession(error);
+    return error;
+}
+
+std::unique_ptr<YOLO_V8> RegressionSuite::NewSession(QString &error) const
+{
+    DL_INIT_PARAM params;
+    params.modelPath = _options.modelPath.toStdString();
+    params.imgSize = {_options.imgSize, _options.imgSize};
+    params.modelType = YOLO_CLS;
+    params.cudaEnable = false;
+    params.intraOpNumThreads = _options.intraOpNumThreads;
+    params.logSeverityLevel = 3;
+    std::unique_ptr<YOLO_V8> yolo(new YOLO_V8);
+    const char* ret = yolo->CreateSession(params);
+    if (ret != RET_OK) {
+        error = QString("CreateSession failed: %1").arg(ret);
+        return nullptr;
+    }
+    return yolo;
+}
+
+void RegressionSuite::Run(QTextStream &log)
+{
+    const int stage_count = int(sizeof(REGRESSION_STAGES) / sizeof(REGRESSION_STAGES[0]));
+    std::vector<std::vector<double>> p50s(stage_count), p95s(stage_count);
+    std::vector<double> throughputs;
+    quint64 calls = 0, allocations = 0, bytes = 0;
+
+    const int rounds = _budget.warmup + _budget.repeat;
+    for (int round = 0; round < rounds; ++round) {
+        const bool timed = round >= _budget.warmup;
+        log << (timed ? "round " : "warm-up ") << (timed ? round - _budget.warmup + 1 : round + 1) << "...\n";
+        log.flush();
+
+        std::vector<std::vector<double>> samples(stage_count);
+        int failed = 0;
+        const auto round_start = std::chrono::steady_clock::now();
+        for (Sample& sample : _images) {
+            const auto start = std::chrono::steady_clock::now();
+            cv::Mat image = cv::imdecode(cv::Mat(1, sample.bytes.size(), CV_8UC1, sample.bytes.data()), cv::IMREAD_COLOR);
+            const double decode = ElapsedMs(start);
+
+            // 失败时 LastStageTime / LastAllocations 仍是上一张图片的数据，不计入统计
+            std::vector<DL_RESULT> results;
+            const bool ok = !image.empty() && _yolo->RunSession(image, results) == RET_OK;
+            const double end_to_end = ElapsedMs(start);
+            if (!ok) {
+                ++failed;
+            }
+            if (timed && ok) {
+                ++calls;
+                allocations += _yolo->LastAllocations().allocations;
+                bytes += _yolo->LastAllocations().bytes;
+            }
+
+            int class_id = -1;
+            float confidence = 0.0f;
+            for (const DL_RESULT& result : results) {
+                if (class_id < 0 || result.confidence > confidence) {
+                    class_id = result.classId;
+                    confidence = result.confidence;
+                }
+            }
+            if (round == _budget.warmup) {
+                sample.classId = class_id;
+                sample.confidence = confidence;
+            } else if (timed && class_id != sample.classId) {
+                sample.unstable = true;
+            }
+
+            if (!ok) {
+                continue;
+            }
+            const DL_STAGE_TIME& stage = _yolo->LastStageTime();
+            const double values[] = {decode, stage.preProcess, stage.blob, stage.run, stage.postProcess, end_to_end};
+            for (int s = 0; s < stage_count; ++s) {
+                samples[s].push_back(values[s]);
+            }
+        }
+        const double round_ms = ElapsedMs(round_start);
+        if (failed > 0) {
+            log << "  " << failed << " image(s) failed to decode or classify, not timed\n";
+        }
+
+        if (timed) {
+            for (int s = 0; s < stage_count; ++s) {
+                p50s[s].push_back(Percentile(samples[s], 50.0));
+                p95s[s].push_back(Percentile(samples[s], 95.0));
+            }
+            throughputs.push_back(round_ms > 0 ? (_images.size() - failed) * 1000.0 / round_ms : 0.0);
+        }
+    }
+
+    _stages.clear();
+    for (int s = 0; s < stage_count; ++s) {
+        StageStats stats;
+        stats.p50 = Median(p50s[s]);
+        stats.p95 = Median(p95s[s]);
+        stats.p50Min = *std::min_element(p50s[s].begin(), p50s[s].end());
+        stats.p50Max = *std::max_element(p50s[s].begin(), p50s[s].end());
+        _stages.insert(REGRESSION_STAGES[s], stats);
+    }
+    _throughput = Median(throughputs);
+    _allocsPerCall = calls > 0 ? double(allocations) / calls : 0.0;
+    _bytesPerCall = calls > 0 ? double(bytes) / calls : 0.0;
+}
+
+QString RegressionSuite::ClassName(int classId) const
+{
+    return classId < 0 ? QString("-") : RecognizeImgThread::ClassName(_classNames, classId);
+}
+
+QJsonObject RegressionSuite::LatencyJson() const
+{
+    QJsonObject latency;
+    for (auto it = _stages.begin(); it != _stages.end(); ++it) {
+        QJsonObject stage;
+        stage["p50_ms"] = it->p50;
+        stage["p95_ms"] = it->p95;
+        stage["p50_min_ms"] = it->p50Min;
+        stage["p50_max_ms"] = it->p50Max;
+        latency[it.key()] = stage;
+    }
+    return latency;
+}
+
+QJsonObject RegressionSuite::MemoryJson() const
+{
+    QJsonObject memory;
+    memory["resident_bytes"] = double(MemoryStats::ResidentBytes());
+    memory["peak_resident_bytes"] = double(MemoryStats::PeakResidentBytes());
+    if (MemoryStats::Enabled()) {
+        memory["heap_live_bytes"] = double(MemoryStats::LiveHeapBytes());
+        memory["allocations_per_run"] = _allocsPerCall;
+        memory["allocated_bytes_per_run"] = _bytesPerCall;
+    }
+    std::vector<std::pair<std::string, std::string>> arena;
+    if (_yolo && _yolo->ArenaStats(arena)) {
+        QJsonObject stats;
+        for (const auto& item : arena) {
+            stats[QString::fromStdString(item.first)] = QString::fromStdString(item.second);
+        }
+        memory["ort_arena"] = stats;
+    }
+    return memory;
+}
+
+QJsonObject RegressionSuite::Golden() const
+{
+    QJsonArray images;
+    for (const Sample& sample : _images) {
+        QJsonObject image;
+        image["path"] = sample.path;
+        image["class_id"] = sample.classId;
+        image["class_name"] = ClassName(sample.classId);
+        image["confidence"] = double(sample.confidence);
+        images.append(image);
+    }
+
+    QJsonObject golden;
+    golden["created"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    golden["host"] = QSysInfo::machineHostName();
+    golden["model"] = QFileInfo(_options.modelPath).fileName();
+    golden["imgsz"] = _options.imgSize;
+    golden["intra_threads"] = _options.intraOpNumThreads;
+    golden["images"] = images;
+    golden["latency_ms"] = LatencyJson();
+    golden["throughput_ips"] = _throughput;
+    return golden;
+}
+
+bool RegressionSuite::Compare(const QJsonObject &golden, QTextStream &report)
+{
+    bool pass = true;
+    QJsonArray checks;
+    auto check = [&](const QString& name, bool ok, const QString& detail) {
+        report << (ok ? "PASS  " : "FAIL  ") << name << ": " << detail << "\n";
+        QJsonObject item;
+        item["check"] = name;
+        item["pass"] = ok;
+        item["detail"] = detail;
+        checks.append(item);
+        pass = pass && ok;
+    };
+
+    // ---- 精度：与黄金输出逐张比对 ----
+    QHash<QString, QJsonObject> expected;
+    for (const QJsonValue& value : golden.value("images").toArray()) {
+        const QJsonObject image = value.toObject();
+        expected.insert(image.value("path").toString(), image);
+    }
+
+    QJsonArray changed, drifted, missing;
+    int compared = 0, agreed = 0, labelled = 0, correct = 0, unstable = 0;
+    report << "---- top-1 differences ----\n";
+    for (const Sample& sample : _images) {
+        if (sample.unstable) {
+            ++unstable;
+        }
+        if (!sample.label.isEmpty()) {
+            ++labelled;
+            if (ClassName(sample.classId) == sample.label) {
+                ++correct;
+            }
+        }
+
+        auto it = expected.find(sample.path);
+        if (it == expected.end()) {
+            missing.append(sample.path);
+            continue;
+        }
+        const int golden_id = it->value("class_id").toInt(-1);
+        const double golden_conf = it->value("confidence").toDouble();
+        expected.erase(it);
+        ++compared;
+
+        QJsonObject diff;
+        diff["path"] = sample.path;
+        diff["golden_class"] = ClassName(golden_id);
+        diff["golden_confidence"] = golden_conf;
+        diff["class"] = ClassName(sample.classId);
+        diff["confidence"] = double(sample.confidence);
+        if (golden_id != sample.classId) {
+            changed.append(diff);
+            report << "  " << sample.path << ": " << ClassName(golden_id) << " (" << QString::number(golden_conf, 'f', 4)
+                   << ") -> " << ClassName(sample.classId) << " (" << QString::number(sample.confidence, 'f', 4) << ")\n";
+            continue;
+        }
+        ++agreed;
+        if (_budget.maxConfidenceDelta > 0 && std::fabs(sample.confidence - golden_conf) > _budget.maxConfidenceDelta) {
+            drifted.append(diff);
+            report << "  " << sample.path << ": " << ClassName(sample.classId) << " confidence "
+                   << QString::number(golden_conf, 'f', 4) << " -> " << QString::number(sample.confidence, 'f', 4) << "\n";
+        }
+    }
+    if (changed.isEmpty() && drifted.isEmpty()) {
+        report << "  (none)\n";
+    }
+    for (auto it = expected.begin(); it != expected.end(); ++it) {
+        missing.append(it.key());
+    }
+
+    report << "---- checks ----\n";
+    const double agreement = compared > 0 ? double(agreed) / compared : 0.0;
+    check("golden coverage", missing.isEmpty() && compared > 0,
+          QString("%1 compared, %2 only in dataset or golden").arg(compared).arg(missing.size()));
+    check("top-1 agreement", agreement >= _budget.minTop1Agreement,
+          QString("%1/%2 = %3 (min %4)").arg(agreed).arg(compared).arg(agreement, 0, 'f', 4).arg(_budget.minTop1Agreement));
+    if (_budget.maxConfidenceDelta > 0) {
+        check("confidence drift", drifted.isEmpty(),
+              QString("%1 images beyond %2").arg(drifted.size()).arg(_budget.maxConfidenceDelta));
+    }
+    check("deterministic top-1", unstable == 0, QString("%1 images changed between rounds").arg(unstable));
+    double accuracy = 0.0;
+    if (labelled > 0) {
+        accuracy = double(correct) / labelled;
+        check("label accuracy", accuracy >= _budget.minAccuracy,
+              QString("%1/%2 = %3 (min %4)").arg(correct).arg(labelled).arg(accuracy, 0, 'f', 4).arg(_budget.minAccuracy));
+    }
+
+    // ---- 性能：绝对门限与相对基线 ----
+    const QJsonObject baseline = golden.value("latency_ms").toObject();
+    for (const char* name : REGRESSION_STAGES) {
+        const StageStats stats = _stages.value(QLatin1String(name));
+        const StageBudget budget = _budget.stages.value(name);
+        const QJsonObject base = baseline.value(name).toObject();
+        const QString measured = QString("p50 %1 ms [%2..%3], p95 %4 ms")
+                                     .arg(Ms(stats.p50), Ms(stats.p50Min), Ms(stats.p50Max), Ms(stats.p95));
+
+        if (budget.p50Ms > 0 || budget.p95Ms > 0) {
+            const bool ok = (budget.p50Ms <= 0 || stats.p50 <= budget.p50Ms)
+                            && (budget.p95Ms <= 0 || stats.p95 <= budget.p95Ms);
+            check(QString("%1 budget").arg(QLatin1String(name)), ok,
+                  QString("%1 (budget p50 %2, p95 %3)").arg(measured, Ms(budget.p50Ms), Ms(budget.p95Ms)));
+        }
+        if (_budget.maxSlowdown > 0 && base.contains("p50_ms")) {
+            const double base_p50 = base.value("p50_ms").toDouble();
+            // 基线本身的轮间波动计入允许范围，避免把噪声判为回归
+            const double noise = base.value("p50_max_ms").toDouble(base_p50) - base_p50;
+            const double limit = base_p50 * (1.0 + _budget.maxSlowdown) + qMax(0.0, noise);
+            const double change = base_p50 > 0 ? (stats.p50 / base_p50 - 1.0) * 100.0 : 0.0;
+            check(QString("%1 vs baseline").arg(QLatin1String(name)), stats.p50 <= limit,
+                  QString("%1 (baseline p50 %2 ms, %3%4%, limit %5 ms)")
+                      .arg(measured, Ms(base_p50), QString(change >= 0 ? "+" : "")).arg(change, 0, 'f', 1).arg(Ms(limit)));
+        }
+    }
+    if (_budget.minThroughput > 0) {
+        check("throughput", _throughput >= _budget.minThroughput,
+              QString("%1 images/s (min %2)").arg(_throughput, 0, 'f', 1).arg(_budget.minThroughput));
+    }
+    report << "---- memory ----\n";
+    report << "  peak RSS " << Ms(MemoryStats::PeakResidentBytes() / (1024.0 * 1024.0)) << " MB";
+    if (MemoryStats::Enabled()) {
+        report << ", " << QString::number(_allocsPerCall, 'f', 1) << " allocations / "
+               << QString::number(_bytesPerCall / 1024.0, 'f', 1) << " KB per RunSession";
+    }
+    report << "\n";
+    report << (pass ? "RESULT: PASS\n" : "RESULT: FAIL\n");
+
+    _report = QJsonObject();
+    _report["pass"] = pass;
+    _report["checks"] = checks;
+    _report["changed"] = changed;
+    _report["confidence_drift"] = drifted;
+    _report["missing"] = missing;
+    _report["top1_agreement"] = agreement;
+    if (labelled > 0) {
+        _report["label_accuracy"] = accuracy;
+    }
+    _report["latency_ms"] = LatencyJson();
+    _report["throughput_ips"] = _throughput;
+    _report["memory"] = MemoryJson();
+    _report["golden_created"] = golden.value("created");
+    _report["warmup"] = _budget.warmup;
+    _report["repeat"] = _budget.repeat;
+    return pass;
+}
+
+bool RegressionSuite::Soak(double minutes, bool sessionPerImage, QTextStream &log, QTextStream &report)
+{
+    const double duration_s = minutes * 60.0;
+    const auto begin = std::chrono::steady_clock::now();
+    auto elapsed_s = [&begin]() { return ElapsedMs(begin) / 1000.0; };
+
+    // 每轮一个采样点：时间、常驻内存、堆存活字节
+    std::vector<double> times, rss, heap;
+    QJsonArray samples;
+    quint64 inferences = 0;
+    int failures = 0;
+    double last_log = 0.0;
+    while (elapsed_s() < duration_s) {
+        for (const Sample& sample : _images) {
+            std::unique_ptr<YOLO_V8> fresh;
+            YOLO_V8* yolo = _yolo.get();
+            if (sessionPerImage) {
+                QString error;
+                fresh = NewSession(error);
+                if (!fresh) {
+                    ++failures;
+                    continue;
+                }
+                yolo = fresh.get();
+            }
+            const cv::Mat encoded(1, sample.bytes.size(), CV_8UC1, const_cast<char*>(sample.bytes.constData()));
+            cv::Mat image = cv::imdecode(encoded, cv::IMREAD_COLOR);
+            std::vector<DL_RESULT> results;
+            if (image.empty() || yolo->RunSession(image, results) != RET_OK) {
+                ++failures;
+            }
+            ++inferences;
+        }
+
+        const double t = elapsed_s();
+        times.push_back(t);
+        rss.push_back(double(MemoryStats::ResidentBytes()));
+        heap.push_back(double(MemoryStats::LiveHeapBytes()));
+        QJsonObject point;
+        point["t_s"] = t;
+        point["resident_bytes"] = rss.back();
+        if (MemoryStats::Enabled()) {
+            point["heap_live_bytes"] = heap.back();
+        }
+        samples.append(point);
+
+        if (t - last_log >= 60.0) {
+            last_log = t;
+            log << QString("soak %1/%2 min, %3 inferences, RSS %4 MB\n")
+                       .arg(t / 60.0, 0, 'f', 1).arg(minutes, 0, 'f', 1).arg(inferences)
+                       .arg(rss.back() / (1024.0 * 1024.0), 0, 'f', 1);
+            log.flush();
+        }
+    }
+
+    // 稳定期：去掉开头的爬升阶段
+    std::vector<double> steady_t, steady_rss, steady_heap;
+    const double from = duration_s * _budget.soakWarmupFraction;
+    for (size_t i = 0; i < times.size(); ++i) {
+        if (times[i] >= from) {
+            steady_t.push_back(times[i] / 3600.0);
+            steady_rss.push_back(rss[i] / (1024.0 * 1024.0));
+            steady_heap.push_back(heap[i] / (1024.0 * 1024.0));
+        }
+    }
+    const double rss_slope = Slope(steady_t, steady_rss);
+    const double heap_slope = Slope(steady_t, steady_heap);
+
+    bool pass = true;
+    QJsonArray checks;
+    auto check = [&](const QString& name, bool ok, const QString& detail) {
+        report << (ok ? "PASS  " : "FAIL  ") << name << ": " << detail << "\n";
+        QJsonObject item;
+        item["check"] = name;
+        item["pass"] = ok;
+        item["detail"] = detail;
+        checks.append(item);
+        pass = pass && ok;
+    };
+
+    report << "---- soak ----\n";
+    check("steady-state samples", steady_t.size() >= 5,
+          QString("%1 rounds after the first %2% of %3 min").arg(steady_t.size())
+              .arg(_budget.soakWarmupFraction * 100.0, 0, 'f', 0).arg(minutes, 0, 'f', 1));
+    check("inference errors", failures == 0, QString("%1 of %2").arg(failures).arg(inferences));
+    check("RSS growth", rss_slope <= _budget.maxRssGrowthMbPerHour,
+          QString("%1 MB/h (max %2)").arg(rss_slope, 0, 'f', 2).arg(_budget.maxRssGrowthMbPerHour));
+    if (MemoryStats::Enabled()) {
+        check("heap growth", heap_slope <= _budget.maxHeapGrowthMbPerHour,
+              QString("%1 MB/h (max %2)").arg(heap_slope, 0, 'f', 2).arg(_budget.maxHeapGrowthMbPerHour));
+    }
+    report << "  peak RSS " << Ms(MemoryStats::PeakResidentBytes() / (1024.0 * 1024.0)) << " MB\n";
+    report << (pass ? "RESULT: PASS\n" : "RESULT: FAIL\n");
+
+    _report = QJsonObject();
+    _report["pass"] = pass;
+    _report["checks"] = checks;
+    _report["minutes"] = minutes;
+    _report["session_per_image"] = sessionPerImage;
+    _report["inferences"] = double(inferences);
+    _report["rss_growth_mb_per_hour"] = rss_slope;
+    if (MemoryStats::Enabled()) {
+        _report["heap_growth_mb_per_hour"] = heap_slope;
+    }
+    _report["samples"] = samples;
+    _report["memory"] = MemoryJson();
+    return pass;
+}
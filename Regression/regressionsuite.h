@@ -0,0 +1,137 @@
+#ifndef REGRESSIONSUITE_H
+#define REGRESSIONSUITE_H
+
+#include <QJsonObject>
+#include <QMap>
+#include <QStringList>
+#include <QTextStream>
+#include <memory>
+#include <vector>
+#include "inference.h"
+
+// 单个阶段的延迟上限（毫秒），0 表示不检查
+struct StageBudget
+{
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+};
+
+/**
+ * @brief 回归检查的门限（budgets.json）
+ * 所有门限为 0 时不检查；max_slowdown 相对黄金文件中记录的基线延迟（0.15 表示允许慢 15%）。
+ */
+struct RegressionBudget
+{
+    int warmup = 5;                     // 预热轮数（整套图片跑一遍为一轮，不计入统计）
+    int repeat = 5;                     // 计时轮数，各阶段取每轮分位数的中位数
+    double minTop1Agreement = 1.0;      // 与黄金输出 top-1 一致的最低比例
+    double maxConfidenceDelta = 0.0;    // top-1 一致时置信度允许的最大偏差
+    double minAccuracy = 0.0;           // 按目录名标注计算的最低准确率
+    double minThroughput = 0.0;         // 最低吞吐（图片/秒，端到端）
+    double maxSlowdown = 0.0;           // 相对基线的最大变慢比例
+    double soakWarmupFraction = 0.2;    // 长稳测试中前多少比例的时间不计入（内存爬升期）
+    double maxRssGrowthMbPerHour = 16;  // 稳定期常驻内存的最大增长斜率（MB/小时）
+    double maxHeapGrowthMbPerHour = 8;  // 稳定期堆存活字节的最大增长斜率（MB/小时，需 CV_MEMSTATS）
+    QMap<QString, StageBudget> stages;  // decode / preprocess / blob / run / postprocess / end_to_end
+
+    static bool Load(const QString& path, RegressionBudget& out, QString& error);
+};
+
+// 运行参数
+struct RegressionOptions
+{
+    QString modelPath;
+    QString labelPath;
+    QString datasetDir;         // 标注图片集，子目录名即类别名（可选）
+    int imgSize = 640;
+    int intraOpNumThreads = 1;
+};
+
+/**
+ * @brief 固定图片集的精度与性能回归检查
+ * 图片只读盘一次，之后每轮从内存解码并推理，分别记录解码、PreProcess、BlobFromImage、
+ * session->Run、后处理与端到端耗时。每轮统计 p50/p95，跨轮取中位数以降低噪声，
+ * 同时给出各轮 p50 的最小值与最大值作为波动参考。
+ * Record 生成黄金文件（top-1 与基线延迟），Compare 与黄金文件比对并输出差异报告。
+ */
+class RegressionSuite
+{
+public:
+    RegressionSuite(const RegressionOptions& options, const RegressionBudget& budget);
+
+    // 加载模型与图片集，失败返回错误信息
+    QString Init();
+
+    // 预热并计时
+    void Run(QTextStream& log);
+
+    // 当前结果作为黄金文件
+    QJsonObject Golden() const;
+
+    /**
+     * @brief 与黄金文件比对
+     * @param golden 黄金文件内容
+     * @param report 文本差异报告
+     * @return 是否全部通过
+     */
+    bool Compare(const QJsonObject& golden, QTextStream& report);
+
+    /**
+     * @brief 长稳测试：反复推理整套图片直到时间用完，每轮记录常驻内存与堆存活字节，
+     * 去掉前 soakWarmupFraction 的时间后按最小二乘求增长斜率，超过门限即失败
+     * @param minutes 持续时间（分钟）
+     * @param sessionPerImage 每张图片新建一次会话（与实时检测中每帧一个 RecognizeImgThread 一致）
+     * @param log 进度输出
+     * @param report 文本报告
+     * @return 是否通过
+     */
+    bool Soak(double minutes, bool sessionPerImage, QTextStream& log, QTextStream& report);
+
+    // 比对结果（JSON，Compare / Soak 之后有效）
+    QJsonObject Report() const { return _report; }
+
+    int ImageCount() const { return int(_images.size()); }
+
+private:
+    // 一张图片
+    struct Sample
+    {
+        QString path;           // 相对图片集目录
+        QString label;          // 目录名标注，没有时为空
+        QByteArray bytes;       // 文件内容
+        int classId = -1;       // 第一轮计时的 top-1
+        float confidence = 0.0f;
+        bool unstable = false;  // 各轮 top-1 不一致
+    };
+
+    // 一个阶段的统计（跨轮）
+    struct StageStats
+    {
+        double p50 = 0.0;       // 各轮 p50 的中位数
+        double p95 = 0.0;       // 各轮 p95 的中位数
+        double p50Min = 0.0;    // 各轮 p50 的最小值
+        double p50Max = 0.0;    // 各轮 p50 的最大值
+    };
+
+    QString ClassName(int classId) const;
+    QJsonObject LatencyJson() const;
+    QJsonObject MemoryJson() const;
+    std::unique_ptr<YOLO_V8> NewSession(QString& error) const;
+
+private:
+    RegressionOptions _options;
+    RegressionBudget _budget;
+    std::unique_ptr<YOLO_V8> _yolo;
+    std::vector<std::string> _classNames;
+    std::vector<Sample> _images;
+    QMap<QString, StageStats> _stages;
+    double _throughput = 0.0;           // 各轮吞吐的中位数（图片/秒）
+    double _allocsPerCall = 0.0;        // 计时轮中每次 RunSession 的平均堆分配次数
+    double _bytesPerCall = 0.0;         // 计时轮中每次 RunSession 的平均堆分配字节
+    QJsonObject _report;
+};
+
+// 回归检查中统计的阶段（输出顺序）
+extern const char* const REGRESSION_STAGES[6];
+
+#endif // REGRESSIONSUITE_H
@@ -1,5 +1,6 @@
 #include "picdetection.h"
 #include "ui_picdetection.h"
+#include <QDebug>
 
 PicDetection::PicDetection(QWidget *parent)
     : QDialog(parent)
@@ -56,13 +57,20 @@ void PicDetection::SlotRecognizeImg()
 
     // 创建识别线程，父对象为当前窗口（Qt 自动管理生命周期）
     _recognize_img_thread = new RecognizeImgThread(_pic_path, labelPath, modelPath, this);
+    _recognize_img_thread->SetModelBundle(ModelRegistry::Instance().Current()); // 使用当前版本的模型与标签
+    _recognize_img_thread->SetIndexEmbedding(true); // 同时加入相似检索索引
+    const QString picPath = _pic_path;
 
     // ===== 成功信号连接 =====
     connect(_recognize_img_thread, &RecognizeImgThread::SigRecognizeFinish,
-            this, [this](const QString &className, float confidence) {
+            this, [this, picPath](const QString &className, float confidence, quint64 modelId) {
                 float displayConfidence = (confidence * 100.0f > 99.99f) ? 99.99f : confidence * 100.0f ;
                 ui->label_1->setText(QString("识别结果：%1 ").arg(className));
                 ui->label_2->setText(QString("置信度 %1%").arg(displayConfidence, 0, 'f', 2));
+
+                // 通知相似图片面板查询
+                emit SigRecognizeDone(picPath, modelId);
+                emit SigRecognizeResult(picPath, className, confidence);
             });
 
     // ===== 失败信号连接 =====
@@ -30,6 +30,8 @@ private slots:
     void SlotRecognizeImg();
 signals:
     void SigClicked(); // 信号：当用户点击按钮时发出
+    void SigRecognizeDone(const QString& path, quint64 modelId); // 信号：图片识别完成（用于在该模型的索引中查询相似图片）
+    void SigRecognizeResult(const QString& path, const QString& className, float confidence); // 信号：识别结果（用于按类别浏览）
 };
 
 #endif // PICDETECTION_H
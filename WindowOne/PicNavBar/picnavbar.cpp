@@ -0,0 +1,78 @@
+#include "picnavbar.h"
+#include "recognizeimgthread.h"
+#include "mainwindow.h"
+#include <QHBoxLayout>
+
+PicNavBar::PicNavBar(QWidget *parent)
+    : QWidget(parent)
+{
+    // 类别列表取自当前模型版本的标签表，模型热替换后重新填充
+    _class_box = new QComboBox(this);
+    SlotReloadClasses();
+    connect(&ModelRegistry::Instance(), &ModelRegistry::modelChanged, this, &PicNavBar::SlotReloadClasses);
+
+    _conf_box = new QSpinBox(this);
+    _conf_box->setRange(0, 100);
+    _conf_box->setPrefix(tr("置信度 < "));
+    _conf_box->setSuffix("%");
+    _conf_box->setSpecialValueText(tr("置信度不限"));
+
+    _pos_box = new QSpinBox(this);
+    _pos_box->setRange(0, 0);
+    _pos_box->setSpecialValueText("-");
+    _pos_box->setKeyboardTracking(false);
+    _pos_box->setButtonSymbols(QAbstractSpinBox::NoButtons);
+    _pos_box->setAlignment(Qt::AlignRight);
+
+    auto* layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(_class_box, 1);
+    layout->addWidget(_conf_box);
+    layout->addWidget(_pos_box);
+
+    connect(_class_box, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &PicNavBar::SlotFilterChanged);
+    connect(_conf_box, QOverload<int>::of(&QSpinBox::valueChanged), this, &PicNavBar::SlotFilterChanged);
+    connect(_pos_box, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int pos) {
+        if (pos > 0) {
+            emit SigJumpTo(pos);
+        }
+    });
+}
+
+void PicNavBar::SlotUpdatePosition(int pos, int size, int total)
+{
+    // 程序设置的值不触发跳转
+    const QSignalBlocker blocker(_pos_box);
+    _pos_box->setRange(0, size);
+    _pos_box->setValue(pos);
+    _pos_box->setSuffix(size == total ? QString(" / %1").arg(size)
+                                      : QString(" / %1（共 %2）").arg(size).arg(total));
+}
+
+void PicNavBar::SlotReloadClasses()
+{
+    const QString selected = _class_box->currentIndex() > 0 ? _class_box->currentText() : QString();
+    const std::shared_ptr<const ModelBundle> bundle = ModelRegistry::Instance().Current();
+    const std::vector<std::string> classNames = bundle ? bundle->classNames
+                                                       : RecognizeImgThread::readLabels(LABEL_PATH.toStdString());
+    {
+        const QSignalBlocker blocker(_class_box);
+        _class_box->clear();
+        _class_box->addItem(tr("全部类别"));
+        for (const std::string& name : classNames) {
+            _class_box->addItem(QString::fromStdString(name));
+        }
+        // 新模型仍有该类别时保持选中
+        _class_box->setCurrentIndex(selected.isEmpty() ? 0 : qMax(0, _class_box->findText(selected)));
+    }
+    if (!selected.isEmpty() && _class_box->currentIndex() == 0) {
+        SlotFilterChanged(); // 所选类别已不存在，筛选改为不限
+    }
+}
+
+void PicNavBar::SlotFilterChanged()
+{
+    const QString class_name = _class_box->currentIndex() > 0 ? _class_box->currentText() : QString();
+    const float max_confidence = _conf_box->value() > 0 ? _conf_box->value() / 100.0f : 1.0f;
+    emit SigFilterChanged(class_name, max_confidence);
+}
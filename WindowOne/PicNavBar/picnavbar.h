@@ -0,0 +1,47 @@
+#ifndef PICNAVBAR_H
+#define PICNAVBAR_H
+
+#include <QComboBox>
+#include <QSpinBox>
+#include <QWidget>
+
+/**
+ * @brief 图片浏览导航栏
+ * 显示当前图片在项目（或筛选结果）中的位置，输入序号可直接跳转；
+ * 可按识别类别和置信度上限筛选，上一张/下一张只在筛选结果中切换。
+ */
+class PicNavBar : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit PicNavBar(QWidget *parent = nullptr);
+
+public slots:
+    /**
+     * @brief 更新位置显示
+     * @param pos 当前序号，从 1 开始，0 表示当前图片不在筛选结果中
+     * @param size 筛选结果中的图片数量
+     * @param total 项目中的图片数量
+     */
+    void SlotUpdatePosition(int pos, int size, int total);
+
+private slots:
+    void SlotFilterChanged();
+
+    // 按当前模型版本的标签表重新填充类别列表
+    void SlotReloadClasses();
+
+private:
+    QComboBox* _class_box;   // 类别筛选
+    QSpinBox* _conf_box;     // 置信度上限（百分比，0 表示不限）
+    QSpinBox* _pos_box;      // 当前序号，可输入跳转
+
+signals:
+    // 筛选条件变化，className 为空表示不限，maxConfidence 为 1 表示不限
+    void SigFilterChanged(const QString& className, float maxConfidence);
+
+    // 跳转到第 pos 张（从 1 开始）
+    void SigJumpTo(int pos);
+};
+
+#endif // PICNAVBAR_H
@@ -0,0 +1,180 @@
+#include "picprefetcher.h"
+#include "const.h"
+#include "metrics.h"
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QThread>
+
+namespace {
+
+// 缓存占用（开销按 KB 计）写入 cv_pool_bytes
+void UpdatePoolGauge(int costKb)
+{
+    static Gauge& bytes = Metrics::Instance().GetGauge("cv_pool_bytes", "Approximate bytes held by image pools and caches.", "pool=\"prefetch\"");
+    bytes.Set(qint64(costKb) * 1024);
+}
+
+} // namespace
+
+PicPrefetcher::PicPrefetcher(QObject *parent)
+    : QObject(parent)
+{
+    _pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 2 * PREFETCH_COUNT));
+    _cache.setMaxCost(PREFETCH_CACHE_MB * 1024);
+
+    // 工作线程的结果回到界面线程写入缓存
+    connect(this, &PicPrefetcher::SigDecoded, this, &PicPrefetcher::SlotDecoded, Qt::QueuedConnection);
+}
+
+PicPrefetcher::~PicPrefetcher()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _urgent = Job();
+        _queue.clear();
+    }
+    _pool.waitForDone();
+}
+
+void PicPrefetcher::SetTargetSize(const QSize &size)
+{
+    if (size == _target) {
+        return;
+    }
+    _target = size;
+    _cache.clear();
+    UpdatePoolGauge(0);
+}
+
+bool PicPrefetcher::Find(const QString &path, QImage &out)
+{
+    static Metrics& metrics = Metrics::Instance();
+    static Counter& hit = metrics.GetCounter("cv_prefetch_lookups_total", "Picture viewer prefetch cache lookups, by outcome.", "outcome=\"hit\"");
+    static Counter& miss = metrics.GetCounter("cv_prefetch_lookups_total", "Picture viewer prefetch cache lookups, by outcome.", "outcome=\"miss\"");
+
+    if (QImage* image = _cache.object(path)) {
+        out = *image;
+        _hits++;
+        hit.Inc();
+        return true;
+    }
+    _misses++;
+    miss.Inc();
+    return false;
+}
+
+void PicPrefetcher::Load(const QString &path)
+{
+    _loading = path;
+    {
+        QMutexLocker locker(&_mutex);
+        // 已在解码中时等待其完成即可
+        if (_inflight.contains(path)) {
+            return;
+        }
+        _urgent = {path, _target};
+    }
+    StartWorkers();
+}
+
+void PicPrefetcher::Prefetch(const QStringList &paths)
+{
+    if (!_target.isValid()) {
+        return;
+    }
+
+    QVector<Job> jobs;
+    for (const QString& path : paths) {
+        if (!_cache.contains(path)) {
+            jobs.append({path, _target});
+        }
+    }
+
+    {
+        QMutexLocker locker(&_mutex);
+        _queue.clear();
+        // 倒序存放，工作线程从末尾取，离当前图片最近的最先解码
+        for (int i = jobs.size() - 1; i >= 0; --i) {
+            if (!_inflight.contains(jobs.at(i).path)) {
+                _queue.append(jobs.at(i));
+            }
+        }
+    }
+    StartWorkers();
+}
+
+double PicPrefetcher::HitRate() const
+{
+    const quint64 total = _hits + _misses;
+    return total ? double(_hits) / double(total) : 0.0;
+}
+
+void PicPrefetcher::StartWorkers()
+{
+    QMutexLocker locker(&_mutex);
+    const int pending = _queue.size() + (_urgent.path.isEmpty() ? 0 : 1);
+    while (_workers < _pool.maxThreadCount() && _workers < pending) {
+        _workers++;
+        _pool.start([this]() { Work(); });
+    }
+}
+
+void PicPrefetcher::Work()
+{
+    for (;;) {
+        Job job;
+        {
+            QMutexLocker locker(&_mutex);
+            if (!_urgent.path.isEmpty()) {
+                job = _urgent;
+                _urgent = Job();
+            } else if (!_queue.isEmpty()) {
+                job = _queue.takeLast();
+            } else {
+                _workers--;
+                return;
+            }
+            _inflight.insert(job.path);
+        }
+        emit SigDecoded(job.path, job.target, Decode(job.path, job.target));
+    }
+}
+
+QImage PicPrefetcher::Decode(const QString &path, const QSize &target)
+{
+    // 直接按显示尺寸解码（JPEG 在 DCT 阶段缩小），避免生成全尺寸像素后再缩放
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+    const QSize size = reader.size();
+    if (size.isValid() && (size.width() > target.width() || size.height() > target.height())) {
+        reader.setScaledSize(size.scaled(target, Qt::KeepAspectRatio));
+    }
+    QImage image = reader.read();
+    if (!image.isNull() && (image.width() > target.width() || image.height() > target.height())) {
+        image = image.scaled(target, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return image;
+}
+
+void PicPrefetcher::SlotDecoded(const QString &path, const QSize &target, const QImage &image)
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _inflight.remove(path);
+    }
+
+    // 显示尺寸已经变化的结果不再缓存
+    if (!image.isNull() && target == _target) {
+        _cache.insert(path, new QImage(image), qMax(1, int(image.sizeInBytes() / 1024)));
+        UpdatePoolGauge(_cache.totalCost());
+    }
+
+    if (path == _loading) {
+        _loading.clear();
+        if (target == _target) {
+            emit SigImageReady(path, image);
+        } else {
+            Load(path); // 解码期间窗口尺寸变了，按新尺寸重新解码
+        }
+    }
+}
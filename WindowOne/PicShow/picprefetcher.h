@@ -0,0 +1,100 @@
+#ifndef PICPREFETCHER_H
+#define PICPREFETCHER_H
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QSize>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+/**
+ * @brief 图片预取器
+ * 在工作线程中把当前图片前后的若干张图片解码成显示尺寸，放入按内存占用限制的 LRU 缓存，
+ * 上一张/下一张切换时直接从缓存取图，界面线程不再做解码和缩放。
+ * 除 Work() 外的所有接口只在界面线程调用。
+ */
+class PicPrefetcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PicPrefetcher(QObject *parent = nullptr);
+    ~PicPrefetcher();
+
+    /**
+     * @brief 设置显示尺寸，尺寸变化时清空缓存（缓存中的图片按旧尺寸缩放）
+     * @param size 显示区域大小
+     */
+    void SetTargetSize(const QSize& size);
+
+    /**
+     * @brief 从缓存中取图，同时统计命中率
+     * @param path 图片路径
+     * @param out 显示尺寸的图片
+     * @return 是否命中
+     */
+    bool Find(const QString& path, QImage& out);
+
+    /**
+     * @brief 以最高优先级解码一张图片（当前要显示的图片未命中时调用）
+     * 完成后发出 SigImageReady
+     */
+    void Load(const QString& path);
+
+    /**
+     * @brief 预取一组图片（按优先级排列），替换之前尚未开始的预取任务
+     * @param paths 图片路径
+     */
+    void Prefetch(const QStringList& paths);
+
+    // 命中率统计
+    quint64 Hits() const { return _hits; }
+    quint64 Misses() const { return _misses; }
+    double HitRate() const;
+
+private:
+    // 一次解码任务
+    struct Job
+    {
+        QString path;   // 图片路径
+        QSize target;   // 显示尺寸
+    };
+
+    void StartWorkers();
+    void Work();                                        // 工作线程循环
+    static QImage Decode(const QString& path, const QSize& target);
+
+private slots:
+    void SlotDecoded(const QString& path, const QSize& target, const QImage& image);
+
+private:
+    QThreadPool _pool;
+    QCache<QString, QImage> _cache;     // 显示尺寸的图片，开销按 KB 计
+    QSize _target;                      // 当前显示尺寸
+    QString _loading;                   // 通过 Load 请求、等待显示的路径
+
+    QMutex _mutex;                      // 保护以下成员（工作线程与界面线程共享）
+    Job _urgent;                        // 当前要显示的图片，优先于预取
+    QVector<Job> _queue;                // 预取任务（末尾最先处理）
+    int _workers = 0;                   // 正在运行的工作线程数
+    QSet<QString> _inflight;            // 正在解码、尚未返回的路径
+
+    quint64 _hits = 0;                  // 命中次数
+    quint64 _misses = 0;                // 未命中次数
+
+signals:
+    // 工作线程完成一次解码（内部使用）
+    void SigDecoded(const QString& path, const QSize& target, const QImage& image);
+
+    /**
+     * @brief 通过 Load 请求的图片已就绪
+     * @param path 图片路径
+     * @param image 显示尺寸的图片，无法解码时为空
+     */
+    void SigImageReady(const QString& path, const QImage& image);
+};
+
+#endif // PICPREFETCHER_H
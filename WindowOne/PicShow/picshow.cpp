@@ -1,5 +1,8 @@
 #include "picshow.h"
 #include "ui_picshow.h"
+#include <QDebug>
+#include <QImageReader>
+#include <QTimer>
 
 
 PicShow::PicShow(QWidget *parent)
@@ -32,6 +35,24 @@ PicShow::PicShow(QWidget *parent)
     connect(ui->nextBtn, &QPushButton::clicked, this, &PicShow::SigNextClicked);
     connect(ui->previousBtn, &QPushButton::clicked, this, &PicShow::SigPreClicked);
 
+    _prefetcher = new PicPrefetcher(this);
+    connect(_prefetcher, &PicPrefetcher::SigImageReady, this, &PicShow::SlotImageReady);
+
+    // 拖动改变窗口大小时只在停下后按新尺寸重新解码一次
+    _resize_timer = new QTimer(this);
+    _resize_timer->setSingleShot(true);
+    _resize_timer->setInterval(150);
+    connect(_resize_timer, &QTimer::timeout, this, [this]() {
+        if (!_tiled_view->isVisible() && !_selected_path.isEmpty() && QFileInfo(_selected_path).isFile()) {
+            _prefetcher->SetTargetSize(ui->label->size());
+            _prefetcher->Load(_selected_path);
+        }
+    });
+
+    _tiled_view = new TiledImageView(this);
+    ui->gridLayout->addWidget(_tiled_view, 1, 3);
+    _tiled_view->hide();
+
     // 打开样式文件（这里假设 qss 文件放在资源文件中）
     QFile qssFile(":/style/PicShow.qss");
 
@@ -90,6 +111,9 @@ void PicShow::resizeEvent(QResizeEvent *event)
             );
         ui->label->setPixmap(scaled);
     }
+
+    // 缓存中的图片按旧尺寸缩放，尺寸稳定后按新尺寸重新解码当前图片（大图由瓦片控件自行重绘）
+    _resize_timer->start();
 }
 
 void PicShow::ShowPreNextBtns(bool b_show)
@@ -130,12 +154,7 @@ void PicShow::ShowPreNextBtns(bool b_show)
 
 void PicShow::SlotSelectItem(const QString &path)
 {
-    _selected_path = path;
-    _pix_map.load(path);
-    auto width = this->width() - 20;
-    auto height = this->height() - 20;
-    _pix_map = _pix_map.scaled(width, height, Qt::KeepAspectRatio);
-    ui->label->setPixmap(_pix_map);
+    SlotUpdatePic(path);
 }
 
 void PicShow::SlotUpdatePic(const QString &_path)
@@ -143,6 +162,7 @@ void PicShow::SlotUpdatePic(const QString &_path)
     _selected_path = _path;
 
     if (_selected_path.isEmpty()) {
+        ShowTiled(false);
         ui->label->clear();
         _pix_map = QPixmap(); // 清空缓存
         return;
@@ -151,29 +171,75 @@ void PicShow::SlotUpdatePic(const QString &_path)
     QFileInfo fileInfo(_selected_path);
 
     if (fileInfo.isDir()) {
+        ShowTiled(false);
         ui->label->setText("📁 当前路径是文件夹");
         _pix_map = QPixmap(); // 清空缓存
         return;
     }
 
     if (fileInfo.isFile()) {
-        QPixmap originalPix;
-        if (originalPix.load(_selected_path)) {
-            _pix_map = originalPix; // 保存原图
-            QPixmap scaled = _pix_map.scaled(
-                ui->label->size(),
-                Qt::KeepAspectRatio,
-                Qt::SmoothTransformation
-                );
-            ui->label->setPixmap(scaled);
-            ui->label->setAlignment(Qt::AlignCenter);
+        // 超大图片用瓦片金字塔浏览，只读取文件头判断尺寸
+        const QSize size = QImageReader(_selected_path).size();
+        if (qint64(size.width()) * size.height() >= PYRAMID_MIN_PIXELS && _tiled_view->Open(_selected_path)) {
+            ShowTiled(true);
+            _pix_map = QPixmap();
+            return;
+        }
+        ShowTiled(false);
+
+        // 预取命中时直接显示；未命中时交给工作线程解码，完成后在 SlotImageReady 中显示
+        _prefetcher->SetTargetSize(ui->label->size());
+        QImage image;
+        if (_prefetcher->Find(_selected_path, image)) {
+            ShowImage(image);
         } else {
-            ui->label->setText("⚠️ 无法加载图片");
-            _pix_map = QPixmap(); // 清空缓存
+            _prefetcher->Load(_selected_path);
         }
     }
 }
 
+void PicShow::ShowImage(const QImage &image)
+{
+    if (image.isNull()) {
+        ui->label->setText("⚠️ 无法加载图片");
+        _pix_map = QPixmap(); // 清空缓存
+        return;
+    }
+    // 图片已是显示尺寸，无需再缩放
+    _pix_map = QPixmap::fromImage(image);
+    ui->label->setPixmap(_pix_map);
+    ui->label->setAlignment(Qt::AlignCenter);
+}
+
+void PicShow::ShowTiled(bool tiled)
+{
+    if (tiled) {
+        ui->label->clear();
+        _tiled_view->show();
+        _tiled_view->raise();
+        // 保持上一张/下一张按钮在最上层
+        ui->widget->raise();
+        ui->widget_2->raise();
+    } else if (_tiled_view->isVisible()) {
+        _tiled_view->hide();
+        _tiled_view->Clear();
+    }
+}
+
+void PicShow::SlotImageReady(const QString &path, const QImage &image)
+{
+    // 解码期间已经切换到别的图片时丢弃
+    if (path != _selected_path || _tiled_view->isVisible()) {
+        return;
+    }
+    ShowImage(image);
+}
+
+void PicShow::SlotPrefetch(const QStringList &paths)
+{
+    _prefetcher->Prefetch(paths);
+}
+
 
 
 // void PicShow::SlotUpdatePic(const QString &_path)
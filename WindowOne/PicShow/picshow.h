@@ -7,6 +7,9 @@
 #include <QString>
 #include <QFileInfo>
 #include <QFile>
+#include <QTimer>
+#include "picprefetcher.h"
+#include "tiledimageview.h"
 
 namespace Ui {
 class PicShow;
@@ -32,6 +35,12 @@ private:
 
     QString GetSelectedPath();
 
+    // 显示一张显示尺寸的图片
+    void ShowImage(const QImage& image);
+
+    // 切换到瓦片浏览（大图）或普通显示
+    void ShowTiled(bool tiled);
+
     Ui::PicShow *ui;
 
     // 动画对象：用于控制“上一张”按钮的显示/隐藏动画效果（如淡入淡出）
@@ -49,6 +58,15 @@ private:
     // 当前加载的图片，使用QPixmap存储图像数据，便于显示
     QPixmap _pix_map;
 
+    // 前后图片预取器，切换图片时优先从其缓存取图
+    PicPrefetcher * _prefetcher;
+
+    // 大图浏览控件，与 label 占据同一格，只在显示大图时可见
+    TiledImageView * _tiled_view;
+
+    // 窗口大小变化的去抖定时器，停止变化后才按新尺寸重新解码
+    QTimer * _resize_timer;
+
 public slots:
     // 槽函数：当用户选择了一个新的图片项时调用，传入该图片的路径
     void SlotSelectItem(const QString& path);
@@ -59,6 +77,13 @@ public slots:
     // 槽函数：当用户触发删除当前图片项的操作时调用
     void SlotDeleteItem();
 
+    // 槽函数：预取当前图片前后的图片（按优先级排列）
+    void SlotPrefetch(const QStringList& paths);
+
+private slots:
+    // 槽函数：未命中缓存的图片解码完成
+    void SlotImageReady(const QString& path, const QImage& image);
+
 signals:
     // 信号：当用户点击“下一张”按钮时发出，通知外部切换到下一张图片
     void SigNextClicked();
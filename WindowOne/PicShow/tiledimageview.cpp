@@ -0,0 +1,221 @@
+#include "tiledimageview.h"
+#include "const.h"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+#include <cmath>
+
+namespace {
+const double MAX_SCALE = 8.0;       // 最大放大倍数（屏幕像素 / 原图像素）
+const double ZOOM_STEP = 1.25;      // 滚轮每格的缩放倍数
+}
+
+TiledImageView::TiledImageView(QWidget *parent)
+    : QWidget(parent), _pyramid(new TilePyramid(this))
+{
+    setMouseTracking(false);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    connect(_pyramid, &TilePyramid::SigTileReady, this, QOverload<>::of(&TiledImageView::update));
+}
+
+bool TiledImageView::Open(const QString &path)
+{
+    if (!_pyramid->Open(path)) {
+        update();
+        return false;
+    }
+    _fit = true;
+    _scale = FitScale();
+    _center = QPointF(_pyramid->ImageSize().width() / 2.0, _pyramid->ImageSize().height() / 2.0);
+    update();
+    return true;
+}
+
+void TiledImageView::Clear()
+{
+    _pyramid->Close();
+    update();
+}
+
+double TiledImageView::FitScale() const
+{
+    const QSize size = _pyramid->ImageSize();
+    if (size.isEmpty() || width() <= 0 || height() <= 0) {
+        return 1.0;
+    }
+    return qMin(1.0, qMin(double(width()) / size.width(), double(height()) / size.height()));
+}
+
+void TiledImageView::ClampCenter()
+{
+    // 图片比视口小时居中，否则不允许拖出边界
+    const QSizeF image(_pyramid->ImageSize());
+    const double half_w = width() / (2.0 * _scale);
+    const double half_h = height() / (2.0 * _scale);
+    _center.setX(image.width() <= 2 * half_w ? image.width() / 2 : qBound(half_w, _center.x(), image.width() - half_w));
+    _center.setY(image.height() <= 2 * half_h ? image.height() / 2 : qBound(half_h, _center.y(), image.height() - half_h));
+}
+
+bool TiledImageView::CoarserTile(int level, int tx, int ty, QPixmap &pixmap, QRectF &source)
+{
+    for (int coarse = level + 1; coarse < _pyramid->LevelCount(); ++coarse) {
+        const int shift = coarse - level;
+        const int ctx = tx >> shift;
+        const int cty = ty >> shift;
+        if (!_pyramid->Tile(coarse, ctx, cty, pixmap)) {
+            continue;
+        }
+        // 目标瓦片在粗层瓦片中对应的区域
+        const double div = double(1 << shift);
+        const QRectF rect(tx * PYRAMID_TILE_SIZE / div - ctx * PYRAMID_TILE_SIZE,
+                          ty * PYRAMID_TILE_SIZE / div - cty * PYRAMID_TILE_SIZE,
+                          PYRAMID_TILE_SIZE / div, PYRAMID_TILE_SIZE / div);
+        source = rect.intersected(QRectF(pixmap.rect()));
+        return !source.isEmpty();
+    }
+    return false;
+}
+
+void TiledImageView::paintEvent(QPaintEvent *)
+{
+    if (!_pyramid->IsOpen()) {
+        return;
+    }
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    // 选择分辨率不低于屏幕需求的最粗一层
+    const int max_level = _pyramid->LevelCount() - 1;
+    const int level = qBound(0, int(std::floor(std::log2(1.0 / _scale))), max_level);
+    const QSize image_size = _pyramid->ImageSize();
+    const QSize level_size = _pyramid->LevelSize(level);
+    const double fx = double(image_size.width()) / level_size.width();   // 层坐标 -> 原图坐标
+    const double fy = double(image_size.height()) / level_size.height();
+
+    // 视口左上角对应的原图坐标
+    const double x0 = _center.x() - width() / (2.0 * _scale);
+    const double y0 = _center.y() - height() / (2.0 * _scale);
+    const double x1 = x0 + width() / _scale;
+    const double y1 = y0 + height() / _scale;
+
+    const int tx0 = qMax(0, int(std::floor(x0 / fx / PYRAMID_TILE_SIZE)));
+    const int ty0 = qMax(0, int(std::floor(y0 / fy / PYRAMID_TILE_SIZE)));
+    const int tx1 = qMin(_pyramid->TileColumns(level) - 1, int(std::floor(x1 / fx / PYRAMID_TILE_SIZE)));
+    const int ty1 = qMin(_pyramid->TileRows(level) - 1, int(std::floor(y1 / fy / PYRAMID_TILE_SIZE)));
+
+    // 最粗一层始终请求，作为其余瓦片缺失时的占位
+    QVector<TilePyramid::TileId> missing;
+    if (level != max_level) {
+        QPixmap top;
+        if (!_pyramid->Tile(max_level, 0, 0, top)) {
+            missing.append({max_level, 0, 0});
+        }
+    }
+
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            const QSize tile_size = QRect(tx * PYRAMID_TILE_SIZE, ty * PYRAMID_TILE_SIZE,
+                                          PYRAMID_TILE_SIZE, PYRAMID_TILE_SIZE)
+                                        .intersected(QRect(QPoint(0, 0), level_size)).size();
+            const QRectF target((tx * PYRAMID_TILE_SIZE * fx - x0) * _scale,
+                                (ty * PYRAMID_TILE_SIZE * fy - y0) * _scale,
+                                tile_size.width() * fx * _scale,
+                                tile_size.height() * fy * _scale);
+
+            QPixmap pixmap;
+            if (_pyramid->Tile(level, tx, ty, pixmap)) {
+                painter.drawPixmap(target, pixmap, QRectF(pixmap.rect()));
+                continue;
+            }
+            missing.append({level, tx, ty});
+
+            QRectF source;
+            if (CoarserTile(level, tx, ty, pixmap, source)) {
+                painter.drawPixmap(target, pixmap, source);
+            }
+        }
+    }
+
+    if (!missing.isEmpty()) {
+        _pyramid->Request(missing);
+    }
+}
+
+void TiledImageView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    if (!_pyramid->IsOpen()) {
+        return;
+    }
+    // 只调整视口参数，下一次绘制按新尺寸选择层和瓦片
+    if (_fit) {
+        _scale = FitScale();
+    }
+    ClampCenter();
+}
+
+void TiledImageView::wheelEvent(QWheelEvent *event)
+{
+    if (!_pyramid->IsOpen()) {
+        return;
+    }
+    const double steps = event->angleDelta().y() / 120.0;
+    const double min_scale = FitScale();
+    const double new_scale = qBound(min_scale, _scale * std::pow(ZOOM_STEP, steps), MAX_SCALE);
+    if (qFuzzyCompare(new_scale, _scale)) {
+        return;
+    }
+
+    // 保持光标下的原图位置不动
+    const QPointF cursor = event->position() - QPointF(width() / 2.0, height() / 2.0);
+    const QPointF anchor = _center + cursor / _scale;
+    _scale = new_scale;
+    _center = anchor - cursor / _scale;
+    _fit = qFuzzyCompare(_scale, min_scale);
+    ClampCenter();
+    update();
+    event->accept();
+}
+
+void TiledImageView::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton) {
+        _dragging = true;
+        _last_pos = event->pos();
+        setCursor(Qt::ClosedHandCursor);
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void TiledImageView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (_dragging) {
+        _center -= QPointF(event->pos() - _last_pos) / _scale;
+        _last_pos = event->pos();
+        ClampCenter();
+        update();
+    }
+    QWidget::mouseMoveEvent(event);
+}
+
+void TiledImageView::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && _dragging) {
+        _dragging = false;
+        unsetCursor();
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+void TiledImageView::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    // 双击恢复适应窗口
+    if (_pyramid->IsOpen()) {
+        _fit = true;
+        _scale = FitScale();
+        ClampCenter();
+        update();
+    }
+    QWidget::mouseDoubleClickEvent(event);
+}
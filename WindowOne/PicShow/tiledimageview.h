@@ -0,0 +1,54 @@
+#ifndef TILEDIMAGEVIEW_H
+#define TILEDIMAGEVIEW_H
+
+#include <QPointF>
+#include <QWidget>
+#include "tilepyramid.h"
+
+/**
+ * @brief 基于瓦片金字塔的大图浏览控件
+ * 根据缩放比例选择合适的层，只绘制可见区域的瓦片；缺失的瓦片先用更粗一层的瓦片放大顶替。
+ * 滚轮以光标为中心缩放，左键拖动平移，双击恢复适应窗口。
+ * 窗口尺寸变化只重新绘制，不会访问原图像素。
+ */
+class TiledImageView : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit TiledImageView(QWidget *parent = nullptr);
+
+    /**
+     * @brief 打开一张图片，初始为适应窗口显示
+     * @param path 图片路径
+     * @return 能否读取图片
+     */
+    bool Open(const QString& path);
+
+    // 关闭当前图片并释放瓦片
+    void Clear();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    double FitScale() const;            // 适应窗口的缩放比例
+    void ClampCenter();                 // 限制平移范围
+    // 在更粗的层中查找覆盖该瓦片的瓦片，返回是否找到以及对应的源区域
+    bool CoarserTile(int level, int tx, int ty, QPixmap& pixmap, QRectF& source);
+
+private:
+    TilePyramid * _pyramid;
+    double _scale = 1.0;                // 屏幕像素 / 原图像素
+    QPointF _center;                    // 视口中心对应的原图坐标
+    bool _fit = true;                   // 是否处于适应窗口模式
+    bool _dragging = false;             // 是否正在拖动
+    QPoint _last_pos;                   // 上一次鼠标位置
+};
+
+#endif // TILEDIMAGEVIEW_H
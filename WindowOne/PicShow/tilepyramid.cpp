@@ -0,0 +1,305 @@
+#include "tilepyramid.h"
+#include "const.h"
+#include "metrics.h"
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QThread>
+
+namespace {
+
+// 缓存占用（开销按 KB 计）写入 cv_pool_bytes
+void UpdatePoolGauge(int costKb)
+{
+    static Gauge& bytes = Metrics::Instance().GetGauge("cv_pool_bytes", "Approximate bytes held by image pools and caches.", "pool=\"tiles\"");
+    bytes.Set(qint64(costKb) * 1024);
+}
+
+// 与 PicShow、预取一致按 EXIF 方向显示；整图解码按金字塔自己的预算放宽分配上限
+void PrepareReader(QImageReader& reader)
+{
+    reader.setAutoTransform(true);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    reader.setAllocationLimit(PYRAMID_DECODE_MAX_MB);
+#endif
+}
+
+} // namespace
+
+TilePyramid::TilePyramid(QObject *parent)
+    : QObject(parent)
+{
+    _pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+    _cache.setMaxCost(PYRAMID_CACHE_MB * 1024);
+
+    // 工作线程的结果回到界面线程写入缓存
+    connect(this, &TilePyramid::SigDecoded, this, &TilePyramid::SlotDecoded, Qt::QueuedConnection);
+}
+
+TilePyramid::~TilePyramid()
+{
+    Close();
+    _pool.waitForDone();
+}
+
+bool TilePyramid::Open(const QString &path)
+{
+    Close();
+
+    QImageReader reader(path);
+    PrepareReader(reader);
+    QSize size = reader.size();
+    if (!size.isValid()) {
+        return false;
+    }
+    // size() 是方向变换前的尺寸，瓦片坐标按变换后的图片计算
+    const QImageIOHandler::Transformations transformation = reader.transformation();
+    if (transformation & QImageIOHandler::TransformationRotate90) {
+        size.transpose();
+    }
+
+    // 层数：直到一个瓦片能放下整层为止
+    int levels = 1;
+    while (qMax((size.width() + (1 << (levels - 1)) - 1) >> (levels - 1),
+                (size.height() + (1 << (levels - 1)) - 1) >> (levels - 1)) > PYRAMID_TILE_SIZE) {
+        levels++;
+    }
+
+    QMutexLocker locker(&_mutex);
+    _path = path;
+    _size = size;
+    _levels = levels;
+    // 缩放与裁剪在方向变换之前进行，需要变换的图片改为整图解码后切分
+    _clip_decode = transformation == QImageIOHandler::TransformationNone
+                   && reader.supportsOption(QImageIOHandler::ScaledClipRect);
+    return true;
+}
+
+void TilePyramid::Close()
+{
+    _generation.fetch_add(1);
+    _cache.clear();
+    UpdatePoolGauge(0);
+
+    QMutexLocker locker(&_mutex);
+    _queue.clear();
+    _inflight.clear();
+    _wanted.clear();
+    _path.clear();
+    _size = QSize();
+    _levels = 0;
+}
+
+QSize TilePyramid::LevelSize(int level) const
+{
+    const int div = 1 << level;
+    return QSize((_size.width() + div - 1) / div, (_size.height() + div - 1) / div);
+}
+
+int TilePyramid::TileColumns(int level) const
+{
+    return (LevelSize(level).width() + PYRAMID_TILE_SIZE - 1) / PYRAMID_TILE_SIZE;
+}
+
+int TilePyramid::TileRows(int level) const
+{
+    return (LevelSize(level).height() + PYRAMID_TILE_SIZE - 1) / PYRAMID_TILE_SIZE;
+}
+
+bool TilePyramid::Tile(int level, int tx, int ty, QPixmap &out)
+{
+    if (QPixmap* pixmap = _cache.object(Key(level, tx, ty))) {
+        out = *pixmap;
+        return true;
+    }
+    return false;
+}
+
+void TilePyramid::Request(const QVector<TileId> &tiles)
+{
+    QMutexLocker locker(&_mutex);
+    _queue.clear();
+    _wanted.clear();
+    // 倒序存放，工作线程从末尾取，排在前面的最先解码
+    for (int i = tiles.size() - 1; i >= 0; --i) {
+        const TileId& tile = tiles.at(i);
+        const quint64 key = Key(tile.level, tile.tx, tile.ty);
+        _wanted.insert(key);
+        if (!_inflight.contains(key) && !_cache.contains(key)) {
+            _queue.append(tile);
+        }
+    }
+
+    while (_workers < _pool.maxThreadCount() && _workers < _queue.size()) {
+        _workers++;
+        _pool.start([this]() { Work(); });
+    }
+}
+
+quint64 TilePyramid::Key(int level, int tx, int ty)
+{
+    return (quint64(level) << 48) | (quint64(quint32(ty) & 0xFFFFFF) << 24) | quint64(quint32(tx) & 0xFFFFFF);
+}
+
+QRect TilePyramid::TileRect(const QSize &levelSize, int tx, int ty)
+{
+    return QRect(tx * PYRAMID_TILE_SIZE, ty * PYRAMID_TILE_SIZE, PYRAMID_TILE_SIZE, PYRAMID_TILE_SIZE)
+        .intersected(QRect(QPoint(0, 0), levelSize));
+}
+
+void TilePyramid::Work()
+{
+    for (;;) {
+        TileId tile;
+        int generation;
+        QString path;
+        QSize level_size;
+        bool clip_decode;
+        bool idle = false;
+        {
+            QMutexLocker locker(&_mutex);
+            if (_queue.isEmpty()) {
+                _workers--;
+                if (_workers > 0) {
+                    return;
+                }
+                idle = true;
+            } else {
+                tile = _queue.takeLast();
+                generation = _generation.load();
+                path = _path;
+                level_size = LevelSize(tile.level);
+                clip_decode = _clip_decode;
+
+                // 一次解码产出整行（裁剪解码）或整层的瓦片，范围内的其他请求一并认领
+                const int cols = TileColumns(tile.level);
+                const int rows = TileRows(tile.level);
+                for (int ty = 0; ty < rows; ++ty) {
+                    if (clip_decode && ty != tile.ty) {
+                        continue;
+                    }
+                    for (int tx = 0; tx < cols; ++tx) {
+                        _inflight.insert(Key(tile.level, tx, ty));
+                    }
+                }
+                for (int i = _queue.size() - 1; i >= 0; --i) {
+                    const TileId& queued = _queue.at(i);
+                    if (queued.level == tile.level && (!clip_decode || queued.ty == tile.ty)) {
+                        _queue.remove(i);
+                    }
+                }
+            }
+        }
+
+        if (idle) {
+            // 最后一个工作线程退出时释放原图，下一批请求若需要再解码
+            QMutexLocker locker(&_source_mutex);
+            _source = QImage();
+            _source_generation = -1;
+            return;
+        }
+
+        if (clip_decode) {
+            DecodeRow(generation, path, level_size, tile.level, tile.ty);
+        } else {
+            DecodeLevel(generation, path, level_size, tile.level);
+        }
+    }
+}
+
+void TilePyramid::DecodeRow(int generation, const QString &path, const QSize &levelSize, int level, int ty)
+{
+    // 缩放到该层尺寸后只取这一行瓦片的横条，JPEG 在 DCT 阶段完成缩放，不会生成全尺寸像素；
+    // 按行解码，同一行的瓦片不再各自把文件从头解码一遍
+    const QRect area = QRect(0, ty * PYRAMID_TILE_SIZE, levelSize.width(), PYRAMID_TILE_SIZE)
+                           .intersected(QRect(QPoint(0, 0), levelSize));
+    QImageReader reader(path);
+    PrepareReader(reader);
+    if (level > 0) {
+        reader.setScaledSize(levelSize);
+    }
+    reader.setScaledClipRect(area);
+    EmitTiles(generation, level, levelSize, reader.read(), area);
+}
+
+void TilePyramid::DecodeLevel(int generation, const QString &path, const QSize &levelSize, int level)
+{
+    // 这类格式任何一层都要先解码整张原图：同一时间只解码一次，其余工作线程等待后复用
+    QImage image;
+    {
+        QMutexLocker locker(&_source_mutex);
+        if (_source_generation != generation) {
+            _source = QImage();
+            if (_generation.load() != generation) {
+                return;
+            }
+            QImageReader reader(path);
+            PrepareReader(reader);
+            _source = reader.read();
+            _source_generation = generation;
+        }
+        image = _source;
+    }
+
+    // 逐级缩小一半得到目标层
+    const QSize source_size = image.size();
+    for (int k = 1; k <= level && !image.isNull(); ++k) {
+        if (_generation.load() != generation) {
+            return;
+        }
+        const int div = 1 << k;
+        const QSize size((source_size.width() + div - 1) / div, (source_size.height() + div - 1) / div);
+        image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+    if (!image.isNull() && image.size() != levelSize) {
+        image = image.scaled(levelSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+    EmitTiles(generation, level, levelSize, image, QRect(QPoint(0, 0), levelSize));
+}
+
+void TilePyramid::EmitTiles(int generation, int level, const QSize &levelSize, const QImage &image, const QRect &area)
+{
+    QVector<quint64> wanted_keys;
+    QVector<QRect> wanted_rects;
+    for (int ty = area.top() / PYRAMID_TILE_SIZE; ty <= area.bottom() / PYRAMID_TILE_SIZE; ++ty) {
+        for (int tx = area.left() / PYRAMID_TILE_SIZE; tx <= area.right() / PYRAMID_TILE_SIZE; ++tx) {
+            if (_generation.load() != generation) {
+                return;
+            }
+            const quint64 key = Key(level, tx, ty);
+            // 瓦片在 image 中的位置
+            const QRect rect = TileRect(levelSize, tx, ty).translated(-area.topLeft());
+            bool wanted;
+            {
+                QMutexLocker locker(&_mutex);
+                wanted = _wanted.contains(key);
+            }
+            // 当前可见的瓦片最后提交，避免被同一批的其余瓦片挤出缓存
+            if (wanted) {
+                wanted_keys.append(key);
+                wanted_rects.append(rect);
+            } else {
+                emit SigDecoded(generation, key, image.isNull() ? QImage() : image.copy(rect));
+            }
+        }
+    }
+    for (int i = 0; i < wanted_keys.size(); ++i) {
+        emit SigDecoded(generation, wanted_keys.at(i), image.isNull() ? QImage() : image.copy(wanted_rects.at(i)));
+    }
+}
+
+void TilePyramid::SlotDecoded(int generation, quint64 key, const QImage &image)
+{
+    if (generation != _generation.load()) {
+        return; // 已经切换到别的图片
+    }
+    {
+        QMutexLocker locker(&_mutex);
+        _inflight.remove(key);
+    }
+    if (image.isNull()) {
+        return;
+    }
+    _cache.insert(key, new QPixmap(QPixmap::fromImage(image)), qMax(1, int(image.sizeInBytes() / 1024)));
+    UpdatePoolGauge(_cache.totalCost());
+    emit SigTileReady();
+}
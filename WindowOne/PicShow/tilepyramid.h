@@ -0,0 +1,105 @@
+#ifndef TILEPYRAMID_H
+#define TILEPYRAMID_H
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+
+/**
+ * @brief 大图的多分辨率瓦片金字塔
+ * 第 0 层为原图，第 k 层边长缩小为 1/2^k，直到一个瓦片能放下整张图。
+ * 瓦片按需在工作线程中解码：支持裁剪解码的格式（如 JPEG）按瓦片行解码对应的横条，
+ * 一次产出整行瓦片；其余格式只能整图解码，同一时间只解码一次原图，
+ * 各层由原图逐级缩小得到，工作线程空闲后释放原图。瓦片保存在按内存占用限制的 LRU 缓存中。
+ * 除工作线程外，所有接口只在界面线程调用。
+ */
+class TilePyramid : public QObject
+{
+    Q_OBJECT
+public:
+    // 瓦片编号
+    struct TileId
+    {
+        int level;
+        int tx;
+        int ty;
+    };
+
+    explicit TilePyramid(QObject *parent = nullptr);
+    ~TilePyramid();
+
+    /**
+     * @brief 打开一张图片（只读取文件头），丢弃之前图片的瓦片和任务
+     * @param path 图片路径
+     * @return 能否读取图片尺寸
+     */
+    bool Open(const QString& path);
+
+    // 关闭当前图片
+    void Close();
+
+    bool IsOpen() const { return _levels > 0; }
+    QSize ImageSize() const { return _size; }
+    int LevelCount() const { return _levels; }
+    QSize LevelSize(int level) const;
+    int TileColumns(int level) const;
+    int TileRows(int level) const;
+
+    // 在缓存中查找瓦片（不会触发解码）
+    bool Tile(int level, int tx, int ty, QPixmap& out);
+
+    /**
+     * @brief 请求一组瓦片（按优先级排列），替换之前尚未开始的请求
+     * @param tiles 瓦片编号
+     */
+    void Request(const QVector<TileId>& tiles);
+
+private:
+    static quint64 Key(int level, int tx, int ty);
+    static QRect TileRect(const QSize& levelSize, int tx, int ty);  // 瓦片在该层中的像素区域
+    void Work();                                                     // 工作线程循环
+    // 按区域解码一行瓦片
+    void DecodeRow(int generation, const QString& path, const QSize& levelSize, int level, int ty);
+    // 由原图逐级缩小得到整层后切成瓦片
+    void DecodeLevel(int generation, const QString& path, const QSize& levelSize, int level);
+    // 把覆盖该层 area 区域的图像切成瓦片提交，当前可见的瓦片最后提交
+    void EmitTiles(int generation, int level, const QSize& levelSize, const QImage& image, const QRect& area);
+
+private slots:
+    void SlotDecoded(int generation, quint64 key, const QImage& image);
+
+private:
+    QThreadPool _pool;
+    QCache<quint64, QPixmap> _cache;    // 瓦片缓存，开销按 KB 计
+
+    QString _path;                      // 图片路径
+    QSize _size;                        // 原图尺寸
+    int _levels = 0;                    // 层数
+    bool _clip_decode = false;          // 格式是否支持按区域缩放解码
+    std::atomic<int> _generation{0};    // 每次打开新图片加一，丢弃旧图片的结果
+
+    QMutex _mutex;                      // 保护以下成员（工作线程与界面线程共享）
+    QVector<TileId> _queue;             // 待解码瓦片（末尾最先处理）
+    QSet<quint64> _inflight;            // 正在解码的瓦片
+    QSet<quint64> _wanted;              // 最近一次请求的瓦片（整层解码时最后提交）
+    int _workers = 0;                   // 正在运行的工作线程数
+
+    QMutex _source_mutex;               // 保护原图，同时保证同一时间只有一个整图解码
+    QImage _source;                     // 整图解码的原图（不支持裁剪解码的格式）
+    int _source_generation = -1;        // 原图所属的图片
+
+signals:
+    // 工作线程解码出一个瓦片（内部使用）
+    void SigDecoded(int generation, quint64 key, const QImage& image);
+
+    // 有新瓦片可以显示
+    void SigTileReady();
+};
+
+#endif // TILEPYRAMID_H
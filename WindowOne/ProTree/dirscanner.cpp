@@ -0,0 +1,162 @@
+#include "dirscanner.h"
+#include <QDir>
+#include <QMutexLocker>
+#include <QThread>
+
+void ScanChannel::Push(ScanBatch &&batch)
+{
+    QMutexLocker locker(&_mutex);
+    _batches.push_back(std::move(batch));
+}
+
+QVector<ScanBatch> ScanChannel::Take(int maxEntries)
+{
+    QMutexLocker locker(&_mutex);
+    QVector<ScanBatch> out;
+    int taken = 0;
+    while (!_batches.empty() && (out.isEmpty() || taken + _batches.front().entries.size() <= maxEntries)) {
+        taken += _batches.front().entries.size();
+        out.append(std::move(_batches.front()));
+        _batches.pop_front();
+    }
+    return out;
+}
+
+bool ScanChannel::IsEmpty()
+{
+    QMutexLocker locker(&_mutex);
+    return _batches.empty();
+}
+
+DirScanner::DirScanner(const QString &projectPath, const ScanFilter &filter, QObject *parent)
+    : QObject(parent), _root(QDir(projectPath).absolutePath()), _filter(filter)
+{
+    // 扫描以 IO 等待为主（尤其是网络盘），线程数可以多于核心数
+    const int workers = qBound(2, QThread::idealThreadCount() * 2, 16);
+    _pool.setMaxThreadCount(workers);
+    for (int i = 0; i < workers; ++i) {
+        _queues.emplace_back(new WorkerQueue);
+    }
+}
+
+DirScanner::~DirScanner()
+{
+    Stop();
+    _pool.waitForDone();
+}
+
+void DirScanner::Start()
+{
+    _pending.store(1);
+    _queued.store(1);
+    _queues[0]->dirs.push_back(QString());
+
+    _running.store(int(_queues.size()));
+    for (int i = 0; i < int(_queues.size()); ++i) {
+        _pool.start([this, i]() { Work(i); });
+    }
+}
+
+void DirScanner::Stop()
+{
+    _stop.store(true);
+    QMutexLocker locker(&_idle_mutex);
+    _work_available.wakeAll();
+}
+
+void DirScanner::Work(int index)
+{
+    QString dir;
+    while (!_stop.load()) {
+        if (Pop(index, dir)) {
+            Scan(index, dir);
+            if (_pending.fetch_sub(1) == 1) {
+                // 最后一个目录扫描完，叫醒空闲线程退出
+                QMutexLocker locker(&_idle_mutex);
+                _work_available.wakeAll();
+            }
+            continue;
+        }
+
+        // 其他线程仍在扫描：睡眠到它们入队新目录或全部扫描完；
+        // 入队方在 _idle_mutex 下唤醒，检查与等待之间不会漏掉唤醒
+        QMutexLocker locker(&_idle_mutex);
+        if (_pending.load() == 0) {
+            break;  // 所有目录都已扫描完
+        }
+        if (_queued.load() == 0 && !_stop.load()) {
+            _work_available.wait(&_idle_mutex);
+        }
+    }
+
+    // 最后一个退出的线程通知扫描结束
+    if (_running.fetch_sub(1) == 1) {
+        _finished.store(true);
+        emit SigFinished();
+    }
+}
+
+bool DirScanner::Pop(int index, QString &dir)
+{
+    {
+        WorkerQueue& own = *_queues[index];
+        QMutexLocker locker(&own.mutex);
+        if (!own.dirs.empty()) {
+            dir = std::move(own.dirs.back());
+            own.dirs.pop_back();
+            _queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    const int count = int(_queues.size());
+    for (int k = 1; k < count; ++k) {
+        WorkerQueue& victim = *_queues[(index + k) % count];
+        QMutexLocker locker(&victim.mutex);
+        if (!victim.dirs.empty()) {
+            dir = std::move(victim.dirs.front());
+            victim.dirs.pop_front();
+            _queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void DirScanner::Scan(int index, const QString &relDir)
+{
+    const QString abs_dir = relDir.isEmpty() ? _root : _root + '/' + relDir;
+    ScanBatch batch;
+    batch.relDir = relDir;
+    batch.entries = _filter.List(abs_dir);
+
+    QVector<QString> subdirs;
+    for (const ScanEntry& entry : batch.entries) {
+        if (entry.dir) {
+            subdirs.append(relDir.isEmpty() ? entry.name : relDir + '/' + entry.name);
+        }
+    }
+    _dir_count.fetch_add(1, std::memory_order_relaxed);
+    _file_count.fetch_add(batch.entries.size() - subdirs.size(), std::memory_order_relaxed);
+
+    // 先写入本目录结果，再把子目录入队，保证父目录先于子目录出现在通道中
+    _channel.Push(std::move(batch));
+
+    if (!subdirs.isEmpty()) {
+        _pending.fetch_add(subdirs.size());
+        {
+            WorkerQueue& own = *_queues[index];
+            QMutexLocker locker(&own.mutex);
+            // 倒序入队，队尾（自己先取）是名称最小的子目录
+            for (int i = subdirs.size() - 1; i >= 0; --i) {
+                own.dirs.push_back(subdirs.at(i));
+            }
+            _queued.fetch_add(subdirs.size());
+        }
+        // 自己会取走一个，其余留给空闲线程窃取
+        if (subdirs.size() > 1) {
+            QMutexLocker locker(&_idle_mutex);
+            _work_available.wakeAll();
+        }
+    }
+}
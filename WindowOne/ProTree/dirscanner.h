@@ -0,0 +1,106 @@
+#ifndef DIRSCANNER_H
+#define DIRSCANNER_H
+
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "scanfilter.h"
+
+// 一个目录的扫描结果
+struct ScanBatch
+{
+    QString relDir;              // 相对项目根目录的路径，根目录为空
+    QVector<ScanEntry> entries;  // 目录内容（已过滤、已排序）
+};
+
+/**
+ * @brief 扫描结果通道（多生产者、单消费者）
+ * 扫描线程写入，界面线程定时成批取出；父目录的结果总是先于子目录写入。
+ */
+class ScanChannel
+{
+public:
+    void Push(ScanBatch&& batch);
+
+    /**
+     * @brief 取出若干批结果
+     * @param maxEntries 本次最多取出的条目数（至少取一批），避免一次占用界面线程太久
+     */
+    QVector<ScanBatch> Take(int maxEntries);
+
+    bool IsEmpty();
+
+private:
+    QMutex _mutex;
+    std::deque<ScanBatch> _batches;
+};
+
+/**
+ * @brief 并行目录扫描器（工作窃取）
+ * 每个工作线程有自己的目录队列：自己从队尾取（深度优先，局部性好），
+ * 空闲时从其他线程的队头窃取（通常是较大的子树），都没有时睡眠到有新目录入队。
+ * 每扫描完一个目录就把结果写入通道，界面可以边扫描边显示。
+ */
+class DirScanner : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @param projectPath 项目根目录
+     * @param filter 过滤规则
+     */
+    DirScanner(const QString& projectPath, const ScanFilter& filter, QObject *parent = nullptr);
+    ~DirScanner();
+
+    void Start();
+
+    // 请求停止（不等待）
+    void Stop();
+
+    ScanChannel& Channel() { return _channel; }
+    bool IsFinished() const { return _finished.load(); }
+
+    // 已发现的目录与图片数量
+    int DirCount() const { return _dir_count.load(std::memory_order_relaxed); }
+    int FileCount() const { return _file_count.load(std::memory_order_relaxed); }
+
+private:
+    // 每个工作线程的目录队列
+    struct WorkerQueue
+    {
+        QMutex mutex;
+        std::deque<QString> dirs;   // 相对路径
+    };
+
+    void Work(int index);
+    bool Pop(int index, QString& dir);      // 先取自己的队尾，再窃取别人的队头
+    void Scan(int index, const QString& relDir);
+
+private:
+    QString _root;                          // 项目根目录
+    ScanFilter _filter;                     // 过滤规则
+    QThreadPool _pool;
+    ScanChannel _channel;
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+    std::atomic<int> _pending{0};           // 已入队或正在扫描的目录数
+    std::atomic<int> _queued{0};            // 已入队、尚未被取走的目录数
+    QMutex _idle_mutex;                     // 与 _work_available 配合，空闲线程在此等待
+    QWaitCondition _work_available;         // 有新目录入队、全部扫描完或请求停止
+    std::atomic<int> _running{0};           // 尚未退出的工作线程数
+    std::atomic<bool> _stop{false};
+    std::atomic<bool> _finished{false};
+    std::atomic<int> _dir_count{0};
+    std::atomic<int> _file_count{0};
+
+signals:
+    // 扫描结束（完成或被停止），在工作线程中发出
+    void SigFinished();
+};
+
+#endif // DIRSCANNER_H
@@ -0,0 +1,94 @@
+#include "pichashthread.h"
+#include "bktree.h"
+#include <memory>
+#include <numeric>
+
+PicHashThread::PicHashThread(const QStringList &paths, PerceptualHash::HashType type,
+                             int max_distance, QObject *parent)
+    : QThread(parent), _paths(paths), _type(type), _max_distance(max_distance)
+{
+}
+
+void PicHashThread::Stop()
+{
+    _stop = true;
+}
+
+void PicHashThread::run()
+{
+    const int total = _paths.size();
+    // 工作线程按下标写入互不重叠的位置，用 std::vector 避免隐式共享容器的 detach 检查
+    std::vector<quint64> hashes(total, 0);
+    std::vector<char> valid(total, 0);
+
+    // ---- 并行计算哈希 ----
+    auto worker = [&]() {
+        while (!_stop) {
+            const int i = _next.fetch_add(1);
+            if (i >= total) {
+                break;
+            }
+            quint64 hash = 0;
+            if (PerceptualHash::HashFile(_paths.at(i), _type, hash)) {
+                hashes[i] = hash;
+                valid[i] = 1;
+            }
+            const int done = _done.fetch_add(1) + 1;
+            if (done % 64 == 0 || done == total) {
+                emit SigProgress(done, total);
+            }
+        }
+    };
+
+    std::vector<std::unique_ptr<QThread>> workers;
+    const int worker_count = std::max(1, QThread::idealThreadCount());
+    for (int i = 0; i < worker_count; ++i) {
+        workers.emplace_back(QThread::create(worker));
+        workers.back()->start();
+    }
+    for (auto& w : workers) {
+        w->wait();
+    }
+    if (_stop) {
+        return;
+    }
+
+    // ---- 近似重复分组（并查集，代表取下标最小者） ----
+    std::vector<int> parent(total);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    };
+
+    BKTree tree;
+    std::vector<int> matches;
+    for (int i = 0; i < total; ++i) {
+        if (!valid[i]) {
+            continue;
+        }
+        matches.clear();
+        tree.Query(hashes[i], _max_distance, matches);
+        for (int j : matches) {
+            const int a = find(i);
+            const int b = find(j);
+            if (a != b) {
+                parent[std::max(a, b)] = std::min(a, b);
+            }
+        }
+        tree.Insert(hashes[i], i);
+    }
+
+    QVector<quint64> out_hashes(total);
+    QVector<bool> out_valid(total);
+    QVector<int> representatives(total);
+    for (int i = 0; i < total; ++i) {
+        out_hashes[i] = hashes[i];
+        out_valid[i] = valid[i] != 0;
+        representatives[i] = find(i);
+    }
+    emit SigHashFinish(out_hashes, out_valid, representatives);
+}
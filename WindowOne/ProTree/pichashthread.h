@@ -0,0 +1,52 @@
+#ifndef PICHASHTHREAD_H
+#define PICHASHTHREAD_H
+
+#include <QThread>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include "perceptualhash.h"
+
+/**
+ * @brief 重复图片检测线程
+ * 多线程并行计算项目内每张图片的 64 位感知哈希，
+ * 再用 BK 树按汉明距离查找近似重复并合并成组，每组以树中最靠前的图片作为代表
+ */
+class PicHashThread : public QThread
+{
+    Q_OBJECT
+public:
+    /**
+     * @param paths 图片路径（按树中顺序）
+     * @param type 哈希算法
+     * @param max_distance 汉明距离不超过该值视为近似重复
+     */
+    explicit PicHashThread(const QStringList& paths, PerceptualHash::HashType type,
+                           int max_distance, QObject *parent = nullptr);
+
+    void Stop();
+
+protected:
+    virtual void run();
+
+private:
+    QStringList _paths;
+    PerceptualHash::HashType _type;
+    int _max_distance;
+    std::atomic<bool> _stop{false};
+    std::atomic<int> _next{0};
+    std::atomic<int> _done{0};
+
+signals:
+    void SigProgress(int done, int total);
+    /**
+     * @brief 完成信号
+     * @param hashes 每张图片的哈希
+     * @param valid 哈希是否有效（无法解码的图片为 false）
+     * @param representatives 每张图片所在组的代表下标（自身即代表时等于自身下标）
+     */
+    void SigHashFinish(const QVector<quint64>& hashes, const QVector<bool>& valid,
+                       const QVector<int>& representatives);
+};
+
+#endif // PICHASHTHREAD_H
@@ -0,0 +1,132 @@
+#include "picindex.h"
+#include <algorithm>
+
+bool PicIndex::Filter::Match(const Result &result) const
+{
+    if (!className.isEmpty() && result.className != className) {
+        return false;
+    }
+    return maxConfidence >= 1.0f || result.confidence < maxConfidence;
+}
+
+void PicIndex::Reset(const QVector<NodeId> &order)
+{
+    _order = order;
+    _position.clear();
+    _position.reserve(_order.size());
+    for (int i = 0; i < _order.size(); ++i) {
+        _position.insert(_order.at(i), i);
+    }
+
+    // 已不在项目中的图片（被删除或改名）不再保留结果
+    for (auto it = _results.begin(); it != _results.end(); ) {
+        if (_position.contains(it.key())) {
+            ++it;
+        } else {
+            it = _results.erase(it);
+        }
+    }
+    RebuildView();
+}
+
+void PicIndex::SetFilter(const Filter &filter)
+{
+    _filter = filter;
+    RebuildView();
+}
+
+bool PicIndex::SetResult(NodeId node, const Result &result)
+{
+    _results.insert(node, result);
+    if (!_filter.IsActive()) {
+        return false;
+    }
+    auto pos = _position.constFind(node);
+    if (pos == _position.constEnd()) {
+        return false;
+    }
+
+    // 视图按位置升序，二分查找后插入或移除
+    auto it = std::lower_bound(_view.begin(), _view.end(), *pos);
+    const bool present = it != _view.end() && *it == *pos;
+    const bool match = _filter.Match(result);
+    if (match && !present) {
+        _view.insert(it, *pos);
+        return true;
+    }
+    if (!match && present) {
+        _view.erase(it);
+        return true;
+    }
+    return false;
+}
+
+bool PicIndex::GetResult(NodeId node, Result &result) const
+{
+    auto it = _results.constFind(node);
+    if (it == _results.constEnd()) {
+        return false;
+    }
+    result = *it;
+    return true;
+}
+
+int PicIndex::Size() const
+{
+    return _filter.IsActive() ? _view.size() : _order.size();
+}
+
+PicIndex::NodeId PicIndex::At(int i) const
+{
+    if (i < 0 || i >= Size()) {
+        return INVALID_NODE;
+    }
+    return _filter.IsActive() ? _order.at(_view.at(i)) : _order.at(i);
+}
+
+int PicIndex::PositionOf(NodeId node) const
+{
+    auto pos = _position.constFind(node);
+    if (pos == _position.constEnd()) {
+        return -1;
+    }
+    if (!_filter.IsActive()) {
+        return *pos;
+    }
+    auto it = std::lower_bound(_view.cbegin(), _view.cend(), *pos);
+    return (it != _view.cend() && *it == *pos) ? int(it - _view.cbegin()) : -1;
+}
+
+PicIndex::NodeId PicIndex::Step(NodeId current, int delta) const
+{
+    auto pos = _position.constFind(current);
+    if (pos == _position.constEnd()) {
+        return INVALID_NODE;
+    }
+    if (!_filter.IsActive()) {
+        return At(*pos + delta);
+    }
+
+    // 视图中第一个不小于当前位置的序号
+    const int k = int(std::lower_bound(_view.cbegin(), _view.cend(), *pos) - _view.cbegin());
+    const bool present = k < _view.size() && _view.at(k) == *pos;
+    if (present) {
+        return At(k + delta);
+    }
+    return At(delta > 0 ? k + delta - 1 : k + delta);
+}
+
+void PicIndex::RebuildView()
+{
+    _view.clear();
+    if (!_filter.IsActive()) {
+        return;
+    }
+    for (auto it = _results.constBegin(); it != _results.constEnd(); ++it) {
+        auto pos = _position.constFind(it.key());
+        if (pos != _position.constEnd() && _filter.Match(it.value())) {
+            _view.append(*pos);
+        }
+    }
+    std::sort(_view.begin(), _view.end());
+}
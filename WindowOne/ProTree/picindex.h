@@ -0,0 +1,83 @@
+#ifndef PICINDEX_H
+#define PICINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 项目图片的扁平有序索引
+ * 按项目树先序保存全部图片节点，支持按位置随机访问、O(1) 定位当前图片的序号。
+ * 可按识别结果筛选（指定类别、置信度上限），筛选视图保存命中的位置（升序），
+ * 识别结果陆续到达时增量更新视图，无需重建。
+ */
+class PicIndex
+{
+public:
+    typedef quint64 NodeId;
+    static const NodeId INVALID_NODE = 0;
+
+    // 一张图片的识别结果
+    struct Result
+    {
+        QString className;        // 类别名称
+        float confidence = 0.0f;  // 置信度
+    };
+
+    // 筛选条件，类别为空且置信度上限为 1 时不筛选；未识别的图片不满足任何筛选
+    struct Filter
+    {
+        QString className;            // 只保留该类别
+        float maxConfidence = 1.0f;   // 只保留置信度低于该值的图片
+
+        bool IsActive() const { return !className.isEmpty() || maxConfidence < 1.0f; }
+        bool Match(const Result& result) const;
+    };
+
+    /**
+     * @brief 重建顺序（项目结构变化后调用），保留已有的识别结果
+     * @param order 全部图片节点（先序）
+     */
+    void Reset(const QVector<NodeId>& order);
+
+    // 设置筛选条件并重建视图
+    void SetFilter(const Filter& filter);
+    const Filter& GetFilter() const { return _filter; }
+
+    /**
+     * @brief 记录一张图片的识别结果，并增量更新筛选视图
+     * @return 视图是否变化
+     */
+    bool SetResult(NodeId node, const Result& result);
+    bool GetResult(NodeId node, Result& result) const;
+    int ResultCount() const { return _results.size(); }
+
+    // 视图中的图片数量（不筛选时为全部图片数量）
+    int Size() const;
+    int TotalSize() const { return _order.size(); }
+
+    // 视图中第 i 张图片
+    NodeId At(int i) const;
+
+    // 图片在视图中的序号（从 0 开始），不在视图中返回 -1
+    int PositionOf(NodeId node) const;
+
+    /**
+     * @brief 在视图中从当前图片前进/后退若干张
+     * 当前图片不在视图中时（例如刚切换了筛选条件），从其所在位置之后/之前最近的一张开始
+     * @return 越界时返回 INVALID_NODE
+     */
+    NodeId Step(NodeId current, int delta) const;
+
+private:
+    void RebuildView();
+
+private:
+    QVector<NodeId> _order;                // 全部图片（先序）
+    QHash<NodeId, int> _position;          // 节点 -> 在 _order 中的位置
+    QHash<NodeId, Result> _results;        // 节点 -> 识别结果
+    Filter _filter;                        // 当前筛选条件
+    QVector<int> _view;                    // 满足筛选条件的位置（升序），不筛选时为空
+};
+
+#endif // PICINDEX_H
@@ -0,0 +1,68 @@
+#include "projectwatcher.h"
+#include "const.h"
+#include <QDebug>
+
+ProjectWatcher::ProjectWatcher(QObject *parent)
+    : QObject(parent)
+{
+    _delay.setSingleShot(true);
+    _delay.setInterval(WATCH_DELAY_MS);
+    connect(&_watcher, &QFileSystemWatcher::directoryChanged, this, &ProjectWatcher::SlotDirectoryChanged);
+    connect(&_delay, &QTimer::timeout, this, &ProjectWatcher::SlotFlush);
+}
+
+void ProjectWatcher::Watch(const QString &dirPath)
+{
+    if (_watcher.addPath(dirPath) || _limit_warned) {
+        return;
+    }
+    // 已在监视时 addPath 也返回 false，只在真正失败时提示一次
+    if (!_watcher.directories().contains(dirPath)) {
+        _limit_warned = true;
+        qWarning() << "cannot watch" << dirPath << "- the system watch limit may be reached"
+                   << "(watching" << Count() << "directories)";
+    }
+}
+
+void ProjectWatcher::UnwatchProject(const QString &projectPath)
+{
+    QStringList paths;
+    for (const QString& dir : _watcher.directories()) {
+        if (dir == projectPath || dir.startsWith(projectPath + '/')) {
+            paths << dir;
+        }
+    }
+    if (!paths.isEmpty()) {
+        _watcher.removePaths(paths);
+    }
+    for (auto it = _dirty.begin(); it != _dirty.end(); ) {
+        if (*it == projectPath || it->startsWith(projectPath + '/')) {
+            it = _dirty.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+int ProjectWatcher::Count() const
+{
+    return _watcher.directories().size();
+}
+
+void ProjectWatcher::SlotDirectoryChanged(const QString &path)
+{
+    // 不重新计时：持续拷贝时也能按固定间隔刷新
+    _dirty.insert(path);
+    if (!_delay.isActive()) {
+        _delay.start();
+    }
+}
+
+void ProjectWatcher::SlotFlush()
+{
+    QStringList dirs(_dirty.begin(), _dirty.end());
+    _dirty.clear();
+    // 父目录先处理，被删除的子目录随父目录一起移除
+    dirs.sort();
+    emit SigDirsChanged(dirs);
+}
@@ -0,0 +1,48 @@
+#ifndef PROJECTWATCHER_H
+#define PROJECTWATCHER_H
+
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+
+/**
+ * @brief 项目目录监视器
+ * 监视已加载的目录（Linux 上由 QFileSystemWatcher 使用 inotify），
+ * 短时间内的多次变化合并后一次通知，拷贝大量照片时不会逐个文件刷新。
+ * 只需要监视已加载的目录：未加载的目录展开时会读取最新内容。
+ */
+class ProjectWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ProjectWatcher(QObject *parent = nullptr);
+
+    // 开始监视一个目录
+    void Watch(const QString& dirPath);
+
+    // 停止监视项目下的全部目录
+    void UnwatchProject(const QString& projectPath);
+
+    // 正在监视的目录数量
+    int Count() const;
+
+private slots:
+    void SlotDirectoryChanged(const QString& path);
+    void SlotFlush();
+
+private:
+    QFileSystemWatcher _watcher;
+    QTimer _delay;                      // 合并短时间内的变化
+    QSet<QString> _dirty;               // 待通知的目录
+    bool _limit_warned = false;         // 已提示过监视数量达到系统上限
+
+signals:
+    /**
+     * @brief 目录内容发生变化（新增、删除、改名）
+     * @param dirs 变化的目录（已去重）
+     */
+    void SigDirsChanged(const QStringList& dirs);
+};
+
+#endif // PROJECTWATCHER_H
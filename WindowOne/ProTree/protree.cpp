@@ -24,9 +24,6 @@ ProTree::ProTree(QWidget *parent)
     ui->treeWidget->setRootIsDecorated(true);
     ui->treeWidget->setItemsExpandable(true);
     ui->treeWidget->setAnimated(true);
-
-    QTreeWidgetItem *root = ui->treeWidget->topLevelItem(0);
-    if (root) root->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
 }
 
 ProTree::~ProTree()
@@ -35,7 +32,7 @@ ProTree::~ProTree()
 }
 
 
-QTreeWidget *ProTree::GetTreeWidget()
+QTreeView *ProTree::GetTreeWidget()
 {
     return ui->treeWidget;
 }
@@ -2,7 +2,7 @@
 #define PROTREE_H
 
 #include <QDialog>
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QFile>
 
 namespace Ui {
@@ -20,7 +20,7 @@ public:
 private:
     Ui::ProTree *ui;
 public:
-    QTreeWidget* GetTreeWidget();
+    QTreeView* GetTreeWidget();
 };
 
 #endif // PROTREE_H
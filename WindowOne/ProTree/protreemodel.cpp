@@ -0,0 +1,737 @@
+#include "protreemodel.h"
+#include "const.h"
+#include <QBrush>
+#include <QDir>
+#include <algorithm>
+
+static_assert(sizeof(quintptr) >= sizeof(ProTreeModel::NodeId), "NodeId must fit in QModelIndex::internalId");
+
+ProTreeModel::ProTreeModel(QObject *parent)
+    : QAbstractItemModel(parent),
+    _dir_icon(":/icon/dir.png"), _pic_icon(":/icon/pic.png")
+{
+
+}
+
+ProTreeModel::~ProTreeModel()
+{
+
+}
+
+QModelIndex ProTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (column != 0 || row < 0) {
+        return QModelIndex();
+    }
+    if (!parent.isValid()) {
+        if (row >= _top.size()) {
+            return QModelIndex();
+        }
+        return createIndex(row, 0, quintptr(MakeId(_top.at(row), 0)));
+    }
+
+    const NodeId parent_id = Node(parent);
+    Project* project = ProjectOf(parent_id);
+    const TreeNode* node = NodePtr(parent_id);
+    if (!node || node->children == NONE || row >= int(project->children[node->children].size())) {
+        return QModelIndex();
+    }
+    return createIndex(row, 0, quintptr(MakeId(SlotOf(parent_id), project->children[node->children][row])));
+}
+
+QModelIndex ProTreeModel::parent(const QModelIndex &child) const
+{
+    const NodeId id = Node(child);
+    const TreeNode* node = NodePtr(id);
+    if (!node || node->parent == NONE) {
+        return QModelIndex();
+    }
+    return Index(MakeId(SlotOf(id), node->parent));
+}
+
+int ProTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return _top.size();
+    }
+    const NodeId id = Node(parent);
+    const TreeNode* node = NodePtr(id);
+    if (!node || node->children == NONE) {
+        return 0;
+    }
+    return int(ProjectOf(id)->children[node->children].size());
+}
+
+int ProTreeModel::columnCount(const QModelIndex &) const
+{
+    return 1;
+}
+
+bool ProTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return !_top.isEmpty();
+    }
+    const TreeNode* node = NodePtr(Node(parent));
+    if (!node || !IsContainer(*node)) {
+        return false;
+    }
+    // 未加载的目录先显示展开标记
+    return !(node->flags & FlagFetched) || rowCount(parent) > 0;
+}
+
+QVariant ProTreeModel::data(const QModelIndex &index, int role) const
+{
+    const NodeId id = Node(index);
+    const TreeNode* node = NodePtr(id);
+    if (!node) {
+        return QVariant();
+    }
+    const Project* project = ProjectOf(id);
+    const quint32 n = NodeOf(id);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return project->names.Get(node->name);
+    case Qt::DecorationRole:
+        if (node->type == TreeItemPic) {
+            auto it = project->thumbs.constFind(n);
+            return it != project->thumbs.constEnd() ? *it : _pic_icon;
+        }
+        return _dir_icon;
+    case Qt::ToolTipRole: {
+        auto it = project->dup_of.constFind(n);
+        if (it != project->dup_of.constEnd()) {
+            return tr("%1\n与 %2 近似重复").arg(Path(id), Path(MakeId(SlotOf(id), *it)));
+        }
+        return Path(id);
+    }
+    case Qt::ForegroundRole:
+        if (project->dup_of.contains(n)) {
+            return QBrush(Qt::gray);
+        }
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+bool ProTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    const TreeNode* node = NodePtr(Node(parent));
+    return node && IsContainer(*node) && !(node->flags & FlagFetched);
+}
+
+void ProTreeModel::fetchMore(const QModelIndex &parent)
+{
+    Fetch(Node(parent));
+}
+
+ProTreeModel::NodeId ProTreeModel::AddProject(const QString &path)
+{
+    const QDir dir(path);
+    auto project = std::make_unique<Project>();
+    project->path = dir.absolutePath();
+    project->filter = ScanFilter(project->path);
+
+    TreeNode root;
+    root.parent = NONE;
+    root.name = project->names.Intern(dir.dirName());
+    root.row = 0;
+    root.children = NONE;
+    root.type = TreeItemPro;
+    root.flags = 0;
+    project->nodes.push_back(root);
+
+    const quint32 slot = quint32(_slots.size());
+    beginInsertRows(QModelIndex(), _top.size(), _top.size());
+    _slots.push_back(std::move(project));
+    _top.append(slot);
+    endInsertRows();
+    return MakeId(slot, 0);
+}
+
+void ProTreeModel::RemoveProject(NodeId root)
+{
+    if (!IsValid(root)) {
+        return;
+    }
+    const quint32 slot = SlotOf(root);
+    const int row = _top.indexOf(slot);
+    beginRemoveRows(QModelIndex(), row, row);
+    _top.removeAt(row);
+    _slots[slot].reset();
+    endRemoveRows();
+}
+
+bool ProTreeModel::HasProject(const QString &path) const
+{
+    const QString abs_path = QDir(path).absolutePath();
+    for (quint32 slot : _top) {
+        if (_slots[slot]->path == abs_path) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const ScanFilter &ProTreeModel::Filter(NodeId root) const
+{
+    static const ScanFilter empty;
+    const Project* project = NodePtr(root) ? ProjectOf(root) : nullptr;
+    return project ? project->filter : empty;
+}
+
+bool ProTreeModel::ApplyListing(NodeId root, const QString &relDir, const QVector<ScanEntry> &entries)
+{
+    const Project* project = NodePtr(root) ? ProjectOf(root) : nullptr;
+    if (!project) {
+        return false;
+    }
+
+    const quint32 n = Resolve(project, relDir);
+    if (n == NONE || !IsContainer(project->nodes[n]) || (project->nodes[n].flags & FlagFetched)) {
+        return false;
+    }
+    const NodeId id = MakeId(SlotOf(root), n);
+    NodePtr(id)->flags |= FlagFetched;
+    InsertChildren(id, entries);
+    return true;
+}
+
+bool ProTreeModel::SyncChildren(NodeId dir, const QVector<ScanEntry> &entries, QVector<NodeId> *added)
+{
+    TreeNode* node = NodePtr(dir);
+    if (!node || !IsContainer(*node) || !(node->flags & FlagFetched)) {
+        return false;
+    }
+    Project* project = ProjectOf(dir);
+    const quint32 slot = SlotOf(dir);
+    const quint32 n = NodeOf(dir);
+    const QModelIndex parent = Index(dir);
+
+    if (node->children == NONE) {
+        node->children = quint32(project->children.size());
+        project->children.emplace_back();
+    }
+    const quint32 list = node->children;
+    auto renumber = [project, list](size_t from) {
+        std::vector<quint32>& children = project->children[list];
+        for (size_t i = from; i < children.size(); ++i) {
+            project->nodes[children[i]].row = quint32(i);
+        }
+    };
+    auto same = [project](quint32 child, const ScanEntry& entry) {
+        const TreeNode& node = project->nodes[child];
+        return project->names.View(node.name) == entry.name && (node.type == TreeItemPic) == !entry.dir;
+    };
+
+    // 两边都按名称排序，归并找出需要保留的旧节点
+    std::vector<quint32>& old_children = project->children[list];
+    std::vector<bool> keep(old_children.size(), false);
+    {
+        size_t i = 0;
+        int j = 0;
+        while (i < old_children.size() && j < entries.size()) {
+            const int cmp = project->names.View(project->nodes[old_children[i]].name).compare(entries.at(j).name);
+            if (cmp == 0) {
+                keep[i] = same(old_children[i], entries.at(j));
+                ++i;
+                ++j;
+            } else if (cmp < 0) {
+                ++i;
+            } else {
+                ++j;
+            }
+        }
+    }
+
+    bool changed = false;
+
+    // 自后向前按连续区间移除，行号在 endRemoveRows 之前更新
+    for (int last = int(keep.size()) - 1; last >= 0; ) {
+        if (keep[last]) {
+            --last;
+            continue;
+        }
+        int first = last;
+        while (first > 0 && !keep[first - 1]) {
+            --first;
+        }
+        beginRemoveRows(parent, first, last);
+        std::vector<quint32>& children = project->children[list];
+        for (int r = first; r <= last; ++r) {
+            MarkRemoved(project, children[r]);
+        }
+        children.erase(children.begin() + first, children.begin() + last + 1);
+        renumber(size_t(first));
+        endRemoveRows();
+        changed = true;
+        last = first - 1;
+    }
+
+    // 代表图片被删除的重复组不再标记
+    if (changed) {
+        for (auto it = project->dup_of.begin(); it != project->dup_of.end(); ) {
+            if (project->nodes[it.value()].flags & FlagRemoved) {
+                it = project->dup_of.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // 按顺序插入新条目，连续的新条目一次插入
+    size_t pos = 0;
+    for (int j = 0; j < entries.size(); ) {
+        const std::vector<quint32>& children = project->children[list];
+        if (pos < children.size() && same(children[pos], entries.at(j))) {
+            ++pos;
+            ++j;
+            continue;
+        }
+        int end = j;
+        while (end < entries.size()
+               && (pos >= children.size() || project->names.View(project->nodes[children[pos]].name).compare(entries.at(end).name) > 0)) {
+            ++end;
+        }
+        if (end == j) {
+            // 旧节点名称更小但未匹配（不应出现：已在上一步移除），跳过以免死循环
+            ++pos;
+            continue;
+        }
+
+        beginInsertRows(parent, int(pos), int(pos) + (end - j) - 1);
+        std::vector<quint32> created;
+        created.reserve(size_t(end - j));
+        for (int k = j; k < end; ++k) {
+            const quint32 child = NewNode(project, n, quint32(pos) + quint32(k - j), entries.at(k));
+            created.push_back(child);
+            if (added && !entries.at(k).dir) {
+                added->append(MakeId(slot, child));
+            }
+        }
+        std::vector<quint32>& target = project->children[list];
+        target.insert(target.begin() + pos, created.begin(), created.end());
+        renumber(pos + created.size());
+        endInsertRows();
+
+        pos += created.size();
+        j = end;
+        changed = true;
+    }
+
+    if (project->children[list].empty()) {
+        NotifyChanged(dir); // 目录变空：去掉展开标记
+    }
+    return changed;
+}
+
+ProTreeModel::NodeId ProTreeModel::FindPath(const QString &path) const
+{
+    const QString abs_path = QDir::cleanPath(QDir(path).absolutePath());
+    for (quint32 slot : _top) {
+        const Project* project = _slots[slot].get();
+        if (abs_path != project->path && !abs_path.startsWith(project->path + QLatin1Char('/'))) {
+            continue;
+        }
+        const quint32 n = Resolve(project, abs_path.mid(project->path.size() + 1));
+        if (n != NONE) {
+            return MakeId(slot, n);
+        }
+    }
+    return INVALID_NODE;
+}
+
+ProTreeModel::NodeId ProTreeModel::Node(const QModelIndex &index) const
+{
+    return index.isValid() ? NodeId(index.internalId()) : INVALID_NODE;
+}
+
+QModelIndex ProTreeModel::Index(NodeId id) const
+{
+    const TreeNode* node = NodePtr(id);
+    if (!node) {
+        return QModelIndex();
+    }
+    const int row = node->parent == NONE ? _top.indexOf(SlotOf(id)) : int(node->row);
+    return createIndex(row, 0, quintptr(id));
+}
+
+bool ProTreeModel::IsValid(NodeId id) const
+{
+    return NodePtr(id) != nullptr;
+}
+
+int ProTreeModel::Type(NodeId id) const
+{
+    const TreeNode* node = NodePtr(id);
+    return node ? node->type : 0;
+}
+
+QString ProTreeModel::Name(NodeId id) const
+{
+    const TreeNode* node = NodePtr(id);
+    return node ? ProjectOf(id)->names.Get(node->name) : QString();
+}
+
+QString ProTreeModel::Path(NodeId id) const
+{
+    const Project* project = ProjectOf(id);
+    if (!NodePtr(id)) {
+        return QString();
+    }
+
+    // 自下而上收集名称，再从项目根目录拼接
+    QVector<quint32> names;
+    for (quint32 n = NodeOf(id); project->nodes[n].parent != NONE; n = project->nodes[n].parent) {
+        names.append(project->nodes[n].name);
+    }
+    QString path = project->path;
+    for (int i = names.size() - 1; i >= 0; --i) {
+        path += QLatin1Char('/');
+        path += project->names.View(names.at(i));
+    }
+    return path;
+}
+
+ProTreeModel::NodeId ProTreeModel::Root(NodeId id) const
+{
+    return IsValid(id) ? MakeId(SlotOf(id), 0) : INVALID_NODE;
+}
+
+ProTreeModel::NodeId ProTreeModel::Next(NodeId id)
+{
+    Project* project = ProjectOf(id);
+    if (!NodePtr(id)) {
+        return INVALID_NODE;
+    }
+    const quint32 slot = SlotOf(id);
+    quint32 n = NodeOf(id);
+
+    // 目录：进入第一个子节点
+    if (project->nodes[n].parent != NONE && IsContainer(project->nodes[n])) {
+        Fetch(id);
+        const quint32 list = project->nodes[n].children;
+        if (list != NONE && !project->children[list].empty()) {
+            return MakeId(slot, project->children[list].front());
+        }
+    }
+
+    // 否则取下一个兄弟，没有时回溯到父节点的下一个兄弟
+    while (project->nodes[n].parent != NONE) {
+        const TreeNode& node = project->nodes[n];
+        const std::vector<quint32>& siblings = project->children[project->nodes[node.parent].children];
+        if (node.row + 1 < siblings.size()) {
+            return MakeId(slot, siblings[node.row + 1]);
+        }
+        n = node.parent;
+    }
+    return INVALID_NODE;
+}
+
+ProTreeModel::NodeId ProTreeModel::Pre(NodeId id)
+{
+    Project* project = ProjectOf(id);
+    const TreeNode* node = NodePtr(id);
+    if (!node || node->parent == NONE) {
+        return INVALID_NODE;
+    }
+    const quint32 slot = SlotOf(id);
+
+    // 第一个子节点的前一个是父目录（项目根节点不在链表中）
+    if (node->row == 0) {
+        return project->nodes[node->parent].parent == NONE ? INVALID_NODE : MakeId(slot, node->parent);
+    }
+
+    // 前一个兄弟的最后一个后代
+    quint32 n = project->children[project->nodes[node->parent].children][node->row - 1];
+    while (IsContainer(project->nodes[n])) {
+        Fetch(MakeId(slot, n));
+        const quint32 list = project->nodes[n].children;
+        if (list == NONE || project->children[list].empty()) {
+            break;
+        }
+        n = project->children[list].back();
+    }
+    return MakeId(slot, n);
+}
+
+bool ProTreeModel::IsFullyFetched(NodeId id) const
+{
+    const Project* project = ProjectOf(id);
+    if (!NodePtr(id)) {
+        return true;
+    }
+
+    QVector<quint32> stack{NodeOf(id)};
+    while (!stack.isEmpty()) {
+        const quint32 n = stack.takeLast();
+        if (!IsContainer(project->nodes[n])) {
+            continue;
+        }
+        if (!(project->nodes[n].flags & FlagFetched)) {
+            return false;
+        }
+        const quint32 list = project->nodes[n].children;
+        if (list == NONE) {
+            continue;
+        }
+        for (quint32 child : project->children[list]) {
+            if (IsContainer(project->nodes[child])) {
+                stack.append(child);
+            }
+        }
+    }
+    return true;
+}
+
+void ProTreeModel::CollectPics(NodeId id, QVector<NodeId> &out) const
+{
+    const Project* project = ProjectOf(id);
+    const TreeNode* node = NodePtr(id);
+    if (!node) {
+        return;
+    }
+    if (node->type == TreeItemPic) {
+        out.append(id);
+        return;
+    }
+    if (node->children == NONE) {
+        return;
+    }
+    for (quint32 child : project->children[node->children]) {
+        CollectPics(MakeId(SlotOf(id), child), out);
+    }
+}
+
+void ProTreeModel::SetPicHash(NodeId id, quint64 hash)
+{
+    if (Project* project = NodePtr(id) ? ProjectOf(id) : nullptr) {
+        project->hashes.insert(NodeOf(id), hash);
+    }
+}
+
+bool ProTreeModel::PicHash(NodeId id, quint64 &hash) const
+{
+    const Project* project = NodePtr(id) ? ProjectOf(id) : nullptr;
+    if (!project) {
+        return false;
+    }
+    auto it = project->hashes.constFind(NodeOf(id));
+    if (it == project->hashes.constEnd()) {
+        return false;
+    }
+    hash = *it;
+    return true;
+}
+
+void ProTreeModel::SetDuplicateOf(NodeId id, NodeId rep)
+{
+    Project* project = NodePtr(id) ? ProjectOf(id) : nullptr;
+    if (!project) {
+        return;
+    }
+    // 代表项是自身或不在同一项目时视为非重复
+    if (rep == id || !IsValid(rep) || SlotOf(rep) != SlotOf(id)) {
+        project->dup_of.remove(NodeOf(id));
+    } else {
+        project->dup_of.insert(NodeOf(id), NodeOf(rep));
+    }
+    NotifyChanged(id);
+}
+
+bool ProTreeModel::IsDuplicate(NodeId id) const
+{
+    const Project* project = NodePtr(id) ? ProjectOf(id) : nullptr;
+    return project && project->dup_of.contains(NodeOf(id));
+}
+
+void ProTreeModel::SetThumbnail(NodeId id, const QIcon &icon)
+{
+    TreeNode* node = NodePtr(id);
+    if (!node) {
+        return;
+    }
+    node->flags |= FlagThumbLoaded;
+    if (!icon.isNull()) {
+        ProjectOf(id)->thumbs.insert(NodeOf(id), icon);
+        NotifyChanged(id);
+    }
+}
+
+void ProTreeModel::ClearThumbnail(NodeId id)
+{
+    TreeNode* node = NodePtr(id);
+    if (!node) {
+        return;
+    }
+    node->flags &= ~FlagThumbLoaded;
+    if (ProjectOf(id)->thumbs.remove(NodeOf(id)) > 0) {
+        NotifyChanged(id);
+    }
+}
+
+bool ProTreeModel::IsThumbLoaded(NodeId id) const
+{
+    const TreeNode* node = NodePtr(id);
+    return node && (node->flags & FlagThumbLoaded);
+}
+
+int ProTreeModel::NodeCount() const
+{
+    size_t count = 0;
+    for (quint32 slot : _top) {
+        count += _slots[slot]->nodes.size();
+    }
+    return int(count);
+}
+
+size_t ProTreeModel::MemoryBytes() const
+{
+    size_t bytes = 0;
+    for (quint32 slot : _top) {
+        const Project* project = _slots[slot].get();
+        bytes += project->nodes.capacity() * sizeof(TreeNode);
+        bytes += project->names.MemoryBytes();
+        for (const auto& list : project->children) {
+            bytes += sizeof(list) + list.capacity() * sizeof(quint32);
+        }
+    }
+    return bytes;
+}
+
+ProTreeModel::Project *ProTreeModel::ProjectOf(NodeId id) const
+{
+    if (id == INVALID_NODE) {
+        return nullptr;
+    }
+    const quint32 slot = SlotOf(id);
+    return slot < _slots.size() ? _slots[slot].get() : nullptr;
+}
+
+ProTreeModel::TreeNode *ProTreeModel::NodePtr(NodeId id) const
+{
+    Project* project = ProjectOf(id);
+    if (!project || NodeOf(id) >= project->nodes.size() || (project->nodes[NodeOf(id)].flags & FlagRemoved)) {
+        return nullptr;
+    }
+    return &project->nodes[NodeOf(id)];
+}
+
+bool ProTreeModel::IsContainer(const TreeNode &node) const
+{
+    return node.type == TreeItemPro || node.type == TreeItemDir;
+}
+
+void ProTreeModel::Fetch(NodeId id)
+{
+    TreeNode* node = NodePtr(id);
+    if (!node || !IsContainer(*node) || (node->flags & FlagFetched)) {
+        return;
+    }
+    node->flags |= FlagFetched;
+
+    // 与后台扫描使用同一套过滤规则，未扫描到的目录展开时结果一致
+    Project* project = ProjectOf(id);
+    InsertChildren(id, project->filter.List(Path(id)));
+}
+
+void ProTreeModel::InsertChildren(NodeId id, const QVector<ScanEntry> &entries)
+{
+    Project* project = ProjectOf(id);
+    const quint32 n = NodeOf(id);
+    if (entries.isEmpty()) {
+        NotifyChanged(id); // 空目录：去掉展开标记
+        emit SigDirFetched(id);
+        return;
+    }
+
+    const quint32 list = quint32(project->children.size());
+    project->children.emplace_back();
+    project->children.back().reserve(size_t(entries.size()));
+    project->nodes.reserve(project->nodes.size() + size_t(entries.size()));
+
+    beginInsertRows(Index(id), 0, entries.size() - 1);
+    for (const ScanEntry& entry : entries) {
+        const quint32 row = quint32(project->children[list].size());
+        project->children[list].push_back(NewNode(project, n, row, entry));
+    }
+    project->nodes[n].children = list;
+    endInsertRows();
+    emit SigDirFetched(id);
+}
+
+quint32 ProTreeModel::FindChild(const Project *project, quint32 n, QStringView name) const
+{
+    const quint32 list = project->nodes[n].children;
+    if (list == NONE) {
+        return NONE;
+    }
+    // 子节点按名称排序（ScanFilter::List 的顺序）
+    const std::vector<quint32>& children = project->children[list];
+    auto it = std::lower_bound(children.begin(), children.end(), name, [project](quint32 child, QStringView key) {
+        return project->names.View(project->nodes[child].name).compare(key) < 0;
+    });
+    if (it == children.end() || project->names.View(project->nodes[*it].name) != name) {
+        return NONE;
+    }
+    return *it;
+}
+
+quint32 ProTreeModel::Resolve(const Project *project, const QString &relDir) const
+{
+    // 沿路径逐级查找，经过的目录必须已加载
+    quint32 n = 0;
+    for (const QString& segment : relDir.split(QLatin1Char('/'), Qt::SkipEmptyParts)) {
+        if (!(project->nodes[n].flags & FlagFetched)) {
+            return NONE;
+        }
+        n = FindChild(project, n, segment);
+        if (n == NONE) {
+            return NONE;
+        }
+    }
+    return n;
+}
+
+quint32 ProTreeModel::NewNode(Project *project, quint32 parent, quint32 row, const ScanEntry &entry)
+{
+    TreeNode child;
+    child.parent = parent;
+    child.name = project->names.Intern(entry.name);
+    child.row = row;
+    child.children = NONE;
+    child.type = entry.dir ? TreeItemDir : TreeItemPic;
+    child.flags = 0;
+    project->nodes.push_back(child);
+    return quint32(project->nodes.size() - 1);
+}
+
+void ProTreeModel::MarkRemoved(Project *project, quint32 n)
+{
+    // 节点数组只增不减，删除的节点只打标记，附加信息一并释放
+    QVector<quint32> stack{n};
+    while (!stack.isEmpty()) {
+        const quint32 m = stack.takeLast();
+        TreeNode& node = project->nodes[m];
+        node.flags |= FlagRemoved;
+        project->hashes.remove(m);
+        project->dup_of.remove(m);
+        project->thumbs.remove(m);
+        if (node.children != NONE) {
+            for (quint32 child : project->children[node.children]) {
+                stack.append(child);
+            }
+            std::vector<quint32>().swap(project->children[node.children]);
+        }
+    }
+}
+
+void ProTreeModel::NotifyChanged(NodeId id)
+{
+    const QModelIndex index = Index(id);
+    if (index.isValid()) {
+        emit dataChanged(index, index);
+    }
+}
@@ -0,0 +1,178 @@
+#ifndef PROTREEMODEL_H
+#define PROTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QIcon>
+#include <QVector>
+#include <memory>
+#include <vector>
+#include "scanfilter.h"
+#include "segmentpool.h"
+
+/**
+ * @brief 项目树数据模型
+ * 每个项目一块紧凑的节点数组，节点只保存父节点、名称编号、行号、类型等定长字段，
+ * 名称统一放在项目的片段池中，完整路径按需拼接。
+ * 目录在视图展开时才通过 canFetchMore/fetchMore 读取，打开项目只创建根节点。
+ * 节点编号 NodeId 高 32 位为项目槽位，低 32 位为项目内的节点下标，项目关闭后编号不会被复用。
+ */
+class ProTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    typedef quint64 NodeId;
+    static const NodeId INVALID_NODE = 0;
+
+    explicit ProTreeModel(QObject *parent = nullptr);
+    ~ProTreeModel();
+
+    // QAbstractItemModel 接口
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    /**
+     * @brief 添加一个项目（只创建根节点，子节点展开时再加载）
+     * @param path 项目根目录
+     * @return 项目根节点
+     */
+    NodeId AddProject(const QString& path);
+
+    // 关闭项目并释放其全部节点
+    void RemoveProject(NodeId root);
+
+    // 项目是否已经打开
+    bool HasProject(const QString& path) const;
+
+    // 项目的扫描过滤规则（展开目录与后台扫描共用）
+    const ScanFilter& Filter(NodeId root) const;
+
+    /**
+     * @brief 写入后台扫描得到的目录内容
+     * 目录已加载（例如用户先展开了它）时忽略；父目录尚未加载时也忽略，之后展开时再同步读取。
+     * @param root 项目根节点
+     * @param relDir 目录相对项目根目录的路径，根目录为空
+     * @param entries 目录内容（已过滤、已排序）
+     * @return 是否写入
+     */
+    bool ApplyListing(NodeId root, const QString& relDir, const QVector<ScanEntry>& entries);
+
+    /**
+     * @brief 按磁盘上的最新内容增量更新已加载的目录
+     * 消失的条目连同其子树一起移除（节点编号随之失效），新条目按名称插入到对应位置，
+     * 改名视为移除旧名称、插入新名称；先序的上一张/下一张顺序随树结构自动更新。
+     * @param dir 目录节点，未加载时不处理
+     * @param entries 目录的最新内容（已过滤、已排序）
+     * @param added 输出新增的图片节点，可为 nullptr
+     * @return 是否有变化
+     */
+    bool SyncChildren(NodeId dir, const QVector<ScanEntry>& entries, QVector<NodeId>* added = nullptr);
+
+    // 按绝对路径查找已加载的节点，找不到返回 INVALID_NODE
+    NodeId FindPath(const QString& path) const;
+
+    // 节点与索引互转
+    NodeId Node(const QModelIndex& index) const;
+    QModelIndex Index(NodeId node) const;
+
+    bool IsValid(NodeId node) const;
+    int Type(NodeId node) const;
+    QString Name(NodeId node) const;
+    QString Path(NodeId node) const;
+    NodeId Root(NodeId node) const;
+
+    /**
+     * @brief 按先序遍历取下一个/上一个节点（与原先 _next_item/_pre_item 链表顺序一致）
+     * 需要时会加载经过的目录
+     */
+    NodeId Next(NodeId node);
+    NodeId Pre(NodeId node);
+
+    // 节点下的全部目录是否都已加载（批量处理前检查，未加载时交给后台扫描）
+    bool IsFullyFetched(NodeId node) const;
+
+    // 收集节点下已加载的全部图片节点（先序）
+    void CollectPics(NodeId node, QVector<NodeId>& out) const;
+
+    // 感知哈希与近似重复标记
+    void SetPicHash(NodeId node, quint64 hash);
+    bool PicHash(NodeId node, quint64& hash) const;
+    void SetDuplicateOf(NodeId node, NodeId rep);
+    bool IsDuplicate(NodeId node) const;
+
+    // 缩略图：已加载（或确认无法生成）的节点不再重复请求
+    void SetThumbnail(NodeId node, const QIcon& icon);
+    void ClearThumbnail(NodeId node);
+    bool IsThumbLoaded(NodeId node) const;
+
+    // 全部项目的节点数量与内存占用（估算）
+    int NodeCount() const;
+    size_t MemoryBytes() const;
+
+private:
+    // 节点（20 字节）
+    struct TreeNode
+    {
+        quint32 parent;     // 父节点下标，根节点为 NONE
+        quint32 name;       // 名称在片段池中的编号
+        quint32 row;        // 在父节点中的行号
+        quint32 children;   // 子节点列表下标（目录），NONE 表示没有
+        quint8 type;        // TreeItmType
+        quint8 flags;       // NodeFlag 组合
+    };
+
+    enum NodeFlag : quint8
+    {
+        FlagFetched = 1,      // 子节点已加载
+        FlagThumbLoaded = 2,  // 缩略图已加载
+        FlagRemoved = 4,      // 已从磁盘删除（节点编号失效）
+    };
+
+    // 一个项目的全部节点
+    struct Project
+    {
+        QString path;                               // 项目根目录
+        ScanFilter filter;                          // 扫描过滤规则
+        SegmentPool names;                          // 名称池
+        std::vector<TreeNode> nodes;                // 节点数组，下标 0 为根节点
+        std::vector<std::vector<quint32>> children; // 目录的子节点列表
+        QHash<quint32, quint64> hashes;             // 节点 -> 感知哈希
+        QHash<quint32, quint32> dup_of;             // 节点 -> 近似重复组代表
+        QHash<quint32, QIcon> thumbs;               // 节点 -> 缩略图
+    };
+
+    static const quint32 NONE = 0xFFFFFFFFu;
+
+    static NodeId MakeId(quint32 slot, quint32 node) { return (NodeId(slot + 1) << 32) | node; }
+    static quint32 SlotOf(NodeId id) { return quint32(id >> 32) - 1; }
+    static quint32 NodeOf(NodeId id) { return quint32(id & 0xFFFFFFFFu); }
+
+    Project* ProjectOf(NodeId id) const;
+    TreeNode* NodePtr(NodeId id) const;           // 无效编号返回 nullptr
+    bool IsContainer(const TreeNode& node) const;
+    void Fetch(NodeId id);                      // 读取目录内容并插入子节点
+    void InsertChildren(NodeId id, const QVector<ScanEntry>& entries);
+    quint32 FindChild(const Project* project, quint32 n, QStringView name) const; // 按名称二分查找
+    quint32 Resolve(const Project* project, const QString& relDir) const;         // 按相对路径查找已加载的节点
+    quint32 NewNode(Project* project, quint32 parent, quint32 row, const ScanEntry& entry);
+    void MarkRemoved(Project* project, quint32 n);                                 // 标记节点及其子树已删除
+    void NotifyChanged(NodeId id);
+
+signals:
+    // 目录内容已加载（展开、后台扫描或增量更新创建的目录）
+    void SigDirFetched(NodeId dir);
+
+private:
+    std::vector<std::unique_ptr<Project>> _slots;   // 项目槽位，关闭的项目置空
+    QVector<quint32> _top;                          // 顶层显示顺序（槽位）
+    QIcon _dir_icon;                                // 目录图标（所有节点共享）
+    QIcon _pic_icon;                                // 图片默认图标（所有节点共享）
+};
+
+#endif // PROTREEMODEL_H
@@ -1,22 +1,48 @@
 #include "protreewidget.h"
+#include <QDebug>
 #include <QDir>
-#include "protreeitem.h"
 #include "const.h"
+#include "metrics.h"
 #include <QGuiApplication>
 #include <QMenu>
 #include <QFileDialog>
+#include <QMessageBox>
+#include <QScrollBar>
+#include <algorithm>
+#include "mainwindow.h"
 
+namespace {
+
+// 批量识别的图片数，按结果分类（跳过的是近似重复图片）
+Counter& BatchPictures(const char* outcome)
+{
+    return Metrics::Instance().GetCounter("cv_batch_pictures_total", "Pictures handled by batch recognition, by outcome.",
+                                          QString("outcome=\"%1\"").arg(QLatin1String(outcome)));
+}
+
+} // namespace
 
-ProTreeWidget::ProTreeWidget(QWidget *parent):QTreeWidget(parent),
-    _right_btn_item(nullptr), _selected_item(nullptr),
-    _thread_open_pro(nullptr)
+
+ProTreeWidget::ProTreeWidget(QWidget *parent):QTreeView(parent),
+    _model(new ProTreeModel(this)),
+    _right_btn_node(ProTreeModel::INVALID_NODE), _selected_node(ProTreeModel::INVALID_NODE),
+    _thread_batch_recognize(nullptr), _dlg_batch_progress(nullptr),
+    _thread_pic_hash(nullptr), _dlg_hash_progress(nullptr),
+    _thumb_loader(new ThumbnailLoader(this)), _thumb_timer(new QTimer(this)), _scan_timer(new QTimer(this)),
+    _listing_node(ProTreeModel::INVALID_NODE), _listing_action(nullptr), _dlg_listing_progress(nullptr),
+    _watcher(new ProjectWatcher(this))
 
 {
+    this->setModel(_model);
+
     // 隐藏树控件的表头（不显示列标题），更像一个文件浏览树
     this->setHeaderHidden(true);
 
+    // 所有行等高，视图不必逐行测量，百万级节点滚动也不卡顿
+    this->setUniformRowHeights(true);
+
     // 连接信号槽：当用户点击树节点时，触发 SlotItemPressed 函数
-    connect(this, &ProTreeWidget::itemPressed, this, &ProTreeWidget::SlotItemPressed);
+    connect(this, &ProTreeWidget::pressed, this, &ProTreeWidget::SlotItemPressed);
 
     // 创建右键菜单的动作（Action）
 
@@ -26,7 +52,49 @@ ProTreeWidget::ProTreeWidget(QWidget *parent):QTreeWidget(parent),
     // 连接动作触发信号与槽函数
     connect(_action_closepro, &QAction::triggered, this, &ProTreeWidget::SlotClosePro);
 
-    connect(this, &ProTreeWidget::itemDoubleClicked, this, &ProTreeWidget::SlotDoubleClickItem);
+    _action_batch_recognize = new QAction(QIcon(":/icon/pic.png"), tr("批量识别"), this);
+    connect(_action_batch_recognize, &QAction::triggered, this, &ProTreeWidget::SlotBatchRecognize);
+
+    _action_find_dup = new QAction(QIcon(":/icon/pic.png"), tr("查找重复图片"), this);
+    connect(_action_find_dup, &QAction::triggered, this, &ProTreeWidget::SlotFindDuplicates);
+
+    connect(this, &ProTreeWidget::doubleClicked, this, &ProTreeWidget::SlotDoubleClickItem);
+
+    // 缩略图只为可见行加载：滚动、展开、折叠后稍作停顿再请求
+    this->setIconSize(QSize(THUMB_ICON_SIZE, THUMB_ICON_SIZE));
+    _thumb_timer->setSingleShot(true);
+    _thumb_timer->setInterval(50);
+    connect(_thumb_timer, &QTimer::timeout, this, &ProTreeWidget::SlotRequestThumbnails);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, _thumb_timer, [this]() { _thumb_timer->start(); });
+    connect(this, &ProTreeWidget::expanded, _thumb_timer, [this]() { _thumb_timer->start(); });
+    connect(this, &ProTreeWidget::collapsed, _thumb_timer, [this]() { _thumb_timer->start(); });
+    connect(_thumb_loader, &ThumbnailLoader::SigThumbnailReady, this, &ProTreeWidget::SlotThumbnailReady);
+
+    // 后台扫描结果按固定间隔成批写入，界面线程每次只处理有限条目
+    _scan_timer->setInterval(SCAN_APPLY_INTERVAL);
+    connect(_scan_timer, &QTimer::timeout, this, &ProTreeWidget::SlotApplyScan);
+
+    // 已加载的目录加入监视，磁盘上的新增、删除、改名增量反映到树中
+    connect(_model, &ProTreeModel::SigDirFetched, this, [this](NodeId dir) { _watcher->Watch(_model->Path(dir)); });
+    connect(_watcher, &ProjectWatcher::SigDirsChanged, this, &ProTreeWidget::SlotDirsChanged);
+
+    _action_auto_recognize = new QAction(tr("自动识别新增图片"), this);
+    _action_auto_recognize->setCheckable(true);
+
+    // 项目结构变化后，图片索引在下次使用时重建
+    auto mark_dirty = [this](const QModelIndex& parent) {
+        if (parent.isValid()) {
+            _index_dirty.insert(_model->Root(_model->Node(parent)));
+        }
+    };
+    connect(_model, &QAbstractItemModel::rowsInserted, this, mark_dirty);
+    connect(_model, &QAbstractItemModel::rowsRemoved, this, mark_dirty);
+}
+
+void ProTreeWidget::resizeEvent(QResizeEvent *event)
+{
+    QTreeView::resizeEvent(event);
+    _thumb_timer->start();
 }
 
 void ProTreeWidget::AddProTree(const QString &name, const QString &path)
@@ -34,8 +102,8 @@ void ProTreeWidget::AddProTree(const QString &name, const QString &path)
     // 生成项目的完整路径 = path + / + name
     QDir dir(path);
     QString file_path = dir.absoluteFilePath(name);
-    // 如果这个路径已经存在于集合中， 直接返回（防止重复添加）
-    if(_set_path.find(file_path) != _set_path.end()){
+    // 如果这个项目已经打开， 直接返回（防止重复添加）
+    if(_model->HasProject(file_path)){
         return;
     }
     // 检查项目路径是否存在，不存在就创建
@@ -48,47 +116,52 @@ void ProTreeWidget::AddProTree(const QString &name, const QString &path)
         }
     }
 
-    // 将路径加入集合， 避免后续重复添加
-    _set_path.insert(file_path);
-    // 创建一个自定义的树节点
-    auto * item = new ProTreeItem(this, name, file_path, TreeItemPro);
-    // 设置节点显示的文字
-    item->setData(0, Qt::DisplayRole, name);
-    // 设置节点显示的图标
-    item->setData(0, Qt::DecorationRole, QIcon(":/icon/dir.png"));
-    // 设置鼠标悬停时的提示信息
-    item->setData(0, Qt::ToolTipRole, file_path);
-    // 将新节点添加为顶层节点
-    this->addTopLevelItem(item);
+    // 在模型中创建项目根节点（显示名称、图标、提示信息由模型提供）
+    _model->AddProject(file_path);
+}
+
+QString ProTreeWidget::ProjectOf(const QString &path) const
+{
+    // 只比较顶层项目路径，不依赖子目录是否已经列出
+    const QString abs_path = QDir::cleanPath(QDir(path).absolutePath());
+    for (int row = 0; row < _model->rowCount(); ++row) {
+        const QString root = _model->Path(_model->Node(_model->index(row, 0)));
+        if (abs_path.startsWith(root + QLatin1Char('/'))) {
+            return root;
+        }
+    }
+    return QString();
 }
 
 // 当用户点击树节点时触发
-void ProTreeWidget::SlotItemPressed(QTreeWidgetItem *pressedItem, int column)
+void ProTreeWidget::SlotItemPressed(const QModelIndex &index)
 {
     // 判断是否为鼠标右键点击
     if(QGuiApplication::mouseButtons() == Qt::RightButton){
         QMenu menu(this);  // 创建右键菜单
-        int itemtype = pressedItem->type();  // 获取节点类型
+        const NodeId node = _model->Node(index);
+        int itemtype = _model->Type(node);  // 获取节点类型
         if(itemtype == TreeItemPro){  // 如果是项目类型节点
-            _right_btn_item = pressedItem; // 记录当前右键点击的节点，用于后续操作
+            _right_btn_node = node; // 记录当前右键点击的节点，用于后续操作
             // 添加菜单操作项
+            menu.addAction(_action_batch_recognize); // 批量识别
+            menu.addAction(_action_find_dup);   // 查找重复图片
+            menu.addAction(_action_auto_recognize); // 自动识别新增图片
             menu.addAction(_action_closepro);   // 关闭项目
             menu.exec(QCursor::pos());          // 在鼠标当前位置显示菜单
         }
     }
 }
 
-void ProTreeWidget::SlotDoubleClickItem(QTreeWidgetItem *doubleItem, int col)
+void ProTreeWidget::SlotDoubleClickItem(const QModelIndex &index)
 {
     if(QGuiApplication::mouseButtons() == Qt::LeftButton){
-        auto * tree_doubleItem = dynamic_cast<ProTreeItem*>(doubleItem);
-        if(!tree_doubleItem){
-            return;
-        }
-        int itemtype = tree_doubleItem->type();
-        if(itemtype == TreeItemPic){
-            emit SigUpdataSelected(tree_doubleItem->GetPath());
-            _selected_item = doubleItem;
+        const NodeId node = _model->Node(index);
+        if(_model->Type(node) == TreeItemPic){
+            emit SigUpdataSelected(_model->Path(node));
+            _selected_node = node;
+            EmitNeighbors(true);
+            EmitPosition();
         }
     }
 }
@@ -96,6 +169,10 @@ void ProTreeWidget::SlotDoubleClickItem(QTreeWidgetItem *doubleItem, int col)
 // 关闭项目
 void ProTreeWidget::SlotClosePro()
 {
+    if(!_model->IsValid(_right_btn_node)){
+        return;
+    }
+
     // 创建一个“删除项目”对话框
     RemoveProDialog remove_pro_dialog;
 
@@ -110,19 +187,10 @@ void ProTreeWidget::SlotClosePro()
     // 判断用户是否选择同时删除硬盘上的项目文件
     bool b_remove = remove_pro_dialog.IsRemoved();
 
-    // 获取当前右键选中的顶层节点在树控件中的索引
-    auto index_right_btn = this->indexOfTopLevelItem(_right_btn_item);
-
-    // 将右键选中的节点转换为 ProTreeItem 类型，以便访问项目路径等自定义方法
-    auto * protreeitem = dynamic_cast<ProTreeItem*>(_right_btn_item);
-
-    auto * selecteditem = dynamic_cast<ProTreeItem*>(_selected_item);
+    const NodeId root = _right_btn_node;
 
     // 获取项目路径
-    auto delete_path = protreeitem->GetPath();
-
-    // 从已打开项目集合中移除该路径，防止重复打开
-    _set_path.remove(delete_path);
+    auto delete_path = _model->Path(root);
 
     // 如果用户选择删除硬盘文件，则递归删除整个目录
     if(b_remove){
@@ -130,70 +198,570 @@ void ProTreeWidget::SlotClosePro()
         delete_dir.removeRecursively();
     }
 
+    // 停止该项目的后台扫描，放弃等待扫描的批量操作
+    if (DirScanner* scanner = _scanners.take(root)) {
+        delete scanner;
+    }
+    if (_dlg_listing_progress && _model->Root(_listing_node) == root) {
+        CloseListingProgress();
+    }
+
+    _indexes.remove(root);
+    _index_dirty.remove(root);
+
+    // 停止监视，丢弃该项目尚未识别的新图片
+    _watcher->UnwatchProject(delete_path);
+    _auto_queue.erase(std::remove_if(_auto_queue.begin(), _auto_queue.end(),
+                                     [&delete_path](const QString& path) { return path.startsWith(delete_path + '/'); }),
+                      _auto_queue.end());
+
+    // 丢弃该项目的缩略图请求与记录
+    _thumb_loader->CloseProject(delete_path);
+    for (auto it = _thumb_pending.begin(); it != _thumb_pending.end(); ) {
+        if (_model->Root(it.value()) == root) {
+            it = _thumb_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    _thumb_loaded.erase(std::remove_if(_thumb_loaded.begin(), _thumb_loaded.end(),
+                                       [this, root](NodeId node) { return _model->Root(node) == root; }),
+                        _thumb_loaded.end());
 
-    if(selecteditem && protreeitem == selecteditem->GetRoot()){
-        selecteditem = nullptr;
-        _selected_item = nullptr;
+    if(_model->IsValid(_selected_node) && _model->Root(_selected_node) == root){
+        _selected_node = ProTreeModel::INVALID_NODE;
         emit SigClearSelected();
     }
 
-    // 从树控件中移除顶层节点，并释放节点内存
-    delete this->takeTopLevelItem(index_right_btn);
+    // 从模型中移除项目，释放其全部节点
+    _model->RemoveProject(root);
 
-    // 清空右键选中节点指针，防止悬空指针
-    _right_btn_item = nullptr;
+    // 清空右键选中节点，防止悬空引用
+    _right_btn_node = ProTreeModel::INVALID_NODE;
     emit SigUpdataPic("");
+    EmitPosition();
 }
 
 
 // 打开项目
 void ProTreeWidget::SlotOpenPro(const QString &path)
 {
-    // 如果路径已经在集合中，说明项目已经打开过，直接返回，不再重复打开
-    if(_set_path.find(path) != _set_path.end()){
+    // 如果项目已经打开过，直接返回，不再重复打开
+    if(_model->HasProject(path)){
+        return;
+    }
+
+    // 先只创建项目根节点，目录内容由后台扫描器并行读取后分批写入；
+    // 扫描到达之前展开的目录由模型同步读取，扫描结果随后被忽略
+    const NodeId root = _model->AddProject(path);
+    StartScan(root);
+    _thumb_timer->start();
+}
+
+void ProTreeWidget::StartScan(NodeId root)
+{
+    DirScanner* scanner = new DirScanner(_model->Path(root), _model->Filter(root), this);
+    _scanners.insert(root, scanner);
+    scanner->Start();
+    _scan_timer->start();
+}
+
+bool ProTreeWidget::EnsureListed(NodeId root)
+{
+    if (_scanners.contains(root)) {
+        return false;
+    }
+    if (_model->IsFullyFetched(root)) {
+        return true;
+    }
+    // 监视只同步已加载目录的内容，之后新建的子目录尚未加载，交给后台补扫；
+    // 已加载的目录扫描结果会被模型忽略
+    StartScan(root);
+    return false;
+}
+
+void ProTreeWidget::WhenListed(NodeId node, void (ProTreeWidget::*action)(NodeId))
+{
+    if (EnsureListed(_model->Root(node))) {
+        (this->*action)(node);
         return;
     }
 
-    // 将路径插入集合，防止重复打开
-    _set_path.insert(path);
+    // 等待扫描期间对话框为模态，同一时间只有一个等待中的批量操作
+    CloseListingProgress();
+    _listing_node = node;
+    _listing_action = action;
+    _dlg_listing_progress = new QProgressDialog(tr("正在读取目录..."), tr("取消"), 0, 0, this);
+    _dlg_listing_progress->setWindowTitle(tr("读取目录"));
+    _dlg_listing_progress->setFixedWidth(PROGRESS_WIDTH);
+    _dlg_listing_progress->setWindowModality(Qt::WindowModal);
+    _dlg_listing_progress->setMinimumDuration(0);
+    // 取消只放弃批量操作，扫描继续进行
+    connect(_dlg_listing_progress, &QProgressDialog::canceled, this, &ProTreeWidget::CloseListingProgress);
+}
 
-    QDir pro_dir(path);               // 创建一个 QDir 对象，用于操作目录
-    QString proname = pro_dir.dirName(); // 获取目录名称，即项目名称
+void ProTreeWidget::CloseListingProgress()
+{
+    _listing_node = ProTreeModel::INVALID_NODE;
+    _listing_action = nullptr;
+    // 先清空成员：close() 会再次发出 canceled
+    QProgressDialog* dlg = _dlg_listing_progress;
+    _dlg_listing_progress = nullptr;
+    if (dlg) {
+        dlg->close();
+        dlg->deleteLater();
+    }
+}
 
-    // 创建一个线程对象，用于递归遍历目录，加载项目树
-    // std::make_shared 创建一个 shared_ptr，确保线程对象在使用过程中不会被释放
-    _thread_open_pro = std::make_shared<OpenTreeThread>(path, this, nullptr);
+void ProTreeWidget::SlotApplyScan()
+{
+    bool applied = false;
+    QVector<NodeId> finished_roots;
+    for (auto it = _scanners.begin(); it != _scanners.end(); ) {
+        DirScanner* scanner = it.value();
+        // 先读取结束标志：结束后通道中不会再有新结果
+        const bool finished = scanner->IsFinished();
+        const QVector<ScanBatch> batches = scanner->Channel().Take(SCAN_APPLY_BATCH);
+        for (const ScanBatch& batch : batches) {
+            applied |= _model->ApplyListing(it.key(), batch.relDir, batch.entries);
+        }
+
+        if (finished && scanner->Channel().IsEmpty()) {
+            static Metrics& metrics = Metrics::Instance();
+            static Counter& dirs = metrics.GetCounter("cv_project_scan_dirs_total", "Directories listed by background project scans.");
+            static Counter& pictures = metrics.GetCounter("cv_project_scan_pictures_total", "Pictures found by background project scans.");
+            dirs.Inc(quint64(scanner->DirCount()));
+            pictures.Inc(quint64(scanner->FileCount()));
+            delete scanner;
+            finished_roots.append(it.key());
+            it = _scanners.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (applied) {
+        _thumb_timer->start();
+    }
+    // 遍历结束后再重建索引：重建时可能为未加载的目录启动新的扫描
+    if (!finished_roots.isEmpty()) {
+        EmitPosition();
+    }
 
-    // 启动线程，开始处理目录遍历
-    _thread_open_pro->start();
+    // 等待扫描的批量操作：显示扫描进度，项目扫描结束后执行
+    if (_dlg_listing_progress) {
+        const NodeId root = _model->Root(_listing_node);
+        if (root == ProTreeModel::INVALID_NODE) {
+            CloseListingProgress();   // 节点在扫描期间被删除
+        } else if (const DirScanner* scanner = _scanners.value(root)) {
+            _dlg_listing_progress->setLabelText(tr("正在读取目录... 已发现 %1 个目录，%2 张图片")
+                                                    .arg(scanner->DirCount()).arg(scanner->FileCount()));
+        } else if (finished_roots.contains(root)) {
+            const NodeId node = _listing_node;
+            const auto action = _listing_action;
+            CloseListingProgress();
+            (this->*action)(node);
+        }
+    }
+    if (_scanners.isEmpty()) {
+        _scan_timer->stop();
+    }
+}
+
+void ProTreeWidget::ShowNode(NodeId node, bool forward)
+{
+    emit SigUpdataPic(_model->Path(node));
+    _selected_node = node;
+    this->setCurrentIndex(_model->Index(node));
+    EmitNeighbors(forward);
+    EmitPosition();
 }
 
 void ProTreeWidget::SlotNextShow()
 {
-    if(!_selected_item){
+    if(!_model->IsValid(_selected_node)){
         return;
     }
-    auto *curItem = dynamic_cast<ProTreeItem*>(_selected_item)->GetNextItem();
-    if(!curItem){
+    const NodeId next = IndexOf(_model->Root(_selected_node)).Step(_selected_node, 1);
+    if(next == ProTreeModel::INVALID_NODE){
         return;
     }
-    emit SigUpdataPic(curItem->GetPath());
-    _selected_item = curItem;
-    this->setCurrentItem(curItem);
+    ShowNode(next, true);
 }
 
 void ProTreeWidget::SlotPreShow()
 {
-    if(!_selected_item){
+    if(!_model->IsValid(_selected_node)){
         return;
     }
-    auto *curItem = dynamic_cast<ProTreeItem*>(_selected_item)->GetPreItem();
-    if(!curItem){
+    const NodeId pre = IndexOf(_model->Root(_selected_node)).Step(_selected_node, -1);
+    if(pre == ProTreeModel::INVALID_NODE){
         return;
     }
-    emit SigUpdataPic(curItem->GetPath());
-    _selected_item = curItem;
-    this->setCurrentItem(curItem);
+    ShowNode(pre, false);
 }
 
+void ProTreeWidget::SlotJumpTo(int pos)
+{
+    if(!_model->IsValid(_selected_node)){
+        return;
+    }
+    const NodeId node = IndexOf(_model->Root(_selected_node)).At(pos - 1);
+    if(node == ProTreeModel::INVALID_NODE || node == _selected_node){
+        return;
+    }
+    ShowNode(node, true);
+}
+
+void ProTreeWidget::SlotSetFilter(const QString &className, float maxConfidence)
+{
+    _pic_filter.className = className;
+    _pic_filter.maxConfidence = maxConfidence;
+    for (PicIndex& index : _indexes) {
+        index.SetFilter(_pic_filter);
+    }
+    EmitPosition();
+}
+
+void ProTreeWidget::SlotRecognizeResult(const QString &path, const QString &className, float confidence)
+{
+    const NodeId node = _model->FindPath(path);
+    if (_model->Type(node) != TreeItemPic) {
+        return;
+    }
+
+    // 只记录结果、增量更新筛选视图，不触发索引重建
+    const NodeId root = _model->Root(node);
+    const bool changed = EnsureIndex(root).SetResult(node, {className, confidence});
+    if (changed && _model->IsValid(_selected_node) && _model->Root(_selected_node) == root) {
+        EmitPosition();
+    }
+}
+
+PicIndex &ProTreeWidget::EnsureIndex(NodeId root)
+{
+    auto it = _indexes.find(root);
+    if (it == _indexes.end()) {
+        it = _indexes.insert(root, PicIndex());
+        it->SetFilter(_pic_filter);
+        _index_dirty.insert(root);
+    }
+    return *it;
+}
+
+PicIndex &ProTreeWidget::IndexOf(NodeId root)
+{
+    PicIndex& index = EnsureIndex(root);
+    if (_index_dirty.remove(root)) {
+        // 目录未全部加载时只收集已加载的图片（其余目录在后台扫描），扫描写入新目录后会再次重建
+        EnsureListed(root);
+        QVector<NodeId> pics;
+        _model->CollectPics(root, pics);
+        index.Reset(pics);
+    }
+    return index;
+}
+
+void ProTreeWidget::EmitPosition()
+{
+    if (!_model->IsValid(_selected_node)) {
+        emit SigUpdataPosition(0, 0, 0);
+        return;
+    }
+    const PicIndex& index = IndexOf(_model->Root(_selected_node));
+    emit SigUpdataPosition(index.PositionOf(_selected_node) + 1, index.Size(), index.TotalSize());
+}
 
+void ProTreeWidget::EmitNeighbors(bool forward)
+{
+    if (!_model->IsValid(_selected_node)) {
+        return;
+    }
+
+    // 沿索引（筛选时为筛选视图）前后交替各取 PREFETCH_COUNT 张，浏览方向上的图片排在前面
+    const PicIndex& index = IndexOf(_model->Root(_selected_node));
+    QStringList paths;
+    for (int i = 1; i <= PREFETCH_COUNT; ++i) {
+        for (int delta : {forward ? i : -i, forward ? -i : i}) {
+            const NodeId node = index.Step(_selected_node, delta);
+            if (node != ProTreeModel::INVALID_NODE) {
+                paths << _model->Path(node);
+            }
+        }
+    }
+    emit SigUpdataNeighbors(paths);
+}
+
+void ProTreeWidget::SlotBatchRecognize()
+{
+    if (!_model->IsValid(_right_btn_node) || _thread_batch_recognize) {
+        return;
+    }
+    WhenListed(_right_btn_node, &ProTreeWidget::StartBatchRecognize);
+}
+
+void ProTreeWidget::StartBatchRecognize(NodeId node)
+{
+    if (!_model->IsValid(node) || _thread_batch_recognize) {
+        return;
+    }
+
+    // 已做过重复检测时，每组只识别代表图片
+    QVector<NodeId> nodes;
+    _model->CollectPics(node, nodes);
+    QStringList paths;
+    int skipped = 0;
+    for (NodeId pic : nodes) {
+        if (_model->IsDuplicate(pic)) {
+            skipped++;
+            continue;
+        }
+        paths << _model->Path(pic);
+    }
+    static Counter& skipped_pictures = BatchPictures("skipped_duplicate");
+    skipped_pictures.Inc(quint64(skipped));
+    if (paths.isEmpty()) {
+        QMessageBox::information(this, tr("批量识别"), tr("项目中没有图片"));
+        return;
+    }
+
+    // 进度对话框，取消时通知线程停止
+    _dlg_batch_progress = new QProgressDialog(tr("正在识别..."), tr("取消"), 0, paths.size(), this);
+    _dlg_batch_progress->setWindowTitle(tr("批量识别"));
+    _dlg_batch_progress->setFixedWidth(PROGRESS_WIDTH);
+    _dlg_batch_progress->setWindowModality(Qt::WindowModal);
+    _dlg_batch_progress->setMinimumDuration(0);
+
+    _thread_batch_recognize = new BatchRecognizeThread(paths, LABEL_PATH, MODEL_PATH, this);
+    _thread_batch_recognize->SetModelBundle(ModelRegistry::Instance().Current());
+
+    connect(_thread_batch_recognize, &BatchRecognizeThread::SigProgress, _dlg_batch_progress,
+            [this](int done, int total) {
+                if (_dlg_batch_progress) {
+                    _dlg_batch_progress->setValue(done);
+                    _dlg_batch_progress->setLabelText(tr("正在识别 %1 / %2").arg(done).arg(total));
+                }
+            });
+    connect(_thread_batch_recognize, &BatchRecognizeThread::SigItemFinish,
+            this, &ProTreeWidget::SlotRecognizeResult);
+    connect(_dlg_batch_progress, &QProgressDialog::canceled,
+            _thread_batch_recognize, &BatchRecognizeThread::Stop, Qt::DirectConnection);
+    connect(_thread_batch_recognize, &BatchRecognizeThread::SigBatchFinish,
+            this, &ProTreeWidget::SlotBatchFinish);
+    connect(_thread_batch_recognize, &BatchRecognizeThread::SigBatchFail, this, [this](const QString &msg) {
+        SlotBatchFinish(0, 0);
+        QMessageBox::warning(this, tr("批量识别"), tr("批量识别失败：%1").arg(msg));
+    });
+
+    _thread_batch_recognize->start();
+}
+
+void ProTreeWidget::SlotBatchFinish(int succeeded, int failed)
+{
+    if (_dlg_batch_progress) {
+        _dlg_batch_progress->close();
+        _dlg_batch_progress->deleteLater();
+        _dlg_batch_progress = nullptr;
+    }
+    if (_thread_batch_recognize) {
+        _thread_batch_recognize->wait();
+        _thread_batch_recognize->deleteLater();
+        _thread_batch_recognize = nullptr;
+    }
+    static Counter& succeeded_pictures = BatchPictures("succeeded");
+    static Counter& failed_pictures = BatchPictures("failed");
+    succeeded_pictures.Inc(quint64(succeeded));
+    failed_pictures.Inc(quint64(failed));
+
+    // 识别期间新增的图片
+    StartAutoRecognize();
+}
+
+void ProTreeWidget::StartAutoRecognize()
+{
+    if (_thread_batch_recognize || _auto_queue.isEmpty()) {
+        return;
+    }
+
+    // 不弹出进度对话框，结果同样写入缓存与相似检索索引
+    _thread_batch_recognize = new BatchRecognizeThread(_auto_queue, LABEL_PATH, MODEL_PATH, this);
+    _thread_batch_recognize->SetModelBundle(ModelRegistry::Instance().Current());
+    _auto_queue.clear();
+    connect(_thread_batch_recognize, &BatchRecognizeThread::SigItemFinish,
+            this, &ProTreeWidget::SlotRecognizeResult);
+    connect(_thread_batch_recognize, &BatchRecognizeThread::SigBatchFinish,
+            this, &ProTreeWidget::SlotBatchFinish);
+    connect(_thread_batch_recognize, &BatchRecognizeThread::SigBatchFail, this, [this](const QString &msg) {
+        qWarning() << "[ProTreeWidget] auto recognize failed:" << msg;
+        SlotBatchFinish(0, 0);
+    });
+    _thread_batch_recognize->start();
+}
+
+void ProTreeWidget::SlotDirsChanged(const QStringList &dirs)
+{
+    bool changed = false;
+    QVector<NodeId> added;
+    for (const QString& dir : dirs) {
+        // 已删除的目录由其父目录的变化一并处理
+        const NodeId node = _model->FindPath(dir);
+        if (node == ProTreeModel::INVALID_NODE || !QDir(dir).exists()) {
+            continue;
+        }
+        const QVector<ScanEntry> entries = _model->Filter(_model->Root(node)).List(dir);
+        changed |= _model->SyncChildren(node, entries, &added);
+    }
+    if (!changed) {
+        return;
+    }
+
+    // 正在浏览的图片被删除或改名
+    if (_selected_node != ProTreeModel::INVALID_NODE && !_model->IsValid(_selected_node)) {
+        _selected_node = ProTreeModel::INVALID_NODE;
+        emit SigClearSelected();
+        emit SigUpdataPic("");
+    }
+    EmitPosition();
+    _thumb_timer->start();
+
+    if (_action_auto_recognize->isChecked() && !added.isEmpty()) {
+        for (NodeId node : added) {
+            _auto_queue << _model->Path(node);
+        }
+        StartAutoRecognize();
+    }
+}
+
+void ProTreeWidget::SlotFindDuplicates()
+{
+    if (!_model->IsValid(_right_btn_node) || _thread_pic_hash) {
+        return;
+    }
+    WhenListed(_right_btn_node, &ProTreeWidget::StartFindDuplicates);
+}
+
+void ProTreeWidget::StartFindDuplicates(NodeId node)
+{
+    if (!_model->IsValid(node) || _thread_pic_hash) {
+        return;
+    }
+
+    _hash_nodes.clear();
+    _model->CollectPics(node, _hash_nodes);
+    if (_hash_nodes.isEmpty()) {
+        QMessageBox::information(this, tr("查找重复图片"), tr("项目中没有图片"));
+        return;
+    }
+
+    QStringList paths;
+    for (NodeId pic : _hash_nodes) {
+        paths << _model->Path(pic);
+    }
+
+    _dlg_hash_progress = new QProgressDialog(tr("正在计算图片指纹..."), tr("取消"), 0, paths.size(), this);
+    _dlg_hash_progress->setWindowTitle(tr("查找重复图片"));
+    _dlg_hash_progress->setFixedWidth(PROGRESS_WIDTH);
+    _dlg_hash_progress->setWindowModality(Qt::WindowModal);
+    _dlg_hash_progress->setMinimumDuration(0);
+
+    _thread_pic_hash = new PicHashThread(paths, PerceptualHash::PHash, DUP_HAMMING_DISTANCE, this);
+    connect(_thread_pic_hash, &PicHashThread::SigProgress, _dlg_hash_progress, &QProgressDialog::setValue);
+    connect(_dlg_hash_progress, &QProgressDialog::canceled, _thread_pic_hash, &PicHashThread::Stop, Qt::DirectConnection);
+    connect(_thread_pic_hash, &PicHashThread::SigHashFinish, this, &ProTreeWidget::SlotHashFinish);
+    connect(_thread_pic_hash, &QThread::finished, this, [this]() {
+        if (_dlg_hash_progress) {
+            _dlg_hash_progress->close();
+            _dlg_hash_progress->deleteLater();
+            _dlg_hash_progress = nullptr;
+        }
+        _thread_pic_hash->deleteLater();
+        _thread_pic_hash = nullptr;
+        _hash_nodes.clear();
+    });
+
+    _thread_pic_hash->start();
+}
+
+void ProTreeWidget::SlotHashFinish(const QVector<quint64> &hashes, const QVector<bool> &valid,
+                                   const QVector<int> &representatives)
+{
+    if (hashes.size() != _hash_nodes.size()) {
+        return;
+    }
+
+    // 每张代表图片的重复项数量，有重复项的代表图片即为一组
+    QVector<int> members(representatives.size(), 0);
+    for (int i = 0; i < representatives.size(); ++i) {
+        if (representatives.at(i) != i) {
+            members[representatives.at(i)]++;
+        }
+    }
+
+    // 项目在计算期间被关闭时，节点已失效，模型会忽略这些调用
+    int groups = 0;
+    int duplicates = 0;
+    for (int i = 0; i < _hash_nodes.size(); ++i) {
+        const NodeId node = _hash_nodes.at(i);
+        if (valid.at(i)) {
+            _model->SetPicHash(node, hashes.at(i));
+        }
+
+        // 近似重复项由模型灰显，并在提示中给出代表图片
+        _model->SetDuplicateOf(node, _hash_nodes.at(representatives.at(i)));
+        if (_model->IsDuplicate(node)) {
+            duplicates++;
+        } else if (members.at(i) > 0) {
+            groups++;
+        }
+    }
+
+    QMessageBox::information(this, tr("查找重复图片"),
+                             tr("共 %1 张图片，发现 %2 组近似重复，共 %3 张重复图片。\n批量识别时每组只识别一张。")
+                                 .arg(_hash_nodes.size()).arg(groups).arg(duplicates));
+}
+
+void ProTreeWidget::SlotRequestThumbnails()
+{
+    // 之前的请求会被新请求替换，未返回的允许重新请求
+    _thumb_pending.clear();
+
+    QVector<ThumbnailLoader::Job> jobs;
+    const int bottom = viewport()->height();
+    for (QModelIndex index = indexAt(QPoint(0, 0)); index.isValid(); index = indexBelow(index)) {
+        if (visualRect(index).top() >= bottom) {
+            break;
+        }
+        const NodeId node = _model->Node(index);
+        if (_model->Type(node) != TreeItemPic || _model->IsThumbLoaded(node)) {
+            continue;
+        }
+        const QString path = _model->Path(node);
+        _thumb_pending.insert(path, node);
+        jobs.append({_model->Path(_model->Root(node)), path});
+    }
+
+    if (!jobs.isEmpty()) {
+        _thumb_loader->Request(jobs);
+    }
+}
+
+void ProTreeWidget::SlotThumbnailReady(const QString &path, const QImage &image)
+{
+    const NodeId node = _thumb_pending.take(path);
+    if (!_model->IsValid(node)) {
+        return; // 已滚出可见区或项目已关闭
+    }
+
+    // 无法解码的图片保留默认图标，不再重复请求
+    if (image.isNull()) {
+        _model->SetThumbnail(node, QIcon());
+        return;
+    }
+    _model->SetThumbnail(node, QIcon(QPixmap::fromImage(image)));
+    _thumb_loaded.append(node);
+
+    // 限制同时持有的缩略图数量，最早加载的恢复为默认图标
+    while (_thumb_loaded.size() > THUMB_MAX_LOADED) {
+        _model->ClearThumbnail(_thumb_loaded.takeFirst());
+    }
+}
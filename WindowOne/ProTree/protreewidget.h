@@ -1,23 +1,33 @@
 #ifndef PROTREEWIDGET_H
 #define PROTREEWIDGET_H
 
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QAction>
 #include <QProgressDialog>
-#include "opentreethread.h"
+#include <QSet>
+#include <QTimer>
+#include "protreemodel.h"
 #include "removeprodialog.h"
+#include "batchrecognizethread.h"
+#include "pichashthread.h"
+#include "thumbnailloader.h"
+#include "dirscanner.h"
+#include "projectwatcher.h"
+#include "picindex.h"
 
 class SlideShowDlg;
 
 /**
  * @brief The ProTreeWidget class
- *        用于管理和显示项目树结构的QTreeWidget扩展控件。
+ *        用于管理和显示项目树结构的QTreeView扩展控件，数据由 ProTreeModel 按需加载。
  *        支持导入、设为活动、关闭项目、幻灯片浏览等功能，并与后台线程和进度对话框交互。
  */
-class ProTreeWidget : public QTreeWidget
+class ProTreeWidget : public QTreeView
 {
     Q_OBJECT
 public:
+    typedef ProTreeModel::NodeId NodeId;
+
     /**
      * @brief 构造函数
      * @param parent 父控件
@@ -31,33 +41,165 @@ public:
      */
     void AddProTree(const QString & name, const QString & path);
 
+    /**
+     * @brief 查找图片所属的已打开项目
+     * @param path 图片路径
+     * @return 项目根目录，不属于任何已打开项目时为空
+     */
+    QString ProjectOf(const QString & path) const;
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+
 private:
-    QSet<QString> _set_path;                            ///< 已添加项目路径集合，用于去重
-    QTreeWidgetItem * _right_btn_item;                  ///< 右键菜单对应的树项
-    QTreeWidgetItem * _selected_item;                   ///< 当前选中的树项
+    /**
+     * @brief 在后台扫描项目目录，结果由 SlotApplyScan 成批写入模型
+     * @param root 项目根节点
+     */
+    void StartScan(NodeId root);
+
+    /**
+     * @brief 检查项目的目录是否已全部加载，有未加载的目录时启动后台扫描（不在界面线程读取目录）
+     * @param root 项目根节点
+     * @return 已全部加载且没有进行中的扫描
+     */
+    bool EnsureListed(NodeId root);
+
+    /**
+     * @brief 节点下的目录全部加载后执行批量操作；需要扫描时显示进度，扫描结束后再执行
+     * @param node 批量操作的节点
+     * @param action 批量操作
+     */
+    void WhenListed(NodeId node, void (ProTreeWidget::*action)(NodeId));
+
+    // 结束等待扫描（扫描结束或用户取消）
+    void CloseListingProgress();
+
+    // 批量识别节点下的全部图片（目录已全部加载）
+    void StartBatchRecognize(NodeId node);
+
+    // 对节点下的全部图片做重复检测（目录已全部加载）
+    void StartFindDuplicates(NodeId node);
+
+    /**
+     * @brief 取项目的图片索引，结构变化后先重建
+     * @param root 项目根节点
+     */
+    PicIndex & IndexOf(NodeId root);
+
+    // 取项目的图片索引，不存在时创建（不重建）
+    PicIndex & EnsureIndex(NodeId root);
+
+    /**
+     * @brief 发出当前图片在索引（或筛选视图）中的位置
+     */
+    void EmitPosition();
+
+    /**
+     * @brief 沿图片索引收集当前图片附近的图片路径并发出预取信号
+     * @param forward 是否正在向后浏览（浏览方向上的图片优先）
+     */
+    void EmitNeighbors(bool forward);
+
+    /**
+     * @brief 切换当前显示的图片节点
+     * @param node 新的节点
+     * @param forward 浏览方向
+     */
+    void ShowNode(NodeId node, bool forward);
+
+    /**
+     * @brief 在后台识别自动排队的新图片（已有批量识别在运行时，结束后再开始）
+     */
+    void StartAutoRecognize();
+
+    ProTreeModel * _model;                              ///< 项目树数据模型
+    NodeId _right_btn_node;                             ///< 右键菜单对应的节点
+    NodeId _selected_node;                              ///< 当前选中的节点
     QAction * _action_closepro;                         ///< 关闭项目动作
-    std::shared_ptr<OpenTreeThread> _thread_open_pro;   ///< 项目树打开线程
+    QAction * _action_batch_recognize;                  ///< 批量识别动作
+    BatchRecognizeThread * _thread_batch_recognize;     ///< 批量识别线程
+    QProgressDialog * _dlg_batch_progress;              ///< 批量识别进度对话框
+    QAction * _action_find_dup;                         ///< 查找重复图片动作
+    PicHashThread * _thread_pic_hash;                   ///< 感知哈希计算线程
+    QProgressDialog * _dlg_hash_progress;               ///< 重复检测进度对话框
+    QVector<NodeId> _hash_nodes;                        ///< 正在计算哈希的图片节点
+    ThumbnailLoader * _thumb_loader;                    ///< 缩略图后台加载器
+    QTimer * _thumb_timer;                              ///< 滚动停顿后再请求缩略图
+    QHash<QString, NodeId> _thumb_pending;              ///< 已请求、尚未返回的缩略图
+    QList<NodeId> _thumb_loaded;                        ///< 已显示缩略图的节点（按加载顺序）
+    QHash<NodeId, DirScanner*> _scanners;               ///< 正在后台扫描的项目（根节点 -> 扫描器）
+    QTimer * _scan_timer;                               ///< 定时把扫描结果成批写入模型
+    NodeId _listing_node;                               ///< 等待扫描结束后批量处理的节点
+    void (ProTreeWidget::*_listing_action)(NodeId);     ///< 扫描结束后执行的批量操作
+    QProgressDialog * _dlg_listing_progress;            ///< 等待扫描的进度对话框
+    ProjectWatcher * _watcher;                          ///< 已加载目录的变化监视
+    QAction * _action_auto_recognize;                   ///< 自动识别新增图片（可勾选）
+    QStringList _auto_queue;                            ///< 等待自动识别的新图片
+    QHash<NodeId, PicIndex> _indexes;                   ///< 项目根节点 -> 图片索引
+    QSet<NodeId> _index_dirty;                          ///< 结构已变化、需要重建索引的项目
+    PicIndex::Filter _pic_filter;                       ///< 浏览筛选条件（所有项目共用）
 
 private slots:
     /**
      * @brief 树项按下处理槽函数 (右键菜单)
-     * @param item 被按下的树项
-     * @param column 列号
+     * @param index 被按下的项
      */
-    void SlotItemPressed(QTreeWidgetItem * item, int column);
+    void SlotItemPressed(const QModelIndex & index);
 
     /**
      * @brief 树项双击处理槽函数
-     * @param doubleItem 被双击的树项
-     * @param col 列号
+     * @param index 被双击的项
      */
-    void SlotDoubleClickItem(QTreeWidgetItem *doubleItem, int col);
+    void SlotDoubleClickItem(const QModelIndex & index);
 
     /**
      * @brief 关闭项目槽函数
      */
     void SlotClosePro();
 
+    /**
+     * @brief 批量识别项目中的全部图片，结果写入缓存并建立相似检索索引
+     */
+    void SlotBatchRecognize();
+
+    /**
+     * @brief 批量识别结束（完成或取消）
+     */
+    void SlotBatchFinish(int succeeded, int failed);
+
+    /**
+     * @brief 对项目做感知哈希并标记近似重复图片
+     */
+    void SlotFindDuplicates();
+
+    /**
+     * @brief 感知哈希计算完成，写回树节点并标记重复项
+     */
+    void SlotHashFinish(const QVector<quint64>& hashes, const QVector<bool>& valid,
+                        const QVector<int>& representatives);
+
+    /**
+     * @brief 为当前可见的图片行请求缩略图
+     */
+    void SlotRequestThumbnails();
+
+    /**
+     * @brief 缩略图加载完成，设置为节点图标
+     */
+    void SlotThumbnailReady(const QString& path, const QImage& image);
+
+    /**
+     * @brief 取出后台扫描结果写入模型，扫描结束的项目释放扫描器
+     */
+    void SlotApplyScan();
+
+    /**
+     * @brief 目录内容变化，增量更新对应的树节点
+     * @param dirs 变化的目录
+     */
+    void SlotDirsChanged(const QStringList& dirs);
+
 public slots:
     /**
      * @brief 打开项目槽函数
@@ -73,6 +215,24 @@ public slots:
     // 上一张槽函数
     void SlotPreShow();
 
+    /**
+     * @brief 跳转到索引（或筛选视图）中的第 pos 张
+     * @param pos 序号，从 1 开始
+     */
+    void SlotJumpTo(int pos);
+
+    /**
+     * @brief 设置浏览筛选条件，上一张/下一张只在满足条件的图片间切换
+     * @param className 类别，为空表示不限
+     * @param maxConfidence 置信度上限，1 表示不限
+     */
+    void SlotSetFilter(const QString& className, float maxConfidence);
+
+    /**
+     * @brief 记录一张图片的识别结果（批量识别或单张识别）
+     */
+    void SlotRecognizeResult(const QString& path, const QString& className, float confidence);
+
 signals:
 
     /**
@@ -87,6 +247,19 @@ signals:
      */
     void SigUpdataPic(const QString& );
 
+    /**
+     * @brief 当前图片附近的图片路径（按预取优先级排列）
+     */
+    void SigUpdataNeighbors(const QStringList& );
+
+    /**
+     * @brief 当前图片的位置
+     * @param pos 在索引（或筛选视图）中的序号，从 1 开始；不在视图中为 0
+     * @param size 视图中的图片数量
+     * @param total 项目中的图片数量
+     */
+    void SigUpdataPosition(int pos, int size, int total);
+
     /**
      * @brief 清除选中信号
      */
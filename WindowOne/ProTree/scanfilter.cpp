@@ -0,0 +1,102 @@
+#include "scanfilter.h"
+#include "const.h"
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <cstring>
+
+ScanFilter::ScanFilter(const QString &projectPath)
+{
+    QStringList patterns = SCAN_EXCLUDE_PATTERNS;
+
+    // 项目自定义的排除规则，空行和 # 开头的注释忽略
+    QFile ignore_file(QDir(projectPath).filePath(".scanignore"));
+    if (ignore_file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream in(&ignore_file);
+        while (!in.atEnd()) {
+            const QString line = in.readLine().trimmed();
+            if (!line.isEmpty() && !line.startsWith('#')) {
+                patterns << line;
+            }
+        }
+    }
+
+    for (const QString& pattern : patterns) {
+        _excludes.append(QRegularExpression(QRegularExpression::wildcardToRegularExpression(pattern),
+                                            QRegularExpression::CaseInsensitiveOption));
+    }
+}
+
+bool ScanFilter::Excluded(const QString &name) const
+{
+    for (const QRegularExpression& re : _excludes) {
+        if (re.match(name).hasMatch()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ScanFilter::IsImageName(const QString &name)
+{
+    const int dot = name.lastIndexOf('.');
+    if (dot < 0) {
+        return false;
+    }
+    const QString suffix = name.mid(dot + 1).toLower();
+    for (const char* image_suffix : IMAGE_SUFFIXES) {
+        if (suffix == QLatin1String(image_suffix)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ScanFilter::SniffImage(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    uchar head[12] = {0};
+    if (file.read(reinterpret_cast<char*>(head), sizeof(head)) < 4) {
+        return false;
+    }
+
+    return (head[0] == 0xFF && head[1] == 0xD8 && head[2] == 0xFF)                 // JPEG
+        || std::memcmp(head, "\x89PNG", 4) == 0                                    // PNG
+        || std::memcmp(head, "GIF8", 4) == 0                                       // GIF
+        || (head[0] == 'B' && head[1] == 'M')                                      // BMP
+        || std::memcmp(head, "II*\0", 4) == 0 || std::memcmp(head, "MM\0*", 4) == 0 // TIFF
+        || (std::memcmp(head, "RIFF", 4) == 0 && std::memcmp(head + 8, "WEBP", 4) == 0); // WebP
+}
+
+QVector<ScanEntry> ScanFilter::List(const QString &dirPath) const
+{
+    // 只取名称，不构造 QFileInfo；目录与文件分别列出后统一排序
+    const QDir dir(dirPath);
+    const QStringList dirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Unsorted);
+    const QStringList files = dir.entryList(QDir::Files, QDir::Unsorted);
+
+    QVector<ScanEntry> entries;
+    entries.reserve(dirs.size() + files.size());
+    for (const QString& name : dirs) {
+        if (!Excluded(name)) {
+            entries.append({name, true});
+        }
+    }
+    for (const QString& name : files) {
+        if (Excluded(name)) {
+            continue;
+        }
+        if (!IsImageName(name) && (name.contains('.') || !SniffImage(dir.filePath(name)))) {
+            continue;
+        }
+        entries.append({name, false});
+    }
+    std::sort(entries.begin(), entries.end(), [](const ScanEntry& a, const ScanEntry& b) {
+        return a.name < b.name;
+    });
+    return entries;
+}
@@ -0,0 +1,53 @@
+#ifndef SCANFILTER_H
+#define SCANFILTER_H
+
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// 目录中的一项（已过滤、按名称排序）
+struct ScanEntry
+{
+    QString name;   // 文件或目录名
+    bool dir;       // 是否为目录
+};
+
+/**
+ * @brief 项目扫描过滤规则
+ * 目录：未命中排除规则即保留。
+ * 文件：扩展名是常见图片格式即保留；没有扩展名时读取文件头的魔数判断；其余扩展名一律跳过，
+ * 因此 thumbs.db、.xmp 等附属文件不会出现在项目树中。
+ * 排除规则为通配符，默认规则见 SCAN_EXCLUDE_PATTERNS，项目根目录下 .scanignore 文件中的每一行追加一条规则。
+ */
+class ScanFilter
+{
+public:
+    ScanFilter() = default;
+
+    /**
+     * @brief 按项目生成过滤规则
+     * @param projectPath 项目根目录（读取其中的 .scanignore）
+     */
+    explicit ScanFilter(const QString& projectPath);
+
+    // 名称是否命中排除规则
+    bool Excluded(const QString& name) const;
+
+    // 扩展名是否为支持的图片格式
+    static bool IsImageName(const QString& name);
+
+    // 根据文件头魔数判断是否为图片
+    static bool SniffImage(const QString& path);
+
+    /**
+     * @brief 列出目录中通过过滤的条目，目录与文件按名称统一排序（QString 比较）
+     * @param dirPath 目录路径
+     */
+    QVector<ScanEntry> List(const QString& dirPath) const;
+
+private:
+    QVector<QRegularExpression> _excludes;  // 排除规则
+};
+
+#endif // SCANFILTER_H
@@ -0,0 +1,62 @@
+#include "segmentpool.h"
+#include <QHash>
+
+SegmentPool::SegmentPool()
+{
+    _offsets.push_back(0);
+    _table.assign(1024, 0);
+}
+
+quint32 SegmentPool::Intern(QStringView segment)
+{
+    // 装载因子超过 0.5 时扩容
+    if ((_offsets.size() + 1) * 2 > _table.size()) {
+        Rehash(_table.size() * 2);
+    }
+
+    const size_t mask = _table.size() - 1;
+    for (size_t i = qHash(segment) & mask; ; i = (i + 1) & mask) {
+        const quint32 slot = _table[i];
+        if (slot == 0) {
+            const quint32 id = quint32(_offsets.size() - 1);
+            _chars.append(segment.data(), segment.size());
+            _offsets.push_back(quint32(_chars.size()));
+            _table[i] = id + 1;
+            return id;
+        }
+        if (View(slot - 1) == segment) {
+            return slot - 1;
+        }
+    }
+}
+
+QString SegmentPool::Get(quint32 id) const
+{
+    return View(id).toString();
+}
+
+QStringView SegmentPool::View(quint32 id) const
+{
+    return QStringView(_chars.constData() + _offsets[id], qsizetype(_offsets[id + 1] - _offsets[id]));
+}
+
+size_t SegmentPool::MemoryBytes() const
+{
+    return size_t(_chars.capacity()) * sizeof(QChar)
+           + _offsets.capacity() * sizeof(quint32)
+           + _table.capacity() * sizeof(quint32);
+}
+
+void SegmentPool::Rehash(size_t capacity)
+{
+    std::vector<quint32> table(capacity, 0);
+    const size_t mask = capacity - 1;
+    for (quint32 id = 0; id + 1 < _offsets.size(); ++id) {
+        size_t i = qHash(View(id)) & mask;
+        while (table[i] != 0) {
+            i = (i + 1) & mask;
+        }
+        table[i] = id + 1;
+    }
+    _table.swap(table);
+}
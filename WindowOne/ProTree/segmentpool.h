@@ -0,0 +1,41 @@
+#ifndef SEGMENTPOOL_H
+#define SEGMENTPOOL_H
+
+#include <QString>
+#include <QStringView>
+#include <vector>
+
+/**
+ * @brief 路径片段字符串池
+ * 每个不同的文件名/目录名只保存一份，所有字符连续存放在同一块缓冲区中，
+ * 节点里只记录 32 位编号，避免每个节点各自持有 QString。
+ */
+class SegmentPool
+{
+public:
+    SegmentPool();
+
+    // 返回片段的编号，不存在时加入池中
+    quint32 Intern(QStringView segment);
+
+    // 按编号取出片段（拷贝）
+    QString Get(quint32 id) const;
+
+    // 按编号取出片段视图，下一次 Intern 之后失效
+    QStringView View(quint32 id) const;
+
+    int Count() const { return int(_offsets.size()) - 1; }
+
+    // 占用的内存字节数（估算）
+    size_t MemoryBytes() const;
+
+private:
+    void Rehash(size_t capacity);
+
+private:
+    QString _chars;                 // 所有片段的字符
+    std::vector<quint32> _offsets;  // 片段 i 占用 [_offsets[i], _offsets[i + 1])
+    std::vector<quint32> _table;    // 开放寻址表，存放 编号 + 1，0 表示空槽
+};
+
+#endif // SEGMENTPOOL_H
@@ -0,0 +1,134 @@
+#include "thumbnailloader.h"
+#include "const.h"
+#include <QBuffer>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace {
+// 项目 -> 缩略图存储，由所有加载器共用，同一个存储文件只打开一次
+QMutex g_stores_mutex;
+QHash<QString, std::shared_ptr<ThumbnailStore>> g_stores;
+}
+
+ThumbnailLoader::ThumbnailLoader(QObject *parent)
+    : QObject(parent)
+{
+    // 解码以 IO 为主，留一半核心给界面和识别线程
+    _pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+}
+
+ThumbnailLoader::~ThumbnailLoader()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _queue.clear();
+    }
+    _pool.waitForDone();
+}
+
+void ThumbnailLoader::Request(const QVector<Job> &jobs)
+{
+    QMutexLocker locker(&_mutex);
+
+    // 倒序存放，工作线程从末尾取，保证最上面的可见行最先出图
+    _queue = jobs;
+    std::reverse(_queue.begin(), _queue.end());
+
+    while (_workers < _pool.maxThreadCount() && _workers < _queue.size()) {
+        _workers++;
+        _pool.start([this]() { Work(); });
+    }
+}
+
+void ThumbnailLoader::CloseProject(const QString &projectPath)
+{
+    QMutexLocker locker(&_mutex);
+    _queue.erase(std::remove_if(_queue.begin(), _queue.end(),
+                                [&](const Job& job) { return job.projectPath == projectPath; }),
+                 _queue.end());
+    locker.unlock();
+
+    // 正在使用的工作线程持有 shared_ptr，用完后存储自动关闭
+    QMutexLocker stores_locker(&g_stores_mutex);
+    g_stores.remove(projectPath);
+}
+
+void ThumbnailLoader::Work()
+{
+    for (;;) {
+        Job job;
+        {
+            QMutexLocker locker(&_mutex);
+            if (_queue.isEmpty()) {
+                _workers--;
+                return;
+            }
+            job = _queue.takeLast();
+        }
+        emit SigThumbnailReady(job.path, Load(job));
+    }
+}
+
+QImage ThumbnailLoader::Load(const Job &job)
+{
+    const QFileInfo info(job.path);
+    if (!info.isFile()) {
+        return QImage();
+    }
+
+    std::shared_ptr<ThumbnailStore> store = Store(job.projectPath);
+    const quint64 key = ThumbnailStore::MakeKey(info);
+
+    QByteArray encoded;
+    if (store && store->Lookup(key, encoded)) {
+        QImage image = QImage::fromData(encoded);
+        if (!image.isNull()) {
+            return image;
+        }
+    }
+
+    // 降分辨率解码：JPEG 在 DCT 阶段按比例缩小，不会生成全尺寸像素
+    QImageReader reader(job.path);
+    reader.setAutoTransform(true);
+    const QSize size = reader.size();
+    if (size.isValid()) {
+        reader.setScaledSize(size.scaled(THUMB_SIZE, THUMB_SIZE, Qt::KeepAspectRatio));
+    }
+    QImage image = reader.read();
+    if (image.isNull()) {
+        return image;
+    }
+    if (image.width() > THUMB_SIZE || image.height() > THUMB_SIZE) {
+        // 不支持按比例解码的格式在这里统一缩放
+        image = image.scaled(THUMB_SIZE, THUMB_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    if (store) {
+        QBuffer buffer(&encoded);
+        buffer.open(QIODevice::WriteOnly);
+        encoded.clear();
+        // 带透明通道的图片用 PNG 保存，其余用 JPEG
+        if (image.hasAlphaChannel()) {
+            image.save(&buffer, "PNG");
+        } else {
+            image.save(&buffer, "JPG", 85);
+        }
+        store->Insert(key, encoded);
+    }
+    return image;
+}
+
+std::shared_ptr<ThumbnailStore> ThumbnailLoader::Store(const QString &projectPath)
+{
+    if (projectPath.isEmpty()) {
+        return nullptr;
+    }
+    QMutexLocker locker(&g_stores_mutex);
+    auto it = g_stores.find(projectPath);
+    if (it == g_stores.end()) {
+        it = g_stores.insert(projectPath, std::make_shared<ThumbnailStore>(projectPath));
+    }
+    return it.value();
+}
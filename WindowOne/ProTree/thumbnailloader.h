@@ -0,0 +1,61 @@
+#ifndef THUMBNAILLOADER_H
+#define THUMBNAILLOADER_H
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+#include <QVector>
+#include <memory>
+#include "thumbnailstore.h"
+
+/**
+ * @brief 缩略图后台加载器
+ * 优先从项目的缩略图存储中读取，未命中时用降分辨率解码生成并写回存储。
+ * 每次请求都会替换尚未开始的旧请求，只处理当前可见的行，滚动时不会积压任务。
+ */
+class ThumbnailLoader : public QObject
+{
+    Q_OBJECT
+public:
+    // 一次加载任务
+    struct Job
+    {
+        QString projectPath;   // 所属项目根目录，为空时不读写缩略图存储
+        QString path;          // 图片路径
+    };
+
+    explicit ThumbnailLoader(QObject *parent = nullptr);
+    ~ThumbnailLoader();
+
+    /**
+     * @brief 提交一批需要缩略图的图片（按显示顺序），丢弃之前未开始的任务
+     * @param jobs 任务列表
+     */
+    void Request(const QVector<Job>& jobs);
+
+    // 关闭项目：丢弃该项目的排队任务并释放其缩略图存储（所有加载器共用）
+    void CloseProject(const QString& projectPath);
+
+private:
+    void Work();                         // 工作线程循环：取任务直到队列为空
+    QImage Load(const Job& job);         // 读取或生成一张缩略图
+    std::shared_ptr<ThumbnailStore> Store(const QString& projectPath);
+
+private:
+    QThreadPool _pool;
+    QMutex _mutex;                       // 保护以下成员
+    QVector<Job> _queue;                 // 待处理任务（末尾最先处理）
+    int _workers = 0;                    // 正在运行的工作线程数
+
+signals:
+    /**
+     * @brief 缩略图就绪（在工作线程中发出，连接到界面时自动排队）
+     * @param path 图片路径
+     * @param image 缩略图，无法解码时为空
+     */
+    void SigThumbnailReady(const QString& path, const QImage& image);
+};
+
+#endif // THUMBNAILLOADER_H
@@ -0,0 +1,417 @@
+#include "thumbnailstore.h"
+#include "contenthash.h"
+#include "const.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char STORE_MAGIC[4] = {'C', 'V', 'T', 'S'};
+const quint32 STORE_VERSION = 2;
+const quint64 INIT_CAPACITY = 1024;             // 初始索引槽位数（必须是 2 的幂）
+const quint64 INIT_DATA_CAPACITY = 4 << 20;     // 初始数据区大小 4 MB
+
+// 文件头（64 字节）
+struct StoreHeader
+{
+    char magic[4];
+    quint32 version;
+    quint64 capacity;       // 索引槽位数
+    quint64 count;          // 已使用槽位数
+    quint64 dataSize;       // 数据区已使用字节数
+    quint64 dataCapacity;   // 数据区总字节数
+    quint32 opens;          // 打开次数（记录的使用序号）
+    quint8 reserved[20];
+};
+
+// 索引记录（24 字节），key 为 0 表示空槽
+struct StoreRecord
+{
+    quint64 key;
+    quint64 offset;   // 相对数据区起点的偏移
+    quint32 length;   // 编码数据长度
+    quint32 lastUse;  // 最近一次读写时的打开序号
+};
+
+static_assert(sizeof(StoreHeader) == 64, "StoreHeader must be 64 bytes");
+static_assert(sizeof(StoreRecord) == 24, "StoreRecord must be 24 bytes");
+
+inline StoreHeader* Header(uchar* map) { return reinterpret_cast<StoreHeader*>(map); }
+inline StoreRecord* Records(uchar* map) { return reinterpret_cast<StoreRecord*>(map + sizeof(StoreHeader)); }
+inline uchar* Data(uchar* map)
+{
+    return map + sizeof(StoreHeader) + Header(map)->capacity * sizeof(StoreRecord);
+}
+inline qint64 FileSize(quint64 capacity, quint64 dataCapacity)
+{
+    return qint64(sizeof(StoreHeader) + capacity * sizeof(StoreRecord) + dataCapacity);
+}
+
+// 记录的数据是否完整位于数据区已使用部分之内（不会溢出）
+inline bool InRange(const StoreRecord& rec, quint64 dataSize)
+{
+    return rec.offset <= dataSize && rec.length <= dataSize - rec.offset;
+}
+
+// 把映射与文件内容写到磁盘，替换文件前调用，避免断电后留下只有文件名的空文件
+bool SyncFile(QFile& file, uchar* map, qint64 size)
+{
+#ifdef _WIN32
+    if (map && !FlushViewOfFile(map, size_t(size))) {
+        return false;
+    }
+    return _commit(file.handle()) == 0;
+#else
+    Q_UNUSED(map);
+    Q_UNUSED(size);
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+const quint64 MAX_DATA_CAPACITY = quint64(THUMB_STORE_MAX_MB) << 20;
+
+} // namespace
+
+ThumbnailStore::ThumbnailStore(const QString &projectPath)
+    : _path(StorePath(projectPath))
+{
+    QMutexLocker locker(&_mutex);
+    if (!Open()) {
+        qWarning() << "[ThumbnailStore] Cannot open store:" << _path;
+    }
+}
+
+ThumbnailStore::~ThumbnailStore()
+{
+    QMutexLocker locker(&_mutex);
+    Close();
+}
+
+QString ThumbnailStore::StorePath(const QString &projectPath)
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (dir.isEmpty()) {
+        dir = QDir::tempPath();
+    }
+    dir += "/thumbnails";
+    QDir().mkpath(dir);
+
+    // 以项目绝对路径的哈希命名，避免在用户的图片目录中写入文件
+    const QByteArray key = QDir(projectPath).absolutePath().toUtf8();
+    return dir + "/" + QString::number(ContentHash::Hash64(key), 16) + ".thumbs";
+}
+
+quint64 ThumbnailStore::MakeKey(const QFileInfo &info)
+{
+    quint64 key = ContentHash::Hash64(info.absoluteFilePath().toUtf8());
+    key = ContentHash::Combine(key, static_cast<quint64>(info.lastModified().toMSecsSinceEpoch()));
+    key = ContentHash::Combine(key, static_cast<quint64>(info.size()));
+    return key ? key : 1; // 0 保留为空槽标记
+}
+
+bool ThumbnailStore::Lookup(quint64 key, QByteArray &out)
+{
+    QMutexLocker locker(&_mutex);
+    if (!_map) {
+        return false;
+    }
+
+    StoreHeader* header = Header(_map);
+    const quint64 mask = header->capacity - 1;
+    StoreRecord* records = Records(_map);
+
+    // 线性探测；文件被改写时表可能没有空槽，最多探测 capacity 次
+    for (quint64 n = 0, i = key & mask; n < header->capacity; ++n, i = (i + 1) & mask) {
+        StoreRecord& rec = records[i];
+        if (rec.key == 0) {
+            return false;
+        }
+        if (rec.key == key) {
+            // 文件被其他进程截断或改写时记录可能越界，按未命中处理
+            if (!InRange(rec, header->dataSize)) {
+                return false;
+            }
+            rec.lastUse = header->opens;
+            out = QByteArray(reinterpret_cast<const char*>(Data(_map) + rec.offset), int(rec.length));
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThumbnailStore::Insert(quint64 key, const QByteArray &data)
+{
+    QMutexLocker locker(&_mutex);
+    if (!_map || data.isEmpty()) {
+        return;
+    }
+
+    // 装载因子超过 0.7 时重建索引表（同时压缩数据区）
+    if ((Header(_map)->count + 1) * 10 > Header(_map)->capacity * 7 && !Compact()) {
+        return;
+    }
+    if (Header(_map)->dataSize + quint64(data.size()) > Header(_map)->dataCapacity) {
+        // 数据区到达上限后先压缩（淘汰过期与最久未用的缩略图），不再扩大
+        const bool full = Header(_map)->dataCapacity >= MAX_DATA_CAPACITY;
+        if (full ? !Compact() : !GrowData(quint64(data.size()))) {
+            return;
+        }
+        if (Header(_map)->dataSize + quint64(data.size()) > Header(_map)->dataCapacity) {
+            return;
+        }
+    }
+
+    StoreHeader* header = Header(_map);
+    std::memcpy(Data(_map) + header->dataSize, data.constData(), size_t(data.size()));
+
+    const quint64 mask = header->capacity - 1;
+    StoreRecord* records = Records(_map);
+    for (quint64 n = 0, i = key & mask; n < header->capacity; ++n, i = (i + 1) & mask) {
+        StoreRecord& rec = records[i];
+        if (rec.key == 0 || rec.key == key) {
+            if (rec.key == 0) {
+                header->count++;
+            }
+            // 覆盖时旧数据成为空洞，扩容索引表时被压缩掉
+            rec.key = key;
+            rec.offset = header->dataSize;
+            rec.length = quint32(data.size());
+            rec.lastUse = header->opens;
+            header->dataSize += quint64(data.size());
+            return;
+        }
+    }
+    // 没有空槽（count 与实际不符）：数据不计入，下次写入时覆盖
+}
+
+int ThumbnailStore::Count()
+{
+    QMutexLocker locker(&_mutex);
+    return _map ? int(Header(_map)->count) : 0;
+}
+
+bool ThumbnailStore::Open()
+{
+    _file.setFileName(_path);
+    bool valid = false;
+
+    if (_file.exists() && _file.open(QIODevice::ReadWrite)) {
+        StoreHeader header;
+        if (_file.read(reinterpret_cast<char*>(&header), sizeof(header)) == sizeof(header)
+            && std::memcmp(header.magic, STORE_MAGIC, 4) == 0
+            && header.version == STORE_VERSION
+            && header.capacity > 0 && (header.capacity & (header.capacity - 1)) == 0
+            && header.count < header.capacity
+            && header.dataSize <= header.dataCapacity
+            && _file.size() == FileSize(header.capacity, header.dataCapacity)) {
+            valid = true;
+        }
+        if (!valid) {
+            _file.close();
+        }
+    }
+
+    if (valid) {
+        _map = _file.map(0, _file.size());
+        // 有越界记录说明文件已损坏，整个重建
+        if (!_map || !ValidRecords()) {
+            Close();
+            valid = false;
+        }
+    }
+
+    if (!valid) {
+        // 文件不存在或已损坏：重建
+        if (!Create(_path, INIT_CAPACITY, INIT_DATA_CAPACITY)) {
+            return false;
+        }
+        _file.setFileName(_path);
+        if (!_file.open(QIODevice::ReadWrite)) {
+            return false;
+        }
+    }
+
+    if (!_map) {
+        _map = _file.map(0, _file.size());
+    }
+    if (!_map) {
+        _file.close();
+        return false;
+    }
+    Header(_map)->opens++;
+    return true;
+}
+
+bool ThumbnailStore::ValidRecords() const
+{
+    const StoreHeader* header = Header(_map);
+    const StoreRecord* records = Records(_map);
+    for (quint64 i = 0; i < header->capacity; ++i) {
+        if (records[i].key != 0 && !InRange(records[i], header->dataSize)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ThumbnailStore::Create(const QString &path, quint64 capacity, quint64 dataCapacity)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    StoreHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, STORE_MAGIC, 4);
+    header.version = STORE_VERSION;
+    header.capacity = capacity;
+    header.dataCapacity = dataCapacity;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // 索引区全部置零（key = 0 即空槽）
+    return file.resize(FileSize(capacity, dataCapacity));
+}
+
+void ThumbnailStore::Close()
+{
+    if (_map) {
+        _file.unmap(_map);
+        _map = nullptr;
+    }
+    if (_file.isOpen()) {
+        _file.close();
+    }
+}
+
+bool ThumbnailStore::Compact()
+{
+    const StoreHeader old_header = *Header(_map);
+    const QString tmp_path = _path + ".tmp";
+    const StoreRecord* old_records = Records(_map);
+
+    // 按距今的打开次数统计数据量：超过 THUMB_STORE_STALE_OPENS 次未用的丢弃，
+    // 剩余数据仍超过上限的一半时，从最久未用的开始继续丢弃
+    std::vector<quint64> bytes_by_age(THUMB_STORE_STALE_OPENS + 1, 0);
+    for (quint64 i = 0; i < old_header.capacity; ++i) {
+        const StoreRecord& rec = old_records[i];
+        if (rec.key != 0) {
+            const quint32 age = old_header.opens - rec.lastUse;
+            if (age <= THUMB_STORE_STALE_OPENS) {
+                bytes_by_age[age] += rec.length;
+            }
+        }
+    }
+    quint32 max_age = 0;
+    quint64 live = bytes_by_age[0];
+    while (max_age < THUMB_STORE_STALE_OPENS && live + bytes_by_age[max_age + 1] <= MAX_DATA_CAPACITY / 2) {
+        max_age++;
+        live += bytes_by_age[max_age];
+    }
+    auto keep = [&](const StoreRecord& rec) {
+        return rec.key != 0 && old_header.opens - rec.lastUse <= max_age && InRange(rec, old_header.dataSize);
+    };
+
+    quint64 kept = 0;
+    for (quint64 i = 0; i < old_header.capacity; ++i) {
+        if (keep(old_records[i])) {
+            kept++;
+        }
+    }
+    // 重建后装载因子不超过 0.35，数据区留出同样多的余量
+    quint64 new_capacity = INIT_CAPACITY;
+    while ((kept + 1) * 20 > new_capacity * 7) {
+        new_capacity *= 2;
+    }
+    const quint64 data_capacity = qMin(qMax(INIT_DATA_CAPACITY, live * 2), qMax(MAX_DATA_CAPACITY, live));
+
+    if (!Create(tmp_path, new_capacity, data_capacity)) {
+        return false;
+    }
+    QFile tmp_file(tmp_path);
+    if (!tmp_file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+    uchar* tmp_map = tmp_file.map(0, tmp_file.size());
+    if (!tmp_map) {
+        return false;
+    }
+
+    // 重新散列并顺序拷贝数据，同时去掉被覆盖记录留下的空洞
+    const quint64 new_mask = new_capacity - 1;
+    StoreRecord* new_records = Records(tmp_map);
+    uchar* old_data = Data(_map);
+    uchar* new_data = Data(tmp_map);
+    quint64 count = 0;
+    quint64 data_size = 0;
+    for (quint64 i = 0; i < old_header.capacity; ++i) {
+        const StoreRecord& rec = old_records[i];
+        if (!keep(rec)) {
+            continue;
+        }
+        quint64 j = rec.key & new_mask;
+        while (new_records[j].key != 0) {
+            j = (j + 1) & new_mask;
+        }
+        std::memcpy(new_data + data_size, old_data + rec.offset, rec.length);
+        new_records[j] = rec;
+        new_records[j].offset = data_size;
+        data_size += rec.length;
+        count++;
+    }
+    Header(tmp_map)->count = count;
+    Header(tmp_map)->dataSize = data_size;
+    // Open 会再加一，抵消后打开序号不变
+    Header(tmp_map)->opens = old_header.opens - 1;
+
+    // 先落盘再替换，断电后要么是旧文件，要么是完整的新文件
+    const bool synced = SyncFile(tmp_file, tmp_map, tmp_file.size());
+    tmp_file.unmap(tmp_map);
+    tmp_file.close();
+    if (!synced) {
+        QFile::remove(tmp_path);
+        return false;
+    }
+
+    Close();
+    QFile::remove(_path);
+    QFile::rename(tmp_path, _path);
+    return Open();
+}
+
+bool ThumbnailStore::GrowData(quint64 needed)
+{
+    const StoreHeader header = *Header(_map);
+    quint64 data_capacity = header.dataCapacity * 2;
+    while (header.dataSize + needed > data_capacity) {
+        data_capacity *= 2;
+    }
+
+    // 数据区位于文件末尾，直接扩大文件后重新映射
+    _file.unmap(_map);
+    _map = nullptr;
+    if (!_file.resize(FileSize(header.capacity, data_capacity))) {
+        _map = _file.map(0, _file.size());
+        return false;
+    }
+    _map = _file.map(0, _file.size());
+    if (!_map) {
+        _file.close();
+        return false;
+    }
+    Header(_map)->dataCapacity = data_capacity;
+    return true;
+}
@@ -0,0 +1,62 @@
+#ifndef THUMBNAILSTORE_H
+#define THUMBNAILSTORE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @brief 项目缩略图存储
+ * 每个项目对应缓存目录下的一个文件，整个文件内存映射：
+ * 文件头之后是开放寻址的索引表（键 -> 数据偏移、长度），再之后是连续追加的缩略图编码数据。
+ * 键由图片路径、修改时间、文件大小共同生成，图片被修改后旧缩略图自然失效。
+ * 每条记录保存最近一次使用时的打开序号：压缩（索引表扩容或数据区达到 THUMB_STORE_MAX_MB）时
+ * 丢弃 THUMB_STORE_STALE_OPENS 次打开都没用到的记录，仍超过上限时再按最久未用淘汰。
+ * 偏移或长度越界的记录视为未命中。所有接口线程安全。
+ */
+class ThumbnailStore
+{
+public:
+    /**
+     * @brief 打开（必要时新建）项目的缩略图存储
+     * @param projectPath 项目根目录
+     */
+    explicit ThumbnailStore(const QString& projectPath);
+    ~ThumbnailStore();
+
+    ThumbnailStore(const ThumbnailStore&) = delete;
+    ThumbnailStore& operator=(const ThumbnailStore&) = delete;
+
+    // 项目对应的存储文件路径
+    static QString StorePath(const QString& projectPath);
+
+    // 根据 路径 + 修改时间 + 文件大小 生成键（不为 0）
+    static quint64 MakeKey(const QFileInfo& info);
+
+    // 查找缩略图编码数据（JPEG/PNG）
+    bool Lookup(quint64 key, QByteArray& out);
+
+    // 写入缩略图编码数据，键已存在时覆盖
+    void Insert(quint64 key, const QByteArray& data);
+
+    // 已保存的缩略图数量
+    int Count();
+
+private:
+    bool Open();
+    bool Create(const QString& path, quint64 capacity, quint64 dataCapacity);
+    void Close();
+    bool Compact();                     // 重建文件：去掉空洞与过期记录，按需调整索引表大小
+    bool GrowData(quint64 needed);      // 数据区空间不足时扩大文件
+    bool ValidRecords() const;          // 全部记录的数据范围是否在数据区内
+
+private:
+    QMutex _mutex;
+    QString _path;          // 存储文件路径
+    QFile _file;            // 存储文件
+    uchar* _map = nullptr;  // 文件映射地址
+};
+
+#endif // THUMBNAILSTORE_H
@@ -0,0 +1,92 @@
+#include "similarpanel.h"
+#include "embeddingindex.h"
+#include "thumbnailloader.h"
+#include "const.h"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QVBoxLayout>
+
+SimilarPanel::SimilarPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    _title = new QLabel(tr("相似图片"), this);
+    _list = new QListWidget(this);
+    _list->setViewMode(QListView::IconMode);
+    _list->setIconSize(QSize(THUMB_SIZE, THUMB_SIZE));
+    _list->setResizeMode(QListView::Adjust);
+    _list->setMovement(QListView::Static);
+    _list->setWordWrap(true);
+
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(_title);
+    layout->addWidget(_list);
+
+    connect(_list, &QListWidget::itemClicked, this, &SimilarPanel::SlotItemClicked);
+
+    _thumb_loader = new ThumbnailLoader(this);
+    connect(_thumb_loader, &ThumbnailLoader::SigThumbnailReady, this, &SimilarPanel::SlotThumbnailReady);
+}
+
+void SimilarPanel::SetProjectResolver(std::function<QString(const QString&)> resolver)
+{
+    _project_of = std::move(resolver);
+}
+
+void SimilarPanel::SlotQuery(const QString &path, quint64 modelId)
+{
+    _list->clear();
+    _thumb_pending.clear();
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<EmbeddingIndex::Hit> hits = EmbeddingIndex::ForModel(modelId).SearchByPath(path, SIMILAR_TOP_K);
+    const double query_ms = timer.nsecsElapsed() / 1e6;
+
+    if (hits.isEmpty()) {
+        _title->setText(tr("相似图片：暂无（需要带特征输出的模型并先完成识别）"));
+        return;
+    }
+    _title->setText(tr("相似图片（%1 张，检索 %2 ms）").arg(hits.size()).arg(query_ms, 0, 'f', 2));
+
+    // 先列出结果，缩略图在后台加载完成后再补上，不在界面线程解码
+    QVector<ThumbnailLoader::Job> jobs;
+    for (const EmbeddingIndex::Hit& hit : hits) {
+        auto* item = new QListWidgetItem(
+            QString("%1\n%2%").arg(QFileInfo(hit.path).fileName()).arg(hit.similarity * 100.0f, 0, 'f', 1));
+        item->setData(Qt::UserRole, hit.path);
+        item->setToolTip(hit.path);
+        _list->addItem(item);
+
+        _thumb_pending.insert(hit.path, item);
+        jobs.append({_project_of ? _project_of(hit.path) : QString(), hit.path});
+    }
+    _thumb_loader->Request(jobs);
+}
+
+void SimilarPanel::SlotClear()
+{
+    _list->clear();
+    _thumb_pending.clear();
+    _thumb_loader->Request({});
+    _title->setText(tr("相似图片"));
+}
+
+void SimilarPanel::SlotItemClicked(QListWidgetItem *item)
+{
+    if (item) {
+        emit SigSelectPath(item->data(Qt::UserRole).toString());
+    }
+}
+
+void SimilarPanel::SlotThumbnailReady(const QString &path, const QImage &image)
+{
+    // 列表已刷新时，旧查询的缩略图直接丢弃
+    QListWidgetItem* item = _thumb_pending.take(path);
+    if (item && !image.isNull()) {
+        item->setIcon(QIcon(QPixmap::fromImage(image)));
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef SIMILARPANEL_H
+#define SIMILARPANEL_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QListWidget>
+#include <QHash>
+#include <functional>
+
+class ThumbnailLoader;
+
+/**
+ * @brief 相似图片面板
+ * 识别完成后按特征向量在相似检索索引中查询 Top-K，以缩略图列表展示，
+ * 单击某一项时通知主窗口切换到该图片。缩略图由 ThumbnailLoader 在后台加载
+ */
+class SimilarPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit SimilarPanel(QWidget *parent = nullptr);
+
+    // 设置图片所属项目的查找函数，用于复用项目的缩略图存储
+    void SetProjectResolver(std::function<QString(const QString&)> resolver);
+
+public slots:
+    // 在 modelId 对应模型的索引中查询与 path 相似的图片并刷新列表
+    void SlotQuery(const QString& path, quint64 modelId);
+
+    // 清空列表
+    void SlotClear();
+
+private slots:
+    void SlotItemClicked(QListWidgetItem* item);
+    void SlotThumbnailReady(const QString& path, const QImage& image);
+
+private:
+    QLabel* _title;          // 标题（显示查询耗时）
+    QListWidget* _list;      // 结果列表
+    ThumbnailLoader* _thumb_loader;                      // 后台缩略图加载
+    QHash<QString, QListWidgetItem*> _thumb_pending;     // 等待缩略图的图片路径 -> 列表项
+    std::function<QString(const QString&)> _project_of; // 图片路径 -> 项目根目录
+
+signals:
+    // 用户选中某张相似图片
+    void SigSelectPath(const QString& path);
+};
+
+#endif // SIMILARPANEL_H
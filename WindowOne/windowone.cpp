@@ -40,11 +40,19 @@ WindowOne::WindowOne(QWidget *parent)
     ui->proLayout->addWidget(_protree);
 
     // 拿到项目树页面中的项目树窗口
-    QTreeWidget* tree_widget = dynamic_cast<ProTree*>(_protree)->GetTreeWidget();
+    QTreeView* tree_widget = dynamic_cast<ProTree*>(_protree)->GetTreeWidget();
     auto * pro_tree_widget = dynamic_cast<ProTreeWidget*>(tree_widget);
 
     connect(this, &WindowOne::SigOpenPro, pro_tree_widget, &ProTreeWidget::SlotOpenPro);
 
+    // 导航栏：显示当前位置、跳转、按识别结果筛选
+    _navbar = new PicNavBar();
+    ui->proLayout->addWidget(_navbar);
+    auto * pic_nav_bar = dynamic_cast<PicNavBar*>(_navbar);
+    connect(pro_tree_widget, &ProTreeWidget::SigUpdataPosition, pic_nav_bar, &PicNavBar::SlotUpdatePosition);
+    connect(pic_nav_bar, &PicNavBar::SigJumpTo, pro_tree_widget, &ProTreeWidget::SlotJumpTo);
+    connect(pic_nav_bar, &PicNavBar::SigFilterChanged, pro_tree_widget, &ProTreeWidget::SlotSetFilter);
+
     // 创建图片页面
     _picshow = new PicShow();
 
@@ -68,6 +76,9 @@ WindowOne::WindowOne(QWidget *parent)
     // 项目树控件中的图片更新时，通知图片页面刷新图片展示
     connect(pro_tree_widget, &ProTreeWidget::SigUpdataPic, pro_pic_show, &PicShow::SlotUpdatePic);
 
+    // 切换图片后预取前后的图片
+    connect(pro_tree_widget, &ProTreeWidget::SigUpdataNeighbors, pro_pic_show, &PicShow::SlotPrefetch);
+
     // 项目树控件需要清除选中项时，通知图片页面删除对应图片
     connect(pro_tree_widget, &ProTreeWidget::SigClearSelected, pro_pic_show, &PicShow::SlotDeleteItem);
 
@@ -85,6 +96,29 @@ WindowOne::WindowOne(QWidget *parent)
 
     // 清楚选中项时 图片路径置空
     connect(pro_tree_widget, &ProTreeWidget::SigClearSelected, pro_res_show, &PicDetection::SlotDeletePath);
+
+    // 相似图片面板，放在项目树下方
+    _similar = new SimilarPanel();
+    ui->proLayout->addWidget(_similar);
+    auto * similar_panel = dynamic_cast<SimilarPanel*>(_similar);
+
+    // 相似图片的缩略图复用所属项目的缩略图存储
+    similar_panel->SetProjectResolver([pro_tree_widget](const QString& path) {
+        return pro_tree_widget->ProjectOf(path);
+    });
+
+    // 单张识别结果同样计入图片索引，用于按类别浏览
+    connect(pro_res_show, &PicDetection::SigRecognizeResult, pro_tree_widget, &ProTreeWidget::SlotRecognizeResult);
+
+    // 识别完成后查询相似图片
+    connect(pro_res_show, &PicDetection::SigRecognizeDone, similar_panel, &SimilarPanel::SlotQuery);
+
+    // 点击相似图片时切换展示与识别路径
+    connect(similar_panel, &SimilarPanel::SigSelectPath, pro_pic_show, &PicShow::SlotUpdatePic);
+    connect(similar_panel, &SimilarPanel::SigSelectPath, pro_res_show, &PicDetection::SlotUpdatePicPath);
+
+    // 清除选中项时清空相似图片
+    connect(pro_tree_widget, &ProTreeWidget::SigClearSelected, similar_panel, &SimilarPanel::SlotClear);
 }
 
 WindowOne::~WindowOne()
@@ -6,11 +6,13 @@
 #include <QWidget>
 #include <QFileDialog>
 #include <QFile>
-#include <QTreeWidget>
+#include <QTreeView>
 #include "protree.h"
 #include "protreewidget.h"
 #include "picshow.h"
 #include "picdetection.h"
+#include "similarpanel.h"
+#include "picnavbar.h"
 
 namespace Ui { class WindowOne; }
 
@@ -37,6 +39,8 @@ private:
     QWidget * _protree;
     QWidget * _picshow;
     QWidget * _picdete;
+    QWidget * _similar;
+    QWidget * _navbar;
 };
 
 #endif // WINDOW_ONE_H
@@ -1,4 +1,7 @@
-#include "CameraThread.h"
+#include "camerathread.h"
+#include "tracer.h"
+#include "metrics.h"
+#include "const.h"
 
 /**
  * @brief CameraThread类的构造函数
@@ -40,6 +43,17 @@ bool CameraThread::getLastFrame(cv::Mat &outFrame)
     return true;
 }
 
+// 界面处理完一帧
+void CameraThread::frameConsumed()
+{
+    static Gauge& pending = Metrics::Instance().GetGauge("cv_camera_frames_pending", "Captured frames waiting for the UI thread.");
+    // run() 开始时计数清零，上一次运行仍在队列中的帧随后到达，不能减到负数（否则积压检查失效）
+    int queued = pendingFrames.load(std::memory_order_relaxed);
+    while (queued > 0 && !pendingFrames.compare_exchange_weak(queued, queued - 1, std::memory_order_relaxed)) {
+    }
+    pending.Set(qMax(0, queued - 1));
+}
+
 /**
  * @brief 线程主函数，当调用start()时执行
  *
@@ -52,15 +66,33 @@ void CameraThread::run()
     running = true;  // 设置运行标志为true，开始捕获循环
     cv::Mat frame;   // OpenCV的Mat对象，用于存储从相机捕获的帧
 
+    Metrics& metrics = Metrics::Instance();
+    Counter& captured = metrics.GetCounter("cv_frames_captured_total", "Frames read from the camera.");
+    Counter& captureFailed = metrics.GetCounter("cv_frames_dropped_total", "Frames dropped before recognition, by reason.", "reason=\"capture_failed\"");
+    Counter& uiBacklog = metrics.GetCounter("cv_frames_dropped_total", "Frames dropped before recognition, by reason.", "reason=\"ui_backlog\"");
+    Gauge& pending = metrics.GetGauge("cv_camera_frames_pending", "Captured frames waiting for the UI thread.");
+    Gauge& frameBytes = metrics.GetGauge("cv_pool_bytes", "Approximate bytes held by image pools and caches.", "pool=\"camera_frames\"");
+    pendingFrames.store(0, std::memory_order_relaxed);
+    pending.Set(0);
+
     // 主循环：当running为true且相机处于打开状态时持续执行
     while (running && cap.isOpened()) {
-        cap >> frame;  // 从相机捕获一帧到frame中（操作符重载，简化的grab和retrieve）
+        {
+            TRACE_SCOPE("camera.capture");
+            cap >> frame;  // 从相机捕获一帧到frame中（操作符重载，简化的grab和retrieve）
+        }
 
         // 如果捕获到的帧为空（可能由于读取错误或相机断开），跳过此次循环
-        if (frame.empty()) continue;
+        if (frame.empty()) {
+            captureFailed.Inc();
+            continue;
+        }
+        const qint64 captureNs = Tracer::NowNs();
+        captured.Inc();
 
         {
             // ✅ 保存最新帧（线程安全）
+            TRACE_SCOPE("camera.copy_last");
             QMutexLocker locker(&frameMutex);
             frame.copyTo(lastFrame);
         }
@@ -71,11 +103,25 @@ void CameraThread::run()
         // frame.rows: 图像高度（行数）
         // frame.step: 图像每行的字节数（步长）
         // QImage::Format_BGR888: 图像格式，对应OpenCV默认的BGR三通道8位格式
+        // 界面线程来不及处理时丢弃本帧，避免信号在事件队列中越积越多
+        if (pendingFrames.load(std::memory_order_relaxed) >= CAMERA_MAX_PENDING_FRAMES) {
+            uiBacklog.Inc();
+            msleep(30);
+            continue;
+        }
+
+        TRACE_BEGIN(convert, "camera.to_qimage");
         QImage image(frame.data, frame.cols, frame.rows, frame.step, QImage::Format_BGR888);
 
         // 发送帧准备好信号，传递图像的副本（确保图像数据在线程间传递时的安全性）
         // 使用copy()创建图像的深拷贝，防止原始数据被释放后出现问题
-        emit frameReady(image.copy());
+        QImage copy = image.copy();
+        TRACE_END(convert);
+        const int queued = pendingFrames.fetch_add(1, std::memory_order_relaxed) + 1;
+        pending.Set(queued);
+        // 排队中的 QImage 副本 + 采集缓冲 + 最近一帧
+        frameBytes.Set(queued * copy.sizeInBytes() + 2 * qint64(frame.total() * frame.elemSize()));
+        emit frameReady(copy, captureNs);
 
         msleep(30);  // 暂停30毫秒，约等于33FPS的帧率控制
     }
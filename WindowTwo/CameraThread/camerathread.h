@@ -6,6 +6,7 @@
 #include <QImage>         // Qt图像类，用于在UI线程中显示图像
 #include <QMutex>
 #include <QMutexLocker>
+#include <atomic>
 #include <opencv2/opencv.hpp>  // OpenCV库，用于相机捕获和图像处理
 
 /**
@@ -28,16 +29,18 @@ public:
     bool openCamera(int index = 0); // 打开指定索引的相机设备
 
     bool getLastFrame(cv::Mat &outFrame); // 获取最近一帧（线程安全）
+    void frameConsumed(); // 界面线程处理完一帧后调用，与 frameReady 配对，用于统计积压
 
 signals:
     /**
      * @brief 帧准备好的信号
      * @param image 捕获到的图像，已转换为QImage格式
+     * @param captureNs 捕获时刻（Tracer::NowNs），用于统计捕获到出结果的延迟
      *
      * 当成功从相机捕获一帧并转换为QImage后，通过此信号
      * 将图像发送给连接到此信号的槽函数（通常在主线程中更新UI）。
      */
-    void frameReady(const QImage &image);
+    void frameReady(const QImage &image, qint64 captureNs);
 
 private:
     cv::VideoCapture cap;  // OpenCV的视频捕获对象，用于从相机获取帧
@@ -45,6 +48,8 @@ private:
 
     cv::Mat lastFrame;   // 存储最近一帧的图像
     QMutex frameMutex;   // 用于保护lastFrame的线程安全
+
+    std::atomic<int> pendingFrames{0};  // 已发出、界面尚未处理的帧数
 };
 
 #endif // CAMERATHREAD_H
@@ -0,0 +1,85 @@
+#include "diagnosticspanel.h"
+#include "metrics.h"
+#include "const.h"
+#include <QDateTime>
+#include <QFontDatabase>
+#include <QVBoxLayout>
+
+DiagnosticsPanel::DiagnosticsPanel(QWidget *parent)
+    : QWidget(parent)
+    , _text(new QLabel(this))
+{
+    _text->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    _text->setTextFormat(Qt::RichText);
+    _text->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    _text->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(_text);
+
+    _timer.setInterval(DIAGNOSTICS_REFRESH_MS);
+    connect(&_timer, &QTimer::timeout, this, &DiagnosticsPanel::SlotRefresh);
+}
+
+void DiagnosticsPanel::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    SlotRefresh();
+    _timer.start();
+}
+
+void DiagnosticsPanel::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    _timer.stop();
+}
+
+void DiagnosticsPanel::SlotRefresh()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const double seconds = _last_ms > 0 ? (now - _last_ms) / 1000.0 : 0;
+    _last_ms = now;
+
+    auto ms = [](double micros) { return QString::number(micros / 1000.0, 'f', 1); };
+
+    QString html = "<table cellspacing='0' cellpadding='1'>";
+    for (const Metrics::Sample& sample : Metrics::Instance().Collect()) {
+        QString name = sample.name;
+        if (name.startsWith("cv_")) {
+            name.remove(0, 3);
+        }
+        if (!sample.labels.isEmpty()) {
+            name += QString("{%1}").arg(QString(sample.labels).remove('"'));
+        }
+
+        QString value;
+        switch (sample.type) {
+        case Metrics::TypeCounter: {
+            const QString key = sample.name + sample.labels;
+            value = QString::number(sample.value, 'f', 0);
+            if (seconds > 0 && _last.contains(key)) {
+                value += QString(" (%1/s)").arg((sample.value - _last.value(key)) / seconds, 0, 'f', 1);
+            }
+            _last.insert(key, sample.value);
+            break;
+        }
+        case Metrics::TypeGauge:
+            value = sample.name.endsWith("_bytes") ? QString("%1 MB").arg(sample.value / (1024.0 * 1024.0), 0, 'f', 1)
+                                                   : QString::number(sample.value, 'f', 0);
+            break;
+        case Metrics::TypeHistogram:
+            if (sample.hist.count == 0) {
+                value = "-";
+            } else {
+                value = QString("n=%1 p50 %2 p90 %3 p99 %4 max %5 ms")
+                            .arg(sample.hist.count)
+                            .arg(ms(sample.hist.p50), ms(sample.hist.p90), ms(sample.hist.p99), ms(sample.hist.max));
+            }
+            break;
+        }
+        html += QString("<tr><td>%1</td><td>&nbsp;%2</td></tr>").arg(name.toHtmlEscaped(), value.toHtmlEscaped());
+    }
+    html += "</table>";
+    _text->setText(html);
+}
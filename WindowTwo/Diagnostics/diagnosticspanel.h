@@ -0,0 +1,35 @@
+#ifndef DIAGNOSTICSPANEL_H
+#define DIAGNOSTICSPANEL_H
+
+#include <QHash>
+#include <QLabel>
+#include <QTimer>
+#include <QWidget>
+
+/**
+ * @brief 实时检测的诊断面板
+ * 定时读取 Metrics 快照：计数器显示累计值与最近一次刷新间隔内的速率，
+ * 瞬时值直接显示，直方图显示次数与 p50/p90/p99/max（毫秒）。
+ * 面板隐藏时停止刷新。
+ */
+class DiagnosticsPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit DiagnosticsPanel(QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void SlotRefresh();
+
+private:
+    QLabel* _text;
+    QTimer _timer;
+    QHash<QString, double> _last;   // 上次刷新时的计数器值（名称 + 标签）
+    qint64 _last_ms = 0;            // 上次刷新时刻
+};
+
+#endif // DIAGNOSTICSPANEL_H
@@ -1,5 +1,6 @@
 #include "settingdialog.h"
 #include "ui_settingdialog.h"
+#include "threadtuning.h"
 
 
 /* ---------------- 摄像头枚举线程实现 ---------------- */
@@ -51,6 +52,12 @@ SettingDialog::SettingDialog(QWidget *parent)
     connect(ui->btnOK, &QPushButton::clicked, this, &SettingDialog::on_btnOK_clicked);
     connect(ui->btnCancel, &QPushButton::clicked, this, &SettingDialog::on_btnCancel_clicked);
 
+    // 推理模式：对应 ThreadTuning 的两个调优目标
+    ui->comboBoxProfile->addItem("低延迟", int(ThreadTuning::LowLatency));
+    ui->comboBoxProfile->addItem("低 CPU 占用", int(ThreadTuning::LowCpu));
+    ui->comboBoxProfile->setCurrentIndex(ui->comboBoxProfile->findData(int(ThreadTuning::Instance().CurrentObjective())));
+    ui->comboBoxProfile->setToolTip(ThreadTuning::Instance().IsTuned() ? QString("已按本机调优") : QString("本机尚未调优，使用默认线程配置"));
+
     // UI 初始状态
     ui->comboBoxCamera->addItem("正在检测摄像头...");
     startEnumerateCameras();
@@ -73,6 +80,7 @@ void SettingDialog::on_btnOK_clicked()
     } else {
         m_selectedIndex = 0;
     }
+    ThreadTuning::Instance().SetObjective(ThreadTuning::Objective(ui->comboBoxProfile->currentData().toInt()));
     accept();
 }
 
@@ -1,6 +1,16 @@
 // window_two.cpp
 #include "windowtwo.h"
 #include "ui_windowtwo.h"
+#include "tracer.h"
+#include "metrics.h"
+#include "memorystats.h"
+#include "threadtuning.h"
+#include "modelresources.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QShortcut>
+#include <QStandardPaths>
 
 WindowTwo::WindowTwo(QWidget *parent)
     : QDialog(parent)
@@ -45,6 +55,56 @@ WindowTwo::WindowTwo(QWidget *parent)
     labelPath = LABEL_PATH;
     modelPath = MODEL_PATH;
 
+    // 诊断面板放在状态栏下方，Ctrl+D 显示/隐藏
+    diagnosticsPanel = new DiagnosticsPanel(this);
+    ui->verticalLayout_3->addWidget(diagnosticsPanel);
+    QShortcut* diagnosticsShortcut = new QShortcut(QKeySequence("Ctrl+D"), this);
+    connect(diagnosticsShortcut, &QShortcut::activated, this, [this]() {
+        diagnosticsPanel->setVisible(!diagnosticsPanel->isVisible());
+    });
+
+    // Ctrl+T 开始/结束分阶段计时，结束时导出 trace 文件
+    QShortcut* traceShortcut = new QShortcut(QKeySequence("Ctrl+T"), this);
+    connect(traceShortcut, &QShortcut::activated, this, &WindowTwo::toggleTrace);
+
+    // 可选：实时识别交给推理子进程，ORT 崩溃或卡死不影响界面；子进程未就绪时仍走进程内识别
+    if (InferenceClient::EnabledByEnvironment()) {
+        const std::shared_ptr<const ModelBundle> bundle = ModelRegistry::Instance().Current();
+        classNames = bundle ? bundle->classNames : RecognizeImgThread::readLabels(labelPath.toStdString());
+        inferenceClient = new InferenceClient(bundle ? bundle->modelPath : modelPath, ThreadTuning::Instance().Profile(), this);
+        connect(inferenceClient, &InferenceClient::resultReady, this, [this](qint64 captureNs, int classId, float confidence) {
+            recognizeCaptureNs = captureNs;
+            onRecognizeSuccess(RecognizeImgThread::ClassName(classNames, classId), confidence);
+        });
+        connect(inferenceClient, &InferenceClient::frameFailed, this, [this](qint64, const QString &errorMsg) {
+            onRecognizeFail(errorMsg);
+        });
+        // 模型热替换：子进程处理完旧模型的帧后换用新模型，标签表在新子进程就绪时一起切换
+        connect(inferenceClient, &InferenceClient::readyChanged, this, [this](bool ready) {
+            if (ready && pendingWorkerBundle) {
+                classNames = pendingWorkerBundle->classNames;
+                pendingWorkerBundle.reset();
+            }
+        });
+        // 首次调优在窗口打开后才结束时，子进程换用调优结果
+        connect(&ModelResources::Instance(), &ModelResources::threadProfileChanged, this, [this]() {
+            if (inferenceClient) {
+                inferenceClient->SetThreadProfile(ThreadTuning::Instance().Profile());
+            }
+        });
+        connect(&ModelRegistry::Instance(), &ModelRegistry::modelChanged, this, [this]() {
+            pendingWorkerBundle = ModelRegistry::Instance().Current();
+            if (inferenceClient && pendingWorkerBundle) {
+                inferenceClient->SetModelPath(pendingWorkerBundle->modelPath);
+            }
+        });
+        const QString error = inferenceClient->Start();
+        if (!error.isEmpty()) {
+            qWarning() << "[WindowTwo] inference worker disabled:" << error;
+            delete inferenceClient;
+            inferenceClient = nullptr;
+        }
+    }
 }
 
 
@@ -55,6 +115,10 @@ WindowTwo::~WindowTwo()
         cameraThread->stop();  // 发送停止信号
         cameraThread->wait();  // 等待线程完全停止
     }
+    // 识别线程以本窗口为父对象，释放前须等待其结束
+    if (recognizeThread) {
+        recognizeThread->wait();
+    }
     delete ui;
 }
 
@@ -84,10 +148,7 @@ void WindowTwo::on_btnStart_clicked()
         cv::imwrite(tempImagePath.toStdString(), frame);
     }
 
-    recognizeThread = new RecognizeImgThread(tempImagePath, labelPath, modelPath, this);
-    connect(recognizeThread, &RecognizeImgThread::SigRecognizeFinish, this, &WindowTwo::onRecognizeSuccess);
-    connect(recognizeThread, &RecognizeImgThread::SigRecognizeFail, this, &WindowTwo::onRecognizeFail);
-    recognizeThread->start();
+    startRecognize(tempImagePath, Tracer::NowNs());
 
 
     // ---- 新增：开始检测后禁用其他按钮 ----
@@ -110,7 +171,6 @@ void WindowTwo::on_btnStop_clicked()
     if (recognizeThread && recognizeThread->isRunning()) {
         recognizeThread->quit();
         recognizeThread->wait();
-        recognizeThread = nullptr;
     }
 
     qApp->processEvents(); // ⚠️ 强制刷新界面
@@ -137,38 +197,122 @@ void WindowTwo::on_setBtn_clicked()
     if (dlg.exec() == QDialog::Accepted) {
         selectedCamera = dlg.selectedCameraIndex();
         ui->labelCameraInfo->setText(QString("当前选择：摄像头 %1").arg(selectedCamera));
+        // 推理模式可能已切换，子进程按新的线程配置重启（进程内识别下一次创建会话时生效）
+        if (inferenceClient) {
+            inferenceClient->SetThreadProfile(ThreadTuning::Instance().Profile());
+        }
     }
 }
 
-void WindowTwo::updateFrame(const QImage &image)
+void WindowTwo::updateFrame(const QImage &image, qint64 captureNs)
 {
+    cameraThread->frameConsumed();
+
     // 将QImage转换为QPixmap，并缩放到labelCamera的大小
     // Qt::KeepAspectRatio: 保持图像宽高比
     // Qt::SmoothTransformation: 使用平滑的缩放算法，提高图像质量
+    TRACE_BEGIN(scale, "ui.scale");
     ui->cameraLabel->setPixmap(
         QPixmap::fromImage(image).scaled(
             ui->cameraLabel->size(),
             Qt::KeepAspectRatio,
             Qt::SmoothTransformation)
         );
+    TRACE_END(scale);
+
+    static Metrics& metrics = Metrics::Instance();
+    static Gauge& pixmapBytes = metrics.GetGauge("cv_pool_bytes", "Approximate bytes held by image pools and caches.", "pool=\"camera_pixmap\"");
+    const QPixmap shown = ui->cameraLabel->pixmap(Qt::ReturnByValue);
+    pixmapBytes.Set(qint64(shown.width()) * shown.height() * shown.depth() / 8);
 
     // 每隔一定帧保存一张图像并识别（避免过于频繁）
     static int frameCount = 0;
     frameCount++;
     if (frameCount % 30 == 0) { // 每30帧识别一次（约1秒）
-        QString tempPath = "temp_frame.jpg";
-        image.save(tempPath);
-        if (recognizeThread == nullptr || !recognizeThread->isRunning()) {
-            recognizeThread = new RecognizeImgThread(tempPath, labelPath, modelPath, this);
-            connect(recognizeThread, &RecognizeImgThread::SigRecognizeFinish, this, &WindowTwo::onRecognizeSuccess);
-            connect(recognizeThread, &RecognizeImgThread::SigRecognizeFail, this, &WindowTwo::onRecognizeFail);
-            recognizeThread->start();
+        if (inferenceClient && inferenceClient->IsReady()) {
+            if (inferenceClient->InFlight() > 0 || !submitToWorker(image, captureNs)) {
+                static Counter& workerBusy = Metrics::Instance().GetCounter("cv_frames_dropped_total", "Frames dropped before recognition, by reason.", "reason=\"recognizer_busy\"");
+                workerBusy.Inc();
+            }
+        } else if (recognizeThread == nullptr || !recognizeThread->isRunning()) {
+            // 识别线程空闲时才写临时文件，避免覆盖正在读取的图片
+            QString tempPath = "temp_frame.jpg";
+            {
+                TRACE_SCOPE("ui.save_temp");
+                image.save(tempPath);
+            }
+            TRACE_SCOPE("ui.start_recognize");
+            startRecognize(tempPath, captureNs);
+        } else {
+            static Counter& busy = Metrics::Instance().GetCounter("cv_frames_dropped_total", "Frames dropped before recognition, by reason.", "reason=\"recognizer_busy\"");
+            busy.Inc();
         }
     }
 }
 
+bool WindowTwo::submitToWorker(const QImage &image, qint64 captureNs)
+{
+    TRACE_SCOPE("ui.submit_worker");
+    int slot = -1;
+    cv::Mat target = inferenceClient->AcquireFrame(image.width(), image.height(), slot);
+    if (target.empty()) {
+        return false;
+    }
+    // 相机最近一帧直接拷进共享内存；尺寸变化时 copyTo 会另行分配，此时放弃该帧
+    const uchar* shared = target.data;
+    if (!cameraThread->getLastFrame(target) || target.data != shared) {
+        inferenceClient->Abandon(slot);
+        return false;
+    }
+    return inferenceClient->Submit(slot, captureNs);
+}
+
+void WindowTwo::startRecognize(const QString &imagePath, qint64 captureNs)
+{
+    static Gauge& inFlight = Metrics::Instance().GetGauge("cv_recognize_in_flight", "Recognition threads currently running for the live view.");
+
+    recognizeCaptureNs = captureNs;
+    recognizeThread = new RecognizeImgThread(imagePath, labelPath, modelPath, this);
+    // 实时画面让位于单张检测，超过截止时间仍未开始推理的帧丢弃
+    recognizeThread->SetModelBundle(ModelRegistry::Instance().Current());
+    recognizeThread->SetPriority(InferenceScheduler::Live, captureNs + qint64(LIVE_DEADLINE_MS) * 1000000);
+    connect(recognizeThread, &RecognizeImgThread::SigRecognizeFinish, this, &WindowTwo::onRecognizeSuccess);
+    connect(recognizeThread, &RecognizeImgThread::SigRecognizeFail, this, &WindowTwo::onRecognizeFail);
+    connect(recognizeThread, &QThread::finished, this, []() { inFlight.Add(-1); });
+    // 每次识别一个线程对象，结束后释放（之前一直挂在窗口下直到窗口销毁）
+    connect(recognizeThread, &QThread::finished, recognizeThread, &QObject::deleteLater);
+    inFlight.Add(1);
+    recognizeThread->start();
+}
+
+void WindowTwo::toggleTrace()
+{
+    if (!Tracer::IsEnabled()) {
+        Tracer::Clear();
+        Tracer::SetEnabled(true);
+        ui->statusLabel->setText("⏱ 正在记录 trace（Ctrl+T 结束）");
+        return;
+    }
+
+    Tracer::SetEnabled(false);
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/traces");
+    dir.mkpath(".");
+    QString path = dir.filePath(QString("trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss")));
+    if (Tracer::WriteChromeJson(path)) {
+        ui->statusLabel->setText(QString("trace 已保存：%1").arg(QDir::toNativeSeparators(path)));
+    } else {
+        ui->statusLabel->setText(QString("trace 保存失败：%1").arg(QDir::toNativeSeparators(path)));
+    }
+}
+
 void WindowTwo::onRecognizeSuccess(QString className, float confidence)
 {
+    static Metrics& metrics = Metrics::Instance();
+    static Counter& inferred = metrics.GetCounter("cv_frames_inferred_total", "Live frames classified successfully.");
+    static Histogram& latency = metrics.GetHistogram("cv_capture_to_result_seconds", "Time from camera capture to recognition result.");
+    inferred.Inc();
+    latency.Record((Tracer::NowNs() - recognizeCaptureNs) / 1000);
+
     confidence = (confidence * 100.0f > 99.99f) ? 99.99f : confidence * 100.0f ;
     ui->resultLabel->setText(QString("识别结果：%1 ").arg(className));
     ui->conLabel->setText(QString("置信度 %1%").arg(confidence, 0, 'f', 2));
@@ -176,6 +320,9 @@ void WindowTwo::onRecognizeSuccess(QString className, float confidence)
 
 void WindowTwo::onRecognizeFail(QString errorMsg)
 {
+    static Counter& failed = Metrics::Instance().GetCounter("cv_frames_dropped_total", "Frames dropped before recognition, by reason.", "reason=\"recognize_failed\"");
+    failed.Inc();
+
     ui->resultLabel->setText(QString("识别失败：%1").arg(errorMsg));
 }
 
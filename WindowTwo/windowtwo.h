@@ -5,6 +5,8 @@
 #include "camerathread.h"
 #include "settingdialog.h"
 #include "recognizeimgthread.h"
+#include "diagnosticspanel.h"
+#include "inferenceclient.h"
 #include "mainwindow.h"
 #include "const.h"
 #include <QDialog>
@@ -12,6 +14,7 @@
 #include <QLabel>
 #include <QCloseEvent>
 #include <QFile>
+#include <QPointer>
 
 namespace Ui { class WindowTwo; }
 
@@ -31,10 +34,15 @@ private slots:
     void on_btnStart_clicked(); // 当用户点击"开始"按钮时调用，用于启动相机捕获线程。
     void on_btnStop_clicked(); // 当用户点击"停止"按钮时调用，用于停止相机捕获线程。
     void on_setBtn_clicked();   // 当用户点击"设置"按钮时打开设置界面，用于设置相机。
-    void updateFrame(const QImage &image); //  当相机线程捕获到新帧并发出frameReady信号时调用，用于在UI中更新显示的图像。
+    void updateFrame(const QImage &image, qint64 captureNs); //  当相机线程捕获到新帧并发出frameReady信号时调用，用于在UI中更新显示的图像。
     // 新增槽函数：接收识别结果
     void onRecognizeSuccess(QString className, float confidence);
     void onRecognizeFail(QString errorMsg);
+    void toggleTrace();        // 开始/结束记录分阶段计时（Ctrl+T），结束时导出 Chrome trace 文件
+private:
+    void startRecognize(const QString &imagePath, qint64 captureNs); // 启动识别线程并记录对应帧的捕获时刻
+    bool submitToWorker(const QImage &image, qint64 captureNs);      // 把最近一帧写入共享内存交给推理子进程
+
 protected:
     void closeEvent(QCloseEvent *event) override;
 
@@ -42,11 +50,18 @@ private:
     Ui::WindowTwo *ui;
 
     int selectedCamera = 0;         // 当前摄像头索引
-    RecognizeImgThread *recognizeThread = nullptr; // 新增：识别线程
+    QPointer<RecognizeImgThread> recognizeThread; // 当前识别线程，结束后自动释放
     CameraThread *cameraThread;  // 指向相机线程对象的指针，用于管理相机捕获
 
     QString labelPath;
     QString modelPath;
+
+    DiagnosticsPanel *diagnosticsPanel;   // 诊断面板（Ctrl+D 显示/隐藏）
+    qint64 recognizeCaptureNs = 0;        // 正在识别的帧的捕获时刻
+
+    InferenceClient *inferenceClient = nullptr;   // 推理子进程（CV_INFERENCE_WORKER=1 时启用）
+    std::vector<std::string> classNames;          // 子进程只返回类别 ID，在界面端转换为标签名
+    std::shared_ptr<const ModelBundle> pendingWorkerBundle; // 子进程正在换用的模型版本，就绪后切换标签表
 };
 
 #endif // WINDOW_TWO_H
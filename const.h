@@ -2,6 +2,8 @@
 #define CONST_H
 
 #include <QString>
+#include <QStringList>
+#include <string>
 
 enum TreeItmType{
     TreeItemPro = 1, // 表示项目的条目
@@ -25,6 +27,73 @@ enum PicBtnState{
 const QString DEF_LABEL_PATH = ":/label/class_names.txt";
 const QString DEF_MODEL_PATH = ":/model/best.onnx";
 
+// 带特征向量输出的模型中，特征向量输出节点的名称
+const std::string EMBEDDING_OUTPUT_NAME = "embedding";
+// 相似图片面板展示的结果数量
+const int SIMILAR_TOP_K = 12;
+
+// 感知哈希汉明距离不超过该值视为近似重复
+const int DUP_HAMMING_DISTANCE = 8;
+
+// 缩略图存储尺寸（长边像素）、树中图标尺寸、树中最多同时持有的缩略图数量
+const int THUMB_SIZE = 96;
+const int THUMB_ICON_SIZE = 32;
+const int THUMB_MAX_LOADED = 2000;
+// 缩略图存储：每个项目的数据区上限（MB），写满时压缩并淘汰最久未用的缩略图；
+// 连续这么多次打开项目都没有用到的缩略图（多为图片已修改或删除）在压缩时丢弃
+const int THUMB_STORE_MAX_MB = 64;
+const quint32 THUMB_STORE_STALE_OPENS = 8;
+
+// 图片浏览时前后各预取的图片数量、预取缓存的内存上限（MB）
+const int PREFETCH_COUNT = 3;
+const int PREFETCH_CACHE_MB = 256;
+
+// 像素数超过该值的图片改用瓦片金字塔浏览；瓦片边长；瓦片缓存的内存上限（MB）
+const qint64 PYRAMID_MIN_PIXELS = 24000000;
+const int PYRAMID_TILE_SIZE = 256;
+const int PYRAMID_CACHE_MB = 128;
+// 瓦片金字塔整图解码的内存上限（MB），约可解码 2.5 亿像素；Qt 6 默认只允许 256 MB
+const int PYRAMID_DECODE_MAX_MB = 1024;
+
+// 项目扫描默认排除的文件与目录（通配符，不区分大小写）
+const QStringList SCAN_EXCLUDE_PATTERNS = {"thumbs.db", "desktop.ini", ".DS_Store", "._*", "@eaDir", "__MACOSX", "*.xmp", "*.tmp"};
+// 按扩展名识别的图片格式（小写）
+const char* const IMAGE_SUFFIXES[] = {"jpg", "jpeg", "png", "bmp", "gif", "tif", "tiff", "webp"};
+// 后台扫描结果每次写入树的最大条目数、写入间隔（毫秒）
+const int SCAN_APPLY_BATCH = 20000;
+const int SCAN_APPLY_INTERVAL = 30;
+// 目录变化合并通知的间隔（毫秒）
+const int WATCH_DELAY_MS = 500;
+
+// 本机 Prometheus 指标端口（/metrics），0 表示不启用；诊断面板刷新间隔（毫秒）
+const int METRICS_PORT = 9464;
+const int DIAGNOSTICS_REFRESH_MS = 500;
+// 界面尚未处理的相机帧达到该数量时丢弃新帧
+const int CAMERA_MAX_PENDING_FRAMES = 2;
+// 实时识别请求的截止时间（自捕获起，毫秒），过期仍未开始推理的帧直接丢弃
+const int LIVE_DEADLINE_MS = 1000;
+// 批量识别每次申请推理槽处理的图片数（有更高优先级请求等待时提前归还）
+const int BATCH_CHUNK_SIZE = 4;
+
+// 推理子进程（CV_INFERENCE_WORKER=1 时启用）：可执行文件名、共享内存 slot 数量与容量（最大 1920x1080 BGR）、
+// 单帧超过该时间未返回视为卡死、重启退避间隔的下限与上限（毫秒）
+const QString WORKER_EXECUTABLE = "cultural-vision-worker";
+const int WORKER_RING_SLOTS = 4;
+const qint64 WORKER_SLOT_BYTES = 1920 * 1080 * 3;
+const int WORKER_STALL_MS = 10000;
+const int WORKER_RESTART_MIN_MS = 500;
+const int WORKER_RESTART_MAX_MS = 10000;
+// 共享内存按用户使用固定的几个名称（同时运行的界面进程各占一个），崩溃残留的段在下次启动时回收
+const int WORKER_SHM_KEYS = 8;
+
+// 线程配置自动调优（首次运行）：每种组合测量的推理次数，以及每次推理后的空闲间隔（毫秒，模拟实时帧之间的间隙，
+// 自旋线程在间隙中消耗的 CPU 计入该组合）；两个组合相差在 TUNE_TOLERANCE 以内视为相同，按另一目标择优
+const int TUNE_RUNS = 15;
+const int TUNE_IDLE_MS = 30;
+const double TUNE_TOLERANCE = 0.05;
+// 调优期间有其他推理进行时丢弃该次测量（界面已可使用）；累计丢弃超过 TUNE_MAX_DISCARDS 次时放弃本次调优，下次启动重试
+const int TUNE_MAX_DISCARDS = 60;
+
 const int PROGRESS_WIDTH = 300;
 const int PROGRESS_MAX = 300;
 
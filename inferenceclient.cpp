@@ -0,0 +1,354 @@
+#include "inferenceclient.h"
+#include "metrics.h"
+#include "inferencescheduler.h"
+#include "const.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QLocalSocket>
+#include <QtDebug>
+#include <cstring>
+
+using namespace WorkerProtocol;
+
+InferenceClient::InferenceClient(const QString &modelPath, const ThreadProfile &profile, QObject *parent)
+    : QObject(parent), _modelPath(modelPath), _profile(profile)
+{
+    _slotBusy.fill(false, WORKER_RING_SLOTS);
+    _slotSize.fill(QSize(), WORKER_RING_SLOTS);
+
+    connect(&_server, &QLocalServer::newConnection, this, &InferenceClient::SlotNewConnection);
+    connect(&_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &InferenceClient::SlotWorkerGone);
+    connect(&_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        // 启动失败不会触发 finished
+        if (error == QProcess::FailedToStart) {
+            qWarning() << "[InferenceClient] cannot start worker:" << _process.errorString();
+            SlotWorkerGone();
+        }
+    });
+
+    _restartTimer.setSingleShot(true);
+    connect(&_restartTimer, &QTimer::timeout, this, &InferenceClient::LaunchWorker);
+    _stallTimer.setInterval(1000);
+    connect(&_stallTimer, &QTimer::timeout, this, &InferenceClient::SlotCheckStall);
+}
+
+InferenceClient::~InferenceClient()
+{
+    _stopping = true;
+    _restartTimer.stop();
+    // 断开后子进程自行退出，超时再强制结束
+    if (_socket) {
+        _socket->disconnectFromServer();
+    }
+    if (_process.state() != QProcess::NotRunning && !_process.waitForFinished(2000)) {
+        _process.kill();
+        _process.waitForFinished(1000);
+    }
+    InferenceScheduler::Instance().AddExternal(-_inFlight.size());
+}
+
+bool InferenceClient::EnabledByEnvironment()
+{
+    return qEnvironmentVariableIntValue("CV_INFERENCE_WORKER") == 1;
+}
+
+QString InferenceClient::Start()
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    // 共享内存：名称按用户固定，依次尝试；已存在的段先挂载再释放，
+    // 崩溃残留的段没有其他进程挂载，释放后即可重新创建，仍在使用的段则换下一个名称
+    const size_t bytes = RingBytes(WORKER_RING_SLOTS, WORKER_SLOT_BYTES);
+    bool created = false;
+    for (int i = 0; i < WORKER_SHM_KEYS && !created; ++i) {
+        _memory.setKey(QString("cultural-vision-ring-%1-%2").arg(QDir::home().dirName()).arg(i));
+        created = _memory.create(int(bytes));
+        if (!created && _memory.error() == QSharedMemory::AlreadyExists) {
+            if (_memory.attach()) {
+                _memory.detach();
+            }
+            created = _memory.create(int(bytes));
+        }
+    }
+    if (!created) {
+        return QString("Cannot create shared memory: %1").arg(_memory.errorString());
+    }
+    RingHeader header{MAGIC, VERSION, quint32(WORKER_RING_SLOTS), 0, quint64(WORKER_SLOT_BYTES)};
+    std::memcpy(_memory.data(), &header, sizeof(header));
+
+    const QString serverName = QString("cultural-vision-worker-%1").arg(pid);
+    QLocalServer::removeServer(serverName);
+    if (!_server.listen(serverName)) {
+        return QString("Cannot listen on %1: %2").arg(serverName, _server.errorString());
+    }
+
+    _process.setProcessChannelMode(QProcess::ForwardedChannels);
+    LaunchWorker();
+    _stallTimer.start();
+    return QString();
+}
+
+void InferenceClient::LaunchWorker()
+{
+    if (_stopping || _process.state() != QProcess::NotRunning) {
+        return;
+    }
+    const QString program = QDir(QCoreApplication::applicationDirPath()).filePath(WORKER_EXECUTABLE);
+    const QStringList arguments = {
+        "--server", _server.serverName(),
+        "--shm", _memory.key(),
+        "--model", _modelPath,
+        "--threads", QString::number(_profile.intraOpNumThreads),
+        "--inter-threads", QString::number(_profile.interOpNumThreads),
+        "--spin", _profile.allowSpinning ? "on" : "off",
+    };
+    _upTime.start();
+    _process.start(program, arguments);
+}
+
+void InferenceClient::SetModelPath(const QString &modelPath)
+{
+    if (modelPath == _modelPath) {
+        return;
+    }
+    _modelPath = modelPath;
+    Relaunch();
+}
+
+void InferenceClient::SetThreadProfile(const ThreadProfile &profile)
+{
+    if (profile.intraOpNumThreads == _profile.intraOpNumThreads && profile.interOpNumThreads == _profile.interOpNumThreads
+        && profile.allowSpinning == _profile.allowSpinning) {
+        return;
+    }
+    _profile = profile;
+    Relaunch();
+}
+
+void InferenceClient::Relaunch()
+{
+    // 子进程未运行（等待重启）时，下次启动即使用新配置
+    if (_process.state() == QProcess::NotRunning) {
+        return;
+    }
+    _swapping = true;
+    if (_ready) {
+        _ready = false;
+        emit readyChanged(false);
+    }
+    FinishSwapIfDrained();
+}
+
+void InferenceClient::FinishSwapIfDrained()
+{
+    if (!_swapping || !_inFlight.isEmpty() || !_socket) {
+        return;
+    }
+    // 断开后旧子进程自行退出，finished 时以新模型启动；超时仍未退出则强制结束
+    _socket->disconnect(this);
+    _socket->disconnectFromServer();
+    _socket->deleteLater();
+    _socket = nullptr;
+    QTimer::singleShot(2000, this, [this]() {
+        if (_swapping && _process.state() != QProcess::NotRunning) {
+            _process.kill();
+        }
+    });
+}
+
+void InferenceClient::ScheduleRestart()
+{
+    static Counter& restarts = Metrics::Instance().GetCounter("cv_worker_restarts_total", "Inference worker process restarts.");
+    restarts.Inc();
+
+    // 稳定运行一分钟以上的子进程退出时从最短间隔重新开始退避
+    if (_restartDelayMs == 0 || (_upTime.isValid() && _upTime.elapsed() > 60000)) {
+        _restartDelayMs = WORKER_RESTART_MIN_MS;
+    } else {
+        _restartDelayMs = qMin(_restartDelayMs * 2, WORKER_RESTART_MAX_MS);
+    }
+    qWarning() << "[InferenceClient] worker gone, restarting in" << _restartDelayMs << "ms";
+    _restartTimer.start(_restartDelayMs);
+}
+
+void InferenceClient::SlotNewConnection()
+{
+    QLocalSocket* socket = _server.nextPendingConnection();
+    if (!socket) {
+        return;
+    }
+    // 只保留当前子进程的连接
+    if (_socket) {
+        _socket->disconnect(this);
+        _socket->deleteLater();
+    }
+    _socket = socket;
+    _readBuffer.clear();
+    connect(_socket, &QLocalSocket::readyRead, this, &InferenceClient::SlotReadyRead);
+    connect(_socket, &QLocalSocket::disconnected, this, &InferenceClient::SlotWorkerGone);
+    // 连接前已要求更换配置：这个子进程还是旧配置，没有帧在处理，直接让它退出
+    FinishSwapIfDrained();
+}
+
+void InferenceClient::SlotReadyRead()
+{
+    static Metrics& metrics = Metrics::Instance();
+    static Counter& ok = metrics.GetCounter("cv_worker_frames_total", "Frames processed by the inference worker, by outcome.", "outcome=\"ok\"");
+    static Counter& failed = metrics.GetCounter("cv_worker_frames_total", "Frames processed by the inference worker, by outcome.", "outcome=\"failed\"");
+
+    _readBuffer.append(_socket->readAll());
+    int offset = 0;
+    while (_readBuffer.size() - offset >= int(sizeof(Message))) {
+        Message message;
+        std::memcpy(&message, _readBuffer.constData() + offset, sizeof(message));
+        offset += int(sizeof(Message));
+
+        if (message.type == Hello) {
+            // 等待更换配置的旧子进程不算就绪，否则界面会按新模型的标签解读旧模型的结果
+            if (!_swapping) {
+                _ready = true;
+                emit readyChanged(true);
+            }
+            continue;
+        }
+        if (message.type != Result) {
+            continue;
+        }
+        const int slot = int(message.slot);
+        auto it = _inFlight.find(slot);
+        if (it == _inFlight.end() || it->seq != message.seq) {
+            continue;
+        }
+        const qint64 tag = it->tag;
+        _inFlight.erase(it);
+        InferenceScheduler::Instance().AddExternal(-1);
+        _slotBusy[slot] = false;
+        if (message.status == Ok) {
+            ok.Inc();
+            emit resultReady(tag, message.classId, message.confidence);
+        } else {
+            failed.Inc();
+            emit frameFailed(tag, message.status == BadFrame ? QString("Worker rejected the frame.")
+                                                             : QString("Worker inference failed."));
+        }
+    }
+    _readBuffer.remove(0, offset);
+    FinishSwapIfDrained();
+}
+
+void InferenceClient::SlotWorkerGone()
+{
+    // finished 与 disconnected 都会到这里，只处理一次
+    if (_stopping || _restartTimer.isActive()) {
+        return;
+    }
+    if (_swapping && _process.state() == QProcess::NotRunning) {
+        // 为更换模型或线程配置而退出，不计入异常重启
+        _swapping = false;
+        if (_socket) {
+            _socket->disconnect(this);
+            _socket->deleteLater();
+            _socket = nullptr;
+        }
+        FailInFlight("Inference worker restarted with a new configuration.");
+        LaunchWorker();
+        return;
+    }
+    _swapping = false;   // 异常退出：重启时已经使用新配置
+    if (_ready) {
+        _ready = false;
+        emit readyChanged(false);
+    }
+    if (_socket) {
+        _socket->disconnect(this);
+        _socket->deleteLater();
+        _socket = nullptr;
+    }
+    FailInFlight("Inference worker exited.");
+    // 先安排重启，kill 同步触发的 finished 会在上面直接返回
+    ScheduleRestart();
+    if (_process.state() != QProcess::NotRunning) {
+        _process.kill();
+        _process.waitForFinished(1000);
+    }
+}
+
+void InferenceClient::SlotCheckStall()
+{
+    for (auto it = _inFlight.cbegin(); it != _inFlight.cend(); ++it) {
+        if (it->age.elapsed() > WORKER_STALL_MS) {
+            qWarning() << "[InferenceClient] frame in slot" << it.key() << "stalled, killing worker";
+            _process.kill();
+            return;
+        }
+    }
+}
+
+void InferenceClient::FailInFlight(const QString &reason)
+{
+    const QHash<int, Pending> pending = _inFlight;
+    _inFlight.clear();
+    InferenceScheduler::Instance().AddExternal(-pending.size());
+    for (auto it = pending.cbegin(); it != pending.cend(); ++it) {
+        _slotBusy[it.key()] = false;
+        emit frameFailed(it->tag, reason);
+    }
+}
+
+uchar *InferenceClient::SlotData(int slot)
+{
+    return static_cast<uchar*>(_memory.data()) + SlotOffset(quint32(slot), WORKER_SLOT_BYTES);
+}
+
+cv::Mat InferenceClient::AcquireFrame(int width, int height, int &slot)
+{
+    slot = -1;
+    if (!IsReady() || width <= 0 || height <= 0 || qint64(width) * height * 3 > WORKER_SLOT_BYTES) {
+        return cv::Mat();
+    }
+    for (int i = 0; i < _slotBusy.size(); ++i) {
+        if (!_slotBusy[i]) {
+            _slotBusy[i] = true;
+            _slotSize[i] = QSize(width, height);
+            slot = i;
+            return cv::Mat(height, width, CV_8UC3, SlotData(i));
+        }
+    }
+    return cv::Mat();
+}
+
+bool InferenceClient::Submit(int slot, qint64 tag)
+{
+    if (slot < 0 || slot >= _slotBusy.size() || !_slotBusy[slot] || _inFlight.contains(slot)) {
+        return false;
+    }
+    if (!IsReady()) {
+        Abandon(slot);
+        return false;
+    }
+    const QSize size = _slotSize[slot];
+    Message message{};
+    message.type = Frame;
+    message.slot = quint32(slot);
+    message.seq = _nextSeq++;
+    message.width = quint32(size.width());
+    message.height = quint32(size.height());
+    message.step = quint32(size.width() * 3);
+
+    Pending pending;
+    pending.tag = tag;
+    pending.seq = message.seq;
+    pending.age.start();
+    _inFlight.insert(slot, pending);
+    InferenceScheduler::Instance().AddExternal(1);
+    _socket->write(reinterpret_cast<const char*>(&message), sizeof(message));
+    return true;
+}
+
+void InferenceClient::Abandon(int slot)
+{
+    if (slot >= 0 && slot < _slotBusy.size() && !_inFlight.contains(slot)) {
+        _slotBusy[slot] = false;
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef INFERENCECLIENT_H
+#define INFERENCECLIENT_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QLocalServer>
+#include <QObject>
+#include <QProcess>
+#include <QSharedMemory>
+#include <QSize>
+#include <QTimer>
+#include <QVector>
+#include <opencv2/opencv.hpp>
+#include "workerprotocol.h"
+#include "threadtuning.h"
+
+class QLocalSocket;
+
+/**
+ * @brief 推理子进程的界面端
+ * 启动 cultural-vision-worker 并由它持有推理会话，ORT 崩溃或 Run 卡死不会带走界面进程。
+ * 帧通过共享内存环形缓冲区传递：调用方用 AcquireFrame 取得指向共享内存的 cv::Mat，
+ * 直接把像素写进去（不经过中间缓冲区），再 Submit；结果经本地套接字返回。
+ *
+ * 子进程退出、断开或单帧超过 WORKER_STALL_MS 未返回时，未完成的帧全部报失败，
+ * 子进程被结束并按退避间隔自动重启（共享内存保留）。
+ *
+ * 更换模型（SetModelPath）或线程配置（SetThreadProfile）时不再接收新帧，已提交的帧在旧子进程上完成后，
+ * 以新配置重新启动子进程；新子进程就绪前 IsReady() 为 false。
+ */
+class InferenceClient : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @param modelPath 模型文件
+     * @param profile 子进程的推理线程配置（ThreadTuning）
+     */
+    InferenceClient(const QString& modelPath, const ThreadProfile& profile, QObject* parent = nullptr);
+    ~InferenceClient() override;
+
+    // 创建共享内存并启动子进程；失败返回错误信息
+    QString Start();
+
+    // 子进程已就绪，可以提交帧
+    bool IsReady() const { return _socket != nullptr && _ready; }
+
+    /**
+     * @brief 取得一个空闲 slot，返回直接指向共享内存的 BGR 图像
+     * @param slot 输出 slot 编号，提交或放弃时使用
+     * @return 没有空闲 slot、子进程未就绪或尺寸超过 slot 容量时返回空 Mat
+     */
+    cv::Mat AcquireFrame(int width, int height, int& slot);
+
+    // 提交已写好的 slot，tag 随结果原样返回（例如捕获时刻）
+    bool Submit(int slot, qint64 tag);
+
+    // 放弃已取得但不再提交的 slot
+    void Abandon(int slot);
+
+    // 已提交、尚未返回结果的帧数
+    int InFlight() const { return _inFlight.size(); }
+
+    // 更换模型：旧子进程处理完已提交的帧后退出，随即以新模型启动
+    void SetModelPath(const QString& modelPath);
+
+    // 更换线程配置，方式同 SetModelPath
+    void SetThreadProfile(const ThreadProfile& profile);
+
+    // 由环境变量 CV_INFERENCE_WORKER=1 开启
+    static bool EnabledByEnvironment();
+
+signals:
+    void resultReady(qint64 tag, int classId, float confidence);
+    void frameFailed(qint64 tag, const QString& errorMsg);
+    void readyChanged(bool ready);
+
+private slots:
+    void SlotNewConnection();
+    void SlotReadyRead();
+    void SlotWorkerGone();
+    void SlotCheckStall();
+
+private:
+    void LaunchWorker();
+    void ScheduleRestart();
+    void FailInFlight(const QString& reason);
+    void Relaunch();
+    void FinishSwapIfDrained();
+    uchar* SlotData(int slot);
+
+    // 已提交的帧
+    struct Pending
+    {
+        qint64 tag;
+        quint64 seq;
+        QElapsedTimer age;
+    };
+
+    QString _modelPath;
+    ThreadProfile _profile;
+    QSharedMemory _memory;
+    QLocalServer _server;
+    QLocalSocket* _socket = nullptr;
+    QProcess _process;
+    QTimer _restartTimer;
+    QTimer _stallTimer;
+    QElapsedTimer _upTime;          // 本次子进程运行时间，稳定运行后重置退避
+    int _restartDelayMs = 0;
+    bool _ready = false;
+    bool _stopping = false;
+    bool _swapping = false;         // 等待旧子进程完成已提交的帧后以新配置重启
+    QByteArray _readBuffer;
+    QVector<bool> _slotBusy;        // 已取得（写入中或已提交）的 slot
+    QVector<QSize> _slotSize;       // 每个 slot 当前帧的尺寸
+    QHash<int, Pending> _inFlight;  // slot -> 已提交的帧
+    quint64 _nextSeq = 1;
+};
+
+#endif // INFERENCECLIENT_H
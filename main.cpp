@@ -1,11 +1,27 @@
 #include "mainwindow.h"
+#include "metricsserver.h"
+#include "memorystats.h"
+#include "startupstats.h"
+#include "const.h"
 
 #include <QApplication>
 #include <QFile>
 
 int main(int argc, char *argv[])
 {
+    StartupStats::Start();
     QApplication a(argc, argv);
+
+    // 本机指标抓取端口，环境变量 CV_METRICS_PORT 可覆盖，0 表示不启用
+    bool portOk = false;
+    int metricsPort = qEnvironmentVariableIntValue("CV_METRICS_PORT", &portOk);
+    if (!portOk) {
+        metricsPort = METRICS_PORT;
+    }
+    MemoryStats::RegisterMetrics();
+    MetricsServer metricsServer;
+    metricsServer.Start(quint16(qBound(0, metricsPort, 65535)));
+
     MainWindow w;
     // 设置窗口标题
     w.setWindowTitle("Cultural-Vision");
@@ -1,6 +1,15 @@
 // mainwindow.cpp
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "windowone.h"
+#include "windowtwo.h"
+#include "embeddingindex.h"
+#include "modelresources.h"
+#include "startupstats.h"
+#include "tracer.h"
+#include <QDebug>
+#include <QFile>
+#include <QTimer>
 
 QString MODEL_PATH;
 QString LABEL_PATH;
@@ -9,18 +18,13 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
 {
+    TRACE_SCOPE("startup.main_window");
     ui->setupUi(this);
     this->setWindowTitle("刺绣检测");  // 设置窗口标题
     this->setWindowIcon(QIcon(":/icon/main_img.png"));  // 设置窗口图标
 
-    QPixmap pixmap(":/icon/mainImg2.png");
-    QSize parentSize = ui->img_label->parentWidget()->size(); // 父控件大小
-
-    ui->img_label->setPixmap(pixmap.scaled(
-        parentSize,
-        Qt::KeepAspectRatio,
-        Qt::SmoothTransformation
-        ));
+    // 主界面图片只解码一次，缩放在布局确定后的 resizeEvent 中进行
+    mainPixmap = QPixmap(":/icon/mainImg2.png");
 
 
     // 打开样式文件（这里假设 qss 文件放在资源文件中）
@@ -39,33 +43,13 @@ MainWindow::MainWindow(QWidget *parent)
         qssFile.close();
     }
 
-
-    MODEL_PATH = copyResourceToDisk(DEF_MODEL_PATH, "best.onnx");
-    LABEL_PATH = copyResourceToDisk(DEF_LABEL_PATH, "class_names.txt");
-
-    if (MODEL_PATH.isEmpty() || LABEL_PATH.isEmpty()) {
-        qWarning() << "Failed to write resource files to disk!";
-    } else {
-        qDebug() << "Resources ready on disk:";
-        qDebug() << "Model:" << MODEL_PATH;
-        qDebug() << "Label:" << LABEL_PATH;
-    }
-
-    // MODEL_PATH = g_modelPathOnDisk;
-    // LABEL_PATH = g_labelPathOnDisk;
-
-    // 初始化窗口对象
-    windowOne = new WindowOne(this);
-    windowTwo = new WindowTwo(this);
+    // 模型与标签的解压、推理会话的创建在第一次绘制后于后台进行（见 paintEvent），
+    // 两个子窗口在第一次打开时才创建
 
     // 连接主界面按钮
     connect(ui->pushButton1, &QPushButton::clicked, this, &MainWindow::openWindowOne);
     connect(ui->pushButton2, &QPushButton::clicked, this, &MainWindow::openWindowTwo);
 
-    // 连接副界面关闭信号
-    connect(windowOne, &WindowOne::windowClosed, this, &MainWindow::windowOneClosed);
-    connect(windowTwo, &WindowTwo::windowClosed, this, &MainWindow::windowTwoClosed);
-
 
 
     QIcon icon1(":/icon/11.png");
@@ -83,15 +67,34 @@ MainWindow::MainWindow(QWidget *parent)
         ui->pushButton1->setIconSize(ui->pushButton1->size());
         ui->pushButton2->setIconSize(ui->pushButton2->size());
     });
+
+    StartupStats::Mark("main_window_ready");
 }
 
 MainWindow::~MainWindow()
 {
+    // 退出前保存相似检索索引
+    EmbeddingIndex::SaveAll();
+
     delete windowOne;
     delete windowTwo;
+    // 预建的推理会话须在 ONNX Runtime 静态对象析构前释放
+    ModelResources::Instance().Release();
     delete ui;
 }
 
+void MainWindow::paintEvent(QPaintEvent *event)
+{
+    QMainWindow::paintEvent(event);
+    if (firstPaintDone) {
+        return;
+    }
+    firstPaintDone = true;
+    StartupStats::Mark("first_paint");
+    // 第一帧画完后再开始后台准备模型
+    QTimer::singleShot(0, this, []() { ModelResources::Instance().PrepareAsync(); });
+}
+
 void MainWindow::disableMainButtons()
 {
     ui->pushButton1->setEnabled(false);
@@ -104,40 +107,16 @@ void MainWindow::enableMainButtons()
     ui->pushButton2->setEnabled(true);
 }
 
-QString MainWindow::copyResourceToDisk(const QString &resPath, const QString &targetFileName)
+void MainWindow::updateMainImage()
 {
-    // 临时目录
-    QString targetPath = QDir::tempPath() + "/" + targetFileName;
-
-    // 如果文件已存在，先删除
-    if (QFile::exists(targetPath)) {
-        QFile::remove(targetPath);
-    }
-
-    // 打开资源文件
-    QFile resFile(resPath);
-    if (!resFile.open(QIODevice::ReadOnly)) {
-        qWarning() << "Cannot open resource:" << resPath;
-        return QString();
+    if (mainPixmap.isNull()) {
+        return;
     }
-
-    // 打开磁盘文件准备写入
-    QFile outFile(targetPath);
-    if (!outFile.open(QIODevice::WriteOnly)) {
-        qWarning() << "Cannot write file:" << targetPath;
-        resFile.close();
-        return QString();
-    }
-
-    // 复制内容
-    outFile.write(resFile.readAll());
-
-    resFile.close();
-    outFile.close();
-
-    qDebug() << "Resource" << resPath << "written to disk:" << targetPath;
-
-    return targetPath;
+    ui->img_label->setPixmap(mainPixmap.scaled(
+        ui->img_label->size(),
+        Qt::KeepAspectRatio,
+        Qt::SmoothTransformation
+        ));
 }
 
 void MainWindow::resizeEvent(QResizeEvent *event)
@@ -147,19 +126,19 @@ void MainWindow::resizeEvent(QResizeEvent *event)
     if (ui->pushButton1) ui->pushButton1->setIconSize(ui->pushButton1->size());
     if (ui->pushButton2) ui->pushButton2->setIconSize(ui->pushButton2->size());
 
-    if (!ui->img_label->pixmap(Qt::ReturnByValue).isNull()) {
-        QPixmap pix = QPixmap(":/icon/mainImg2.png"); // 原始图像
-        ui->img_label->setPixmap(pix.scaled(
-            ui->img_label->size(),
-            Qt::KeepAspectRatio,
-            Qt::SmoothTransformation
-            ));
-    }
+    updateMainImage();
 }
 
 void MainWindow::openWindowOne()
 {
     disableMainButtons();
+    if (!windowOne) {
+        // 子窗口使用 MODEL_PATH / LABEL_PATH，创建前确保模型已解压
+        ModelResources::Instance().WaitReady();
+        TRACE_SCOPE("startup.window_one");
+        windowOne = new WindowOne(this);
+        connect(windowOne, &WindowOne::windowClosed, this, &MainWindow::windowOneClosed);
+    }
     if (!windowOne->isVisible()) {
         windowOne->show();
     } else {
@@ -171,6 +150,12 @@ void MainWindow::openWindowOne()
 void MainWindow::openWindowTwo()
 {
     disableMainButtons();
+    if (!windowTwo) {
+        ModelResources::Instance().WaitReady();
+        TRACE_SCOPE("startup.window_two");
+        windowTwo = new WindowTwo(this);
+        connect(windowTwo, &WindowTwo::windowClosed, this, &MainWindow::windowTwoClosed);
+    }
     if (!windowTwo->isVisible()) {
         windowTwo->show();
     } else {
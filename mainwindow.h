@@ -3,8 +3,7 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include "windowone.h"
-#include "windowtwo.h"
+#include <QPixmap>
 #include "const.h"
 
 QT_BEGIN_NAMESPACE
@@ -34,14 +33,19 @@ private slots:
 private:
     void disableMainButtons();
     void enableMainButtons();
+    void updateMainImage();      // 按当前尺寸缩放主界面图片
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
 
 private:
     Ui::MainWindow *ui;
-    WindowOne* windowOne;
-    WindowTwo* windowTwo;
+    WindowOne* windowOne = nullptr;   // 第一次打开时创建
+    WindowTwo* windowTwo = nullptr;   // 第一次打开时创建
+
+    QPixmap mainPixmap;               // 主界面图片（只解码一次）
+    bool firstPaintDone = false;
 
-    // 将资源写到磁盘的函数
-    QString copyResourceToDisk(const QString &resPath, const QString &targetFileName);
     virtual void resizeEvent(QResizeEvent *event);
 };
 
@@ -0,0 +1,74 @@
+#include "metricsserver.h"
+#include "metrics.h"
+#include <QHostAddress>
+#include <QTcpSocket>
+#include <QTimer>
+
+namespace {
+
+// 请求头的最大长度，超过即断开
+const int MAX_REQUEST_BYTES = 8192;
+// 客户端未发完请求的超时（毫秒）
+const int REQUEST_TIMEOUT_MS = 5000;
+
+QByteArray Response(const QByteArray& status, const QByteArray& contentType, const QByteArray& body)
+{
+    return "HTTP/1.1 " + status + "\r\n"
+           "Content-Type: " + contentType + "\r\n"
+           "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+           "Connection: close\r\n\r\n" + body;
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(QObject *parent)
+    : QObject(parent)
+{
+    connect(&_server, &QTcpServer::newConnection, this, &MetricsServer::SlotNewConnection);
+}
+
+bool MetricsServer::Start(quint16 port)
+{
+    if (port == 0) {
+        return false;
+    }
+    return _server.listen(QHostAddress::LocalHost, port);
+}
+
+void MetricsServer::SlotNewConnection()
+{
+    while (QTcpSocket* socket = _server.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { Respond(socket); });
+        QTimer::singleShot(REQUEST_TIMEOUT_MS, socket, [socket]() { socket->abort(); });
+    }
+}
+
+void MetricsServer::Respond(QTcpSocket *socket)
+{
+    // 等到请求头读完整（只处理请求行，忽略其余头部）
+    const QByteArray request = socket->peek(MAX_REQUEST_BYTES);
+    if (!request.contains("\r\n\r\n")) {
+        if (request.size() >= MAX_REQUEST_BYTES) {
+            socket->abort();
+        }
+        return;
+    }
+    socket->readAll();
+    disconnect(socket, &QTcpSocket::readyRead, this, nullptr);
+
+    const QList<QByteArray> line = request.left(request.indexOf("\r\n")).split(' ');
+    QByteArray reply;
+    if (line.size() >= 2 && (line[0] == "GET" || line[0] == "HEAD")
+        && (line[1] == "/metrics" || line[1].startsWith("/metrics?"))) {
+        const QByteArray body = Metrics::Instance().PrometheusText();
+        reply = Response("200 OK", "text/plain; version=0.0.4; charset=utf-8", body);
+        if (line[0] == "HEAD") {
+            reply.chop(body.size());
+        }
+    } else {
+        reply = Response("404 Not Found", "text/plain; charset=utf-8", "only /metrics is served\n");
+    }
+    socket->write(reply);
+    socket->disconnectFromHost();
+}
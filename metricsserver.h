@@ -0,0 +1,38 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+
+class QTcpSocket;
+
+/**
+ * @brief 以 Prometheus 文本格式提供进程内指标
+ * 只监听 127.0.0.1，GET /metrics 返回 Metrics::PrometheusText()，其余路径返回 404。
+ * 每次请求后关闭连接，足以应付抓取间隔为秒级的本地采集。
+ */
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+
+    /**
+     * @brief 开始监听
+     * @param port 端口，0 表示不启用
+     * @return 是否在监听
+     */
+    bool Start(quint16 port);
+
+    quint16 Port() const { return _server.serverPort(); }
+
+private slots:
+    void SlotNewConnection();
+
+private:
+    void Respond(QTcpSocket* socket);
+
+    QTcpServer _server;
+};
+
+#endif // METRICSSERVER_H
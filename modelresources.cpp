@@ -0,0 +1,189 @@
+#include "modelresources.h"
+#include "mainwindow.h"
+#include "inference.h"
+#include "modelregistry.h"
+#include "startupstats.h"
+#include "tracer.h"
+#include "threadtuning.h"
+#include "const.h"
+#include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QtDebug>
+
+ModelResources &ModelResources::Instance()
+{
+    static ModelResources instance;
+    return instance;
+}
+
+ModelResources::~ModelResources() = default;
+
+void ModelResources::PrepareAsync()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        if (_started) {
+            return;
+        }
+        _started = true;
+    }
+    QThreadPool::globalInstance()->start([this]() { Prepare(); });
+}
+
+bool ModelResources::WaitReady()
+{
+    PrepareAsync();
+    QMutexLocker locker(&_mutex);
+    if (!_done) {
+        TRACE_SCOPE("startup.wait_model");
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        while (!_done) {
+            _finished.wait(&_mutex);
+        }
+        QApplication::restoreOverrideCursor();
+    }
+    return _ok;
+}
+
+void ModelResources::Release()
+{
+    ThreadTuning::Instance().Cancel();   // 首次调优尚未结束时不等它测完
+    {
+        QMutexLocker locker(&_mutex);
+        while (_started && !_finishedAll) {
+            _finished.wait(&_mutex);
+        }
+        _session.reset();
+    }
+    ModelRegistry::Instance().Shutdown();
+}
+
+void ModelResources::Prepare()
+{
+    TRACE_SCOPE("startup.prepare_model");
+    const QString modelPath = CopyResourceToDisk(DEF_MODEL_PATH, "best.onnx");
+    const QString labelPath = CopyResourceToDisk(DEF_LABEL_PATH, "class_names.txt");
+    const bool ok = !modelPath.isEmpty() && !labelPath.isEmpty();
+    if (!ok) {
+        qWarning() << "Failed to write resource files to disk!";
+    } else {
+        qDebug() << "Resources ready on disk:";
+        qDebug() << "Model:" << modelPath;
+        qDebug() << "Label:" << labelPath;
+    }
+
+    // 读取本机的线程调优结果，之后创建的会话都按它配置
+    ThreadTuning& tuning = ThreadTuning::Instance();
+    const bool tuned = tuning.Load();
+
+    // 内置模型作为默认版本；外部模型目录中有可用版本时由 ModelRegistry 替换
+    if (ok) {
+        ModelRegistry::Instance().SetFallback(modelPath, labelPath);
+    }
+
+    // 路径先公布，窗口即可打开；会话预建失败不影响识别（届时按需创建）
+    {
+        QMutexLocker locker(&_mutex);
+        MODEL_PATH = modelPath;
+        LABEL_PATH = labelPath;
+        _ok = ok;
+        _done = true;
+        _finished.wakeAll();
+    }
+    StartupStats::Mark("model_extracted");
+    QMetaObject::invokeMethod(this, [this, ok]() { emit ready(ok); }, Qt::QueuedConnection);
+
+    // 先按当前配置预建会话，第一次识别不必等调优
+    if (ok) {
+        std::unique_ptr<YOLO_V8> yolo = PrepareSession(modelPath);
+        QMutexLocker locker(&_mutex);
+        _session = std::move(yolo);
+    }
+
+    // 首次运行（或换了机器）时测量线程配置；配置变化后重建预建的会话，并通知推理子进程
+    if (ok && !tuned) {
+        const ThreadProfile before = tuning.Profile();
+        QString error;
+        if (tuning.Tune(modelPath.toStdString(), &error)) {
+            StartupStats::Mark("threads_tuned");
+            const ThreadProfile after = tuning.Profile();
+            if (after.intraOpNumThreads != before.intraOpNumThreads || after.interOpNumThreads != before.interOpNumThreads
+                || after.allowSpinning != before.allowSpinning) {
+                std::unique_ptr<YOLO_V8> yolo = PrepareSession(modelPath);
+                {
+                    QMutexLocker locker(&_mutex);
+                    _session = std::move(yolo);
+                }
+                QMetaObject::invokeMethod(this, [this]() { emit threadProfileChanged(); }, Qt::QueuedConnection);
+            }
+        } else {
+            qWarning() << "[ModelResources] thread tuning failed:" << error;
+        }
+    }
+
+    // 外部模型在调优之后加载，不干扰测量，会话也直接使用调优结果；目录监视须在界面线程开始
+    QMetaObject::invokeMethod(&ModelRegistry::Instance(), []() { ModelRegistry::Instance().Start(); }, Qt::QueuedConnection);
+
+    QMutexLocker locker(&_mutex);
+    _finishedAll = true;
+    _finished.wakeAll();
+}
+
+std::unique_ptr<YOLO_V8> ModelResources::PrepareSession(const QString &modelPath)
+{
+    // 参数与 RecognizeImgThread 一致，之后的识别命中同一个共享会话
+    std::unique_ptr<YOLO_V8> yolo(new YOLO_V8);
+    DL_INIT_PARAM params;
+    params.modelPath = modelPath.toStdString();
+    params.imgSize = {640, 640};
+    params.modelType = YOLO_CLS;
+    params.cudaEnable = false;
+    ThreadTuning::Instance().Apply(params);
+    params.logSeverityLevel = 3;
+    const char* ret = yolo->CreateSession(params);
+    if (ret != RET_OK) {
+        qWarning() << "[ModelResources] session preparation failed:" << ret;
+        return nullptr;
+    }
+    StartupStats::Mark("model_ready");
+    return yolo;
+}
+
+QString ModelResources::CopyResourceToDisk(const QString &resPath, const QString &targetFileName)
+{
+    // 临时目录
+    QString targetPath = QDir::tempPath() + "/" + targetFileName;
+
+    // 如果文件已存在，先删除
+    if (QFile::exists(targetPath)) {
+        QFile::remove(targetPath);
+    }
+
+    // 打开资源文件
+    QFile resFile(resPath);
+    if (!resFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open resource:" << resPath;
+        return QString();
+    }
+
+    // 打开磁盘文件准备写入
+    QFile outFile(targetPath);
+    if (!outFile.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write file:" << targetPath;
+        resFile.close();
+        return QString();
+    }
+
+    // 复制内容
+    outFile.write(resFile.readAll());
+
+    resFile.close();
+    outFile.close();
+
+    qDebug() << "Resource" << resPath << "written to disk:" << targetPath;
+
+    return targetPath;
+}
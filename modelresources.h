@@ -0,0 +1,65 @@
+#ifndef MODELRESOURCES_H
+#define MODELRESOURCES_H
+
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QWaitCondition>
+#include <memory>
+
+class YOLO_V8;
+
+/**
+ * @brief 模型资源的后台准备
+ * 把内置的模型与标签写到临时目录（设置 MODEL_PATH / LABEL_PATH），并预先创建一个推理会话。
+ * 会话以 SHARE_SESSION 方式创建、参数与 RecognizeImgThread 一致，之后的识别直接复用，
+ * 不再重复加载与预热。这些工作在主窗口第一次绘制之后于线程池中进行，不占用启动关键路径。
+ * 内置模型同时登记为 ModelRegistry 的默认版本，随后开始监视外部模型目录。
+ * 本机尚未调优推理线程配置时，先按默认配置预建会话，再运行一次 ThreadTuning（数秒到数十秒，
+ * 期间有识别进行的测量会被丢弃）；调优结果与默认配置不同时按新配置重建会话并发出 threadProfileChanged，
+ * 推理子进程据此重启。之后才开始加载外部模型，不干扰测量。
+ */
+class ModelResources : public QObject
+{
+    Q_OBJECT
+public:
+    // 获取全局唯一实例（只在界面线程调用）
+    static ModelResources& Instance();
+
+    // 开始后台准备，重复调用无副作用
+    void PrepareAsync();
+
+    /**
+     * @brief 等待准备完成（打开使用模型的窗口前调用，通常已经完成）
+     * @return 模型与标签是否已写到磁盘
+     */
+    bool WaitReady();
+
+    // 释放预建的会话与全部模型版本（退出前在界面线程调用，须早于 ONNX Runtime 的静态对象析构）
+    void Release();
+
+signals:
+    void ready(bool ok);
+    // 首次调优完成，ThreadTuning::Profile() 已变化（界面线程发出）
+    void threadProfileChanged();
+
+private:
+    ModelResources() = default;
+    ~ModelResources() override;
+    ModelResources(const ModelResources&) = delete;
+    ModelResources& operator=(const ModelResources&) = delete;
+
+    void Prepare();
+    static std::unique_ptr<YOLO_V8> PrepareSession(const QString& modelPath);
+    static QString CopyResourceToDisk(const QString& resPath, const QString& targetFileName);
+
+    QMutex _mutex;
+    QWaitCondition _finished;
+    bool _started = false;
+    bool _done = false;          // 路径已公布
+    bool _finishedAll = false;   // 后台准备（含会话）全部结束
+    bool _ok = false;
+    std::unique_ptr<YOLO_V8> _session;   // 保持共享会话存活
+};
+
+#endif // MODELRESOURCES_H
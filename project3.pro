@@ -1,4 +1,4 @@
-QT       += core gui
+QT       += core gui network
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -11,19 +11,34 @@ CONFIG += c++17
 SOURCES += \
     main.cpp \
     mainwindow.cpp \
-    RecognizeImg/inference.cpp \
-    RecognizeImg/recognizeimgthread.cpp \
-    WindowOne/ProTree/opentreethread.cpp \
+    metricsserver.cpp \
+    inferenceclient.cpp \
+    modelresources.cpp \
+    startupstats.cpp \
+    WindowOne/ProTree/dirscanner.cpp \
+    WindowOne/ProTree/pichashthread.cpp \
+    WindowOne/ProTree/picindex.cpp \
+    WindowOne/ProTree/thumbnailloader.cpp \
+    WindowOne/ProTree/thumbnailstore.cpp \
     WindowOne/PicShow/picbutton.cpp \
+    WindowOne/PicShow/picprefetcher.cpp \
     WindowOne/PicShow/picshow.cpp \
+    WindowOne/PicShow/tiledimageview.cpp \
+    WindowOne/PicShow/tilepyramid.cpp \
+    WindowOne/ProTree/projectwatcher.cpp \
     WindowOne/ProTree/protree.cpp \
-    WindowOne/ProTree/protreeitem.cpp \
+    WindowOne/ProTree/protreemodel.cpp \
     WindowOne/ProTree/protreewidget.cpp \
     WindowOne/ProTree/removeprodialog.cpp \
+    WindowOne/ProTree/scanfilter.cpp \
+    WindowOne/ProTree/segmentpool.cpp \
     WindowOne/windowone.cpp \
     WindowOne/PicDetection/picdetection.cpp\
+    WindowOne/SimilarPanel/similarpanel.cpp \
+    WindowOne/PicNavBar/picnavbar.cpp \
     WindowTwo/windowtwo.cpp \
     WindowTwo/CameraThread/camerathread.cpp \
+    WindowTwo/Diagnostics/diagnosticspanel.cpp \
     WindowTwo/settingdialog.cpp
 
 
@@ -31,19 +46,34 @@ SOURCES += \
 HEADERS += \
     const.h \
     mainwindow.h \
-    RecognizeImg/inference.h \
-    RecognizeImg/recognizeimgthread.h \
-    WindowOne/ProTree/opentreethread.h \
+    metricsserver.h \
+    inferenceclient.h \
+    modelresources.h \
+    startupstats.h \
+    WindowOne/ProTree/dirscanner.h \
+    WindowOne/ProTree/pichashthread.h \
+    WindowOne/ProTree/picindex.h \
+    WindowOne/ProTree/thumbnailloader.h \
+    WindowOne/ProTree/thumbnailstore.h \
     WindowOne/PicShow/picbutton.h \
+    WindowOne/PicShow/picprefetcher.h \
     WindowOne/PicShow/picshow.h \
+    WindowOne/PicShow/tiledimageview.h \
+    WindowOne/PicShow/tilepyramid.h \
+    WindowOne/ProTree/projectwatcher.h \
     WindowOne/ProTree/protree.h \
-    WindowOne/ProTree/protreeitem.h \
+    WindowOne/ProTree/protreemodel.h \
     WindowOne/ProTree/protreewidget.h \
     WindowOne/ProTree/removeprodialog.h \
+    WindowOne/ProTree/scanfilter.h \
+    WindowOne/ProTree/segmentpool.h \
     WindowOne/windowone.h \
     WindowOne/PicDetection/picdetection.h \
+    WindowOne/SimilarPanel/similarpanel.h \
+    WindowOne/PicNavBar/picnavbar.h \
     WindowTwo/windowtwo.h \
     WindowTwo/CameraThread/camerathread.h \
+    WindowTwo/Diagnostics/diagnosticspanel.h \
     WindowTwo/settingdialog.h
 
 FORMS += \
@@ -59,12 +89,14 @@ FORMS += \
 INCLUDEPATH += \
     $$PWD \
     $$PWD/WindowOne \
-    $$PWD/RecognizeImg \
     $$PWD/WindowOne/ProTree \
     $$PWD/WindowOne/PicShow \
     $$PWD/WindowOne/PicDetection \
+    $$PWD/WindowOne/SimilarPanel \
+    $$PWD/WindowOne/PicNavBar \
     $$PWD/WindowTwo \
-    $$PWD/WindowTwo/CameraThread
+    $$PWD/WindowTwo/CameraThread \
+    $$PWD/WindowTwo/Diagnostics
 
 
 # Default rules for deployment.
@@ -73,28 +105,8 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
 
-# ---------------- OpenCV 配置 ----------------
-# Windows Release 版本
-CONFIG(release, debug|release): LIBS += -LE:/opencv/build/x64/vc16/lib/ -lopencv_world490
-# Windows Debug 版本
-else:CONFIG(debug, debug|release): LIBS += -LE:/opencv/build/x64/vc16/lib/ -lopencv_world490d
-
-# OpenCV 包含路径和依赖路径
-INCLUDEPATH += E:/opencv/build/include \    # 包含头文件目录
-               E:/opencv/build/include/opencv2 \
-
-DEPENDPATH += E:/opencv/build/include \
-              E:/opencv/build/include/opencv2 \
-
-# ---------------- ONNX Runtime 配置 ----------------
-# Windows Release 版本
-CONFIG(release, debug|release): LIBS += -LE:/onnxruntime/onnxruntime-win-x64-1.16.0/lib/ -lonnxruntime
-# Windows Debug 版本
-else:CONFIG(debug, debug|release): LIBS += -LE:/onnxruntime/onnxruntime-win-x64-1.16.0/lib/ -lonnxruntime
-
-# ONNX Runtime 包含路径和依赖路径
-INCLUDEPATH += E:/onnxruntime/onnxruntime-win-x64-1.16.0/include  # 头文件目录
-DEPENDPATH += E:/onnxruntime/onnxruntime-win-x64-1.16.0/include     # 库文件目录
+# ---------------- 推理核心与 OpenCV / ONNX Runtime 配置 ----------------
+include($$PWD/RecognizeImg/recognizeimg.pri)
 
 RESOURCES += \
     res.qrc
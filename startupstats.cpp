@@ -0,0 +1,45 @@
+#include "startupstats.h"
+#include "metrics.h"
+#include "tracer.h"
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtDebug>
+#include <atomic>
+
+namespace {
+
+std::atomic<qint64> g_startNs{0};
+QMutex g_mutex;
+QHash<QString, double> g_marks;   // 里程碑 -> 毫秒
+
+} // namespace
+
+void StartupStats::Start()
+{
+    g_startNs.store(Tracer::NowNs(), std::memory_order_relaxed);
+}
+
+double StartupStats::ElapsedMs()
+{
+    return (Tracer::NowNs() - g_startNs.load(std::memory_order_relaxed)) / 1e6;
+}
+
+void StartupStats::Mark(const char *milestone)
+{
+    const double ms = ElapsedMs();
+    const QString name = QLatin1String(milestone);
+    {
+        QMutexLocker locker(&g_mutex);
+        if (g_marks.contains(name)) {
+            return;
+        }
+        g_marks.insert(name, ms);
+    }
+    qInfo().noquote() << QString("[Startup] %1: %2 ms").arg(name).arg(ms, 0, 'f', 1);
+
+    // 回调在注册表锁内读取，这里只读已经写入的值
+    Metrics::Instance().RegisterCallback("cv_startup_seconds", "Time from process start (main) to each startup milestone.",
+                                         Metrics::TypeGauge, [ms]() { return ms / 1000.0; },
+                                         QString("milestone=\"%1\"").arg(name));
+}
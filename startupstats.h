@@ -0,0 +1,23 @@
+#ifndef STARTUPSTATS_H
+#define STARTUPSTATS_H
+
+/**
+ * @brief 启动阶段里程碑计时
+ * main() 开头调用 Start()，之后在各里程碑调用 Mark()，记录自 Start 起的毫秒数：
+ *     main_window_ready   主窗口构造完成
+ *     first_paint         主窗口第一次绘制
+ *     model_extracted     模型与标签已写到磁盘
+ *     model_ready         推理会话已创建并预热
+ * 每个里程碑只记录第一次，同时输出到日志并导出为指标 cv_startup_seconds{milestone="..."}。
+ */
+class StartupStats
+{
+public:
+    static void Start();
+    static void Mark(const char* milestone);
+
+    // 自 Start 起经过的毫秒数
+    static double ElapsedMs();
+};
+
+#endif // STARTUPSTATS_H
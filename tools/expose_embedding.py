@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+为 YOLOv8 分类模型导出倒数第二层特征向量。
+
+在最后一个全连接层（Gemm / MatMul）的输入上挂一个 Identity 节点，
+并把它注册为名为 "embedding" 的图输出，推理时通过
+DL_INIT_PARAM::embeddingOutputName = "embedding" 取回。
+
+用法：
+    python tools/expose_embedding.py best.onnx best_embed.onnx [--dynamic-batch]
+
+依赖：pip install onnx
+"""
+import argparse
+import sys
+
+import onnx
+from onnx import helper, shape_inference
+
+EMBEDDING_NAME = "embedding"
+
+
+def find_classifier_input(graph):
+    """返回最后一个 Gemm / MatMul 节点的数据输入（即池化 + 展平后的特征）。"""
+    for node in reversed(graph.node):
+        if node.op_type in ("Gemm", "MatMul"):
+            return node.input[0]
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("src", help="原始模型 best.onnx")
+    parser.add_argument("dst", help="输出模型路径")
+    parser.add_argument("--dynamic-batch", action="store_true",
+                        help="同时把输入/输出的第 0 维改为动态 batch")
+    args = parser.parse_args()
+
+    model = onnx.load(args.src)
+    graph = model.graph
+
+    if any(o.name == EMBEDDING_NAME for o in graph.output):
+        print("model already exposes '%s'" % EMBEDDING_NAME)
+        return 0
+
+    feature = find_classifier_input(graph)
+    if feature is None:
+        print("cannot find the final Gemm/MatMul node", file=sys.stderr)
+        return 1
+
+    graph.node.append(helper.make_node("Identity", [feature], [EMBEDDING_NAME], name="ExposeEmbedding"))
+
+    # 推断特征维度
+    inferred = shape_inference.infer_shapes(model)
+    dim = None
+    for vi in list(inferred.graph.value_info) + list(inferred.graph.output):
+        if vi.name == feature:
+            dims = vi.type.tensor_type.shape.dim
+            if dims and dims[-1].HasField("dim_value"):
+                dim = dims[-1].dim_value
+            break
+    graph.output.append(helper.make_tensor_value_info(EMBEDDING_NAME, onnx.TensorProto.FLOAT, ["batch", dim]))
+
+    if args.dynamic_batch:
+        for value in list(graph.input) + list(graph.output):
+            dims = value.type.tensor_type.shape.dim
+            if dims:
+                dims[0].ClearField("dim_value")
+                dims[0].dim_param = "batch"
+
+    onnx.checker.check_model(model)
+    onnx.save(model, args.dst)
+    print("saved %s (embedding '%s' from '%s', dim=%s)" % (args.dst, EMBEDDING_NAME, feature, dim))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+把 YOLOv8 分类模型的输入改为 uint8 NHWC RGB，归一化放进图内。
+
+在原输入（float32 NCHW，取值 [0,1]）前插入 Cast -> Transpose -> Mul(1/255)，
+新的图输入与原输入同名，形状为 [N, H, W, 3]、类型 uint8。
+推理端（YOLO_CLS_U8）直接把预处理后的 cv::Mat 缓冲区作为输入张量，
+不再生成 float CHW blob，每次推理的输入数据量约为原来的 1/4。
+
+用法：
+    python tools/fuse_uint8_input.py best.onnx best_u8.onnx [--dynamic-batch]
+
+依赖：pip install onnx numpy
+"""
+import argparse
+import sys
+
+import numpy as np
+import onnx
+from onnx import helper, numpy_helper
+
+NORMALIZED_NAME = "fused_input_nchw"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("src", help="原始模型 best.onnx（float32 NCHW 输入）")
+    parser.add_argument("dst", help="输出模型路径")
+    parser.add_argument("--dynamic-batch", action="store_true",
+                        help="同时把输入/输出的第 0 维改为动态 batch")
+    args = parser.parse_args()
+
+    model = onnx.load(args.src)
+    graph = model.graph
+
+    initializers = {init.name for init in graph.initializer}
+    inputs = [i for i in graph.input if i.name not in initializers]
+    if len(inputs) != 1:
+        print("expected exactly one graph input, found %d" % len(inputs), file=sys.stderr)
+        return 1
+    source = inputs[0]
+    tensor_type = source.type.tensor_type
+    if tensor_type.elem_type == onnx.TensorProto.UINT8:
+        print("model input '%s' is already uint8" % source.name)
+        return 0
+    if tensor_type.elem_type != onnx.TensorProto.FLOAT:
+        print("model input '%s' is not float32" % source.name, file=sys.stderr)
+        return 1
+    dims = tensor_type.shape.dim
+    if len(dims) != 4 or (dims[1].HasField("dim_value") and dims[1].dim_value != 3):
+        print("model input '%s' is not NCHW with 3 channels" % source.name, file=sys.stderr)
+        return 1
+
+    # 原输入的使用者改为读取归一化后的张量
+    input_name = source.name
+    for node in graph.node:
+        for k, name in enumerate(node.input):
+            if name == input_name:
+                node.input[k] = NORMALIZED_NAME
+
+    def dim_of(d):
+        return d.dim_value if d.HasField("dim_value") else (d.dim_param or None)
+
+    batch = "batch" if args.dynamic_batch else dim_of(dims[0])
+    height, width = dim_of(dims[2]), dim_of(dims[3])
+    new_input = helper.make_tensor_value_info(input_name, onnx.TensorProto.UINT8, [batch, height, width, 3])
+    graph.input.remove(source)
+    graph.input.insert(0, new_input)
+
+    scale = numpy_helper.from_array(np.array(1.0 / 255.0, dtype=np.float32), "fused_input_scale")
+    graph.initializer.append(scale)
+    prologue = [
+        helper.make_node("Cast", [input_name], ["fused_input_f32"], name="FusedInputCast",
+                         to=onnx.TensorProto.FLOAT),
+        helper.make_node("Transpose", ["fused_input_f32"], ["fused_input_chw"], name="FusedInputTranspose",
+                         perm=[0, 3, 1, 2]),
+        helper.make_node("Mul", ["fused_input_chw", scale.name], [NORMALIZED_NAME], name="FusedInputScale"),
+    ]
+    # 节点须保持拓扑顺序，前置节点放在最前
+    for node in reversed(prologue):
+        graph.node.insert(0, node)
+
+    if args.dynamic_batch:
+        for value in graph.output:
+            out_dims = value.type.tensor_type.shape.dim
+            if out_dims:
+                out_dims[0].ClearField("dim_value")
+                out_dims[0].dim_param = "batch"
+
+    onnx.checker.check_model(model)
+    onnx.save(model, args.dst)
+    print("saved %s (input '%s' uint8 [%s, %s, %s, 3])" % (args.dst, input_name, batch, height, width))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+汇总 ONNX Runtime 性能分析文件（DL_INIT_PARAM::profilePrefix 或
+cultural-vision-bench --stages profile 生成的 JSON）。
+
+输出两张表，均按耗时降序：
+  - 按算子类型（Conv、FusedConv、Gemm ...）：总耗时、占比、执行次数、平均耗时
+  - 按节点：同上，另列出算子类型与执行提供者
+节点名里出现的 Fused* 算子和节点数量可以用来确认图优化是否生效。
+
+给出 --compare 时并排对比两个文件（例如 FP32 与 INT8、两种线程数），
+列出各自的每次推理耗时与差值。
+
+用法：
+    python tools/ort_profile_report.py ort-t1_2024.json [--top 20] [--skip-runs 1]
+    python tools/ort_profile_report.py ort-t1.json --compare ort-t4.json [--by op|node]
+
+只依赖标准库。
+"""
+import argparse
+import json
+import sys
+from collections import defaultdict
+
+KERNEL_SUFFIX = "_kernel_time"
+
+
+class Profile:
+    """一个分析文件的聚合结果，耗时单位为微秒。"""
+
+    def __init__(self, path, skip_runs):
+        with open(path, "r", encoding="utf-8") as f:
+            events = json.load(f)
+        if isinstance(events, dict):
+            events = events.get("traceEvents", [])
+
+        runs = sorted((e["ts"], e["ts"] + e.get("dur", 0))
+                      for e in events if e.get("cat") == "Session" and e.get("name") == "model_run")
+        skipped = runs[:skip_runs]
+        self.path = path
+        self.runs = len(runs) - len(skipped)
+
+        self.ops = defaultdict(lambda: [0, 0])      # op -> [dur, count]
+        self.nodes = {}                             # node -> [dur, count, op, provider]
+        self.total = 0
+        for e in events:
+            if e.get("cat") != "Node" or not e.get("name", "").endswith(KERNEL_SUFFIX):
+                continue
+            ts = e.get("ts", 0)
+            if any(begin <= ts <= end for begin, end in skipped):
+                continue
+            dur = e.get("dur", 0)
+            args = e.get("args", {})
+            op = args.get("op_name", "?")
+            node = e["name"][:-len(KERNEL_SUFFIX)]
+            self.ops[op][0] += dur
+            self.ops[op][1] += 1
+            entry = self.nodes.setdefault(node, [0, 0, op, args.get("provider", "")])
+            entry[0] += dur
+            entry[1] += 1
+            self.total += dur
+
+    def per_run(self, dur):
+        """每次推理的平均耗时（毫秒）。"""
+        return dur / 1000.0 / max(1, self.runs)
+
+    def rows(self, by):
+        if by == "op":
+            return {op: (v[0], v[1], op, "") for op, v in self.ops.items()}
+        return {node: tuple(v) for node, v in self.nodes.items()}
+
+
+def share(dur, total):
+    return 100.0 * dur / total if total else 0.0
+
+
+def print_table(profile, by, top):
+    rows = sorted(profile.rows(by).items(), key=lambda kv: kv[1][0], reverse=True)
+    title = "operator" if by == "op" else "node"
+    print("## by %s (%d %ss, %d runs, %.3f ms/run)" % (title, len(rows), title, profile.runs,
+                                                       profile.per_run(profile.total)))
+    header = "%-48s %10s %7s %7s %10s" % (title, "ms/run", "share", "count", "avg_us")
+    if by == "node":
+        header += "  %-16s %s" % ("op", "provider")
+    print(header)
+    shown = rows if top <= 0 else rows[:top]
+    for name, (dur, count, op, provider) in shown:
+        line = "%-48s %10.3f %6.1f%% %7d %10.1f" % (name[-48:], profile.per_run(dur), share(dur, profile.total),
+                                                   count, dur / count if count else 0.0)
+        if by == "node":
+            line += "  %-16s %s" % (op, provider)
+        print(line)
+    if len(rows) > len(shown):
+        rest = sum(v[0] for _, v in rows[len(shown):])
+        print("%-48s %10.3f %6.1f%%" % ("(%d more)" % (len(rows) - len(shown)), profile.per_run(rest),
+                                         share(rest, profile.total)))
+    print()
+
+
+def print_compare(a, b, by, top):
+    rows_a, rows_b = a.rows(by), b.rows(by)
+    names = set(rows_a) | set(rows_b)
+
+    def cost(name):
+        return max(a.per_run(rows_a.get(name, (0,))[0]), b.per_run(rows_b.get(name, (0,))[0]))
+
+    ordered = sorted(names, key=cost, reverse=True)
+    title = "operator" if by == "op" else "node"
+    print("## compare by %s" % title)
+    print("A: %s (%d runs)" % (a.path, a.runs))
+    print("B: %s (%d runs)" % (b.path, b.runs))
+    print("%-48s %10s %7s %10s %7s %10s %8s" % (title, "A ms/run", "A %", "B ms/run", "B %", "B-A ms", "B/A"))
+    shown = ordered if top <= 0 else ordered[:top]
+    for name in shown:
+        da = rows_a.get(name, (0, 0))[0]
+        db = rows_b.get(name, (0, 0))[0]
+        ma, mb = a.per_run(da), b.per_run(db)
+        ratio = "%.2fx" % (mb / ma) if ma > 0 else ("new" if mb > 0 else "-")
+        if name not in rows_b:
+            ratio = "gone"
+        print("%-48s %10.3f %6.1f%% %10.3f %6.1f%% %+10.3f %8s" % (name[-48:], ma, share(da, a.total), mb,
+                                                                    share(db, b.total), mb - ma, ratio))
+    ta, tb = a.per_run(a.total), b.per_run(b.total)
+    print("%-48s %10.3f %7s %10.3f %7s %+10.3f %8s" % ("total", ta, "", tb, "", tb - ta,
+                                                       "%.2fx" % (tb / ta) if ta > 0 else "-"))
+    print("%-48s %10d %7s %10d" % ("%ss" % title, len(rows_a), "", len(rows_b)))
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("profile", help="ORT 性能分析 JSON")
+    parser.add_argument("--compare", metavar="PROFILE", help="与另一个分析文件并排对比")
+    parser.add_argument("--by", choices=["op", "node", "both"], default="both", help="汇总维度")
+    parser.add_argument("--top", type=int, default=25, help="每张表显示的行数，0 表示全部")
+    parser.add_argument("--skip-runs", type=int, default=1,
+                        help="忽略前几次推理（默认 1，即 CreateSession 内的预热）")
+    args = parser.parse_args()
+
+    try:
+        a = Profile(args.profile, args.skip_runs)
+        b = Profile(args.compare, args.skip_runs) if args.compare else None
+    except (OSError, ValueError, KeyError) as e:
+        print("cannot read profile: %s" % e, file=sys.stderr)
+        return 2
+    if a.total == 0:
+        print("no kernel events in %s" % args.profile, file=sys.stderr)
+        return 1
+
+    dims = ["op", "node"] if args.by == "both" else [args.by]
+    for by in dims:
+        if b is None:
+            print_table(a, by, args.top)
+        else:
+            print_compare(a, b, by, args.top)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())